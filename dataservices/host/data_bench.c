@@ -0,0 +1,2012 @@
+/******************************************************************************
+
+			D A T A _ B E N C H . C
+
+Copyright (c) 2016, The Linux Foundation. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above
+	  copyright notice, this list of conditions and the following
+	  disclaimer in the documentation and/or other materials provided
+	  with the distribution.
+	* Neither the name of The Linux Foundation nor the names of its
+	  contributors may be used to endorse or promote products derived
+	  from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************/
+
+/******************************************************************************
+
+  @file    data_bench.c
+  @brief   host benchmark suite for the dataservices libraries
+
+  DESCRIPTION
+  Build and run with "make bench" in this directory. Every result is one
+  {"benchmark", "params", "metric", "value", "unit"} record in a JSON
+  document written with -o (stdout gets a readable summary), so that runs
+  can be diffed across changes.
+
+  usage: data_bench [-f filter] [-s scale] [-o results.json]
+    -f  only run benchmarks whose name contains filter
+    -s  multiply iteration counts by scale (default 1)
+
+  The rmnet_data netlink family is stood in for by a responder thread on
+  the other end of a socketpair: socket(), bind() and connect() below are
+  found before the C library ones when librmnetctl resolves them. The
+  sockev multicast group is stood in for the same way, by a thread that
+  sends socket events at a set pace. A filter attached to the receiving end
+  of a socketpair runs on every send, as on a netlink socket.
+
+******************************************************************************/
+
+/*===========================================================================
+				INCLUDE FILES
+===========================================================================*/
+
+#define _GNU_SOURCE
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/netlink.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <linux/rmnet_data.h>
+#include <linux/sockev.h>
+#include "librmnetctl.h"
+
+#define BENCH_MAX_RESULTS 256
+#define BENCH_STR_LEN 64
+#define STAND_IN_MAX_FDS 16
+#define STAND_IN_WINDOW 32
+#define STAND_IN_MAX_DEVS 4
+#define STAND_IN_MAX_VNDS 32
+#define STAND_IN_MAX_EPS 33
+#define STAND_IN_MAX_TC_HANDLES 8
+
+/*===========================================================================
+			 RESULTS
+===========================================================================*/
+
+struct bench_result_s {
+	char benchmark[BENCH_STR_LEN];
+	char params[BENCH_STR_LEN];
+	char metric[BENCH_STR_LEN];
+	double value;
+	char unit[BENCH_STR_LEN];
+};
+
+static struct bench_result_s results[BENCH_MAX_RESULTS];
+static int num_results;
+static double scale = 1.0;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t scaled(uint32_t count)
+{
+	uint32_t n = (uint32_t)(count * scale);
+	return n > 0 ? n : 1;
+}
+
+static void report(const char *benchmark, const char *params,
+		   const char *metric, double value, const char *unit)
+{
+	struct bench_result_s *r;
+	printf("%-22s %-20s %-18s %14.3f %s\n",
+	       benchmark, params, metric, value, unit);
+	if (num_results == BENCH_MAX_RESULTS)
+		return;
+	r = &results[num_results++];
+	snprintf(r->benchmark, sizeof(r->benchmark), "%s", benchmark);
+	snprintf(r->params, sizeof(r->params), "%s", params);
+	snprintf(r->metric, sizeof(r->metric), "%s", metric);
+	r->value = value;
+	snprintf(r->unit, sizeof(r->unit), "%s", unit);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+/* reports min, p50, p99 and max of samples, which gets sorted */
+static void report_latency(const char *benchmark, const char *params,
+			   uint64_t *samples, uint32_t count)
+{
+	if (!count)
+		return;
+	qsort(samples, count, sizeof(uint64_t), compare_u64);
+	report(benchmark, params, "latency_min", samples[0] / 1e3, "us");
+	report(benchmark, params, "latency_p50",
+	       samples[(count - 1) / 2] / 1e3, "us");
+	report(benchmark, params, "latency_p99",
+	       samples[(count - 1) * 99 / 100] / 1e3, "us");
+	report(benchmark, params, "latency_max", samples[count - 1] / 1e3,
+	       "us");
+}
+
+/*===========================================================================
+			 STAND-IN RMNET_DATA RESPONDER
+===========================================================================*/
+
+struct stand_in_msg_s {
+	struct nlmsghdr nlmsghdr_val;
+	struct rmnet_nl_msg_s rmnet_nl_msg_s_val;
+};
+
+/* Library end of each stand-in socketpair, -1 if free */
+static int stand_in_fds[STAND_IN_MAX_FDS] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+static pthread_mutex_t stand_in_lock = PTHREAD_MUTEX_INITIALIZER;
+/* how long the responder sleeps before it answers what it took, as a slow
+ * driver */
+static volatile int stand_in_delay_ms;
+/* 1 to keep the configuration that is set and answer from it */
+static int stand_in_stateful;
+/* 1 to take requests without answering them, as a wedged driver */
+static volatile int stand_in_mute;
+
+/* Associated device of the stateful stand-in, free if name is empty */
+struct stand_in_dev_s {
+	char name[RMNET_MAX_STR_LEN];
+	uint32_t egress_flags;
+	uint16_t agg_size;
+	uint16_t agg_count;
+	uint32_t ingress_flags;
+	uint8_t tail_spacing;
+	/* by ep_id + 1 */
+	uint8_t ep_mode[STAND_IN_MAX_EPS];
+	char ep_next_dev[STAND_IN_MAX_EPS][RMNET_MAX_STR_LEN];
+};
+
+/* TC handle of a VND flow of the stateful stand-in */
+struct stand_in_flow_s {
+	uint32_t map_flow_id;
+	uint32_t tc_flow_id;
+};
+
+/* Configuration of the stateful stand-in, under stand_in_lock */
+static struct {
+	struct stand_in_dev_s devs[STAND_IN_MAX_DEVS];
+	char vnds[STAND_IN_MAX_VNDS][RMNET_MAX_STR_LEN];
+	struct stand_in_flow_s flows[STAND_IN_MAX_VNDS]
+				   [STAND_IN_MAX_TC_HANDLES];
+	uint32_t num_flows[STAND_IN_MAX_VNDS];
+} stand_in_state;
+
+static int stand_in_owns(int fd)
+{
+	int i, owned = 0;
+	pthread_mutex_lock(&stand_in_lock);
+	for (i = 0; i < STAND_IN_MAX_FDS; i++)
+		if (stand_in_fds[i] == fd)
+			owned = 1;
+	pthread_mutex_unlock(&stand_in_lock);
+	return owned;
+}
+
+static struct stand_in_dev_s *stand_in_dev(const __u8 *name)
+{
+	int i;
+	for (i = 0; i < STAND_IN_MAX_DEVS; i++)
+		if (stand_in_state.devs[i].name[0] &&
+		    !strncmp(stand_in_state.devs[i].name, (const char *)name,
+			     RMNET_MAX_STR_LEN))
+			return &stand_in_state.devs[i];
+	return NULL;
+}
+
+/* a device the stateful stand-in knows: associated or a VND */
+static int stand_in_dev_exists(const __u8 *name)
+{
+	int i;
+	if (stand_in_dev(name))
+		return 1;
+	for (i = 0; i < STAND_IN_MAX_VNDS; i++)
+		if (stand_in_state.vnds[i][0] &&
+		    !strncmp(stand_in_state.vnds[i], (const char *)name,
+			     RMNET_MAX_STR_LEN))
+			return 1;
+	return 0;
+}
+
+/*!
+* @brief Answers a request from the configuration that was set, the way
+* rmnet_data does: setting up what is set up already fails, so does
+* configuring what does not exist. Like there, adding a flow twice takes
+* a second TC handle, and deleting one that is not there fails.
+*/
+static void stand_in_answer_stateful(const struct rmnet_nl_msg_s *req,
+				     struct rmnet_nl_msg_s *resp)
+{
+	struct stand_in_dev_s *dev;
+	uint32_t ep = (uint32_t)((int32_t)req->local_ep_config.ep_id + 1);
+	uint32_t id = req->vnd.id;
+	int i;
+
+	pthread_mutex_lock(&stand_in_lock);
+	switch (req->message_type) {
+	case RMNET_NETLINK_ASSOCIATE_NETWORK_DEVICE:
+		if (stand_in_dev(req->data)) {
+			resp->return_code = RMNET_CONFIG_DEVICE_IN_USE;
+			break;
+		}
+		for (i = 0; i < STAND_IN_MAX_DEVS; i++)
+			if (!stand_in_state.devs[i].name[0])
+				break;
+		if (i == STAND_IN_MAX_DEVS) {
+			resp->return_code = RMNET_CONFIG_NOMEM;
+			break;
+		}
+		memset(&stand_in_state.devs[i], 0, sizeof(*dev));
+		memcpy(stand_in_state.devs[i].name, req->data,
+		       RMNET_MAX_STR_LEN - 1);
+		break;
+	case RMNET_NETLINK_UNASSOCIATE_NETWORK_DEVICE:
+		if (!(dev = stand_in_dev(req->data)))
+			resp->return_code = RMNET_CONFIG_NO_SUCH_DEVICE;
+		else
+			dev->name[0] = 0;
+		break;
+	case RMNET_NETLINK_GET_NETWORK_DEVICE_ASSOCIATED:
+		resp->crd = RMNET_NETLINK_MSG_RETURNDATA;
+		resp->return_code = stand_in_dev(req->data) ? 1 : 0;
+		break;
+	case RMNET_NETLINK_SET_LINK_EGRESS_DATA_FORMAT:
+	case RMNET_NETLINK_SET_LINK_INGRESS_DATA_FORMAT:
+	case RMNET_NETLINK_GET_LINK_EGRESS_DATA_FORMAT:
+	case RMNET_NETLINK_GET_LINK_INGRESS_DATA_FORMAT:
+		if (!(dev = stand_in_dev(req->data_format.dev))) {
+			resp->return_code = RMNET_CONFIG_NO_SUCH_DEVICE;
+			break;
+		}
+		if (req->message_type ==
+		    RMNET_NETLINK_SET_LINK_EGRESS_DATA_FORMAT) {
+			dev->egress_flags = req->data_format.flags;
+			dev->agg_size = req->data_format.agg_size;
+			dev->agg_count = req->data_format.agg_count;
+		} else if (req->message_type ==
+			   RMNET_NETLINK_SET_LINK_INGRESS_DATA_FORMAT) {
+			dev->ingress_flags = req->data_format.flags;
+			dev->tail_spacing = req->data_format.tail_spacing;
+		} else {
+			resp->crd = RMNET_NETLINK_MSG_RETURNDATA;
+			memcpy(resp->data_format.dev, dev->name,
+			       RMNET_MAX_STR_LEN);
+			if (req->message_type ==
+			    RMNET_NETLINK_GET_LINK_EGRESS_DATA_FORMAT) {
+				resp->data_format.flags = dev->egress_flags;
+				resp->data_format.agg_size = dev->agg_size;
+				resp->data_format.agg_count = dev->agg_count;
+			} else {
+				resp->data_format.flags = dev->ingress_flags;
+				resp->data_format.tail_spacing =
+					dev->tail_spacing;
+			}
+		}
+		break;
+	case RMNET_NETLINK_SET_LOGICAL_EP_CONFIG:
+	case RMNET_NETLINK_UNSET_LOGICAL_EP_CONFIG:
+	case RMNET_NETLINK_GET_LOGICAL_EP_CONFIG:
+		if (!(dev = stand_in_dev(req->local_ep_config.dev))) {
+			resp->return_code = RMNET_CONFIG_NO_SUCH_DEVICE;
+			break;
+		}
+		if (ep >= STAND_IN_MAX_EPS) {
+			resp->return_code = RMNET_CONFIG_BAD_ARGUMENTS;
+			break;
+		}
+		if (req->message_type == RMNET_NETLINK_SET_LOGICAL_EP_CONFIG) {
+			if (dev->ep_mode[ep] != RMNET_EPMODE_NONE)
+				resp->return_code = RMNET_CONFIG_DEVICE_IN_USE;
+			else if (!stand_in_dev_exists(
+					req->local_ep_config.next_dev))
+				resp->return_code =
+					RMNET_CONFIG_BAD_EGRESS_DEVICE;
+			else {
+				dev->ep_mode[ep] =
+					req->local_ep_config.operating_mode;
+				memcpy(dev->ep_next_dev[ep],
+				       req->local_ep_config.next_dev,
+				       RMNET_MAX_STR_LEN - 1);
+			}
+		} else if (req->message_type ==
+			   RMNET_NETLINK_UNSET_LOGICAL_EP_CONFIG) {
+			dev->ep_mode[ep] = RMNET_EPMODE_NONE;
+			dev->ep_next_dev[ep][0] = 0;
+		} else {
+			resp->crd = RMNET_NETLINK_MSG_RETURNDATA;
+			resp->local_ep_config.ep_id =
+				req->local_ep_config.ep_id;
+			resp->local_ep_config.operating_mode =
+				dev->ep_mode[ep];
+			memcpy(resp->local_ep_config.next_dev,
+			       dev->ep_next_dev[ep], RMNET_MAX_STR_LEN);
+		}
+		break;
+	case RMNET_NETLINK_NEW_VND:
+	case RMNET_NETLINK_NEW_VND_WITH_PREFIX:
+		if (id >= STAND_IN_MAX_VNDS)
+			resp->return_code = RMNET_CONFIG_BAD_ARGUMENTS;
+		else if (stand_in_state.vnds[id][0])
+			resp->return_code = RMNET_CONFIG_DEVICE_IN_USE;
+		else
+			snprintf(stand_in_state.vnds[id], RMNET_MAX_STR_LEN,
+				 "%.*s%u", RMNET_MAX_STR_LEN - 3,
+				 (req->message_type == RMNET_NETLINK_NEW_VND) ?
+				 "rmnet_data" : (const char *)req->vnd.vnd_name,
+				 id);
+		break;
+	case RMNET_NETLINK_FREE_VND:
+	case RMNET_NETLINK_GET_VND_NAME:
+	case RMNET_NETLINK_ADD_VND_TC_FLOW:
+	case RMNET_NETLINK_DEL_VND_TC_FLOW:
+		/* vnd.id and flow_control.id are the same field */
+		if ((id >= STAND_IN_MAX_VNDS) || !stand_in_state.vnds[id][0]) {
+			resp->return_code = RMNET_CONFIG_NO_SUCH_DEVICE;
+			break;
+		}
+		if (req->message_type == RMNET_NETLINK_FREE_VND) {
+			stand_in_state.vnds[id][0] = 0;
+			stand_in_state.num_flows[id] = 0;
+		} else if (req->message_type ==
+			   RMNET_NETLINK_ADD_VND_TC_FLOW) {
+			if (stand_in_state.num_flows[id] ==
+			    STAND_IN_MAX_TC_HANDLES) {
+				resp->return_code =
+					RMNET_CONFIG_TC_HANDLE_FULL;
+				break;
+			}
+			i = stand_in_state.num_flows[id]++;
+			stand_in_state.flows[id][i].map_flow_id =
+				req->flow_control.map_flow_id;
+			stand_in_state.flows[id][i].tc_flow_id =
+				req->flow_control.tc_flow_id;
+		} else if (req->message_type ==
+			   RMNET_NETLINK_DEL_VND_TC_FLOW) {
+			for (i = 0; i < (int)stand_in_state.num_flows[id]; i++)
+				if ((stand_in_state.flows[id][i].map_flow_id ==
+				     req->flow_control.map_flow_id) &&
+				    (stand_in_state.flows[id][i].tc_flow_id ==
+				     req->flow_control.tc_flow_id))
+					break;
+			if (i == (int)stand_in_state.num_flows[id]) {
+				resp->return_code =
+					RMNET_CONFIG_INVALID_REQUEST;
+				break;
+			}
+			stand_in_state.flows[id][i] = stand_in_state.flows[id]
+				[--stand_in_state.num_flows[id]];
+		} else if (req->message_type == RMNET_NETLINK_GET_VND_NAME) {
+			resp->crd = RMNET_NETLINK_MSG_RETURNDATA;
+			resp->vnd.id = id;
+			memcpy(resp->vnd.vnd_name, stand_in_state.vnds[id],
+			       RMNET_MAX_STR_LEN);
+		}
+		break;
+	default:
+		resp->return_code = RMNET_CONFIG_UNKNOWN_MESSAGE;
+		break;
+	}
+	pthread_mutex_unlock(&stand_in_lock);
+}
+
+static void stand_in_reset(void)
+{
+	pthread_mutex_lock(&stand_in_lock);
+	memset(&stand_in_state, 0, sizeof(stand_in_state));
+	pthread_mutex_unlock(&stand_in_lock);
+}
+
+/*!
+* @brief Answers a request the way rmnet_data does for a device that
+* accepts everything, except for VND ids of 200 and up, which do not exist
+*/
+static void stand_in_answer(const struct stand_in_msg_s *request,
+			    struct stand_in_msg_s *response)
+{
+	const struct rmnet_nl_msg_s *req = &request->rmnet_nl_msg_s_val;
+	struct rmnet_nl_msg_s *resp = &response->rmnet_nl_msg_s_val;
+
+	memset(response, 0, sizeof(*response));
+	response->nlmsghdr_val.nlmsg_len = sizeof(*response);
+	response->nlmsghdr_val.nlmsg_type = NLMSG_DONE;
+	response->nlmsghdr_val.nlmsg_seq = request->nlmsghdr_val.nlmsg_seq;
+	resp->message_type = req->message_type;
+	resp->crd = RMNET_NETLINK_MSG_RETURNCODE;
+	resp->return_code = RMNET_CONFIG_OK;
+
+	if (stand_in_stateful) {
+		stand_in_answer_stateful(req, resp);
+		return;
+	}
+
+	switch (req->message_type) {
+	case RMNET_NETLINK_GET_NETWORK_DEVICE_ASSOCIATED:
+		resp->crd = RMNET_NETLINK_MSG_RETURNDATA;
+		resp->return_code = 1;
+		break;
+	case RMNET_NETLINK_GET_LINK_EGRESS_DATA_FORMAT:
+	case RMNET_NETLINK_GET_LINK_INGRESS_DATA_FORMAT:
+	case RMNET_NETLINK_GET_LOGICAL_EP_CONFIG:
+		resp->crd = RMNET_NETLINK_MSG_RETURNDATA;
+		memcpy(resp->data, req->data, RMNET_NL_DATA_MAX_LEN);
+		break;
+	case RMNET_NETLINK_GET_VND_NAME:
+		resp->crd = RMNET_NETLINK_MSG_RETURNDATA;
+		resp->vnd.id = req->vnd.id;
+		snprintf((char *)resp->vnd.vnd_name, RMNET_MAX_STR_LEN,
+			 "rmnet_data%u", req->vnd.id);
+		break;
+	case RMNET_NETLINK_NEW_VND:
+	case RMNET_NETLINK_NEW_VND_WITH_PREFIX:
+	case RMNET_NETLINK_FREE_VND:
+		if (req->vnd.id >= 200)
+			resp->return_code = RMNET_CONFIG_NO_SUCH_DEVICE;
+		break;
+	case RMNET_NETLINK_ADD_VND_TC_FLOW:
+	case RMNET_NETLINK_DEL_VND_TC_FLOW:
+		if (req->flow_control.id >= 200)
+			resp->return_code = RMNET_CONFIG_NO_SUCH_DEVICE;
+		break;
+	default:
+		break;
+	}
+}
+
+/*!
+* @brief Responder thread of a stand-in socket, until the library closes it.
+* Like the kernel, it takes every request it finds queued and answers each
+* with its own datagram.
+*/
+static void *stand_in_thread(void *arg)
+{
+	int fd = (int)(intptr_t)arg;
+	struct stand_in_msg_s request[STAND_IN_WINDOW];
+	struct stand_in_msg_s response[STAND_IN_WINDOW];
+	struct iovec request_iov[STAND_IN_WINDOW], response_iov[STAND_IN_WINDOW];
+	struct mmsghdr request_msg[STAND_IN_WINDOW];
+	struct mmsghdr response_msg[STAND_IN_WINDOW];
+	int i, n, answered, done = 0;
+
+	while (!done) {
+		memset(request_msg, 0, sizeof(request_msg));
+		for (i = 0; i < STAND_IN_WINDOW; i++) {
+			request_iov[i].iov_base = &request[i];
+			request_iov[i].iov_len = sizeof(request[i]);
+			request_msg[i].msg_hdr.msg_iov = &request_iov[i];
+			request_msg[i].msg_hdr.msg_iovlen = 1;
+		}
+		n = recvmmsg(fd, request_msg, STAND_IN_WINDOW, MSG_WAITFORONE,
+			     NULL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+
+		if (stand_in_delay_ms)
+			usleep(stand_in_delay_ms * 1000);
+		memset(response_msg, 0, sizeof(response_msg));
+		answered = 0;
+		for (i = 0; i < n; i++) {
+			if (request_msg[i].msg_len == 0) {
+				/* the library closed its end */
+				done = 1;
+				break;
+			}
+			if (stand_in_mute)
+				continue;
+			stand_in_answer(&request[i], &response[answered]);
+			response_iov[answered].iov_base = &response[answered];
+			response_iov[answered].iov_len = sizeof(response[0]);
+			response_msg[answered].msg_hdr.msg_iov =
+				&response_iov[answered];
+			response_msg[answered].msg_hdr.msg_iovlen = 1;
+			answered++;
+		}
+		if (answered > 0 &&
+		    sendmmsg(fd, response_msg, answered, 0) < 0)
+			break;
+	}
+	close(fd);
+	return NULL;
+}
+
+static int stand_in_open(void)
+{
+	int fds[2], i, slot = -1;
+	pthread_t thread;
+
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) < 0)
+		return -1;
+	pthread_mutex_lock(&stand_in_lock);
+	for (i = 0; i < STAND_IN_MAX_FDS && slot < 0; i++)
+		if (stand_in_fds[i] < 0)
+			slot = i;
+	if (slot >= 0)
+		stand_in_fds[slot] = fds[0];
+	pthread_mutex_unlock(&stand_in_lock);
+	if (slot < 0 || pthread_create(&thread, NULL, stand_in_thread,
+				       (void *)(intptr_t)fds[1])) {
+		close(fds[0]);
+		close(fds[1]);
+		errno = EMFILE;
+		return -1;
+	}
+	pthread_detach(thread);
+	return fds[0];
+}
+
+/*===========================================================================
+			 STAND-IN SOCKEV MULTICAST
+===========================================================================*/
+
+/* Collector end of the stand-in sockev socket and its peer, -1 if none */
+static int sockev_stand_in_fd = -1;
+static int sockev_stand_in_peer = -1;
+static pthread_t sockev_stand_in_thread;
+/* set when an event did not fit, as the kernel does, so that the next
+ * receive fails with ENOBUFS */
+static int sockev_stand_in_overrun;
+
+/* Events the stand-in sends, in bursts, and what became of them. The
+ * events that match are the ones the receiver's filter is expected to
+ * keep, all of them if match is NULL. */
+static struct {
+	uint32_t events;
+	uint32_t burst;
+	uint32_t pause_us;
+	uint32_t pids;
+	int (*match)(const struct sknlsockevmsg *msg);
+	uint32_t sent;
+	uint32_t matched;
+	uint32_t dropped;
+} sockev_load;
+
+struct sockev_stand_in_msg_s {
+	struct nlmsghdr nlh;
+	struct sknlsockevmsg msg;
+};
+
+/* event seq of the load: every pid creates, connects and shuts down a TCP
+ * socket in turn, skflags carries seq so that a receiver can check it */
+static void sockev_load_event(uint32_t seq, struct sknlsockevmsg *msg)
+{
+	static const char *const events[] = {
+		"SOCKEV_SOCKET", "SOCKEV_CONNECT", "SOCKEV_SHUTDOWN"
+	};
+	uint32_t pid = 1000 + (seq / 3) % sockev_load.pids;
+
+	memset(msg, 0, sizeof(*msg));
+	snprintf((char *)msg->event, sizeof(msg->event), "%s",
+		 events[seq % 3]);
+	msg->pid = pid;
+	msg->skfamily = (pid & 1) ? AF_INET6 : AF_INET;
+	msg->skstate = (seq % 3) ? 1 : 7;
+	msg->skprotocol = IPPROTO_TCP;
+	msg->sktype = SOCK_STREAM;
+	msg->skflags = seq;
+}
+
+static void *sockev_stand_in_send(void *arg)
+{
+	struct sockev_stand_in_msg_s datagram;
+	int fd = (int)(intptr_t)arg;
+	uint32_t seq = 0, i;
+
+	memset(&datagram, 0, sizeof(datagram));
+	datagram.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(datagram.msg));
+	while (seq < sockev_load.events) {
+		for (i = 0; i < sockev_load.burst &&
+			    seq < sockev_load.events; i++, seq++) {
+			sockev_load_event(seq, &datagram.msg);
+			if (send(fd, &datagram, sizeof(datagram), MSG_DONTWAIT)
+				== sizeof(datagram)) {
+				sockev_load.sent++;
+				if (!sockev_load.match ||
+				    sockev_load.match(&datagram.msg))
+					sockev_load.matched++;
+			} else {
+				sockev_load.dropped++;
+				__sync_lock_test_and_set(
+					&sockev_stand_in_overrun, 1);
+			}
+		}
+		usleep(sockev_load.pause_us);
+	}
+	/* the collector drains what is queued, then sees the end */
+	close(fd);
+	return NULL;
+}
+
+static int sockev_stand_in_open(void)
+{
+	int fds[2];
+	if (sockev_stand_in_fd >= 0) {
+		errno = EADDRINUSE;
+		return -1;
+	}
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) < 0)
+		return -1;
+	sockev_stand_in_overrun = 0;
+	sockev_load.sent = 0;
+	sockev_load.matched = 0;
+	sockev_load.dropped = 0;
+	sockev_stand_in_peer = fds[1];
+	sockev_stand_in_fd = fds[0];
+	return fds[0];
+}
+
+/* on bind(), once the receive buffer is set */
+static int sockev_stand_in_start(void)
+{
+	if (pthread_create(&sockev_stand_in_thread, NULL,
+			   sockev_stand_in_send,
+			   (void *)(intptr_t)sockev_stand_in_peer)) {
+		errno = ENOMEM;
+		return -1;
+	}
+	return 0;
+}
+
+int socket(int domain, int type, int protocol)
+{
+	static int (*real_socket)(int, int, int);
+	if (domain == PF_NETLINK && protocol == RMNET_NETLINK_PROTO)
+		return stand_in_open();
+	if (domain == PF_NETLINK && protocol == NETLINK_SOCKEV)
+		return sockev_stand_in_open();
+	if (!real_socket)
+		real_socket = (int (*)(int, int, int))dlsym(RTLD_NEXT,
+							      "socket");
+	return real_socket(domain, type, protocol);
+}
+
+int bind(int fd, __CONST_SOCKADDR_ARG addr, socklen_t len)
+{
+	static int (*real_bind)(int, __CONST_SOCKADDR_ARG, socklen_t);
+	if (stand_in_owns(fd))
+		return 0;
+	if (fd >= 0 && fd == sockev_stand_in_fd)
+		return sockev_stand_in_start();
+	if (!real_bind)
+		real_bind = (int (*)(int, __CONST_SOCKADDR_ARG, socklen_t))
+			    dlsym(RTLD_NEXT, "bind");
+	return real_bind(fd, addr, len);
+}
+
+int connect(int fd, __CONST_SOCKADDR_ARG addr, socklen_t len)
+{
+	static int (*real_connect)(int, __CONST_SOCKADDR_ARG, socklen_t);
+	if (stand_in_owns(fd))
+		return 0;
+	if (!real_connect)
+		real_connect = (int (*)(int, __CONST_SOCKADDR_ARG, socklen_t))
+			       dlsym(RTLD_NEXT, "connect");
+	return real_connect(fd, addr, len);
+}
+
+int close(int fd)
+{
+	static int (*real_close)(int);
+	int i;
+	pthread_mutex_lock(&stand_in_lock);
+	for (i = 0; i < STAND_IN_MAX_FDS; i++)
+		if (stand_in_fds[i] == fd)
+			stand_in_fds[i] = -1;
+	pthread_mutex_unlock(&stand_in_lock);
+	if (fd >= 0 && fd == sockev_stand_in_fd)
+		sockev_stand_in_fd = -1;
+	if (!real_close)
+		real_close = (int (*)(int))dlsym(RTLD_NEXT, "close");
+	return real_close(fd);
+}
+
+static int real_setsockopt(int fd, int level, int name, const void *val,
+			   socklen_t len)
+{
+	static int (*real)(int, int, int, const void *, socklen_t);
+	if (!real)
+		real = (int (*)(int, int, int, const void *, socklen_t))
+		       dlsym(RTLD_NEXT, "setsockopt");
+	return real(fd, level, name, val, len);
+}
+
+int setsockopt(int fd, int level, int name, const void *val, socklen_t len)
+{
+	socklen_t size_len = sizeof(int);
+	int rc, size;
+
+	rc = real_setsockopt(fd, level, name, val, len);
+	if (rc == 0 && fd >= 0 && fd == sockev_stand_in_fd &&
+	    level == SOL_SOCKET &&
+	    (name == SO_RCVBUF || name == SO_RCVBUFFORCE) &&
+	    getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, &size_len) == 0) {
+		/* a socketpair queues what the sender's buffer holds */
+		size /= 2;
+		if (real_setsockopt(sockev_stand_in_peer, SOL_SOCKET,
+				    SO_SNDBUFFORCE, &size, sizeof(size)) < 0)
+			real_setsockopt(sockev_stand_in_peer, SOL_SOCKET,
+					SO_SNDBUF, &size, sizeof(size));
+	}
+	return rc;
+}
+
+int recvmmsg(int fd, struct mmsghdr *msgs, unsigned int vlen, int flags,
+	     struct timespec *timeout)
+{
+	static int (*real_recvmmsg)(int, struct mmsghdr *, unsigned int, int,
+				    struct timespec *);
+	int i, n;
+
+	if (fd >= 0 && fd == sockev_stand_in_fd &&
+	    __sync_lock_test_and_set(&sockev_stand_in_overrun, 0)) {
+		errno = ENOBUFS;
+		return -1;
+	}
+	if (!real_recvmmsg)
+		real_recvmmsg = (int (*)(int, struct mmsghdr *, unsigned int,
+					 int, struct timespec *))
+				dlsym(RTLD_NEXT, "recvmmsg");
+	n = real_recvmmsg(fd, msgs, vlen, flags, timeout);
+	/* the sender closed the socketpair: the messages before, then 0 */
+	for (i = 0; fd >= 0 && fd == sockev_stand_in_fd && i < n; i++)
+		if (msgs[i].msg_len == 0)
+			return i;
+	return n;
+}
+
+/*===========================================================================
+			 RMNETCTL
+===========================================================================*/
+
+#define BRINGUP_PHYS_DEV "rmnet_ipa0"
+#define BRINGUP_FLOWS_PER_VND 4
+
+/*!
+* @brief Brings up a data call of num_vnds VNDs: the physical device, then
+* per VND its logical endpoint, the VND itself and its flows
+* @return number of requests, -1 if one of them failed
+*/
+static int bringup_sync(rmnetctl_hndl_t *hndl, uint32_t num_vnds)
+{
+	char vnd_name[BENCH_STR_LEN];
+	uint16_t error_code;
+	uint32_t vnd, flow;
+	int requests = 0, failed = 0;
+
+	failed |= rmnet_associate_network_device(hndl, BRINGUP_PHYS_DEV,
+				&error_code, RMNETCTL_DEVICE_ASSOCIATE);
+	failed |= rmnet_set_link_ingress_data_format_tailspace(hndl,
+				RMNET_INGRESS_FORMAT_MAP |
+				RMNET_INGRESS_FORMAT_DEAGGREGATION |
+				RMNET_INGRESS_FORMAT_DEMUXING,
+				0, BRINGUP_PHYS_DEV, &error_code);
+	failed |= rmnet_set_link_egress_data_format(hndl,
+				RMNET_EGRESS_FORMAT_MAP |
+				RMNET_EGRESS_FORMAT_AGGREGATION |
+				RMNET_EGRESS_FORMAT_MUXING,
+				8192, 20, BRINGUP_PHYS_DEV, &error_code);
+	requests += 3;
+	for (vnd = 0; vnd < num_vnds; vnd++) {
+		snprintf(vnd_name, sizeof(vnd_name), "rmnet_data%u", vnd);
+		failed |= rmnet_new_vnd(hndl, vnd, &error_code,
+					RMNETCTL_NEW_VND);
+		failed |= rmnet_set_logical_ep_config(hndl, (int32_t)vnd,
+					RMNET_EPMODE_VND, BRINGUP_PHYS_DEV,
+					vnd_name, &error_code);
+		requests += 2;
+		for (flow = 0; flow < BRINGUP_FLOWS_PER_VND; flow++) {
+			failed |= rmnet_add_del_vnd_tc_flow(hndl, vnd,
+					flow, vnd * 16 + flow,
+					RMNETCTL_ADD_FLOW, &error_code);
+			requests++;
+		}
+	}
+	return failed ? -1 : requests;
+}
+
+/* queues the requests of bringup_sync() for phys_dev on batch */
+static int bringup_queue(rmnetctl_batch_t *batch, const char *phys_dev,
+			 uint32_t num_vnds)
+{
+	char vnd_name[BENCH_STR_LEN];
+	uint16_t error_code;
+	uint32_t vnd, flow;
+	int failed = 0;
+
+	rmnetctl_batch_reset(batch);
+	failed |= rmnet_batch_associate_network_device(batch, phys_dev,
+				&error_code, RMNETCTL_DEVICE_ASSOCIATE);
+	failed |= rmnet_batch_set_link_ingress_data_format_tailspace(batch,
+				RMNET_INGRESS_FORMAT_MAP |
+				RMNET_INGRESS_FORMAT_DEAGGREGATION |
+				RMNET_INGRESS_FORMAT_DEMUXING,
+				0, phys_dev, &error_code);
+	failed |= rmnet_batch_set_link_egress_data_format(batch,
+				RMNET_EGRESS_FORMAT_MAP |
+				RMNET_EGRESS_FORMAT_AGGREGATION |
+				RMNET_EGRESS_FORMAT_MUXING,
+				8192, 20, phys_dev, &error_code);
+	for (vnd = 0; vnd < num_vnds; vnd++) {
+		snprintf(vnd_name, sizeof(vnd_name), "rmnet_data%u", vnd);
+		failed |= rmnet_batch_new_vnd(batch, vnd, &error_code,
+					      RMNETCTL_NEW_VND);
+		failed |= rmnet_batch_set_logical_ep_config(batch,
+					(int32_t)vnd, RMNET_EPMODE_VND,
+					phys_dev, vnd_name, &error_code);
+		for (flow = 0; flow < BRINGUP_FLOWS_PER_VND; flow++)
+			failed |= rmnet_batch_add_del_vnd_tc_flow(batch, vnd,
+					flow, vnd * 16 + flow,
+					RMNETCTL_ADD_FLOW, &error_code);
+	}
+	return failed;
+}
+
+static int bringup_batch(rmnetctl_batch_t *batch, uint32_t num_vnds)
+{
+	uint16_t error_code;
+	int failed;
+
+	failed = bringup_queue(batch, BRINGUP_PHYS_DEV, num_vnds);
+	failed |= rmnetctl_batch_commit(batch, &error_code);
+	return failed ? -1 : (int)rmnetctl_batch_count(batch);
+}
+
+/*!
+* @brief Checks that every request of a batch gets its own outcome
+* @return 0 if all outcomes are as expected
+*/
+static int check_batch_status(rmnetctl_batch_t *batch)
+{
+	static const uint32_t vnd_ids[] = { 1, 250, 2, 3, 201, 4 };
+	const uint32_t num = sizeof(vnd_ids) / sizeof(vnd_ids[0]);
+	uint16_t error_code, expected_code;
+	uint32_t i, n = 0;
+	int rc, expected, errors = 0;
+
+	rmnetctl_batch_reset(batch);
+	/* more requests than fit one window */
+	for (n = 0; n < 40; n++)
+		rmnet_batch_new_vnd(batch, vnd_ids[n % num], &error_code,
+				    RMNETCTL_NEW_VND);
+	rc = rmnetctl_batch_commit(batch, &error_code);
+	if (rc != RMNETCTL_KERNEL_ERR ||
+	    error_code != RMNETCTL_KERNEL_FIRST_ERR +
+			  RMNET_CONFIG_NO_SUCH_DEVICE)
+		errors++;
+	for (i = 0; i < n; i++) {
+		expected = (vnd_ids[i % num] >= 200) ?
+			   RMNETCTL_KERNEL_ERR : RMNETCTL_SUCCESS;
+		expected_code = (vnd_ids[i % num] >= 200) ?
+			RMNETCTL_KERNEL_FIRST_ERR + RMNET_CONFIG_NO_SUCH_DEVICE :
+			RMNETCTL_API_SUCCESS;
+		rc = rmnetctl_batch_status(batch, i, &error_code);
+		if (rc != expected || error_code != expected_code)
+			errors++;
+	}
+	return errors;
+}
+
+static void bench_rmnetctl(void)
+{
+	static const uint32_t vnd_counts[] = { 1, 8, 16 };
+	static const uint32_t batch_sizes[] = { 1, 8, 32, 128 };
+	const uint32_t rounds = scaled(2000);
+	rmnetctl_hndl_t *hndl = NULL;
+	rmnetctl_batch_t *batch = NULL;
+	uint64_t *samples, start, elapsed;
+	uint16_t error_code;
+	char params[BENCH_STR_LEN];
+	uint32_t v, b, i, j, total;
+	int requests = 0;
+
+	if (rmnetctl_init(&hndl, &error_code) != RMNETCTL_SUCCESS ||
+	    rmnetctl_batch_init(hndl, &batch, &error_code)
+		!= RMNETCTL_SUCCESS) {
+		fprintf(stderr, "rmnetctl: init failed %u\n", error_code);
+		rmnetctl_cleanup(hndl);
+		return;
+	}
+	samples = (uint64_t *)malloc(rounds * sizeof(uint64_t));
+
+	report("rmnetctl", "check=status", "errors",
+	       check_batch_status(batch), "count");
+
+	for (v = 0; v < sizeof(vnd_counts) / sizeof(vnd_counts[0]); v++) {
+		for (i = 0; i < rounds; i++) {
+			start = now_ns();
+			requests = bringup_sync(hndl, vnd_counts[v]);
+			samples[i] = now_ns() - start;
+		}
+		snprintf(params, sizeof(params), "sync vnds=%u",
+			 vnd_counts[v]);
+		if (requests < 0)
+			report("rmnetctl_bringup", params, "failed", 1, "");
+		report("rmnetctl_bringup", params, "requests", requests, "");
+		report_latency("rmnetctl_bringup", params, samples, rounds);
+
+		for (i = 0; i < rounds; i++) {
+			start = now_ns();
+			requests = bringup_batch(batch, vnd_counts[v]);
+			samples[i] = now_ns() - start;
+		}
+		snprintf(params, sizeof(params), "batch vnds=%u",
+			 vnd_counts[v]);
+		if (requests < 0)
+			report("rmnetctl_bringup", params, "failed", 1, "");
+		report_latency("rmnetctl_bringup", params, samples, rounds);
+	}
+
+	/* raw request rate by batch size, tc flows only */
+	total = scaled(200000);
+	for (b = 0; b < sizeof(batch_sizes) / sizeof(batch_sizes[0]); b++) {
+		start = now_ns();
+		for (i = 0; i < total; i += batch_sizes[b]) {
+			rmnetctl_batch_reset(batch);
+			for (j = 0; j < batch_sizes[b]; j++)
+				rmnet_batch_add_del_vnd_tc_flow(batch, 1, j, j,
+					RMNETCTL_ADD_FLOW, &error_code);
+			rmnetctl_batch_commit(batch, &error_code);
+		}
+		elapsed = now_ns() - start;
+		snprintf(params, sizeof(params), "batch=%u", batch_sizes[b]);
+		report("rmnetctl_rate", params, "throughput",
+		       i / (elapsed / 1e9), "req/s");
+	}
+	start = now_ns();
+	for (i = 0; i < total; i++)
+		rmnet_add_del_vnd_tc_flow(hndl, 1, i, i, RMNETCTL_ADD_FLOW,
+					  &error_code);
+	elapsed = now_ns() - start;
+	report("rmnetctl_rate", "sync", "throughput", i / (elapsed / 1e9),
+	       "req/s");
+
+	free(samples);
+	rmnetctl_batch_cleanup(batch);
+	rmnetctl_cleanup(hndl);
+}
+
+struct shared_worker_s {
+	rmnetctl_hndl_t *hndl;
+	uint32_t first_id;
+	uint32_t count;
+	uint32_t mismatches;
+};
+
+/* each response has to carry the name of the VND asked for */
+static void *shared_worker(void *arg)
+{
+	struct shared_worker_s *worker = (struct shared_worker_s *)arg;
+	char name[RMNET_MAX_STR_LEN], expected[BENCH_STR_LEN];
+	uint16_t error_code;
+	uint32_t i, id;
+
+	for (i = 0; i < worker->count; i++) {
+		id = worker->first_id + i % 1000;
+		snprintf(expected, sizeof(expected), "rmnet_data%u", id);
+		if (rmnet_get_vnd_name(worker->hndl, id, &error_code, name,
+				       sizeof(name)) != RMNETCTL_SUCCESS ||
+		    strcmp(name, expected))
+			worker->mismatches++;
+	}
+	return NULL;
+}
+
+static void bench_rmnetctl_shared(void)
+{
+	static const uint32_t thread_counts[] = { 1, 2, 4, 8 };
+	const uint32_t total = scaled(100000);
+	struct shared_worker_s workers[8];
+	pthread_t threads[8];
+	rmnetctl_hndl_t *shared = NULL;
+	uint64_t start, elapsed;
+	uint16_t error_code;
+	uint32_t t, i, n, mismatches;
+	char params[BENCH_STR_LEN];
+	int per_thread;
+
+	for (per_thread = 0; per_thread < 2; per_thread++) {
+		for (t = 0; t < sizeof(thread_counts) /
+				sizeof(thread_counts[0]); t++) {
+			n = thread_counts[t];
+			if (!per_thread &&
+			    rmnetctl_init(&shared, &error_code)
+				!= RMNETCTL_SUCCESS)
+				return;
+			for (i = 0; i < n; i++) {
+				workers[i].hndl = shared;
+				if (per_thread &&
+				    rmnetctl_init(&workers[i].hndl,
+						  &error_code)
+					!= RMNETCTL_SUCCESS)
+					return;
+				workers[i].first_id = i * 1000;
+				workers[i].count = total / n;
+				workers[i].mismatches = 0;
+			}
+			start = now_ns();
+			for (i = 0; i < n; i++)
+				pthread_create(&threads[i], NULL,
+					       shared_worker, &workers[i]);
+			mismatches = 0;
+			for (i = 0; i < n; i++) {
+				pthread_join(threads[i], NULL);
+				mismatches += workers[i].mismatches;
+			}
+			elapsed = now_ns() - start;
+			for (i = 0; per_thread && i < n; i++)
+				rmnetctl_cleanup(workers[i].hndl);
+			if (!per_thread)
+				rmnetctl_cleanup(shared);
+
+			snprintf(params, sizeof(params), "%s threads=%u",
+				 per_thread ? "own" : "shared", n);
+			report("rmnetctl_shared", params, "throughput",
+			       (total / n) * n / (elapsed / 1e9), "req/s");
+			report("rmnetctl_shared", params, "mismatches",
+			       mismatches, "count");
+		}
+	}
+}
+
+#define ASYNC_MAX_DEVS 8
+#define ASYNC_TIMEOUT_MS 1000
+#define ASYNC_SHORT_TIMEOUT_MS 20
+
+struct async_outcome_s {
+	uint32_t token;
+	uint32_t completions;
+	int return_code;
+	uint16_t error_code;
+};
+
+static void async_done(rmnetctl_batch_t *batch, uint32_t token,
+		       int return_code, uint16_t error_code, void *user_data)
+{
+	struct async_outcome_s *outcome = (struct async_outcome_s *)user_data;
+	(void)batch;
+	outcome->completions++;
+	outcome->return_code = return_code;
+	outcome->error_code = error_code;
+	if (token != outcome->token)
+		outcome->completions += 100;
+}
+
+/*!
+* @brief Event loop of an asynchronous caller, until `completions`
+* commits completed
+* @return 0 if they did, -1 if processing failed
+*/
+static int async_loop(rmnetctl_hndl_t *hndl, struct async_outcome_s *outcomes,
+		      uint32_t count, uint32_t completions)
+{
+	struct pollfd pfd;
+	uint16_t error_code;
+	uint32_t i, n;
+
+	pfd.fd = rmnetctl_get_fd(hndl);
+	pfd.events = POLLIN;
+	for (;;) {
+		for (i = 0, n = 0; i < count; i++)
+			n += outcomes[i].completions;
+		if (n >= completions)
+			return 0;
+		if (poll(&pfd, 1, rmnetctl_async_timeout(hndl)) < 0 &&
+		    errno != EINTR)
+			return -1;
+		if (rmnetctl_async_process(hndl, &error_code)
+			!= RMNETCTL_SUCCESS)
+			return -1;
+	}
+}
+
+/*!
+* @brief Checks that overlapping commits each complete once, that a wedged
+* driver fails a commit at its deadline, and that a cancelled commit does
+* not complete
+* @return number of unexpected outcomes
+*/
+static int check_async(rmnetctl_hndl_t *hndl, rmnetctl_batch_t **batches)
+{
+	struct async_outcome_s outcomes[ASYNC_MAX_DEVS];
+	char phys_dev[BENCH_STR_LEN], name[RMNET_MAX_STR_LEN];
+	uint64_t start, elapsed_ms;
+	uint16_t error_code;
+	uint32_t i;
+	int errors = 0;
+
+	memset(outcomes, 0, sizeof(outcomes));
+	for (i = 0; i < ASYNC_MAX_DEVS; i++) {
+		snprintf(phys_dev, sizeof(phys_dev), "rmnet_ipa%u", i);
+		/* more requests than fit one window */
+		errors += bringup_queue(batches[i], phys_dev, 8) != 0;
+		errors += rmnetctl_batch_commit_async(batches[i],
+				ASYNC_TIMEOUT_MS, async_done, &outcomes[i],
+				&outcomes[i].token, &error_code)
+			  != RMNETCTL_SUCCESS;
+	}
+	errors += async_loop(hndl, outcomes, ASYNC_MAX_DEVS,
+			     ASYNC_MAX_DEVS) != 0;
+	for (i = 0; i < ASYNC_MAX_DEVS; i++)
+		errors += (outcomes[i].completions != 1) ||
+			  (outcomes[i].return_code != RMNETCTL_SUCCESS);
+
+	/* wedged driver */
+	memset(outcomes, 0, sizeof(outcomes));
+	stand_in_mute = 1;
+	start = now_ns();
+	rmnet_batch_get_vnd_name(batches[0], 1, &error_code, name,
+				 sizeof(name));
+	bringup_queue(batches[0], BRINGUP_PHYS_DEV, 1);
+	errors += rmnetctl_batch_commit_async(batches[0],
+			ASYNC_SHORT_TIMEOUT_MS, async_done, &outcomes[0],
+			&outcomes[0].token, &error_code) != RMNETCTL_SUCCESS;
+	errors += async_loop(hndl, outcomes, 1, 1) != 0;
+	elapsed_ms = (now_ns() - start) / 1000000;
+	stand_in_mute = 0;
+	errors += (outcomes[0].completions != 1) ||
+		  (outcomes[0].return_code != RMNETCTL_LIB_ERR) ||
+		  (outcomes[0].error_code != RMNETCTL_API_ERR_TIMEOUT) ||
+		  (elapsed_ms < ASYNC_SHORT_TIMEOUT_MS) ||
+		  (elapsed_ms > ASYNC_SHORT_TIMEOUT_MS + 100);
+	for (i = 0; i < rmnetctl_batch_count(batches[0]); i++)
+		errors += rmnetctl_batch_status(batches[0], i, &error_code)
+				!= RMNETCTL_LIB_ERR ||
+			  error_code != RMNETCTL_API_ERR_TIMEOUT;
+	/* the handle still works */
+	errors += rmnet_get_vnd_name(hndl, 3, &error_code, name,
+				     sizeof(name)) != RMNETCTL_SUCCESS ||
+		  strcmp(name, "rmnet_data3");
+
+	/* cancelled commit */
+	memset(outcomes, 0, sizeof(outcomes));
+	bringup_queue(batches[0], BRINGUP_PHYS_DEV, 1);
+	bringup_queue(batches[1], BRINGUP_PHYS_DEV, 1);
+	rmnetctl_batch_commit_async(batches[0], ASYNC_TIMEOUT_MS, async_done,
+				    &outcomes[0], &outcomes[0].token,
+				    &error_code);
+	rmnetctl_batch_commit_async(batches[1], ASYNC_TIMEOUT_MS, async_done,
+				    &outcomes[1], &outcomes[1].token,
+				    &error_code);
+	rmnetctl_batch_reset(batches[0]);
+	errors += async_loop(hndl, outcomes, 2, 1) != 0;
+	errors += (outcomes[0].completions != 0) ||
+		  (outcomes[1].completions != 1) ||
+		  (outcomes[1].return_code != RMNETCTL_SUCCESS) ||
+		  (rmnetctl_async_timeout(hndl) != -1);
+	return errors;
+}
+
+/*!
+* @brief Checks that a blocking call made while commits are in flight moves
+* them along, for a commit of one window, which the blocking call completes,
+* and one of several windows
+* @return number of unexpected outcomes
+*/
+static int check_async_shared(rmnetctl_hndl_t *hndl,
+			      rmnetctl_batch_t **batches)
+{
+	struct async_outcome_s outcomes[2];
+	char name[RMNET_MAX_STR_LEN];
+	uint64_t start, elapsed_ms;
+	uint16_t error_code;
+	uint32_t i;
+	int errors = 0;
+
+	memset(outcomes, 0, sizeof(outcomes));
+	/* the loop watches the fd from before the commits */
+	rmnetctl_get_fd(hndl);
+	start = now_ns();
+	errors += bringup_queue(batches[0], BRINGUP_PHYS_DEV, 1) != 0;
+	errors += bringup_queue(batches[1], "rmnet_ipa1", 8) != 0;
+	for (i = 0; i < 2; i++)
+		errors += rmnetctl_batch_commit_async(batches[i],
+				ASYNC_TIMEOUT_MS, async_done, &outcomes[i],
+				&outcomes[i].token, &error_code)
+			  != RMNETCTL_SUCCESS;
+	/* answered after the windows in flight, which it receives too */
+	errors += rmnet_get_vnd_name(hndl, 3, &error_code, name,
+				     sizeof(name)) != RMNETCTL_SUCCESS ||
+		  strcmp(name, "rmnet_data3");
+	errors += async_loop(hndl, outcomes, 2, 2) != 0;
+	elapsed_ms = (now_ns() - start) / 1000000;
+	for (i = 0; i < 2; i++)
+		errors += (outcomes[i].completions != 1) ||
+			  (outcomes[i].return_code != RMNETCTL_SUCCESS);
+	errors += elapsed_ms >= ASYNC_TIMEOUT_MS / 2;
+	return errors;
+}
+
+/*!
+* @brief Checks that the response to the first request of a handle, which
+* came after the deadline of its commit, does not answer the next request
+* @return number of unexpected outcomes
+*/
+static int check_async_late(void)
+{
+	struct async_outcome_s outcome;
+	rmnetctl_hndl_t *hndl = NULL;
+	rmnetctl_batch_t *batch = NULL;
+	char name[RMNET_MAX_STR_LEN];
+	uint16_t error_code;
+	int errors = 0;
+
+	if (rmnetctl_init(&hndl, &error_code) != RMNETCTL_SUCCESS)
+		return 1;
+	if (rmnetctl_batch_init(hndl, &batch, &error_code)
+		!= RMNETCTL_SUCCESS) {
+		rmnetctl_cleanup(hndl);
+		return 1;
+	}
+
+	memset(&outcome, 0, sizeof(outcome));
+	stand_in_delay_ms = ASYNC_SHORT_TIMEOUT_MS * 3;
+	rmnet_batch_get_vnd_name(batch, 1, &error_code, name, sizeof(name));
+	errors += rmnetctl_batch_commit_async(batch, ASYNC_SHORT_TIMEOUT_MS,
+			async_done, &outcome, &outcome.token, &error_code)
+		  != RMNETCTL_SUCCESS;
+	errors += async_loop(hndl, &outcome, 1, 1) != 0;
+	stand_in_delay_ms = 0;
+	errors += (outcome.completions != 1) ||
+		  (outcome.error_code != RMNETCTL_API_ERR_TIMEOUT);
+	/* sent while the response for rmnet_data1 is still on its way */
+	errors += rmnet_get_vnd_name(hndl, 3, &error_code, name,
+				     sizeof(name)) != RMNETCTL_SUCCESS ||
+		  strcmp(name, "rmnet_data3");
+
+	rmnetctl_batch_cleanup(batch);
+	rmnetctl_cleanup(hndl);
+	return errors;
+}
+
+static void bench_rmnetctl_async(void)
+{
+	static const uint32_t dev_counts[] = { 1, 4, 8 };
+	const uint32_t rounds = scaled(1000);
+	struct async_outcome_s outcomes[ASYNC_MAX_DEVS];
+	rmnetctl_batch_t *batches[ASYNC_MAX_DEVS];
+	rmnetctl_hndl_t *hndl = NULL;
+	char phys_dev[BENCH_STR_LEN], params[BENCH_STR_LEN];
+	uint64_t *samples, start;
+	uint16_t error_code;
+	uint32_t d, i, r;
+	int failed;
+
+	memset(batches, 0, sizeof(batches));
+	if (rmnetctl_init(&hndl, &error_code) != RMNETCTL_SUCCESS)
+		return;
+	for (i = 0; i < ASYNC_MAX_DEVS; i++)
+		if (rmnetctl_batch_init(hndl, &batches[i], &error_code)
+			!= RMNETCTL_SUCCESS)
+			goto out;
+	samples = (uint64_t *)malloc(rounds * sizeof(uint64_t));
+
+	report("rmnetctl_async", "check=async", "errors",
+	       check_async(hndl, batches), "count");
+	report("rmnetctl_async", "check=async_shared", "errors",
+	       check_async_shared(hndl, batches), "count");
+	report("rmnetctl_async", "check=late", "errors", check_async_late(),
+	       "count");
+
+	/* bring-up of 8 VNDs on each of several devices */
+	for (d = 0; d < sizeof(dev_counts) / sizeof(dev_counts[0]); d++) {
+		failed = 0;
+		for (r = 0; r < rounds; r++) {
+			for (i = 0; i < dev_counts[d]; i++) {
+				snprintf(phys_dev, sizeof(phys_dev),
+					 "rmnet_ipa%u", i);
+				failed |= bringup_queue(batches[i], phys_dev, 8);
+			}
+			start = now_ns();
+			for (i = 0; i < dev_counts[d]; i++)
+				failed |= rmnetctl_batch_commit(batches[i],
+								&error_code);
+			samples[r] = now_ns() - start;
+		}
+		snprintf(params, sizeof(params), "sequential devs=%u",
+			 dev_counts[d]);
+		if (failed)
+			report("rmnetctl_async", params, "failed", 1, "");
+		report_latency("rmnetctl_async", params, samples, rounds);
+
+		failed = 0;
+		for (r = 0; r < rounds; r++) {
+			memset(outcomes, 0, sizeof(outcomes));
+			for (i = 0; i < dev_counts[d]; i++) {
+				snprintf(phys_dev, sizeof(phys_dev),
+					 "rmnet_ipa%u", i);
+				failed |= bringup_queue(batches[i], phys_dev, 8);
+			}
+			start = now_ns();
+			for (i = 0; i < dev_counts[d]; i++)
+				failed |= rmnetctl_batch_commit_async(
+					batches[i], ASYNC_TIMEOUT_MS,
+					async_done, &outcomes[i],
+					&outcomes[i].token, &error_code);
+			failed |= async_loop(hndl, outcomes, dev_counts[d],
+					     dev_counts[d]);
+			samples[r] = now_ns() - start;
+			for (i = 0; i < dev_counts[d]; i++)
+				failed |= outcomes[i].return_code;
+		}
+		snprintf(params, sizeof(params), "overlapped devs=%u",
+			 dev_counts[d]);
+		if (failed)
+			report("rmnetctl_async", params, "failed", 1, "");
+		report_latency("rmnetctl_async", params, samples, rounds);
+	}
+	free(samples);
+out:
+	for (i = 0; i < ASYNC_MAX_DEVS; i++)
+		rmnetctl_batch_cleanup(batches[i]);
+	rmnetctl_cleanup(hndl);
+}
+
+/*===========================================================================
+			 RMNETCLI
+===========================================================================*/
+
+/* rmnetcli is built in, so that it runs against the stand-in */
+#define main rmnetcli_main
+#include "../rmnetctl/cli/rmnetcli.c"
+#undef main
+
+/* the bring-up of bringup_sync(), as an rmnetcli apply file */
+static int write_apply_config(const char *path, uint32_t num_vnds)
+{
+	FILE *file = fopen(path, "w");
+	uint32_t vnd, flow;
+	if (!file)
+		return -1;
+	fprintf(file, "# %u VNDs on " BRINGUP_PHYS_DEV "\n", num_vnds);
+	fprintf(file, "assocnetdev " BRINGUP_PHYS_DEV "\n");
+	fprintf(file, "setlidf %u 0 " BRINGUP_PHYS_DEV "\n",
+		RMNET_INGRESS_FORMAT_MAP | RMNET_INGRESS_FORMAT_DEAGGREGATION |
+		RMNET_INGRESS_FORMAT_DEMUXING);
+	fprintf(file, "setledf %u 8192 20 " BRINGUP_PHYS_DEV "\n",
+		RMNET_EGRESS_FORMAT_MAP | RMNET_EGRESS_FORMAT_AGGREGATION |
+		RMNET_EGRESS_FORMAT_MUXING);
+	for (vnd = 0; vnd < num_vnds; vnd++) {
+		fprintf(file, "newvnd %u\n", vnd);
+		fprintf(file, "setlepc %u %u " BRINGUP_PHYS_DEV " rmnet_data%u\n",
+			vnd, RMNET_EPMODE_VND, vnd);
+		for (flow = 0; flow < BRINGUP_FLOWS_PER_VND; flow++)
+			fprintf(file, "addvnctcflow %u %u %u\n", vnd, flow,
+				vnd * 16 + flow);
+	}
+	return fclose(file) ? -1 : 0;
+}
+
+/* runs a built in command with its output dropped */
+static int run_silenced(int (*command)(int, char **), int argc, char **argv)
+{
+	int saved, null_fd, rc;
+	fflush(stdout);
+	saved = dup(STDOUT_FILENO);
+	null_fd = open("/dev/null", O_WRONLY);
+	dup2(null_fd, STDOUT_FILENO);
+	close(null_fd);
+	rc = command(argc, argv);
+	fflush(stdout);
+	dup2(saved, STDOUT_FILENO);
+	close(saved);
+	return rc;
+}
+
+static int run_rmnetcli(int argc, char **argv)
+{
+	return run_silenced(rmnetcli_main, argc, argv);
+}
+
+/*!
+* @brief Checks that apply brings up the data call from scratch, finds it
+* in place the second time, and changes back what was changed behind it
+* @return number of unexpected outcomes
+*/
+static int check_apply(char *path, uint32_t num_vnds)
+{
+	char *apply[] = { "rmnetcli", "apply", path, NULL };
+	char name[BENCH_STR_LEN];
+	struct stand_in_dev_s *dev;
+	uint32_t vnd;
+	int errors = 0;
+
+	stand_in_reset();
+	errors += (run_rmnetcli(3, apply) != RMNETCTL_SUCCESS);
+	errors += (run_rmnetcli(3, apply) != RMNETCTL_SUCCESS);
+
+	pthread_mutex_lock(&stand_in_lock);
+	dev = stand_in_dev((const __u8 *)BRINGUP_PHYS_DEV);
+	if (dev) {
+		dev->agg_count = 1;
+		memcpy(dev->ep_next_dev[1], "rmnet_data9", 12);
+	}
+	stand_in_state.vnds[num_vnds - 1][0] = 0;
+	stand_in_state.num_flows[num_vnds - 1] = 0;
+	pthread_mutex_unlock(&stand_in_lock);
+	errors += (run_rmnetcli(3, apply) != RMNETCTL_SUCCESS);
+
+	pthread_mutex_lock(&stand_in_lock);
+	if (!dev || !dev->name[0] || dev->agg_count != 20)
+		errors++;
+	for (vnd = 0; dev && vnd < num_vnds; vnd++) {
+		snprintf(name, sizeof(name), "rmnet_data%u", vnd);
+		if (strcmp(stand_in_state.vnds[vnd], name) ||
+		    dev->ep_mode[vnd + 1] != RMNET_EPMODE_VND ||
+		    strcmp(dev->ep_next_dev[vnd + 1], name) ||
+		    stand_in_state.num_flows[vnd] != BRINGUP_FLOWS_PER_VND)
+			errors++;
+	}
+	pthread_mutex_unlock(&stand_in_lock);
+	return errors;
+}
+
+/*!
+* @brief Checks that apply replaces a VND whose name only starts with the
+* prefix the file asks for
+* @return number of unexpected outcomes
+*/
+static int check_apply_prefix(char *path)
+{
+	char *apply[] = { "rmnetcli", "apply", path, NULL };
+	static const char *prefixes[] = { "rmnet_data", "rmnet" };
+	FILE *file;
+	uint32_t i;
+	int errors = 0;
+
+	stand_in_reset();
+	for (i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+		if (!(file = fopen(path, "w")))
+			return 1;
+		fprintf(file, "newvndprefix 0 %s\n", prefixes[i]);
+		if (fclose(file))
+			return 1;
+		errors += (run_rmnetcli(3, apply) != RMNETCTL_SUCCESS);
+	}
+	pthread_mutex_lock(&stand_in_lock);
+	errors += (strcmp(stand_in_state.vnds[0], "rmnet0") != 0);
+	pthread_mutex_unlock(&stand_in_lock);
+	return errors;
+}
+
+static void bench_rmnetcli_apply(void)
+{
+	static const uint32_t vnd_counts[] = { 1, 8, 16 };
+	const uint32_t rounds = scaled(500);
+	char path[] = "/tmp/data_bench_apply_XXXXXX";
+	char *apply[] = { "rmnetcli", "apply", path, NULL };
+	char line[RMNET_CFG_MAX_LINE_LEN], *args[8], *save;
+	char params[BENCH_STR_LEN];
+	uint64_t *samples, start;
+	uint32_t v, i, n;
+	FILE *file;
+	int fd, failed;
+
+	if ((fd = mkstemp(path)) < 0)
+		return;
+	close(fd);
+	samples = (uint64_t *)malloc(rounds * sizeof(uint64_t));
+	stand_in_stateful = 1;
+	report("rmnetcli_apply", "check=prefix", "errors",
+	       check_apply_prefix(path), "count");
+
+	for (v = 0; v < sizeof(vnd_counts) / sizeof(vnd_counts[0]); v++) {
+		if (write_apply_config(path, vnd_counts[v]))
+			break;
+		snprintf(params, sizeof(params), "vnds=%u check=apply",
+			 vnd_counts[v]);
+		report("rmnetcli_apply", params, "errors",
+		       check_apply(path, vnd_counts[v]), "count");
+
+		/* one rmnetcli command per line, as bring-up scripts do */
+		failed = 0;
+		for (i = 0; i < rounds; i++) {
+			stand_in_reset();
+			if (!(file = fopen(path, "r")))
+				break;
+			start = now_ns();
+			while (fgets(line, sizeof(line), file)) {
+				if (line[0] == '#')
+					continue;
+				n = 0;
+				args[n++] = "rmnetcli";
+				for (args[n] = strtok_r(line, " \n", &save);
+				     args[n] && n < 7;
+				     args[n] = strtok_r(NULL, " \n", &save))
+					n++;
+				args[n] = NULL;
+				failed |= run_rmnetcli((int)n, args);
+			}
+			samples[i] = now_ns() - start;
+			fclose(file);
+		}
+		snprintf(params, sizeof(params), "vnds=%u commands",
+			 vnd_counts[v]);
+		if (failed)
+			report("rmnetcli_apply", params, "failed", 1, "");
+		report_latency("rmnetcli_apply", params, samples, i);
+
+		failed = 0;
+		for (i = 0; i < rounds; i++) {
+			stand_in_reset();
+			start = now_ns();
+			failed |= run_rmnetcli(3, apply);
+			samples[i] = now_ns() - start;
+		}
+		snprintf(params, sizeof(params), "vnds=%u apply",
+			 vnd_counts[v]);
+		if (failed)
+			report("rmnetcli_apply", params, "failed", 1, "");
+		report_latency("rmnetcli_apply", params, samples, rounds);
+
+		/* everything but the flows is found in place */
+		failed = 0;
+		for (i = 0; i < rounds; i++) {
+			start = now_ns();
+			failed |= run_rmnetcli(3, apply);
+			samples[i] = now_ns() - start;
+		}
+		snprintf(params, sizeof(params), "vnds=%u reapply",
+			 vnd_counts[v]);
+		if (failed)
+			report("rmnetcli_apply", params, "failed", 1, "");
+		report_latency("rmnetcli_apply", params, samples, rounds);
+	}
+
+	stand_in_stateful = 0;
+	free(samples);
+	unlink(path);
+}
+
+/*===========================================================================
+			 SOCKEV
+===========================================================================*/
+
+/* sockev is built in, so that it runs against the stand-in */
+#define main sockev_main
+#include "../sockev/cli/sockev_cli.c"
+#undef main
+
+/* the loop sockev had before it drained in batches */
+static int sockev_legacy_main(int argc, char **argv)
+{
+	struct sockaddr_nl my_addr, src_addr;
+	socklen_t addrlen = sizeof(src_addr);
+	struct nlmsghdr *nlh;
+	struct sknlsockevmsg *msg;
+	int skfd;
+
+	(void)argc;
+	(void)argv;
+	nlh = (struct nlmsghdr *)
+		malloc(NLMSG_SPACE(sizeof(struct sknlsockevmsg) + 16));
+	skfd = socket(AF_NETLINK, SOCK_RAW, NETLINK_SOCKEV);
+	memset(&my_addr, 0, sizeof(my_addr));
+	my_addr.nl_family = AF_NETLINK;
+	my_addr.nl_groups = SKNLGRP_SOCKEV;
+	bind(skfd, (struct sockaddr *)&my_addr, sizeof(my_addr));
+	while (recvfrom(skfd, nlh, sizeof(struct sknlsockevmsg) + 16, 0,
+			(struct sockaddr *)&src_addr, &addrlen) > 0) {
+		msg = NLMSG_DATA(nlh);
+		printf("----------------------------\n");
+		printf("pid:\t%d\n", msg->pid);
+		printf("event:\t%s\n", msg->event);
+		printf("skfamily:\t0x%04X\n", msg->skfamily);
+		printf("skstate:\t%03d\n", msg->skstate);
+		printf("skprotocol:\t%03d\n", msg->skprotocol);
+		printf("sktype:\t0x%04X\n", msg->sktype);
+		printf("skflags:\t0x%016llX\n", (unsigned long long)msg->skflags);
+	}
+	close(skfd);
+	free(nlh);
+	return 0;
+}
+
+/*!
+* @brief Checks a log written by sockev: one record per event that was
+* sent and matched, in order and as sent, and overrun records where events
+* were lost
+* @return number of unexpected records
+*/
+static int check_sockev_log(const char *path)
+{
+	struct sockev_log_header_s header;
+	struct sockev_log_record_s record;
+	struct sknlsockevmsg sent;
+	uint32_t events = 0, overruns = 0;
+	int64_t last_seq = -1;
+	int errors = 0;
+	FILE *log = fopen(path, "rb");
+
+	if (!log)
+		return 1;
+	if (fread(&header, sizeof(header), 1, log) != 1 ||
+	    memcmp(header.magic, SOCKEV_LOG_MAGIC, 4) ||
+	    header.record_len != sizeof(record))
+		errors++;
+	while (!errors && fread(&record, sizeof(record), 1, log) == 1) {
+		if (record.event == SOCKEV_EV_OVERRUN) {
+			overruns++;
+			continue;
+		}
+		events++;
+		sockev_load_event((uint32_t)record.skflags, &sent);
+		errors += ((int64_t)record.skflags <= last_seq) ||
+			  (record.pid != sent.pid) ||
+			  (record.skfamily != sent.skfamily) ||
+			  (record.sktype != sent.sktype) ||
+			  (record.skprotocol != sent.skprotocol) ||
+			  (record.skstate != sent.skstate) ||
+			  (record.event != sockev_event(sent.event)) ||
+			  (sockev_load.match && !sockev_load.match(&sent));
+		last_seq = (int64_t)record.skflags;
+	}
+	fclose(log);
+	errors += (events != sockev_load.matched);
+	errors += (sockev_load.dropped && !overruns);
+	errors += (!sockev_load.dropped && overruns);
+	return errors;
+}
+
+/* runs a sockev receiver against the load, reports what it kept up with */
+static void run_sockev(const char *params, int (*command)(int, char **),
+		       int argc, char **argv)
+{
+	struct timespec start, end;
+	double cpu_ns;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	run_silenced(command, argc, argv);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	pthread_join(sockev_stand_in_thread, NULL);
+
+	cpu_ns = (end.tv_sec - start.tv_sec) * 1e9 +
+		 (end.tv_nsec - start.tv_nsec);
+	report("sockev", params, "received", sockev_load.matched, "events");
+	report("sockev", params, "dropped_pct",
+	       100.0 * sockev_load.dropped / sockev_load.events, "%");
+	/* per event sent, whether the receiver got it or not */
+	if (sockev_load.sent)
+		report("sockev", params, "cpu_per_event",
+		       cpu_ns / sockev_load.sent, "ns");
+}
+
+/* what "tcp and (event connect or event shutdown) and not family inet6"
+ * keeps */
+static int sockev_match_mixed(const struct sknlsockevmsg *msg)
+{
+	uint8_t event = sockev_event(msg->event);
+	return msg->skprotocol == IPPROTO_TCP &&
+	       (event == SOCKEV_EV_CONNECT || event == SOCKEV_EV_SHUTDOWN) &&
+	       msg->skfamily != AF_INET6;
+}
+
+/* what "pid 1002 and event connect" keeps */
+static int sockev_match_one(const struct sknlsockevmsg *msg)
+{
+	return msg->pid == 1002 &&
+	       sockev_event(msg->event) == SOCKEV_EV_CONNECT;
+}
+
+static void bench_sockev(void)
+{
+	char path[] = "/tmp/data_bench_sockev_XXXXXX";
+	char *small[] = { "sockev", "-i", "0", "-b", "212992", NULL };
+	char *large[] = { "sockev", "-i", "0", NULL };
+	char *logged[] = { "sockev", "-i", "0", "-w", path, NULL };
+	char *checked[] = { "sockev", "-i", "0", "-b", "65536", "-w", path,
+			    NULL };
+	char *filter_checked[] = { "sockev", "-i", "0", "-w", path, "tcp",
+				   "and", "(event connect or event shutdown)",
+				   "and not family inet6", NULL };
+	char *filtered[] = { "sockev", "-i", "0",
+			     "pid 1002 and event connect", NULL };
+	int fd;
+
+	if ((fd = mkstemp(path)) < 0)
+		return;
+	close(fd);
+
+	/* bursts of connection churn from 64 apps */
+	sockev_load.events = scaled(100000);
+	sockev_load.burst = 2000;
+	sockev_load.pause_us = 2000;
+	sockev_load.pids = 64;
+
+	unlink(path);
+	run_sockev("check=log", sockev_main, 7, checked);
+	report("sockev", "check=log", "errors", check_sockev_log(path),
+	       "count");
+	unlink(path);
+
+	run_sockev("legacy", sockev_legacy_main, 1, small);
+	run_sockev("rcvbuf=208k", sockev_main, 5, small);
+	run_sockev("rcvbuf=4M", sockev_main, 3, large);
+	run_sockev("rcvbuf=4M log", sockev_main, 5, logged);
+	unlink(path);
+
+	sockev_load.match = sockev_match_mixed;
+	run_sockev("check=filter", sockev_main, 9, filter_checked);
+	report("sockev", "check=filter", "errors", check_sockev_log(path),
+	       "count");
+	unlink(path);
+	/* one event in 192 is of interest, the rest stays in the kernel */
+	sockev_load.match = sockev_match_one;
+	run_sockev("rcvbuf=4M filter", sockev_main, 4, filtered);
+	sockev_load.match = NULL;
+}
+
+static void sockev_track_msg(struct sknlsockevmsg *msg, uint32_t pid,
+			     const char *event)
+{
+	memset(msg, 0, sizeof(*msg));
+	snprintf((char *)msg->event, sizeof(msg->event), "%s", event);
+	msg->pid = pid;
+	msg->skfamily = AF_INET;
+	msg->sktype = SOCK_STREAM;
+	msg->skprotocol = IPPROTO_TCP;
+}
+
+/*!
+* @brief Feeds a tracker events of known timing and checks what it makes
+* of them: pairing, buckets, the top and eviction
+* @return Number of mismatches
+*/
+static int check_sockev_track(void)
+{
+	/* pid 1: two sockets 1 ms apart, connected after 1.5 and 0.5 ms,
+	 * living 3 and 4 ms, then a connect and a shutdown of nothing */
+	static const struct {
+		const char *event;
+		uint64_t time_us;
+	} events[] = {
+		{ "SOCKEV_SOCKET", 0 }, { "SOCKEV_SOCKET", 1000 },
+		{ "SOCKEV_CONNECT", 1500 }, { "SOCKEV_CONNECT", 1500 },
+		{ "SOCKEV_CONNECT", 2000 }, { "SOCKEV_SHUTDOWN", 3000 },
+		{ "SOCKEV_SHUTDOWN", 5000 }, { "SOCKEV_SHUTDOWN", 5000 },
+	};
+	struct sockev_track_report_s report;
+	struct sknlsockevmsg msg;
+	sockev_tracker_t *tracker;
+	uint64_t t = 0;
+	uint32_t i;
+	int errors = 0;
+
+	if (sockev_tracker_init(&tracker, 4, 10) < 0)
+		return 1;
+	/* CLOCK_MONOTONIC is never 0, start a second in */
+	for (i = 0; i < sizeof(events) / sizeof(events[0]); i++) {
+		sockev_track_msg(&msg, 1, events[i].event);
+		t = 1000000000ULL + events[i].time_us * 1000;
+		sockev_tracker_event(tracker, &msg, sockev_event(msg.event), t);
+	}
+	sockev_tracker_report(tracker, t, 2, &report);
+	errors += (report.events != 8 || report.apps != 1);
+	errors += (report.unpaired != 2);
+	errors += (report.lifetime.count != 2 ||
+		   report.lifetime.buckets[11] != 2 ||
+		   report.lifetime.sum_us != 7000);
+	errors += (report.connect_delay.count != 2 ||
+		   report.connect_delay.buckets[10] != 1 ||
+		   report.connect_delay.buckets[8] != 1);
+	errors += (report.interarrival.count != 1 ||
+		   report.interarrival.buckets[9] != 1);
+	errors += (sockev_hist_percentile(&report.lifetime, 50) != 4096);
+	errors += (report.num_top != 1 || report.top[0].pid != 1 ||
+		   report.top[0].created != 2 || report.top[0].connected != 3 ||
+		   report.top[0].shut_down != 3 || report.top[0].open != 0);
+
+	/* 7 more apps with room for 3: the least recently seen make room,
+	 * or the newcomers go untracked */
+	for (i = 2; i <= 8; i++) {
+		sockev_track_msg(&msg, i, "SOCKEV_SOCKET");
+		t += 1000;
+		sockev_tracker_event(tracker, &msg, SOCKEV_EV_SOCKET, t);
+	}
+	sockev_tracker_report(tracker, t, 2, &report);
+	errors += (report.events != 7 || report.apps != 4);
+	errors += (report.evicted + report.untracked != 4);
+	errors += (report.num_top != 2 || report.top[0].created != 1 ||
+		   report.top[0].open != 1);
+
+	/* nothing for 10 s: everyone is forgotten */
+	sockev_tracker_report(tracker, t + 10000000001ULL, 2, &report);
+	errors += (report.events != 0 || report.apps != 0);
+	errors += (report.evicted != 4 || report.num_top != 0);
+	sockev_tracker_free(tracker);
+	return errors;
+}
+
+/* ns per event of a tracker fed by apps creating, connecting and shutting
+ * down sockets in turn */
+static double time_sockev_track(uint32_t apps, uint32_t events)
+{
+	struct sknlsockevmsg *msgs;
+	struct sockev_track_report_s report;
+	sockev_tracker_t *tracker;
+	uint32_t i, n = apps * 3;
+	uint8_t *kinds;
+	uint64_t start, end;
+
+	msgs = (struct sknlsockevmsg *)calloc(n, sizeof(*msgs));
+	kinds = (uint8_t *)calloc(n, 1);
+	if (!msgs || !kinds ||
+	    sockev_tracker_init(&tracker, apps, 300) < 0) {
+		free(msgs);
+		free(kinds);
+		return 0;
+	}
+	sockev_load.pids = apps;
+	for (i = 0; i < n; i++) {
+		sockev_load_event(i, &msgs[i]);
+		kinds[i] = sockev_event(msgs[i].event);
+	}
+
+	start = now_ns();
+	for (i = 0; i < events; i++)
+		sockev_tracker_event(tracker, &msgs[i % n], kinds[i % n],
+				     start + i * 1000ULL);
+	end = now_ns();
+	sockev_tracker_report(tracker, end, 10, &report);
+
+	sockev_tracker_free(tracker);
+	free(kinds);
+	free(msgs);
+	return (double)(end - start) / events;
+}
+
+/* Checks the export of a tracking sockev: one line, with every event */
+static int check_sockev_export(const char *path)
+{
+	char line[8192], expected[64];
+	FILE *f = fopen(path, "r");
+	int errors = 0;
+
+	if (!f)
+		return 1;
+	snprintf(expected, sizeof(expected), "\"events\":%u,",
+		 sockev_load.matched);
+	if (!fgets(line, sizeof(line), f))
+		errors++;
+	else
+		errors += !strstr(line, expected) ||
+			  !strstr(line, "\"lifetime_us\":{") ||
+			  !strstr(line, "\"top\":[{\"pid\":");
+	errors += (fgets(line, sizeof(line), f) != NULL);
+	fclose(f);
+	return errors;
+}
+
+static void bench_sockev_track(void)
+{
+	char path[] = "/tmp/data_bench_sockev_XXXXXX";
+	char *plain[] = { "sockev", "-i", "0", NULL };
+	char *tracked[] = { "sockev", "-i", "0", "-o", path, NULL };
+	uint32_t events = scaled(1000000);
+	int fd;
+
+	report("sockev_track", "check=track", "errors", check_sockev_track(),
+	       "count");
+
+	report("sockev_track", "apps=64", "ns_per_event",
+	       time_sockev_track(64, events), "ns");
+	report("sockev_track", "apps=3000", "ns_per_event",
+	       time_sockev_track(3000, events), "ns");
+
+	if ((fd = mkstemp(path)) < 0)
+		return;
+	close(fd);
+	unlink(path);
+	sockev_load.events = scaled(100000);
+	sockev_load.burst = 2000;
+	sockev_load.pause_us = 2000;
+	sockev_load.pids = 64;
+	run_sockev("rcvbuf=4M no track", sockev_main, 3, plain);
+	run_sockev("rcvbuf=4M track", sockev_main, 5, tracked);
+	report("sockev_track", "check=export", "errors",
+	       check_sockev_export(path), "count");
+	unlink(path);
+}
+
+/*===========================================================================
+			 MAIN
+===========================================================================*/
+
+struct bench_s {
+	const char *name;
+	void (*run)(void);
+};
+
+static const struct bench_s benches[] = {
+	{ "rmnetctl", bench_rmnetctl },
+	{ "rmnetctl_shared", bench_rmnetctl_shared },
+	{ "rmnetctl_async", bench_rmnetctl_async },
+	{ "rmnetcli_apply", bench_rmnetcli_apply },
+	{ "sockev", bench_sockev },
+	{ "sockev_track", bench_sockev_track },
+};
+
+static void write_json(FILE *out)
+{
+	char host[64] = "";
+	int i;
+	gethostname(host, sizeof(host) - 1);
+	fprintf(out, "{\n  \"suite\": \"data_bench\",\n  \"host\": \"%s\",\n"
+		"  \"scale\": %g,\n  \"results\": [\n", host, scale);
+	for (i = 0; i < num_results; i++) {
+		const struct bench_result_s *r = &results[i];
+		fprintf(out, "    {\"benchmark\": \"%s\", \"params\": \"%s\", "
+			"\"metric\": \"%s\", \"value\": %.3f, \"unit\": \"%s\"}"
+			"%s\n", r->benchmark, r->params, r->metric, r->value,
+			r->unit, (i + 1 < num_results) ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = NULL;
+	const char *out_path = NULL;
+	size_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:s:o:")) != -1) {
+		switch (opt) {
+		case 'f': filter = optarg; break;
+		case 's': scale = atof(optarg); break;
+		case 'o': out_path = optarg; break;
+		default:
+			fprintf(stderr, "usage: %s [-f filter] [-s scale] "
+				"[-o results.json]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+		if (!filter || strstr(benches[i].name, filter))
+			benches[i].run();
+	}
+
+	if (out_path) {
+		FILE *out = fopen(out_path, "w");
+		if (!out) {
+			fprintf(stderr, "could not open %s\n", out_path);
+			return 1;
+		}
+		write_json(out);
+		fclose(out);
+	}
+	return 0;
+}
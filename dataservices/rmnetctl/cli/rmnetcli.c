@@ -53,6 +53,8 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <time.h>
+#include <linux/rmnet_data.h>
 #include "rmnetcli.h"
 #include "librmnetctl.h"
 
@@ -78,7 +80,9 @@ char rmnetcfg_error_code_text
 [RMNETCFG_TOTAL_ERR_MSGS][RMNETCTL_ERR_MSG_SIZE] = {
 	"Help option Specified",
 	"ERROR: No\\Invalid command was specified\n",
-	"ERROR: Could not allocate buffer for Egress device\n"
+	"ERROR: Could not allocate buffer for Egress device\n",
+	"ERROR: Could not read the configuration file\n",
+	"ERROR: Invalid line in the configuration file\n"
 };
 
 /*!
@@ -201,6 +205,23 @@ static void rmnet_api_usage(void)
 	printf(_2TABS" <mdm_flow_hndl>         handle - tc flow handle");
 	printf(_2TABS" <tc_flow_hndl>          mapping for a virtual network");
 	printf(_2TABS" device node\n\n");
+	printf("rmnetcli apply [-n] <config_file>        Brings the");
+	printf(_5TABS" configuration in line with");
+	printf(_5TABS" config_file. Each line of");
+	printf(_5TABS" the file is one of the");
+	printf(_5TABS" assocnetdev, setledf,");
+	printf(_5TABS" setlidf, setlepc, newvnd,");
+	printf(_5TABS" newvndprefix or addvnctcflow");
+	printf(_5TABS" commands with its arguments,");
+	printf(_5TABS" # starts a comment. Only the");
+	printf(_5TABS" lines which differ from the");
+	printf(_5TABS" current configuration are");
+	printf(_5TABS" applied. -n lists them");
+	printf(_5TABS" without applying them.");
+	printf(_5TABS" Flows cannot be queried,");
+	printf(_5TABS" they are deleted and added");
+	printf(_5TABS" again every time.");
+	printf(_5TABS" Returns the status code\n\n");
 }
 
 static void print_rmnetctl_lib_errors(uint16_t error_number)
@@ -238,6 +259,585 @@ static void print_rmnet_api_status(int return_code, uint16_t error_number)
 		printf("INVALID_ARG\n");
 }
 
+/*===========================================================================
+			DECLARATIVE CONFIGURATION
+===========================================================================*/
+
+#define RMNET_CFG_MAX_LINE_LEN 256
+#define RMNET_CFG_MAX_ARGS 5
+#define RMNET_CFG_NO_REQUEST 0xFFFFFFFF
+
+/*!
+* @brief Commands a configuration file is made of. Each takes the arguments
+* of the rmnetcli command of the same name.
+*/
+enum rmnet_cfg_command_e {
+	RMNET_CFG_ASSOCNETDEV,
+	RMNET_CFG_SETLEDF,
+	RMNET_CFG_SETLIDF,
+	RMNET_CFG_SETLEPC,
+	RMNET_CFG_NEWVND,
+	RMNET_CFG_NEWVNDPREFIX,
+	RMNET_CFG_ADDVNCTCFLOW,
+	RMNET_CFG_COMMANDS
+};
+
+static const struct {
+	const char *name;
+	int num_args;
+} rmnet_cfg_commands[RMNET_CFG_COMMANDS] = {
+	{ "assocnetdev", 1 },
+	{ "setledf", 4 },
+	{ "setlidf", 3 },
+	{ "setlepc", 4 },
+	{ "newvnd", 1 },
+	{ "newvndprefix", 2 },
+	{ "addvnctcflow", 3 },
+};
+
+/*!
+* @brief Configuration of an entry, as the file wants it or as it was found
+* @var name Egress device of setlepc, name or prefix of the VND of newvnd
+* and newvndprefix
+*/
+struct rmnet_cfg_state_s {
+	int register_status;
+	uint32_t flags;
+	uint16_t agg_size;
+	uint16_t agg_count;
+	uint8_t tail_spacing;
+	uint8_t operating_mode;
+	char name[RMNET_MAX_STR_LEN];
+};
+
+/*!
+* @brief One line of a configuration file
+* @var command What the line configures
+* @var line Line number in the file
+* @var text The line, for messages
+* @var dev_name Device of assocnetdev, setledf, setlidf and setlepc
+* @var ep_id Logical endpoint of setlepc
+* @var id VND of newvnd, newvndprefix and addvnctcflow
+* @var map_flow_id Modem flow handle of addvnctcflow
+* @var tc_flow_id TC flow handle of addvnctcflow
+* @var want Configuration the file asks for
+* @var have Current configuration, if found is set
+* @var found The current configuration could be queried
+* @var query Index of the query in the batch
+* @var change Index of the first change request in the batch
+* @var num_changes Number of change requests, 0 if up to date
+* @var num_optional Number of leading change requests which may fail
+*/
+struct rmnet_cfg_entry_s {
+	int command;
+	uint32_t line;
+	char text[RMNET_CFG_MAX_LINE_LEN];
+	char dev_name[RMNET_MAX_STR_LEN];
+	int32_t ep_id;
+	uint32_t id;
+	uint32_t map_flow_id;
+	uint32_t tc_flow_id;
+	struct rmnet_cfg_state_s want;
+	struct rmnet_cfg_state_s have;
+	int found;
+	uint32_t query;
+	uint32_t change;
+	uint32_t num_changes;
+	uint32_t num_optional;
+};
+
+static uint64_t rmnet_cfg_now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*!
+* @brief Method to read a number argument of a configuration line
+* @return 0 if arg is a number from min to max, -1 otherwise
+*/
+static int rmnet_cfg_number(const char *arg, long long min, long long max,
+			    long long *value)
+{
+	char *end;
+	*value = strtoll(arg, &end, 0);
+	if ((end == arg) || (*end) || (*value < min) || (*value > max))
+		return -1;
+	return 0;
+}
+
+/*!
+* @brief Method to read a device name argument of a configuration line
+* @return 0 if the name fits, -1 otherwise
+*/
+static int rmnet_cfg_name(const char *arg, char *name)
+{
+	if (strlen(arg) >= RMNET_MAX_STR_LEN)
+		return -1;
+	strcpy(name, arg);
+	return 0;
+}
+
+/*!
+* @brief Method to fill in an entry from the arguments of its line
+* @return 0 if the arguments are valid, -1 otherwise
+*/
+static int rmnet_cfg_entry(struct rmnet_cfg_entry_s *entry, char *args[])
+{
+	struct rmnet_cfg_state_s *want = &entry->want;
+	long long v[3];
+	switch (entry->command) {
+	case RMNET_CFG_ASSOCNETDEV:
+		want->register_status = 1;
+		return rmnet_cfg_name(args[0], entry->dev_name);
+	case RMNET_CFG_SETLEDF:
+		if (rmnet_cfg_number(args[0], 0, UINT32_MAX, &v[0]) ||
+		    rmnet_cfg_number(args[1], 0, UINT16_MAX, &v[1]) ||
+		    rmnet_cfg_number(args[2], 0, UINT16_MAX, &v[2]))
+			return -1;
+		want->flags = (uint32_t)v[0];
+		want->agg_size = (uint16_t)v[1];
+		want->agg_count = (uint16_t)v[2];
+		return rmnet_cfg_name(args[3], entry->dev_name);
+	case RMNET_CFG_SETLIDF:
+		if (rmnet_cfg_number(args[0], 0, UINT32_MAX, &v[0]) ||
+		    rmnet_cfg_number(args[1], 0, UINT8_MAX, &v[1]))
+			return -1;
+		want->flags = (uint32_t)v[0];
+		want->tail_spacing = (uint8_t)v[1];
+		return rmnet_cfg_name(args[2], entry->dev_name);
+	case RMNET_CFG_SETLEPC:
+		if (rmnet_cfg_number(args[0], -1, 31, &v[0]) ||
+		    rmnet_cfg_number(args[1], 0, RMNET_EPMODE_LENGTH - 1,
+				     &v[1]))
+			return -1;
+		entry->ep_id = (int32_t)v[0];
+		want->operating_mode = (uint8_t)v[1];
+		if (rmnet_cfg_name(args[2], entry->dev_name))
+			return -1;
+		return rmnet_cfg_name(args[3], want->name);
+	case RMNET_CFG_NEWVND:
+		if (rmnet_cfg_number(args[0], 0, UINT32_MAX, &v[0]))
+			return -1;
+		entry->id = (uint32_t)v[0];
+		return 0;
+	case RMNET_CFG_NEWVNDPREFIX:
+		if (rmnet_cfg_number(args[0], 0, UINT32_MAX, &v[0]))
+			return -1;
+		entry->id = (uint32_t)v[0];
+		return rmnet_cfg_name(args[1], want->name);
+	case RMNET_CFG_ADDVNCTCFLOW:
+		if (rmnet_cfg_number(args[0], 0, UINT32_MAX, &v[0]) ||
+		    rmnet_cfg_number(args[1], 0, UINT32_MAX, &v[1]) ||
+		    rmnet_cfg_number(args[2], 0, UINT32_MAX, &v[2]))
+			return -1;
+		entry->id = (uint32_t)v[0];
+		entry->map_flow_id = (uint32_t)v[1];
+		entry->tc_flow_id = (uint32_t)v[2];
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+/*!
+* @brief Method to read a configuration file
+* @details Blank lines and everything after a # are skipped, every other
+* line is one command and its arguments separated by blanks
+* @param path Configuration file
+* @param entries Entries of the file, to be freed by the caller
+* @param count Number of entries
+* @param error_number Error number of this operation
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if the file could not be read or has an invalid
+* line. Check error_number
+*/
+static int rmnet_cfg_read(const char *path,
+			  struct rmnet_cfg_entry_s **entries,
+			  uint32_t *count,
+			  uint16_t *error_number)
+{
+	char buffer[RMNET_CFG_MAX_LINE_LEN], *args[RMNET_CFG_MAX_ARGS + 1];
+	char *token, *save, *comment;
+	struct rmnet_cfg_entry_s *entry, *grown;
+	uint32_t line = 0, capacity = 0;
+	int num_args, command;
+	FILE *file;
+
+	*entries = NULL;
+	*count = 0;
+	if (!(file = fopen(path, "r"))) {
+		*error_number = RMNETCTL_CFG_FAILURE_CONFIG_FILE;
+		return RMNETCTL_LIB_ERR;
+	}
+	*error_number = RMNETCTL_CFG_FAILURE_CONFIG_SYNTAX;
+	while (fgets(buffer, sizeof(buffer), file)) {
+		line++;
+		if ((!strchr(buffer, '\n')) && (!feof(file)))
+			goto invalid;
+		if ((comment = strchr(buffer, '#')))
+			*comment = 0;
+		buffer[strcspn(buffer, "\r\n")] = 0;
+
+		if (*count == capacity) {
+			capacity = capacity ? capacity * 2 : 16;
+			grown = (struct rmnet_cfg_entry_s *)realloc(*entries,
+				capacity * sizeof(struct rmnet_cfg_entry_s));
+			if (!grown)
+				goto failed;
+			*entries = grown;
+		}
+		entry = &(*entries)[*count];
+		memset(entry, 0, sizeof(struct rmnet_cfg_entry_s));
+		entry->line = line;
+		strcpy(entry->text, buffer);
+
+		num_args = -1;
+		for (token = strtok_r(buffer, " \t", &save); token;
+		     token = strtok_r(NULL, " \t", &save)) {
+			if (num_args == RMNET_CFG_MAX_ARGS)
+				goto invalid;
+			if (num_args >= 0)
+				args[num_args] = token;
+			else
+				args[RMNET_CFG_MAX_ARGS] = token;
+			num_args++;
+		}
+		if (num_args < 0)
+			continue;
+
+		for (command = 0; command < RMNET_CFG_COMMANDS; command++)
+			if (!strcmp(args[RMNET_CFG_MAX_ARGS],
+				    rmnet_cfg_commands[command].name))
+				break;
+		if ((command == RMNET_CFG_COMMANDS) ||
+		    (num_args != rmnet_cfg_commands[command].num_args))
+			goto invalid;
+		entry->command = command;
+		if (rmnet_cfg_entry(entry, args))
+			goto invalid;
+		(*count)++;
+	}
+	if (ferror(file))
+		goto failed;
+	fclose(file);
+	return RMNETCTL_SUCCESS;
+
+failed:
+	*error_number = RMNETCTL_CFG_FAILURE_CONFIG_FILE;
+	fclose(file);
+	return RMNETCTL_LIB_ERR;
+
+invalid:
+	printf("line %u: ", line);
+	fclose(file);
+	return RMNETCTL_LIB_ERR;
+}
+
+/*!
+* @brief Method to queue the query of the current configuration of an entry
+* @details Flows cannot be queried, they are always deleted and added again
+* @return Return code of the batched API
+*/
+static int rmnet_cfg_queue_query(rmnetctl_batch_t *batch,
+				 struct rmnet_cfg_entry_s *entry,
+				 uint16_t *error_number)
+{
+	struct rmnet_cfg_state_s *have = &entry->have;
+	char *name = have->name;
+	int return_code;
+
+	entry->query = rmnetctl_batch_count(batch);
+	switch (entry->command) {
+	case RMNET_CFG_ASSOCNETDEV:
+		return_code = rmnet_batch_get_network_device_associated(batch,
+			entry->dev_name, &have->register_status,
+			error_number);
+		break;
+	case RMNET_CFG_SETLEDF:
+		return_code = rmnet_batch_get_link_egress_data_format(batch,
+			entry->dev_name, &have->flags, &have->agg_size,
+			&have->agg_count, error_number);
+		break;
+	case RMNET_CFG_SETLIDF:
+		return_code = rmnet_batch_get_link_ingress_data_format_tailspace(
+			batch, entry->dev_name, &have->flags,
+			&have->tail_spacing, error_number);
+		break;
+	case RMNET_CFG_SETLEPC:
+		return_code = rmnet_batch_get_logical_ep_config(batch,
+			entry->ep_id, entry->dev_name, &have->operating_mode,
+			name, RMNET_MAX_STR_LEN, error_number);
+		break;
+	case RMNET_CFG_NEWVND:
+	case RMNET_CFG_NEWVNDPREFIX:
+		return_code = rmnet_batch_get_vnd_name(batch, entry->id,
+			error_number, name, RMNET_MAX_STR_LEN);
+		break;
+	default:
+		entry->query = RMNET_CFG_NO_REQUEST;
+		return RMNETCTL_SUCCESS;
+	}
+	if (return_code != RMNETCTL_SUCCESS)
+		entry->query = RMNET_CFG_NO_REQUEST;
+	return return_code;
+}
+
+/*!
+* @brief Method to check if a VND name is the one the kernel gives a VND
+* created with a prefix, the prefix followed by a number
+*/
+static int rmnet_cfg_vnd_prefix_name(const char *name, const char *prefix)
+{
+	size_t len = strlen(prefix);
+	if (strncmp(name, prefix, len) || !name[len])
+		return 0;
+	for (name += len; *name; name++)
+		if (*name < '0' || *name > '9')
+			return 0;
+	return 1;
+}
+
+/*!
+* @brief Method to check if an entry is already configured as it should be
+*/
+static int rmnet_cfg_up_to_date(const struct rmnet_cfg_entry_s *entry)
+{
+	const struct rmnet_cfg_state_s *want = &entry->want;
+	const struct rmnet_cfg_state_s *have = &entry->have;
+	if (!entry->found)
+		return 0;
+	switch (entry->command) {
+	case RMNET_CFG_ASSOCNETDEV:
+		return have->register_status == want->register_status;
+	case RMNET_CFG_SETLEDF:
+		return (have->flags == want->flags) &&
+		       (have->agg_size == want->agg_size) &&
+		       (have->agg_count == want->agg_count);
+	case RMNET_CFG_SETLIDF:
+		return (have->flags == want->flags) &&
+		       (have->tail_spacing == want->tail_spacing);
+	case RMNET_CFG_SETLEPC:
+		return (have->operating_mode == want->operating_mode) &&
+		       (!strcmp(have->name, want->name));
+	case RMNET_CFG_NEWVND:
+		return 1;
+	case RMNET_CFG_NEWVNDPREFIX:
+		return rmnet_cfg_vnd_prefix_name(have->name, want->name);
+	default:
+		return 0;
+	}
+}
+
+/*!
+* @brief Method to queue the requests which bring an entry in line with
+* the file
+* @details A logical endpoint which is set is unset first, a VND with
+* another prefix is freed first. A flow is deleted and added again, as
+* adding one that is there adds another TC handle; the delete fails if
+* it is not there yet, which does not fail the entry
+* @return Return code of the batched API
+*/
+static int rmnet_cfg_queue_change(rmnetctl_batch_t *batch,
+				  struct rmnet_cfg_entry_s *entry,
+				  uint16_t *error_number)
+{
+	struct rmnet_cfg_state_s *want = &entry->want;
+	int return_code = RMNETCTL_SUCCESS;
+
+	entry->change = rmnetctl_batch_count(batch);
+	switch (entry->command) {
+	case RMNET_CFG_ASSOCNETDEV:
+		return_code = rmnet_batch_associate_network_device(batch,
+			entry->dev_name, error_number,
+			RMNETCTL_DEVICE_ASSOCIATE);
+		break;
+	case RMNET_CFG_SETLEDF:
+		return_code = rmnet_batch_set_link_egress_data_format(batch,
+			want->flags, want->agg_size, want->agg_count,
+			entry->dev_name, error_number);
+		break;
+	case RMNET_CFG_SETLIDF:
+		return_code = rmnet_batch_set_link_ingress_data_format_tailspace(
+			batch, want->flags, want->tail_spacing,
+			entry->dev_name, error_number);
+		break;
+	case RMNET_CFG_SETLEPC:
+		if (entry->found &&
+		    (entry->have.operating_mode != RMNET_EPMODE_NONE))
+			return_code = rmnet_batch_unset_logical_ep_config(
+				batch, entry->ep_id, entry->dev_name,
+				error_number);
+		if (return_code == RMNETCTL_SUCCESS)
+			return_code = rmnet_batch_set_logical_ep_config(batch,
+				entry->ep_id, want->operating_mode,
+				entry->dev_name, want->name, error_number);
+		break;
+	case RMNET_CFG_NEWVND:
+		return_code = rmnet_batch_new_vnd(batch, entry->id,
+			error_number, RMNETCTL_NEW_VND);
+		break;
+	case RMNET_CFG_NEWVNDPREFIX:
+		if (entry->found)
+			return_code = rmnet_batch_new_vnd(batch, entry->id,
+				error_number, RMNETCTL_FREE_VND);
+		if (return_code == RMNETCTL_SUCCESS)
+			return_code = rmnet_batch_new_vnd_prefix(batch,
+				entry->id, error_number, RMNETCTL_NEW_VND,
+				want->name);
+		break;
+	case RMNET_CFG_ADDVNCTCFLOW:
+		return_code = rmnet_batch_add_del_vnd_tc_flow(batch, entry->id,
+			entry->map_flow_id, entry->tc_flow_id,
+			RMNETCTL_DEL_FLOW, error_number);
+		entry->num_optional = 1;
+		if (return_code == RMNETCTL_SUCCESS)
+			return_code = rmnet_batch_add_del_vnd_tc_flow(batch,
+				entry->id, entry->map_flow_id,
+				entry->tc_flow_id, RMNETCTL_ADD_FLOW,
+				error_number);
+		break;
+	}
+	entry->num_changes = rmnetctl_batch_count(batch) - entry->change;
+	return return_code;
+}
+
+/*!
+* @brief Method to bring the configuration in line with a configuration file
+* @details Queries the current configuration of every entry of the file in
+* one batch, then applies the entries which differ from it in a second
+* batch, in the order of the file. Prints the entries which were changed,
+* those which failed and how long both steps took.
+* @param handle RmNet handle
+* @param path Configuration file
+* @param dry_run Only print the entries which would be changed
+* @param error_number Error number of this operation
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_number
+* @return RMNETCTL_KERNEL_ERR if an entry failed in the kernel. Check
+* error_number
+* @return RMNETCTL_INVALID_ARG if an entry had invalid arguments
+*/
+static int rmnet_apply_config(rmnetctl_hndl_t *handle,
+			      const char *path,
+			      int dry_run,
+			      uint16_t *error_number)
+{
+	struct rmnet_cfg_entry_s *entries = NULL, *entry;
+	rmnetctl_batch_t *batch = NULL;
+	uint64_t start, query_us, apply_us = 0;
+	uint32_t count, i, queries, changed = 0, failed = 0;
+	uint16_t status;
+	int return_code, rc;
+
+	do {
+	return_code = rmnet_cfg_read(path, &entries, &count, error_number);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+	return_code = rmnetctl_batch_init(handle, &batch, error_number);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	start = rmnet_cfg_now_us();
+	for (i = 0; i < count; i++) {
+		return_code = rmnet_cfg_queue_query(batch, &entries[i],
+						    error_number);
+		if (return_code != RMNETCTL_SUCCESS)
+			break;
+	}
+	if (return_code != RMNETCTL_SUCCESS) {
+		printf("line %u: ", entries[i].line);
+		break;
+	}
+	queries = rmnetctl_batch_count(batch);
+	/* anything that is not set up yet fails its query in the kernel */
+	rmnetctl_batch_commit(batch, error_number);
+	for (i = 0; i < count; i++) {
+		entry = &entries[i];
+		if (entry->query == RMNET_CFG_NO_REQUEST)
+			continue;
+		rc = rmnetctl_batch_status(batch, entry->query, &status);
+		if (rc == RMNETCTL_LIB_ERR) {
+			return_code = rc;
+			*error_number = status;
+			break;
+		}
+		entry->found = (rc == RMNETCTL_SUCCESS);
+	}
+	query_us = rmnet_cfg_now_us() - start;
+	if (return_code != RMNETCTL_SUCCESS) {
+		printf("line %u: ", entries[i].line);
+		break;
+	}
+
+	rmnetctl_batch_reset(batch);
+	for (i = 0; i < count; i++) {
+		entry = &entries[i];
+		if (rmnet_cfg_up_to_date(entry))
+			continue;
+		return_code = rmnet_cfg_queue_change(batch, entry,
+						     error_number);
+		if (return_code != RMNETCTL_SUCCESS)
+			break;
+		changed++;
+		if (dry_run)
+			printf("line %u: %s\n", entry->line, entry->text);
+	}
+	if (return_code != RMNETCTL_SUCCESS) {
+		printf("line %u: ", entries[i].line);
+		break;
+	}
+
+	if (!dry_run && changed) {
+		start = rmnet_cfg_now_us();
+		return_code = rmnetctl_batch_commit(batch, error_number);
+		apply_us = rmnet_cfg_now_us() - start;
+		for (i = 0; i < count; i++) {
+			entry = &entries[i];
+			if (!entry->num_changes)
+				continue;
+			/* an entry fails with the first of its requests that did */
+			rc = RMNETCTL_SUCCESS;
+			status = RMNETCTL_API_SUCCESS;
+			while ((rc == RMNETCTL_SUCCESS) &&
+			       (entry->num_changes--)) {
+				rc = rmnetctl_batch_status(batch,
+						entry->change++, &status);
+				if (entry->num_optional &&
+				    (rc == RMNETCTL_KERNEL_ERR)) {
+					rc = RMNETCTL_SUCCESS;
+					status = RMNETCTL_API_SUCCESS;
+				}
+				if (entry->num_optional)
+					entry->num_optional--;
+			}
+			printf("line %u: %s: ", entry->line, entry->text);
+			print_rmnet_api_status(rc, status);
+			if (rc != RMNETCTL_SUCCESS)
+				failed++;
+		}
+		/* the requests which failed may all have been optional */
+		if (!failed && (return_code == RMNETCTL_KERNEL_ERR)) {
+			return_code = RMNETCTL_SUCCESS;
+			*error_number = RMNETCTL_API_SUCCESS;
+		}
+	}
+
+	printf("queried %u entries with %u requests in %llu us\n", count,
+	       queries, (unsigned long long)query_us);
+	if (dry_run)
+		printf("%u entries to change\n", changed);
+	else
+		printf("changed %u entries with %u requests in %llu us, "
+		       "%u failed\n", changed, rmnetctl_batch_count(batch),
+		       (unsigned long long)apply_us, failed);
+	} while(0);
+	rmnetctl_batch_cleanup(batch);
+	free(entries);
+	return return_code;
+}
+
 /*!
 * @brief Method to make the API calls
 * @details Checks for each type of parameter and calls the appropriate
@@ -383,6 +983,11 @@ static int rmnet_api_call(int argc, char *argv[])
 		return_code = rmnet_set_logical_ep_config(handle,
 		_STRTOI32(argv[1]), _STRTOUI8(argv[2]), argv[3], argv[4],
 		&error_number);
+	} else if (!strcmp(*argv, "apply")) {
+		int dry_run = argv[1] && !strcmp(argv[1], "-n");
+		_RMNETCLI_CHECKNULL(argv[1 + dry_run]);
+		return_code = rmnet_apply_config(handle, argv[1 + dry_run],
+						 dry_run, &error_number);
 	} else if (!strcmp(*argv, "unsetlepc")) {
 		_RMNETCLI_CHECKNULL(argv[1]);
 		return_code = rmnet_unset_logical_ep_config(handle,
@@ -51,11 +51,15 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define RMNETCTL_CFG_FAILURE_NO_COMMAND 101
 /* The buffer for egress device name was NULL */
 #define RMNETCTL_CFG_FAILURE_EGRESS_DEV_NAME_NULL 102
+/* The configuration file could not be opened or read */
+#define RMNETCTL_CFG_FAILURE_CONFIG_FILE 103
+/* A line of the configuration file is not a valid command */
+#define RMNETCTL_CFG_FAILURE_CONFIG_SYNTAX 104
 
 /* This should always be the value of the starting element */
 #define RMNETCFG_ERR_NUM_START 100
 
 /* This should always be the total number of error message from CLI */
-#define RMNETCFG_TOTAL_ERR_MSGS 3
+#define RMNETCFG_TOTAL_ERR_MSGS 5
 
 #endif /* not defined RMNETCLI_H */
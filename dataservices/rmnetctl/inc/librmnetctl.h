@@ -129,6 +129,10 @@ enum rmnetctl_error_codes_e {
 	/* TC handle is full */
 	RMNETCTL_KERNEL_ERR_TC_HANDLE_FULL = 24,
 
+	/* API failed because the kernel did not answer before the deadline of
+	 * an asynchronous request */
+	RMNETCTL_API_ERR_TIMEOUT = 25,
+
 	/* This should always be the last element */
 	RMNETCTL_API_ERR_ENUM_LENGTH
 };
@@ -165,7 +169,8 @@ char rmnetctl_error_code_text
 	"ERROR: Device doesn't exist\n",
 	"ERROR: One or more of the arguments is invalid\n",
 	"ERROR: Egress device is invalid\n",
-	"ERROR: TC handle is full\n"
+	"ERROR: TC handle is full\n",
+	"ERROR: No response from the kernel before the deadline\n"
 };
 
 /*===========================================================================
@@ -176,7 +181,8 @@ typedef struct rmnetctl_hndl_s rmnetctl_hndl_t;
 /*!
 * @brief Public API to initialize the RMNET control driver
 * @details Allocates memory for the RmNet handle. Creates and binds to a   and
-* netlink socket if successful
+* netlink socket if successful. The handle can be used by several threads at
+* once, each transaction gets the response with its own sequence number.
 * @param **rmnetctl_hndl_t_val RmNet handle to be initialized
 * @return RMNETCTL_SUCCESS if successful
 * @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
@@ -194,6 +200,17 @@ int rmnetctl_init(rmnetctl_hndl_t **hndl, uint16_t *error_code);
 */
 void rmnetctl_cleanup(rmnetctl_hndl_t *hndl);
 
+/*!
+* @brief Public API to get the fd the event loop of a RmNet handle watches
+* @details The fd becomes readable when responses of the kernel are waiting,
+* or when a blocking call on the handle completed an asynchronous commit,
+* so that rmnetctl_async_process() is called. It must not be read or
+* closed by the caller.
+* @param hndl RmNet handle
+* @return The fd, -1 if hndl is NULL
+*/
+int rmnetctl_get_fd(rmnetctl_hndl_t *hndl);
+
 /*!
 * @brief Public API to register/unregister a RMNET driver on a particular device
 * @details Message type is RMNET_NETLINK_ASSOCIATE_NETWORK_DEVICE or
@@ -495,5 +512,320 @@ int rmnet_add_del_vnd_tc_flow(rmnetctl_hndl_t *hndl,
 			      uint8_t set_flow,
 			      uint16_t *error_code);
 
+/*===========================================================================
+			 BATCHED REQUESTS
+===========================================================================*/
+/*
+* A batch queues configuration requests and sends them to the kernel
+* together on commit, one datagram per request with a single sendmmsg()
+* call, then collects the responses with recvmmsg() and matches them to the
+* requests by netlink sequence number. Bringing up a data call with many
+* logical endpoints, VNDs and flows then costs a couple of system calls for
+* up to 32 requests instead of a round trip to the kernel per request.
+*
+* Every request is checked when it is queued, with the same rules as the
+* API of the same name, and completes with the return code and status code
+* that API would have returned. A batch can be reset and reused; it keeps
+* the memory of its largest use. A batch is committed on the handle it was
+* created for, alongside whatever other threads do on that handle, and must
+* not itself be used from more than one thread at a time.
+*/
+typedef struct rmnetctl_batch_s rmnetctl_batch_t;
+struct rmnet_nl_msg_s;
+
+/*!
+* @brief Public API to create a batch of requests on a RmNet handle
+* @param hndl RmNet handle the batch is committed on
+* @param batch Batch to be initialized
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnetctl_batch_init(rmnetctl_hndl_t *hndl,
+			rmnetctl_batch_t **batch,
+			uint16_t *error_code);
+
+/*!
+* @brief Public API to free a batch
+* @param batch Batch to be freed. The handle it was created for is left open.
+* @return void
+*/
+void rmnetctl_batch_cleanup(rmnetctl_batch_t *batch);
+
+/*!
+* @brief Public API to drop all requests of a batch, so it can be reused
+* @param batch Batch to be reset
+* @return void
+*/
+void rmnetctl_batch_reset(rmnetctl_batch_t *batch);
+
+/*!
+* @brief Public API to get the number of requests queued on a batch
+* @param batch Batch to be checked
+* @return Number of requests, which are indexed from 0 in the order they
+* were queued
+*/
+uint32_t rmnetctl_batch_count(rmnetctl_batch_t *batch);
+
+/*!
+* @brief Public API to queue a raw request on a batch
+* @details For callers which build struct rmnet_nl_msg_s from
+* linux/rmnet_data.h themselves. The request is copied and is not checked.
+* @param batch Batch to queue the request on
+* @param request Message to be sent to the kernel
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnetctl_batch_add(rmnetctl_batch_t *batch,
+		       const struct rmnet_nl_msg_s *request,
+		       uint16_t *error_code);
+
+/*!
+* @brief Public API to send all requests of a batch and collect their
+* responses
+* @details Requests go out in order, up to 32 at a time. A request failing in
+* the kernel does not stop the others; if sending or receiving fails, the
+* requests which were not answered fail with RMNETCTL_API_ERR_MESSAGE_SEND or
+* RMNETCTL_API_ERR_MESSAGE_RECEIVE and no further requests are sent.
+* @param batch Batch to be committed
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if every request succeeded
+* @return The return code of the first request which failed otherwise, with
+* its status code in error_code. Check rmnetctl_batch_status() for the others.
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnetctl_batch_commit(rmnetctl_batch_t *batch, uint16_t *error_code);
+
+/*!
+* @brief Public API to get the outcome of a committed request
+* @param batch Batch the request was queued on
+* @param index Index of the request in the batch
+* @param error_code Status code of the request
+* @return RMNETCTL_SUCCESS if the request succeeded
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_KERNEL_ERR if there was an error in the kernel.
+* Check error_code
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnetctl_batch_status(rmnetctl_batch_t *batch,
+			  uint32_t index,
+			  uint16_t *error_code);
+
+/*!
+* @brief Public API to get the response of the kernel to a committed request
+* @param batch Batch the request was queued on
+* @param index Index of the request in the batch
+* @return Response of the kernel, valid until the batch is reset, committed
+* again or freed. NULL if the request was not answered.
+*/
+const struct rmnet_nl_msg_s *rmnetctl_batch_response(rmnetctl_batch_t *batch,
+						     uint32_t index);
+
+/*!
+* @brief Public APIs to queue a configuration request on a batch
+* @details Each one takes the arguments of the API of the same name without
+* the "batch_", with the batch in place of the RmNet handle, and queues the
+* request that API sends
+* @return RMNETCTL_SUCCESS if the request was queued
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnet_batch_associate_network_device(rmnetctl_batch_t *batch,
+					 const char *dev_name,
+					 uint16_t *error_code,
+					 uint8_t assoc_dev);
+
+int rmnet_batch_set_link_egress_data_format(rmnetctl_batch_t *batch,
+					    uint32_t egress_flags,
+					    uint16_t agg_size,
+					    uint16_t agg_count,
+					    const char *dev_name,
+					    uint16_t *error_code);
+
+int rmnet_batch_set_link_ingress_data_format_tailspace(
+						rmnetctl_batch_t *batch,
+						uint32_t ingress_flags,
+						uint8_t  tail_spacing,
+						const char *dev_name,
+						uint16_t *error_code);
+
+int rmnet_batch_set_logical_ep_config(rmnetctl_batch_t *batch,
+				      int32_t ep_id,
+				      uint8_t operating_mode,
+				      const char *dev_name,
+				      const char *next_dev,
+				      uint16_t *error_code);
+
+int rmnet_batch_unset_logical_ep_config(rmnetctl_batch_t *batch,
+					int32_t ep_id,
+					const char *dev_name,
+					uint16_t *error_code);
+
+int rmnet_batch_new_vnd(rmnetctl_batch_t *batch,
+			uint32_t id,
+			uint16_t *error_code,
+			uint8_t new_vnd);
+
+int rmnet_batch_new_vnd_prefix(rmnetctl_batch_t *batch,
+			       uint32_t id,
+			       uint16_t *error_code,
+			       uint8_t new_vnd,
+			       const char *prefix);
+
+int rmnet_batch_add_del_vnd_tc_flow(rmnetctl_batch_t *batch,
+				    uint32_t id,
+				    uint32_t map_flow_id,
+				    uint32_t tc_flow_id,
+				    uint8_t set_flow,
+				    uint16_t *error_code);
+
+/*!
+* @brief Public APIs to queue a query on a batch
+* @details Each one takes the arguments of the API of the same name without
+* the "batch_", with the batch in place of the RmNet handle, except that the
+* name of the egress device is copied to next_dev itself. The data is stored
+* when the batch is committed and the request succeeds, so the pointers have
+* to stay valid until then.
+* @return RMNETCTL_SUCCESS if the request was queued
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnet_batch_get_network_device_associated(rmnetctl_batch_t *batch,
+					      const char *dev_name,
+					      int *register_status,
+					      uint16_t *error_code);
+
+int rmnet_batch_get_link_egress_data_format(rmnetctl_batch_t *batch,
+					    const char *dev_name,
+					    uint32_t *egress_flags,
+					    uint16_t *agg_size,
+					    uint16_t *agg_count,
+					    uint16_t *error_code);
+
+int rmnet_batch_get_link_ingress_data_format_tailspace(
+						rmnetctl_batch_t *batch,
+						const char *dev_name,
+						uint32_t *ingress_flags,
+						uint8_t  *tail_spacing,
+						uint16_t *error_code);
+
+int rmnet_batch_get_logical_ep_config(rmnetctl_batch_t *batch,
+				      int32_t ep_id,
+				      const char *dev_name,
+				      uint8_t *operating_mode,
+				      char *next_dev,
+				      uint32_t next_dev_len,
+				      uint16_t *error_code);
+
+int rmnet_batch_get_vnd_name(rmnetctl_batch_t *batch,
+			     uint32_t id,
+			     uint16_t *error_code,
+			     char *buf,
+			     uint32_t buflen);
+
+/*===========================================================================
+			 ASYNCHRONOUS REQUESTS
+===========================================================================*/
+/*
+* A batch can also be committed without blocking, for callers which run an
+* event loop: rmnetctl_batch_commit_async() sends the requests and returns a
+* token, and the outcome is delivered to a callback from
+* rmnetctl_async_process(), which the loop calls when the handle fd is
+* readable or when the deadline rmnetctl_async_timeout() reports is reached.
+* A batch which is not answered in full by its deadline completes with
+* RMNETCTL_API_ERR_TIMEOUT, so a wedged driver cannot stall the loop. The
+* deadline is per batch, not per request: it covers every window of the
+* batch. Several batches can be in flight on a handle at once, e.g. one per
+* rmnet device.
+*
+* A typical loop:
+*
+*	pfd.fd = rmnetctl_get_fd(hndl);
+*	pfd.events = POLLIN;
+*	while (running) {
+*		poll(&pfd, 1, rmnetctl_async_timeout(hndl));
+*		rmnetctl_async_process(hndl, &error_code);
+*	}
+*
+* Blocking calls can be made on the same handle from other threads while
+* commits are in flight. The blocking call receives the responses of the
+* commits along with its own, sends their next windows, and signals the fd
+* of rmnetctl_get_fd() when one completes; the callbacks are still only
+* called from rmnetctl_async_process().
+*/
+
+/*!
+* @brief Completion callback of an asynchronous commit
+* @details Called from rmnetctl_async_process() without the handle lock
+* held. The batch is no longer in flight: its results can be read with
+* rmnetctl_batch_status(), and it can be reset, committed again or freed.
+* @param batch Batch which completed
+* @param token Token rmnetctl_batch_commit_async() returned for it
+* @param return_code What rmnetctl_batch_commit() would have returned, or
+* RMNETCTL_LIB_ERR if the deadline passed
+* @param error_code Status code of the commit, RMNETCTL_API_ERR_TIMEOUT if
+* the deadline passed
+* @param user_data As passed to rmnetctl_batch_commit_async()
+*/
+typedef void (*rmnetctl_async_cb_t)(rmnetctl_batch_t *batch,
+				    uint32_t token,
+				    int return_code,
+				    uint16_t error_code,
+				    void *user_data);
+
+/*!
+* @brief Public API to send the requests of a batch without waiting for the
+* responses
+* @details Requests go out 32 at a time, the next ones once the previous
+* ones were answered. Requests that were not answered by the deadline fail
+* with RMNETCTL_API_ERR_TIMEOUT, those that were not sent by then with
+* RMNETCTL_API_ERR_MESSAGE_SEND. While in flight, no request can be queued
+* on the batch; freeing or resetting it cancels the commit, without a call
+* to cb.
+* @param batch Batch to be committed, with at least one request
+* @param timeout_ms Time the kernel has to answer all requests of the
+* batch, across all of its windows
+* @param cb Completion callback
+* @param user_data Passed to cb
+* @param token Set to a token for the commit, never 0
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if the first requests were sent
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnetctl_batch_commit_async(rmnetctl_batch_t *batch,
+				uint32_t timeout_ms,
+				rmnetctl_async_cb_t cb,
+				void *user_data,
+				uint32_t *token,
+				uint16_t *error_code);
+
+/*!
+* @brief Public API to receive the responses available on a handle and
+* complete the asynchronous commits which are done or past their deadline
+* @details Does not block. Completion callbacks are called from here, in
+* the thread calling this API.
+* @param hndl RmNet handle
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if receiving failed. Check error_code. Pending
+* commits are left to their deadline.
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+int rmnetctl_async_process(rmnetctl_hndl_t *hndl, uint16_t *error_code);
+
+/*!
+* @brief Public API to get how long an event loop can wait before it has to
+* call rmnetctl_async_process() again
+* @param hndl RmNet handle
+* @return Milliseconds until the nearest deadline of an asynchronous commit,
+* 0 if one has passed, -1 if there is none. This is the timeout argument of
+* poll().
+*/
+int rmnetctl_async_timeout(rmnetctl_hndl_t *hndl);
+
 #endif /* not defined LIBRMNETCTL_H */
 
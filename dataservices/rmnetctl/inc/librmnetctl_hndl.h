@@ -43,15 +43,72 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 			 DEFINITIONS AND DECLARATIONS
 ===========================================================================*/
 
+#include <pthread.h>
+
+/* Most responses the handle receives with one system call */
+#define RMNETCTL_RECV_WINDOW 32
+
+struct rmnetctl_batch_s;
+
+/*!
+* @brief Netlink message as it goes to or comes from the kernel
+*/
+struct rmnetctl_nl_buf_s {
+	struct nlmsghdr nlmsghdr_val;
+	struct rmnet_nl_msg_s rmnet_nl_msg_s_val;
+};
+
+/*!
+* @brief Request sent on a handle and waiting for its response. Pending
+* requests are listed on the handle in sequence number order, so that a
+* response can be handed to the request it is for, whichever thread
+* received it.
+* @var seq Sequence number the request was sent with
+* @var response Where the response goes
+* @var len Length of the netlink message of the response
+* @var remaining Requests of the waiting thread still unanswered, decremented
+* when this one is answered
+* @var answered 1 once the response was copied to response
+* @var next Next pending request on the handle
+*/
+struct rmnetctl_pending_s {
+	uint32_t seq;
+	struct rmnet_nl_msg_s *response;
+	uint32_t len;
+	uint32_t *remaining;
+	uint8_t answered;
+	struct rmnetctl_pending_s *next;
+};
+
 /*!
 * @brief Structure for RMNET control handles. A rmnet hndl contains the caller
 * process id, the transaction id which is initialized to 0 for each new
 * initialized handle and the netlink file descriptor for this handle.
+* A handle can be used by several threads at once: requests are sent and
+* listed under lock, and whichever waiting thread holds the reader role
+* receives for all of them.
 * @var pid process id to be used for the netlink message
-* @var transaction_id message number for debugging
+* @var transaction_id sequence number of the next message, under lock. 0
+* is skipped, no request is sent with it
 * @var netlink_fd netlink file descriptor to be used
 * @var src_addr source socket address properties for this message
 * @var dest_addr destination socket address properties for this message
+* @var lock protects transaction_id, the pending list and the reader role
+* @var answered signalled when responses were handed out or the reader
+* role was released
+* @var pending_head oldest pending request
+* @var pending_tail newest pending request
+* @var reading 1 while a thread receives for the handle
+* @var recv_buf responses received by the reader
+* @var recv_iov recvmmsg() vectors of recv_buf
+* @var recv_msg recvmmsg() headers of recv_buf
+* @var async_head batches committed asynchronously and not completed yet,
+* under lock
+* @var async_token token of the last asynchronous commit, under lock
+* @var poll_fd epoll instance watching netlink_fd and wake_fd, handed out by
+* rmnetctl_get_fd(), -1 until it is first asked for
+* @var wake_fd eventfd a blocking caller signals when it completed an
+* asynchronous commit for the event loop, -1 with poll_fd
 */
 
 struct rmnetctl_hndl_s {
@@ -59,6 +116,17 @@ struct rmnetctl_hndl_s {
 	 uint32_t transaction_id;
 	 int netlink_fd;
 	 struct sockaddr_nl src_addr, dest_addr;
+	 pthread_mutex_t lock;
+	 pthread_cond_t answered;
+	 struct rmnetctl_pending_s *pending_head, *pending_tail;
+	 uint8_t reading;
+	 struct rmnetctl_nl_buf_s recv_buf[RMNETCTL_RECV_WINDOW];
+	 struct iovec recv_iov[RMNETCTL_RECV_WINDOW];
+	 struct mmsghdr recv_msg[RMNETCTL_RECV_WINDOW];
+	 struct rmnetctl_batch_s *async_head;
+	 uint32_t async_token;
+	 int poll_fd;
+	 int wake_fd;
 };
 
 #endif /* not defined LIBRMNETCTL_HNDL_H */
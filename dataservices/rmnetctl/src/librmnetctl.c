@@ -40,13 +40,23 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 			INCLUDE FILES
 ===========================================================================*/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <stdint.h>
 #include <linux/netlink.h>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
 #include <linux/rmnet_data.h>
 #include "librmnetctl_hndl.h"
 #include "librmnetctl.h"
@@ -63,6 +73,10 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define KERNEL_PROCESS_ID 0
 #define UNICAST 0
 #define MAX_BUF_SIZE sizeof(struct nlmsghdr) + sizeof(struct rmnet_nl_msg_s)
+/* Most requests of a batch that are in flight at once */
+#define RMNETCTL_BATCH_WINDOW 32
+/* Requests a batch has room for before it first grows */
+#define RMNETCTL_BATCH_MIN_CAPACITY 16
 #define INGRESS_FLAGS_MASK   (RMNET_INGRESS_FIX_ETHERNET | \
 			      RMNET_INGRESS_FORMAT_MAP | \
 			      RMNET_INGRESS_FORMAT_DEAGGREGATION | \
@@ -78,15 +92,258 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 			      RMNET_EGRESS_FORMAT_MAP_CKSUMV4)
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
+
+/*===========================================================================
+			 DEFINITIONS AND DECLARATIONS
+===========================================================================*/
+/*!
+* @brief Request queued on a batch and its outcome
+* @var buf Netlink message of the request, sent as is on commit
+* @var response Response of the kernel, once answered
+* @var pending Registration of the request on the handle while in flight
+* @var return_code Return code of the request, as the synchronous API
+* would have returned it
+* @var error_code Status code of the request
+* @var out Where the data of a GET request is stored once it succeeds. NULL
+* members are not stored.
+*/
+struct rmnetctl_batch_entry_s {
+	struct rmnetctl_nl_buf_s buf;
+	struct rmnet_nl_msg_s response;
+	struct rmnetctl_pending_s pending;
+	int return_code;
+	uint16_t error_code;
+	union {
+		int *register_status;
+		struct {
+			uint32_t *flags;
+			uint16_t *agg_size;
+			uint16_t *agg_count;
+			uint8_t *tail_spacing;
+		} data_format;
+		struct {
+			uint8_t *operating_mode;
+			char *next_dev;
+			uint32_t next_dev_len;
+		} local_ep_config;
+		struct {
+			char *buf;
+			uint32_t buflen;
+		} vnd;
+	} out;
+};
+
+/*!
+* @brief Structure for a batch of requests on a RmNet handle
+* @var hndl RmNet handle the batch is committed on
+* @var entries Queued requests, in order
+* @var count Number of queued requests
+* @var capacity Number of requests entries has room for
+* @var request_msg sendmmsg() vector of the requests in flight
+* @var in_flight 1 while committed asynchronously
+* @var cb Called when the asynchronous commit completes
+* @var user_data Passed to cb
+* @var token Token of the asynchronous commit
+* @var deadline_ms CLOCK_MONOTONIC time the asynchronous commit fails at
+* @var first Index of the first request of the window in flight
+* @var sent Index of the first request not sent yet
+* @var remaining Requests of the window in flight still unanswered
+* @var async_error Status code of the exchange which failed, if one did
+* @var next_async Next batch committed asynchronously on the handle
+*/
+struct rmnetctl_batch_s {
+	rmnetctl_hndl_t *hndl;
+	struct rmnetctl_batch_entry_s *entries;
+	uint32_t count;
+	uint32_t capacity;
+	struct iovec request_iov[RMNETCTL_BATCH_WINDOW];
+	struct mmsghdr request_msg[RMNETCTL_BATCH_WINDOW];
+	uint8_t in_flight;
+	rmnetctl_async_cb_t cb;
+	void *user_data;
+	uint32_t token;
+	uint64_t deadline_ms;
+	uint32_t first;
+	uint32_t sent;
+	uint32_t remaining;
+	uint16_t async_error;
+	struct rmnetctl_batch_s *next_async;
+};
+
 /*===========================================================================
 			LOCAL FUNCTION DEFINITIONS
 ===========================================================================*/
+/*!
+* @brief Static function to list a request as pending on a handle
+* @details Gives the request the next sequence number of the handle, which
+* is never 0, so that a response without one matches no request. Called
+* with the handle lock held, right before the request is sent, so that the
+* pending list is in the order the kernel answers in.
+* @param *hndl RmNet handle the request is sent on
+* @param pending Registration of the request
+* @param nlmsghdr_val Netlink header of the request
+* @return void
+*/
+static void _rmnetctl_pending_add(rmnetctl_hndl_t *hndl,
+				  struct rmnetctl_pending_s *pending,
+				  struct nlmsghdr *nlmsghdr_val) {
+	if (!hndl->transaction_id)
+		hndl->transaction_id++;
+	nlmsghdr_val->nlmsg_seq = hndl->transaction_id++;
+	pending->seq = nlmsghdr_val->nlmsg_seq;
+	pending->answered = 0;
+	pending->len = 0;
+	pending->next = NULL;
+	if (hndl->pending_tail)
+		hndl->pending_tail->next = pending;
+	else
+		hndl->pending_head = pending;
+	hndl->pending_tail = pending;
+	(*pending->remaining)++;
+}
+
+/*!
+* @brief Static function to take a request off the pending list of a handle
+* @details Called with the handle lock held
+* @param *hndl RmNet handle the request was sent on
+* @param pending Registration of the request
+* @return void
+*/
+static void _rmnetctl_pending_remove(rmnetctl_hndl_t *hndl,
+				     struct rmnetctl_pending_s *pending) {
+	struct rmnetctl_pending_s *prev = NULL, *cur = hndl->pending_head;
+	while (cur && cur != pending) {
+		prev = cur;
+		cur = cur->next;
+	}
+	if (!cur)
+		return;
+	if (prev)
+		prev->next = cur->next;
+	else
+		hndl->pending_head = cur->next;
+	if (hndl->pending_tail == cur)
+		hndl->pending_tail = prev;
+	(*cur->remaining)--;
+}
+
+/*!
+* @brief Static function to hand a received response to its request
+* @details The kernel echoes the sequence number of the request. Responses
+* which match no pending request are stale, from a request whose sender
+* gave up on it, e.g. at the deadline of an asynchronous commit, and are
+* dropped. Called with the handle lock held.
+* @param *hndl RmNet handle the response was received on
+* @param buf Response of the kernel
+* @param len Length of the response
+* @return void
+*/
+static void _rmnetctl_dispatch(rmnetctl_hndl_t *hndl,
+			       const struct rmnetctl_nl_buf_s *buf,
+			       uint32_t len) {
+	struct rmnetctl_pending_s *pending;
+	if (len < NLMSG_HDRLEN)
+		return;
+	for (pending = hndl->pending_head; pending; pending = pending->next)
+		if (pending->seq == buf->nlmsghdr_val.nlmsg_seq)
+			break;
+	if (!pending)
+		return;
+
+	_rmnetctl_pending_remove(hndl, pending);
+	memset(pending->response, 0, sizeof(struct rmnet_nl_msg_s));
+	memcpy(pending->response, &buf->rmnet_nl_msg_s_val,
+	       min(len - NLMSG_HDRLEN, sizeof(struct rmnet_nl_msg_s)));
+	pending->len = len;
+	pending->answered = 1;
+}
+
+/*!
+* @brief Static function to receive responses into the buffers of a handle
+* @details Called by the thread holding the reader role, without the handle
+* lock
+* @param *hndl RmNet handle to receive on
+* @param flags Flags of recvmmsg()
+* @return Number of responses received, -1 with errno set on failure
+*/
+static int _rmnetctl_recv(rmnetctl_hndl_t *hndl, int flags) {
+	int rc, i;
+	for (i = 0; i < RMNETCTL_RECV_WINDOW; i++) {
+		hndl->recv_iov[i].iov_base = &hndl->recv_buf[i];
+		hndl->recv_iov[i].iov_len = sizeof(struct rmnetctl_nl_buf_s);
+		memset(&hndl->recv_msg[i], 0, sizeof(struct mmsghdr));
+		hndl->recv_msg[i].msg_hdr.msg_iov = &hndl->recv_iov[i];
+		hndl->recv_msg[i].msg_hdr.msg_iovlen = 1;
+	}
+	do {
+		rc = recvmmsg(hndl->netlink_fd, hndl->recv_msg,
+			      RMNETCTL_RECV_WINDOW, flags, NULL);
+	} while (rc < 0 && errno == EINTR);
+	return rc;
+}
+
+static void _rmnetctl_async_kick(rmnetctl_hndl_t *hndl);
+
+/*!
+* @brief Static function to wait for the responses of the requests a thread
+* sent
+* @details Called with the handle lock held, returns with it released. The
+* first waiting thread takes the reader role: it receives responses for
+* every thread, hands them out, moves the asynchronous commits along and
+* lets the others know. Threads which find the role taken sleep until they
+* are answered or the role is released.
+* @param *hndl RmNet handle the requests were sent on
+* @param remaining Requests of this thread still unanswered
+* @return RMNETCTL_API_SUCCESS if all requests were answered
+* @return RMNETCTL_API_ERR_MESSAGE_RECEIVE if receiving failed. The requests
+* still unanswered are taken off the pending list.
+*/
+static uint16_t _rmnetctl_wait(rmnetctl_hndl_t *hndl, uint32_t *remaining) {
+	struct rmnetctl_pending_s *pending, *next;
+	uint16_t return_code = RMNETCTL_API_SUCCESS;
+	int rc, i;
+
+	while (*remaining) {
+		if (hndl->reading) {
+			pthread_cond_wait(&hndl->answered, &hndl->lock);
+			continue;
+		}
+
+		hndl->reading = 1;
+		pthread_mutex_unlock(&hndl->lock);
+		rc = _rmnetctl_recv(hndl, MSG_WAITFORONE);
+		pthread_mutex_lock(&hndl->lock);
+		hndl->reading = 0;
+
+		for (i = 0; i < rc; i++)
+			_rmnetctl_dispatch(hndl, &hndl->recv_buf[i],
+					   hndl->recv_msg[i].msg_len);
+		if (rc > 0)
+			_rmnetctl_async_kick(hndl);
+		pthread_cond_broadcast(&hndl->answered);
+
+		if (rc <= 0) {
+			for (pending = hndl->pending_head; pending;
+			     pending = next) {
+				next = pending->next;
+				if (pending->remaining == remaining)
+					_rmnetctl_pending_remove(hndl, pending);
+			}
+			return_code = RMNETCTL_API_ERR_MESSAGE_RECEIVE;
+		}
+	}
+	pthread_mutex_unlock(&hndl->lock);
+	return return_code;
+}
+
 /*!
 * @brief Synchronous method to send and receive messages to and from the kernel
 * using  netlink sockets
 * @details Increments the transaction id for each message sent to the kernel.
 * Sends the netlink message to the kernel and receives the response from the
-* kernel.
+* kernel. The request is built on the stack of the caller and the response
+* lands in the receive buffers of the handle, so nothing is allocated, and
+* several threads can transact on the same handle at once.
 * @param *hndl RmNet handle for this transaction
 * @param request Message to be sent to the kernel
 * @param response Message received from the kernel
@@ -94,8 +351,8 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 * from the kernel
 * @return RMNETCTL_API_ERR_HNDL_INVALID if RmNet handle for the transaction was
 * NULL
-* @return RMNETCTL_API_ERR_REQUEST_NULL not enough memory to create buffer for
-* sending the message
+* @return RMNETCTL_API_ERR_REQUEST_NULL if the request was NULL
+* @return RMNETCTL_API_ERR_RESPONSE_NULL if the response was NULL or too short
 * @return RMNETCTL_API_ERR_MESSAGE_SEND if could not send the message to kernel
 * @return RMNETCTL_API_ERR_MESSAGE_RECEIVE if could not receive message from the
 * kernel
@@ -105,16 +362,10 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 static uint16_t rmnetctl_transact(rmnetctl_hndl_t *hndl,
 			struct rmnet_nl_msg_s *request,
 			struct rmnet_nl_msg_s *response) {
-	uint8_t *request_buf, *response_buf;
-	struct nlmsghdr *nlmsghdr_val;
-	struct rmnet_nl_msg_s *rmnet_nl_msg_s_val;
-	ssize_t bytes_read = -1;
+	struct rmnetctl_nl_buf_s request_buf;
+	struct rmnetctl_pending_s pending;
+	uint32_t remaining = 0;
 	uint16_t return_code = RMNETCTL_API_ERR_HNDL_INVALID;
-	struct sockaddr_nl* __attribute__((__may_alias__)) saddr_ptr;
-	request_buf = NULL;
-	response_buf = NULL;
-	nlmsghdr_val = NULL;
-	rmnet_nl_msg_s_val = NULL;
 	do {
 	if (!hndl){
 		break;
@@ -127,82 +378,44 @@ static uint16_t rmnetctl_transact(rmnetctl_hndl_t *hndl,
 		return_code = RMNETCTL_API_ERR_RESPONSE_NULL;
 		break;
 	}
-	request_buf = (uint8_t *)malloc(MAX_BUF_SIZE * sizeof(uint8_t));
-	if (!request_buf){
-		return_code = RMNETCTL_API_ERR_REQUEST_NULL;
-		break;
-	}
-
-	response_buf = (uint8_t *)malloc(MAX_BUF_SIZE * sizeof(uint8_t));
-	if (!response_buf) {
-		free(request_buf);
-		return_code = RMNETCTL_API_ERR_RESPONSE_NULL;
-		break;
-	}
-
-	nlmsghdr_val = (struct nlmsghdr *)request_buf;
-	rmnet_nl_msg_s_val = (struct rmnet_nl_msg_s *)NLMSG_DATA(request_buf);
-
-	memset(request_buf, 0, MAX_BUF_SIZE*sizeof(uint8_t));
-	memset(response_buf, 0, MAX_BUF_SIZE*sizeof(uint8_t));
 
-	nlmsghdr_val->nlmsg_seq = hndl->transaction_id;
-	nlmsghdr_val->nlmsg_pid = hndl->pid;
-	nlmsghdr_val->nlmsg_len = MAX_BUF_SIZE;
+	memset(&request_buf, 0, sizeof(struct rmnetctl_nl_buf_s));
+	request_buf.nlmsghdr_val.nlmsg_pid = hndl->pid;
+	request_buf.nlmsghdr_val.nlmsg_len = MAX_BUF_SIZE;
+	memcpy(&request_buf.rmnet_nl_msg_s_val, request,
+	       sizeof(struct rmnet_nl_msg_s));
+	request_buf.rmnet_nl_msg_s_val.crd = RMNET_NETLINK_MSG_COMMAND;
 
-	memcpy((void *)NLMSG_DATA(request_buf), request,
-	sizeof(struct rmnet_nl_msg_s));
+	pending.response = response;
+	pending.remaining = &remaining;
 
-	rmnet_nl_msg_s_val->crd = RMNET_NETLINK_MSG_COMMAND;
-	hndl->transaction_id++;
-
-	saddr_ptr = &hndl->dest_addr;
-	socklen_t addrlen = sizeof(struct sockaddr_nl);
-	if (sendto(hndl->netlink_fd,
-			request_buf,
+	pthread_mutex_lock(&hndl->lock);
+	_rmnetctl_pending_add(hndl, &pending, &request_buf.nlmsghdr_val);
+	if (send(hndl->netlink_fd,
+			&request_buf,
 			MAX_BUF_SIZE,
-			RMNETCTL_SOCK_FLAG,
-			(struct sockaddr*)saddr_ptr,
-			sizeof(struct sockaddr_nl)) < 0) {
+			RMNETCTL_SOCK_FLAG) < 0) {
+		_rmnetctl_pending_remove(hndl, &pending);
+		pthread_mutex_unlock(&hndl->lock);
 		return_code = RMNETCTL_API_ERR_MESSAGE_SEND;
-		free(request_buf);
-		free(response_buf);
 		break;
 	}
 
-	saddr_ptr = &hndl->src_addr;
-	bytes_read = recvfrom(hndl->netlink_fd,
-			response_buf,
-			MAX_BUF_SIZE,
-			RMNETCTL_SOCK_FLAG,
-			(struct sockaddr*)saddr_ptr,
-			&addrlen);
-	if (bytes_read < 0) {
-		return_code = RMNETCTL_API_ERR_MESSAGE_RECEIVE;
-		free(request_buf);
-		free(response_buf);
+	if ((return_code = _rmnetctl_wait(hndl, &remaining))
+		!= RMNETCTL_API_SUCCESS)
 		break;
-	}
 
-	memcpy(response, (void *)NLMSG_DATA(response_buf),
-	sizeof(struct rmnet_nl_msg_s));
-	if (sizeof(*response) < sizeof(struct rmnet_nl_msg_s)) {
+	if (pending.len < MAX_BUF_SIZE) {
 		return_code = RMNETCTL_API_ERR_RESPONSE_NULL;
-		free(request_buf);
-		free(response_buf);
 		break;
 	}
 
 	if (request->message_type != response->message_type) {
 		return_code = RMNETCTL_API_ERR_MESSAGE_TYPE;
-		free(request_buf);
-		free(response_buf);
 		break;
 	}
 	return_code = RMNETCTL_SUCCESS;
 	} while(0);
-	free(request_buf);
-	free(response_buf);
 	return return_code;
 }
 
@@ -306,89 +519,54 @@ static inline int _rmnetctl_set_codes(int error_val, uint16_t *error_code) {
 	return return_code;
 }
 
-/*===========================================================================
-				EXPOSED API
-===========================================================================*/
-
-int rmnetctl_init(rmnetctl_hndl_t **hndl, uint16_t *error_code)
-{
-	pid_t pid = 0;
-	int netlink_fd = -1, return_code = RMNETCTL_LIB_ERR;
-	struct sockaddr_nl* __attribute__((__may_alias__)) saddr_ptr;
+/*!
+* @brief Static function to run a request answered with a return code
+* @details Sends the request, receives the response and converts the return
+* code of the response
+* @param *hndl RmNet handle for this transaction
+* @param request Message to be sent to the kernel
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_KERNEL_ERR if there was an error in the kernel.
+* Check error_code
+*/
+static int _rmnetctl_transact_code(rmnetctl_hndl_t *hndl,
+				   struct rmnet_nl_msg_s *request,
+				   uint16_t *error_code) {
+	struct rmnet_nl_msg_s response;
+	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!error_code)){
-		return_code = RMNETCTL_INVALID_ARG;
-		break;
-	}
-
-	*hndl = (rmnetctl_hndl_t *)malloc(sizeof(rmnetctl_hndl_t));
-	if (!*hndl) {
-		*error_code = RMNETCTL_API_ERR_HNDL_INVALID;
-		break;
-	}
-
-	memset(*hndl, 0, sizeof(rmnetctl_hndl_t));
-
-	pid = getpid();
-	if (pid  < MIN_VALID_PROCESS_ID) {
-		free(*hndl);
-		*error_code = RMNETCTL_INIT_ERR_PROCESS_ID;
-		break;
-	}
-	(*hndl)->pid = (uint32_t)pid;
-	netlink_fd = socket(PF_NETLINK, SOCK_RAW, RMNET_NETLINK_PROTO);
-	if (netlink_fd < MIN_VALID_SOCKET_FD) {
-		free(*hndl);
-		*error_code = RMNETCTL_INIT_ERR_NETLINK_FD;
+	if ((*error_code = rmnetctl_transact(hndl, request, &response))
+		!= RMNETCTL_SUCCESS)
 		break;
-	}
-
-	(*hndl)->netlink_fd = netlink_fd;
-
-	memset(&(*hndl)->src_addr, 0, sizeof(struct sockaddr_nl));
-
-	(*hndl)->src_addr.nl_family = AF_NETLINK;
-	(*hndl)->src_addr.nl_pid = (*hndl)->pid;
-
-	saddr_ptr = &(*hndl)->src_addr;
-	if (bind((*hndl)->netlink_fd,
-		(struct sockaddr*)saddr_ptr,
-		sizeof(struct sockaddr_nl)) < 0) {
-		close((*hndl)->netlink_fd);
-		free(*hndl);
-		*error_code = RMNETCTL_INIT_ERR_BIND;
+	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
 		break;
-	}
-
-	memset(&(*hndl)->dest_addr, 0, sizeof(struct sockaddr_nl));
-
-	(*hndl)->dest_addr.nl_family = AF_NETLINK;
-	(*hndl)->dest_addr.nl_pid = KERNEL_PROCESS_ID;
-	(*hndl)->dest_addr.nl_groups = UNICAST;
-
-	return_code = RMNETCTL_SUCCESS;
+	return_code = _rmnetctl_set_codes(response.return_code, error_code);
 	} while(0);
 	return return_code;
 }
 
-void rmnetctl_cleanup(rmnetctl_hndl_t *hndl)
-{
-	if (!hndl)
-		return;
-	close(hndl->netlink_fd);
-	free(hndl);
-}
-
-int rmnet_associate_network_device(rmnetctl_hndl_t *hndl,
-				   const char *dev_name,
-				   uint16_t *error_code,
-				   uint8_t assoc_dev)
-{
-	struct rmnet_nl_msg_s request, response;
+/*!
+* @brief Static functions to build the request of a configuration API
+* @details Each one checks the arguments of the API of the same name and
+* fills in the request that is sent for it, so that the API and its batched
+* variant send the same message
+* @param request Message to be filled in
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code
+* @return RMNETCTL_INVALID_ARG if invalid arguments were passed to the API
+*/
+static int _rmnetctl_fill_associate_network_device(
+					struct rmnet_nl_msg_s *request,
+					const char *dev_name,
+					uint8_t assoc_dev,
+					uint16_t *error_code) {
 	size_t str_len = 0;
 	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!error_code) || _rmnetctl_check_dev_name(dev_name) ||
+	if (_rmnetctl_check_dev_name(dev_name) ||
 		((assoc_dev != RMNETCTL_DEVICE_ASSOCIATE) &&
 		(assoc_dev != RMNETCTL_DEVICE_UNASSOCIATE))) {
 		return_code = RMNETCTL_INVALID_ARG;
@@ -396,510 +574,1794 @@ int rmnet_associate_network_device(rmnetctl_hndl_t *hndl,
 	}
 
 	if (assoc_dev == RMNETCTL_DEVICE_ASSOCIATE)
-		request.message_type = RMNET_NETLINK_ASSOCIATE_NETWORK_DEVICE;
+		request->message_type = RMNET_NETLINK_ASSOCIATE_NETWORK_DEVICE;
 	else
-		request.message_type = RMNET_NETLINK_UNASSOCIATE_NETWORK_DEVICE;
+		request->message_type = RMNET_NETLINK_UNASSOCIATE_NETWORK_DEVICE;
 
-	request.arg_length = RMNET_MAX_STR_LEN;
-	str_len = strlcpy((char *)(request.data), dev_name, (size_t)RMNET_MAX_STR_LEN);
+	request->arg_length = RMNET_MAX_STR_LEN;
+	str_len = strlcpy((char *)(request->data), dev_name, (size_t)RMNET_MAX_STR_LEN);
 	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
 		break;
-
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
-		break;
-	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
-		break;
-	return_code = _rmnetctl_set_codes(response.return_code, error_code);
+	return_code = RMNETCTL_SUCCESS;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_get_network_device_associated(rmnetctl_hndl_t *hndl,
+static int _rmnetctl_fill_set_link_egress_data_format(
+					struct rmnet_nl_msg_s *request,
+					uint32_t egress_flags,
+					uint16_t agg_size,
+					uint16_t agg_count,
 					const char *dev_name,
-					int *register_status,
 					uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
 	size_t str_len = 0;
-	int  return_code = RMNETCTL_LIB_ERR;
+	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!register_status) || (!error_code) ||
-	_rmnetctl_check_dev_name(dev_name)) {
+	if (_rmnetctl_check_dev_name(dev_name) ||
+	    ((~EGRESS_FLAGS_MASK) & egress_flags)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_GET_NETWORK_DEVICE_ASSOCIATED;
+	request->message_type = RMNET_NETLINK_SET_LINK_EGRESS_DATA_FORMAT;
 
-	request.arg_length = RMNET_MAX_STR_LEN;
-	str_len = strlcpy((char *)(request.data), dev_name, RMNET_MAX_STR_LEN);
+	request->arg_length = RMNET_MAX_STR_LEN +
+			 sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint16_t);
+	str_len = strlcpy((char *)(request->data_format.dev),
+			  dev_name,
+			  RMNET_MAX_STR_LEN);
 	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
 		break;
 
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
-		break;
-
-	if (_rmnetctl_check_data(response.crd, error_code)
-		!= RMNETCTL_SUCCESS) {
-		if (_rmnetctl_check_code(response.crd, error_code)
-			== RMNETCTL_SUCCESS)
-			return_code = _rmnetctl_set_codes(response.return_code,
-							  error_code);
-		break;
-	}
-
-	*register_status = response.return_code;
+	request->data_format.flags = egress_flags;
+	request->data_format.agg_size = agg_size;
+	request->data_format.agg_count = agg_count;
 	return_code = RMNETCTL_SUCCESS;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_set_link_egress_data_format(rmnetctl_hndl_t *hndl,
-				      uint32_t egress_flags,
-				      uint16_t agg_size,
-				      uint16_t agg_count,
-				      const char *dev_name,
-				      uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
+static int _rmnetctl_fill_set_link_ingress_data_format_tailspace(
+					struct rmnet_nl_msg_s *request,
+					uint32_t ingress_flags,
+					uint8_t  tail_spacing,
+					const char *dev_name,
+					uint16_t *error_code) {
 	size_t str_len = 0;
-	int  return_code = RMNETCTL_LIB_ERR;
+	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!error_code) || _rmnetctl_check_dev_name(dev_name) ||
-	    ((~EGRESS_FLAGS_MASK) & egress_flags)) {
+	if (_rmnetctl_check_dev_name(dev_name) ||
+	    ((~INGRESS_FLAGS_MASK) & ingress_flags)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_SET_LINK_EGRESS_DATA_FORMAT;
+	request->message_type = RMNET_NETLINK_SET_LINK_INGRESS_DATA_FORMAT;
 
-	request.arg_length = RMNET_MAX_STR_LEN +
-			 sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint16_t);
-	str_len = strlcpy((char *)(request.data_format.dev),
+	request->arg_length = RMNET_MAX_STR_LEN +
+	sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint16_t);
+	str_len = strlcpy((char *)(request->data_format.dev),
 			  dev_name,
 			  RMNET_MAX_STR_LEN);
 	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
 		break;
-
-	request.data_format.flags = egress_flags;
-	request.data_format.agg_size = agg_size;
-	request.data_format.agg_count = agg_count;
-
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
-		break;
-
-	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
-		break;
-
-	return_code = _rmnetctl_set_codes(response.return_code, error_code);
+	request->data_format.flags = ingress_flags;
+	request->data_format.tail_spacing = tail_spacing;
+	return_code = RMNETCTL_SUCCESS;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_get_link_egress_data_format(rmnetctl_hndl_t *hndl,
-				      const char *dev_name,
-				      uint32_t *egress_flags,
-				      uint16_t *agg_size,
-				      uint16_t *agg_count,
-				      uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
+static int _rmnetctl_fill_set_logical_ep_config(struct rmnet_nl_msg_s *request,
+						int32_t ep_id,
+						uint8_t operating_mode,
+						const char *dev_name,
+						const char *next_dev,
+						uint16_t *error_code) {
 	size_t str_len = 0;
-	int  return_code = RMNETCTL_LIB_ERR;
+	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!egress_flags) || (!agg_size) || (!agg_count) ||
-	(!error_code) || _rmnetctl_check_dev_name(dev_name)) {
+	if (((ep_id < -1) || (ep_id > 31)) ||
+		_rmnetctl_check_dev_name(dev_name) ||
+		_rmnetctl_check_dev_name(next_dev) ||
+		operating_mode >= RMNET_EPMODE_LENGTH) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
-	request.message_type = RMNET_NETLINK_GET_LINK_EGRESS_DATA_FORMAT;
 
-	request.arg_length = RMNET_MAX_STR_LEN;
-	str_len = strlcpy((char *)(request.data_format.dev),
+	request->message_type = RMNET_NETLINK_SET_LOGICAL_EP_CONFIG;
+
+	request->arg_length = RMNET_MAX_STR_LEN +
+	RMNET_MAX_STR_LEN + sizeof(int32_t) + sizeof(uint8_t);
+	str_len = strlcpy((char *)(request->local_ep_config.dev),
 			  dev_name,
 			  RMNET_MAX_STR_LEN);
 	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
 		break;
 
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
-		break;
-
-	if (_rmnetctl_check_data(response.crd, error_code)
-		!= RMNETCTL_SUCCESS) {
-		if (_rmnetctl_check_code(response.crd, error_code)
-			== RMNETCTL_SUCCESS)
-			return_code = _rmnetctl_set_codes(response.return_code,
-							  error_code);
+	str_len = strlcpy((char *)(request->local_ep_config.next_dev),
+			  next_dev,
+			  RMNET_MAX_STR_LEN);
+	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
 		break;
-	}
-
-	*egress_flags = response.data_format.flags;
-	*agg_size = response.data_format.agg_size;
-	*agg_count = response.data_format.agg_count;
+	request->local_ep_config.ep_id = ep_id;
+	request->local_ep_config.operating_mode = operating_mode;
 	return_code = RMNETCTL_SUCCESS;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_set_link_ingress_data_format_tailspace(rmnetctl_hndl_t *hndl,
-						 uint32_t ingress_flags,
-						 uint8_t  tail_spacing,
-						 const char *dev_name,
-						 uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
+static int _rmnetctl_fill_unset_logical_ep_config(
+					struct rmnet_nl_msg_s *request,
+					int32_t ep_id,
+					const char *dev_name,
+					uint16_t *error_code) {
 	size_t str_len = 0;
-	int  return_code = RMNETCTL_LIB_ERR;
+	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!error_code) || _rmnetctl_check_dev_name(dev_name) ||
-	    ((~INGRESS_FLAGS_MASK) & ingress_flags)) {
+	if (((ep_id < -1) || (ep_id > 31)) ||
+		_rmnetctl_check_dev_name(dev_name)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_SET_LINK_INGRESS_DATA_FORMAT;
+	request->message_type = RMNET_NETLINK_UNSET_LOGICAL_EP_CONFIG;
 
-	request.arg_length = RMNET_MAX_STR_LEN +
-	sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint16_t);
-	str_len = strlcpy((char *)(request.data_format.dev),
+	request->arg_length = RMNET_MAX_STR_LEN + sizeof(int32_t);
+	str_len = strlcpy((char *)(request->local_ep_config.dev),
 			  dev_name,
 			  RMNET_MAX_STR_LEN);
+
 	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
 		break;
-	request.data_format.flags = ingress_flags;
-	request.data_format.tail_spacing = tail_spacing;
 
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
+	request->local_ep_config.ep_id = ep_id;
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+static int _rmnetctl_fill_new_vnd_prefix(struct rmnet_nl_msg_s *request,
+					 uint32_t id,
+					 uint8_t new_vnd,
+					 const char *prefix,
+					 uint16_t *error_code) {
+	size_t str_len = 0;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((new_vnd != RMNETCTL_NEW_VND) && (new_vnd != RMNETCTL_FREE_VND)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	memset(request->vnd.vnd_name, 0, RMNET_MAX_STR_LEN);
+	if (new_vnd ==  RMNETCTL_NEW_VND) {
+		if (prefix) {
+			request->message_type =RMNET_NETLINK_NEW_VND_WITH_PREFIX;
+			str_len = strlcpy((char *)request->vnd.vnd_name,
+					  prefix, RMNET_MAX_STR_LEN);
+			if (_rmnetctl_check_len(str_len, error_code)
+						!= RMNETCTL_SUCCESS)
+				break;
+		} else {
+			request->message_type = RMNET_NETLINK_NEW_VND;
+		}
+	} else {
+		request->message_type = RMNET_NETLINK_FREE_VND;
+	}
+
+	request->arg_length = sizeof(uint32_t);
+	request->vnd.id = id;
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+static int _rmnetctl_fill_add_del_vnd_tc_flow(struct rmnet_nl_msg_s *request,
+					      uint32_t id,
+					      uint32_t map_flow_id,
+					      uint32_t tc_flow_id,
+					      uint8_t set_flow) {
+	if ((set_flow != RMNETCTL_ADD_FLOW) && (set_flow != RMNETCTL_DEL_FLOW))
+		return RMNETCTL_INVALID_ARG;
+
+	if (set_flow ==  RMNETCTL_ADD_FLOW)
+		request->message_type = RMNET_NETLINK_ADD_VND_TC_FLOW;
+	else
+		request->message_type = RMNET_NETLINK_DEL_VND_TC_FLOW;
+
+	request->arg_length = (sizeof(uint32_t))*3;
+	request->flow_control.id = id;
+	request->flow_control.map_flow_id = map_flow_id;
+	request->flow_control.tc_flow_id = tc_flow_id;
+	return RMNETCTL_SUCCESS;
+}
+
+static int _rmnetctl_fill_get_network_device_associated(
+					struct rmnet_nl_msg_s *request,
+					const char *dev_name,
+					uint16_t *error_code) {
+	size_t str_len = 0;
+	if (_rmnetctl_check_dev_name(dev_name))
+		return RMNETCTL_INVALID_ARG;
+
+	request->message_type = RMNET_NETLINK_GET_NETWORK_DEVICE_ASSOCIATED;
+
+	request->arg_length = RMNET_MAX_STR_LEN;
+	str_len = strlcpy((char *)(request->data), dev_name, RMNET_MAX_STR_LEN);
+	return _rmnetctl_check_len(str_len, error_code);
+}
+
+static int _rmnetctl_fill_get_link_data_format(struct rmnet_nl_msg_s *request,
+					       uint16_t message_type,
+					       const char *dev_name,
+					       uint16_t *error_code) {
+	size_t str_len = 0;
+	if (_rmnetctl_check_dev_name(dev_name))
+		return RMNETCTL_INVALID_ARG;
+
+	request->message_type = message_type;
+
+	request->arg_length = RMNET_MAX_STR_LEN;
+	str_len = strlcpy((char *)(request->data_format.dev),
+			  dev_name,
+			  RMNET_MAX_STR_LEN);
+	return _rmnetctl_check_len(str_len, error_code);
+}
+
+static int _rmnetctl_fill_get_logical_ep_config(
+					struct rmnet_nl_msg_s *request,
+					int32_t ep_id,
+					const char *dev_name,
+					uint16_t *error_code) {
+	size_t str_len = 0;
+	if (((ep_id < -1) || (ep_id > 31)) ||
+		_rmnetctl_check_dev_name(dev_name))
+		return RMNETCTL_INVALID_ARG;
+
+	request->message_type = RMNET_NETLINK_GET_LOGICAL_EP_CONFIG;
+
+	request->arg_length = RMNET_MAX_STR_LEN + sizeof(int32_t);
+	str_len = strlcpy((char *)(request->local_ep_config.dev),
+			  dev_name,
+			  RMNET_MAX_STR_LEN);
+	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
+		return RMNETCTL_LIB_ERR;
+
+	request->local_ep_config.ep_id = ep_id;
+	return RMNETCTL_SUCCESS;
+}
+
+static void _rmnetctl_fill_get_vnd_name(struct rmnet_nl_msg_s *request,
+					uint32_t id) {
+	request->message_type = RMNET_NETLINK_GET_VND_NAME;
+	request->arg_length = sizeof(uint32_t);
+	request->vnd.id = id;
+}
+
+/*!
+* @brief Static function to queue a request on a batch
+* @details Grows the batch when it is full. The new entry is zeroed and only
+* counted once the caller filled in its request successfully.
+* @param batch Batch to queue the request on
+* @param error_code Status code of this operation
+* @return Entry for the request, NULL if the batch could not grow
+*/
+static struct rmnetctl_batch_entry_s *_rmnetctl_batch_next(
+					rmnetctl_batch_t *batch,
+					uint16_t *error_code) {
+	struct rmnetctl_batch_entry_s *entries, *entry;
+	uint32_t capacity;
+	if (batch->in_flight) {
+		/* the requests in flight must stay where they are */
+		*error_code = RMNETCTL_API_ERR_REQUEST_INVALID;
+		return NULL;
+	}
+	if (batch->count == batch->capacity) {
+		capacity = batch->capacity ? batch->capacity * 2 :
+			   RMNETCTL_BATCH_MIN_CAPACITY;
+		entries = (struct rmnetctl_batch_entry_s *)realloc(
+			  batch->entries,
+			  capacity * sizeof(struct rmnetctl_batch_entry_s));
+		if (!entries) {
+			*error_code = RMNETCTL_API_ERR_REQUEST_INVALID;
+			return NULL;
+		}
+		batch->entries = entries;
+		batch->capacity = capacity;
+	}
+	entry = &batch->entries[batch->count];
+	memset(entry, 0, sizeof(struct rmnetctl_batch_entry_s));
+	return entry;
+}
+
+/*!
+* @brief Static function to store the data of an answered GET request
+* @details Stores the data where the batched GET API was asked to, the same
+* way the synchronous API does. Requests queued raw store nothing.
+* @param entry Request that was answered with data
+* @return RMNETCTL_SUCCESS if successful
+* @return RMNETCTL_LIB_ERR if there was a library error. Check error_code of
+* the entry
+*/
+static int _rmnetctl_batch_store(struct rmnetctl_batch_entry_s *entry) {
+	struct rmnet_nl_msg_s *response = &entry->response;
+	size_t str_len;
+	switch (entry->buf.rmnet_nl_msg_s_val.message_type) {
+	case RMNET_NETLINK_GET_NETWORK_DEVICE_ASSOCIATED:
+		if (entry->out.register_status)
+			*entry->out.register_status = response->return_code;
+		break;
+	case RMNET_NETLINK_GET_LINK_EGRESS_DATA_FORMAT:
+	case RMNET_NETLINK_GET_LINK_INGRESS_DATA_FORMAT:
+		if (entry->out.data_format.flags)
+			*entry->out.data_format.flags =
+				response->data_format.flags;
+		if (entry->out.data_format.agg_size)
+			*entry->out.data_format.agg_size =
+				response->data_format.agg_size;
+		if (entry->out.data_format.agg_count)
+			*entry->out.data_format.agg_count =
+				response->data_format.agg_count;
+		if (entry->out.data_format.tail_spacing)
+			*entry->out.data_format.tail_spacing =
+				response->data_format.tail_spacing;
+		break;
+	case RMNET_NETLINK_GET_LOGICAL_EP_CONFIG:
+		if (entry->out.local_ep_config.next_dev) {
+			str_len = strlcpy(entry->out.local_ep_config.next_dev,
+				(char *)(response->local_ep_config.next_dev),
+				min(RMNET_MAX_STR_LEN,
+				    entry->out.local_ep_config.next_dev_len));
+			if (_rmnetctl_check_len(str_len, &entry->error_code)
+				!= RMNETCTL_SUCCESS)
+				return RMNETCTL_LIB_ERR;
+		}
+		if (entry->out.local_ep_config.operating_mode)
+			*entry->out.local_ep_config.operating_mode =
+				response->local_ep_config.operating_mode;
+		break;
+	case RMNET_NETLINK_GET_VND_NAME:
+		if (entry->out.vnd.buf) {
+			str_len = strlcpy(entry->out.vnd.buf,
+					  (char *)(response->vnd.vnd_name),
+					  entry->out.vnd.buflen);
+			if (str_len >= entry->out.vnd.buflen) {
+				entry->error_code =
+					RMNETCTL_API_ERR_STRING_TRUNCATION;
+				return RMNETCTL_LIB_ERR;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+	return RMNETCTL_SUCCESS;
+}
+
+/*!
+* @brief Static function to complete a request of a batch with its response
+* @details Checks the response the same way the synchronous API does. A
+* response carrying data completes the request successfully, the data is
+* stored for the batched GET APIs and can be read with
+* rmnetctl_batch_response().
+* @param entry Request that was answered
+* @return void
+*/
+static void _rmnetctl_batch_complete(struct rmnetctl_batch_entry_s *entry) {
+	entry->return_code = RMNETCTL_LIB_ERR;
+	do {
+	if (entry->pending.len < MAX_BUF_SIZE) {
+		entry->error_code = RMNETCTL_API_ERR_RESPONSE_NULL;
+		break;
+	}
+
+	if (entry->buf.rmnet_nl_msg_s_val.message_type !=
+	    entry->response.message_type) {
+		entry->error_code = RMNETCTL_API_ERR_MESSAGE_TYPE;
+		break;
+	}
+	if (_rmnetctl_check_data(entry->response.crd, &entry->error_code)
+		== RMNETCTL_SUCCESS) {
+		entry->error_code = RMNETCTL_API_SUCCESS;
+		entry->return_code = _rmnetctl_batch_store(entry);
+		break;
+	}
+	if (_rmnetctl_check_code(entry->response.crd, &entry->error_code)
 		!= RMNETCTL_SUCCESS)
 		break;
+	entry->error_code = RMNETCTL_API_SUCCESS;
+	entry->return_code = _rmnetctl_set_codes(entry->response.return_code,
+						 &entry->error_code);
+	} while(0);
+}
+
+/*!
+* @brief Static function to send a window of requests of a batch
+* @details Lists the requests as pending on the handle and sends them with
+* sendmmsg(). Requests that could not be sent are taken off the list again
+* and keep RMNETCTL_API_ERR_MESSAGE_SEND, the others are left with
+* RMNETCTL_API_ERR_MESSAGE_RECEIVE until they are answered. Called with the
+* handle lock held.
+* @param batch Batch being committed
+* @param first Index of the first request of the window
+* @param count Number of requests in the window, at most
+* RMNETCTL_BATCH_WINDOW
+* @param remaining Counter of the requests of the window still unanswered
+* @return Number of requests sent
+*/
+static uint32_t _rmnetctl_batch_send(rmnetctl_batch_t *batch,
+				     uint32_t first,
+				     uint32_t count,
+				     uint32_t *remaining) {
+	rmnetctl_hndl_t *hndl = batch->hndl;
+	struct rmnetctl_batch_entry_s *entry;
+	uint32_t i, sent = 0;
+	int rc;
+
+	for (i = 0; i < count; i++) {
+		entry = &batch->entries[first + i];
+		entry->buf.nlmsghdr_val.nlmsg_len = MAX_BUF_SIZE;
+		entry->buf.nlmsghdr_val.nlmsg_pid = hndl->pid;
+		entry->buf.rmnet_nl_msg_s_val.crd = RMNET_NETLINK_MSG_COMMAND;
+		entry->pending.response = &entry->response;
+		entry->pending.remaining = remaining;
+		entry->return_code = RMNETCTL_LIB_ERR;
+		entry->error_code = RMNETCTL_API_ERR_MESSAGE_SEND;
+
+		batch->request_iov[i].iov_base = &entry->buf;
+		batch->request_iov[i].iov_len = MAX_BUF_SIZE;
+		memset(&batch->request_msg[i], 0, sizeof(struct mmsghdr));
+		batch->request_msg[i].msg_hdr.msg_iov = &batch->request_iov[i];
+		batch->request_msg[i].msg_hdr.msg_iovlen = 1;
+		_rmnetctl_pending_add(hndl, &entry->pending,
+				      &entry->buf.nlmsghdr_val);
+	}
+
+	while (sent < count) {
+		rc = sendmmsg(hndl->netlink_fd, &batch->request_msg[sent],
+			      count - sent, RMNETCTL_SOCK_FLAG);
+		if (rc < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		sent += (uint32_t)rc;
+	}
+	for (i = sent; i < count; i++)
+		_rmnetctl_pending_remove(hndl,
+					 &batch->entries[first + i].pending);
+	for (i = 0; i < sent; i++)
+		batch->entries[first + i].error_code =
+			RMNETCTL_API_ERR_MESSAGE_RECEIVE;
+	return sent;
+}
+
+/*!
+* @brief Static function to exchange a window of requests with the kernel
+* @details Sends the requests and waits for their responses, which are
+* matched by sequence number like those of any other request on the handle.
+* Requests that could not be sent or were not answered keep
+* RMNETCTL_API_ERR_MESSAGE_SEND or RMNETCTL_API_ERR_MESSAGE_RECEIVE.
+* @param batch Batch being committed
+* @param first Index of the first request of the window
+* @param count Number of requests in the window, at most
+* RMNETCTL_BATCH_WINDOW
+* @param error_code Status code of this operation
+* @return RMNETCTL_SUCCESS if every request was answered
+* @return RMNETCTL_LIB_ERR if the exchange failed. Check error_code
+*/
+static int _rmnetctl_batch_exchange(rmnetctl_batch_t *batch,
+				    uint32_t first,
+				    uint32_t count,
+				    uint16_t *error_code) {
+	rmnetctl_hndl_t *hndl = batch->hndl;
+	struct rmnetctl_batch_entry_s *entry;
+	uint32_t i, sent, remaining = 0;
+	uint16_t recv_code;
+
+	pthread_mutex_lock(&hndl->lock);
+	sent = _rmnetctl_batch_send(batch, first, count, &remaining);
+	recv_code = _rmnetctl_wait(hndl, &remaining);
+
+	for (i = 0; i < sent; i++) {
+		entry = &batch->entries[first + i];
+		if (entry->pending.answered)
+			_rmnetctl_batch_complete(entry);
+	}
+
+	if (sent < count) {
+		*error_code = RMNETCTL_API_ERR_MESSAGE_SEND;
+		return RMNETCTL_LIB_ERR;
+	}
+	if (recv_code != RMNETCTL_API_SUCCESS) {
+		*error_code = recv_code;
+		return RMNETCTL_LIB_ERR;
+	}
+	return RMNETCTL_SUCCESS;
+}
+
+static uint64_t _rmnetctl_now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*!
+* @brief Static function to move an asynchronous commit along
+* @details Completes the window in flight once it was answered and sends the
+* next one. At the deadline, the requests of the window which were not
+* answered are taken off the pending list and fail with
+* RMNETCTL_API_ERR_TIMEOUT. Called with the handle lock held.
+* @param batch Batch committed asynchronously
+* @param now_ms Current CLOCK_MONOTONIC time
+* @return 1 if the commit is complete, 0 otherwise
+*/
+static int _rmnetctl_async_advance(rmnetctl_batch_t *batch, uint64_t now_ms) {
+	struct rmnetctl_batch_entry_s *entry;
+	uint32_t i, window;
+
+	while (!batch->remaining) {
+		for (i = batch->first; i < batch->sent; i++)
+			_rmnetctl_batch_complete(&batch->entries[i]);
+		batch->first = batch->sent;
+		if ((batch->sent == batch->count) || batch->async_error)
+			return 1;
+		if (now_ms >= batch->deadline_ms) {
+			batch->async_error = RMNETCTL_API_ERR_TIMEOUT;
+			return 1;
+		}
+		window = min(batch->count - batch->sent, RMNETCTL_BATCH_WINDOW);
+		batch->sent += _rmnetctl_batch_send(batch, batch->first, window,
+						    &batch->remaining);
+		if (batch->sent < batch->first + window)
+			batch->async_error = RMNETCTL_API_ERR_MESSAGE_SEND;
+	}
+	if (now_ms < batch->deadline_ms)
+		return 0;
+
+	for (i = batch->first; i < batch->sent; i++) {
+		entry = &batch->entries[i];
+		if (entry->pending.answered) {
+			_rmnetctl_batch_complete(entry);
+		} else {
+			_rmnetctl_pending_remove(batch->hndl, &entry->pending);
+			entry->error_code = RMNETCTL_API_ERR_TIMEOUT;
+		}
+	}
+	batch->first = batch->sent;
+	batch->async_error = RMNETCTL_API_ERR_TIMEOUT;
+	return 1;
+}
+
+/*!
+* @brief Static function to stop an asynchronous commit
+* @details Takes the requests in flight off the pending list, their
+* responses are dropped when they come. Called with the handle lock held.
+* @param batch Batch committed asynchronously
+* @return void
+*/
+static void _rmnetctl_async_cancel(rmnetctl_batch_t *batch) {
+	rmnetctl_batch_t **link;
+	uint32_t i;
+	for (i = batch->first; i < batch->sent; i++)
+		if (!batch->entries[i].pending.answered)
+			_rmnetctl_pending_remove(batch->hndl,
+						 &batch->entries[i].pending);
+	for (link = &batch->hndl->async_head; *link;
+	     link = &(*link)->next_async) {
+		if (*link == batch) {
+			*link = batch->next_async;
+			break;
+		}
+	}
+	batch->next_async = NULL;
+	batch->in_flight = 0;
+}
+
+/*!
+* @brief Static function to move the asynchronous commits of a handle along
+* after a blocking caller received responses
+* @details The blocking caller receives the responses of the asynchronous
+* commits too, so the fd the event loop watches does not become readable
+* for them: the next windows are sent from here, and the loop is woken
+* through wake_fd when a commit completed, for rmnetctl_async_process() to
+* call its callback. Called with the handle lock held.
+* @param *hndl RmNet handle the responses were received on
+* @return void
+*/
+static void _rmnetctl_async_kick(rmnetctl_hndl_t *hndl) {
+	rmnetctl_batch_t *batch;
+	uint64_t now_ms;
+	int done = 0;
+	if (!hndl->async_head)
+		return;
+	now_ms = _rmnetctl_now_ms();
+	for (batch = hndl->async_head; batch; batch = batch->next_async)
+		done |= _rmnetctl_async_advance(batch, now_ms);
+	if (done && (hndl->wake_fd >= 0))
+		eventfd_write(hndl->wake_fd, 1);
+}
+
+/*===========================================================================
+				EXPOSED API
+===========================================================================*/
+
+int rmnetctl_init(rmnetctl_hndl_t **hndl, uint16_t *error_code)
+{
+	pid_t pid = 0;
+	int netlink_fd = -1, return_code = RMNETCTL_LIB_ERR;
+	struct sockaddr_nl* __attribute__((__may_alias__)) saddr_ptr;
+	do {
+	if ((!hndl) || (!error_code)){
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	*hndl = (rmnetctl_hndl_t *)malloc(sizeof(rmnetctl_hndl_t));
+	if (!*hndl) {
+		*error_code = RMNETCTL_API_ERR_HNDL_INVALID;
+		break;
+	}
+
+	memset(*hndl, 0, sizeof(rmnetctl_hndl_t));
+	(*hndl)->poll_fd = -1;
+	(*hndl)->wake_fd = -1;
+
+	pid = getpid();
+	if (pid  < MIN_VALID_PROCESS_ID) {
+		free(*hndl);
+		*error_code = RMNETCTL_INIT_ERR_PROCESS_ID;
+		break;
+	}
+	(*hndl)->pid = (uint32_t)pid;
+	netlink_fd = socket(PF_NETLINK, SOCK_RAW, RMNET_NETLINK_PROTO);
+	if (netlink_fd < MIN_VALID_SOCKET_FD) {
+		free(*hndl);
+		*error_code = RMNETCTL_INIT_ERR_NETLINK_FD;
+		break;
+	}
+
+	(*hndl)->netlink_fd = netlink_fd;
+
+	memset(&(*hndl)->src_addr, 0, sizeof(struct sockaddr_nl));
+
+	(*hndl)->src_addr.nl_family = AF_NETLINK;
+	(*hndl)->src_addr.nl_pid = (*hndl)->pid;
+
+	saddr_ptr = &(*hndl)->src_addr;
+	if (bind((*hndl)->netlink_fd,
+		(struct sockaddr*)saddr_ptr,
+		sizeof(struct sockaddr_nl)) < 0) {
+		close((*hndl)->netlink_fd);
+		free(*hndl);
+		*error_code = RMNETCTL_INIT_ERR_BIND;
+		break;
+	}
+
+	memset(&(*hndl)->dest_addr, 0, sizeof(struct sockaddr_nl));
+
+	(*hndl)->dest_addr.nl_family = AF_NETLINK;
+	(*hndl)->dest_addr.nl_pid = KERNEL_PROCESS_ID;
+	(*hndl)->dest_addr.nl_groups = UNICAST;
+
+	/* Requests, batched or not, go out without a per-message address */
+	saddr_ptr = &(*hndl)->dest_addr;
+	if (connect((*hndl)->netlink_fd,
+		(struct sockaddr*)saddr_ptr,
+		sizeof(struct sockaddr_nl)) < 0) {
+		close((*hndl)->netlink_fd);
+		free(*hndl);
+		*error_code = RMNETCTL_INIT_ERR_BIND;
+		break;
+	}
+
+	pthread_mutex_init(&(*hndl)->lock, NULL);
+	pthread_cond_init(&(*hndl)->answered, NULL);
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+void rmnetctl_cleanup(rmnetctl_hndl_t *hndl)
+{
+	if (!hndl)
+		return;
+	close(hndl->netlink_fd);
+	if (hndl->poll_fd >= 0) {
+		close(hndl->poll_fd);
+		close(hndl->wake_fd);
+	}
+	pthread_cond_destroy(&hndl->answered);
+	pthread_mutex_destroy(&hndl->lock);
+	free(hndl);
+}
+
+int rmnetctl_get_fd(rmnetctl_hndl_t *hndl)
+{
+	struct epoll_event event;
+	int fd;
+	if (!hndl)
+		return -1;
+
+	pthread_mutex_lock(&hndl->lock);
+	do {
+	if (hndl->poll_fd >= 0)
+		break;
+	hndl->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (hndl->wake_fd < 0)
+		break;
+	hndl->poll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (hndl->poll_fd < 0)
+		break;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	if ((epoll_ctl(hndl->poll_fd, EPOLL_CTL_ADD, hndl->netlink_fd,
+		       &event) < 0) ||
+	    (epoll_ctl(hndl->poll_fd, EPOLL_CTL_ADD, hndl->wake_fd,
+		       &event) < 0)) {
+		close(hndl->poll_fd);
+		hndl->poll_fd = -1;
+	}
+	} while(0);
+	if ((hndl->poll_fd < 0) && (hndl->wake_fd >= 0)) {
+		close(hndl->wake_fd);
+		hndl->wake_fd = -1;
+	}
+	/* without the epoll instance, the loop still gets the responses it
+	 * receives itself */
+	fd = (hndl->poll_fd >= 0) ? hndl->poll_fd : hndl->netlink_fd;
+	pthread_mutex_unlock(&hndl->lock);
+	return fd;
+}
+
+int rmnet_associate_network_device(rmnetctl_hndl_t *hndl,
+				   const char *dev_name,
+				   uint16_t *error_code,
+				   uint8_t assoc_dev)
+{
+	struct rmnet_nl_msg_s request;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_associate_network_device(&request,
+							      dev_name,
+							      assoc_dev,
+							      error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	return_code = _rmnetctl_transact_code(hndl, &request, error_code);
+	} while(0);
+	return return_code;
+}
+
+int rmnet_get_network_device_associated(rmnetctl_hndl_t *hndl,
+					const char *dev_name,
+					int *register_status,
+					uint16_t *error_code) {
+	struct rmnet_nl_msg_s request, response;
+	int  return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!register_status) || (!error_code) ||
+	_rmnetctl_check_dev_name(dev_name)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_get_network_device_associated(&request,
+								   dev_name,
+								   error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+	return_code = RMNETCTL_LIB_ERR;
+
+	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
+		!= RMNETCTL_SUCCESS)
+		break;
+
+	if (_rmnetctl_check_data(response.crd, error_code)
+		!= RMNETCTL_SUCCESS) {
+		if (_rmnetctl_check_code(response.crd, error_code)
+			== RMNETCTL_SUCCESS)
+			return_code = _rmnetctl_set_codes(response.return_code,
+							  error_code);
+		break;
+	}
+
+	*register_status = response.return_code;
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+int rmnet_set_link_egress_data_format(rmnetctl_hndl_t *hndl,
+				      uint32_t egress_flags,
+				      uint16_t agg_size,
+				      uint16_t agg_count,
+				      const char *dev_name,
+				      uint16_t *error_code) {
+	struct rmnet_nl_msg_s request;
+	int  return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_set_link_egress_data_format(&request,
+								 egress_flags,
+								 agg_size,
+								 agg_count,
+								 dev_name,
+								 error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	return_code = _rmnetctl_transact_code(hndl, &request, error_code);
+	} while(0);
+	return return_code;
+}
+
+int rmnet_get_link_egress_data_format(rmnetctl_hndl_t *hndl,
+				      const char *dev_name,
+				      uint32_t *egress_flags,
+				      uint16_t *agg_size,
+				      uint16_t *agg_count,
+				      uint16_t *error_code) {
+	struct rmnet_nl_msg_s request, response;
+	int  return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!egress_flags) || (!agg_size) || (!agg_count) ||
+	(!error_code) || _rmnetctl_check_dev_name(dev_name)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+	return_code = _rmnetctl_fill_get_link_data_format(&request,
+				RMNET_NETLINK_GET_LINK_EGRESS_DATA_FORMAT,
+				dev_name, error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+	return_code = RMNETCTL_LIB_ERR;
+
+	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
+		!= RMNETCTL_SUCCESS)
+		break;
+
+	if (_rmnetctl_check_data(response.crd, error_code)
+		!= RMNETCTL_SUCCESS) {
+		if (_rmnetctl_check_code(response.crd, error_code)
+			== RMNETCTL_SUCCESS)
+			return_code = _rmnetctl_set_codes(response.return_code,
+							  error_code);
+		break;
+	}
+
+	*egress_flags = response.data_format.flags;
+	*agg_size = response.data_format.agg_size;
+	*agg_count = response.data_format.agg_count;
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+int rmnet_set_link_ingress_data_format_tailspace(rmnetctl_hndl_t *hndl,
+						 uint32_t ingress_flags,
+						 uint8_t  tail_spacing,
+						 const char *dev_name,
+						 uint16_t *error_code) {
+	struct rmnet_nl_msg_s request;
+	int  return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_set_link_ingress_data_format_tailspace(
+					&request, ingress_flags, tail_spacing,
+					dev_name, error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	return_code = _rmnetctl_transact_code(hndl, &request, error_code);
+	} while(0);
+	return return_code;
+}
+
+int rmnet_get_link_ingress_data_format_tailspace(rmnetctl_hndl_t *hndl,
+						 const char *dev_name,
+						 uint32_t *ingress_flags,
+						 uint8_t  *tail_spacing,
+						 uint16_t *error_code) {
+	struct rmnet_nl_msg_s request, response;
+	int  return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code) ||
+		_rmnetctl_check_dev_name(dev_name)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_get_link_data_format(&request,
+				RMNET_NETLINK_GET_LINK_INGRESS_DATA_FORMAT,
+				dev_name, error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+	return_code = RMNETCTL_LIB_ERR;
+
+	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
+		!= RMNETCTL_SUCCESS)
+		break;
+
+	if (_rmnetctl_check_data(response.crd, error_code)
+		!= RMNETCTL_SUCCESS) {
+		if (_rmnetctl_check_code(response.crd, error_code)
+			== RMNETCTL_SUCCESS)
+			return_code = _rmnetctl_set_codes(response.return_code,
+							  error_code);
+		break;
+	}
+
+	if (ingress_flags)
+		*ingress_flags = response.data_format.flags;
+
+	if (tail_spacing)
+		*tail_spacing = response.data_format.tail_spacing;
+
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+int rmnet_set_logical_ep_config(rmnetctl_hndl_t *hndl,
+				int32_t ep_id,
+				uint8_t operating_mode,
+				const char *dev_name,
+				const char *next_dev,
+				uint16_t *error_code) {
+	struct rmnet_nl_msg_s request;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_set_logical_ep_config(&request,
+							   ep_id,
+							   operating_mode,
+							   dev_name,
+							   next_dev,
+							   error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	return_code = _rmnetctl_transact_code(hndl, &request, error_code);
+	} while(0);
+	return return_code;
+}
+
+int rmnet_unset_logical_ep_config(rmnetctl_hndl_t *hndl,
+				  int32_t ep_id,
+				  const char *dev_name,
+				  uint16_t *error_code) {
+	struct rmnet_nl_msg_s request;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+
+	if ((!hndl) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_unset_logical_ep_config(&request,
+							     ep_id,
+							     dev_name,
+							     error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	return_code = _rmnetctl_transact_code(hndl, &request, error_code);
+	} while(0);
+
+	return return_code;
+}
+
+int rmnet_get_logical_ep_config(rmnetctl_hndl_t *hndl,
+				int32_t ep_id,
+				const char *dev_name,
+				uint8_t *operating_mode,
+				char **next_dev,
+				uint32_t next_dev_len,
+				uint16_t *error_code) {
+	struct rmnet_nl_msg_s request, response;
+	size_t str_len = 0;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!operating_mode) || (!error_code) || ((ep_id < -1) ||
+	    (ep_id > 31)) || _rmnetctl_check_dev_name(dev_name) || (!next_dev)
+	    || (0 == next_dev_len)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_get_logical_ep_config(&request, ep_id,
+							   dev_name,
+							   error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+	return_code = RMNETCTL_LIB_ERR;
+
+	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
+		!= RMNETCTL_SUCCESS)
+		break;
+
+	if (_rmnetctl_check_data(response.crd, error_code)
+		!= RMNETCTL_SUCCESS) {
+		if (_rmnetctl_check_code(response.crd, error_code)
+			== RMNETCTL_SUCCESS)
+			return_code = _rmnetctl_set_codes(response.return_code,
+							  error_code);
+		break;
+	}
+
+	str_len = strlcpy(*next_dev,
+			  (char *)(response.local_ep_config.next_dev),
+			  min(RMNET_MAX_STR_LEN, next_dev_len));
+	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
+		break;
+
+	*operating_mode = response.local_ep_config.operating_mode;
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+int rmnet_new_vnd_prefix(rmnetctl_hndl_t *hndl,
+			 uint32_t id,
+			 uint16_t *error_code,
+			 uint8_t new_vnd,
+			 const char *prefix)
+{
+	struct rmnet_nl_msg_s request;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_new_vnd_prefix(&request, id, new_vnd,
+						    prefix, error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	return_code = _rmnetctl_transact_code(hndl, &request, error_code);
+	} while(0);
+	return return_code;
+}
+
+int rmnet_new_vnd(rmnetctl_hndl_t *hndl,
+		  uint32_t id,
+		  uint16_t *error_code,
+		  uint8_t new_vnd)
+{
+	return rmnet_new_vnd_prefix(hndl, id, error_code, new_vnd, 0);
+}
+
+int rmnet_get_vnd_name(rmnetctl_hndl_t *hndl,
+		       uint32_t id,
+		       uint16_t *error_code,
+		       char *buf,
+		       uint32_t buflen)
+{
+	struct rmnet_nl_msg_s request, response;
+	uint32_t str_len;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code) || (!buf) || (0 == buflen)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	_rmnetctl_fill_get_vnd_name(&request, id);
+
+	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
+		!= RMNETCTL_SUCCESS)
+		break;
+
+	if (_rmnetctl_check_data(response.crd, error_code)
+		!= RMNETCTL_SUCCESS) {
+		if (_rmnetctl_check_code(response.crd, error_code)
+			== RMNETCTL_SUCCESS)
+			return_code = _rmnetctl_set_codes(response.return_code,
+							  error_code);
+		break;
+	}
+
+	str_len = (uint32_t)strlcpy(buf,
+			  (char *)(response.vnd.vnd_name),
+			  buflen);
+	if (str_len >= buflen) {
+		*error_code = RMNETCTL_API_ERR_STRING_TRUNCATION;
+		break;
+	}
+
+	return_code = RMNETCTL_SUCCESS;
+	} while (0);
+	return return_code;
+}
+
+int rmnet_add_del_vnd_tc_flow(rmnetctl_hndl_t *hndl,
+			      uint32_t id,
+			      uint32_t map_flow_id,
+			      uint32_t tc_flow_id,
+			      uint8_t set_flow,
+			      uint16_t *error_code) {
+	struct rmnet_nl_msg_s request;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = _rmnetctl_fill_add_del_vnd_tc_flow(&request, id,
+							 map_flow_id,
+							 tc_flow_id,
+							 set_flow);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+
+	return_code = _rmnetctl_transact_code(hndl, &request, error_code);
+	} while(0);
+	return return_code;
+}
+
+
+/*===========================================================================
+				BATCHED REQUESTS
+===========================================================================*/
+
+int rmnetctl_batch_init(rmnetctl_hndl_t *hndl,
+			rmnetctl_batch_t **batch,
+			uint16_t *error_code)
+{
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!hndl) || (!batch) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	*batch = (rmnetctl_batch_t *)malloc(sizeof(rmnetctl_batch_t));
+	if (!*batch) {
+		*error_code = RMNETCTL_API_ERR_REQUEST_INVALID;
+		break;
+	}
+
+	memset(*batch, 0, sizeof(rmnetctl_batch_t));
+	(*batch)->hndl = hndl;
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+void rmnetctl_batch_cleanup(rmnetctl_batch_t *batch)
+{
+	if (!batch)
+		return;
+	if (batch->in_flight) {
+		pthread_mutex_lock(&batch->hndl->lock);
+		_rmnetctl_async_cancel(batch);
+		pthread_mutex_unlock(&batch->hndl->lock);
+	}
+	free(batch->entries);
+	free(batch);
+}
+
+void rmnetctl_batch_reset(rmnetctl_batch_t *batch)
+{
+	if (!batch)
+		return;
+	if (batch->in_flight) {
+		pthread_mutex_lock(&batch->hndl->lock);
+		_rmnetctl_async_cancel(batch);
+		pthread_mutex_unlock(&batch->hndl->lock);
+	}
+	batch->count = 0;
+}
+
+uint32_t rmnetctl_batch_count(rmnetctl_batch_t *batch)
+{
+	return batch ? batch->count : 0;
+}
+
+int rmnetctl_batch_add(rmnetctl_batch_t *batch,
+		       const struct rmnet_nl_msg_s *request,
+		       uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!request) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
+		break;
+
+	memcpy(&entry->buf.rmnet_nl_msg_s_val, request,
+	       sizeof(struct rmnet_nl_msg_s));
+	batch->count++;
+	return_code = RMNETCTL_SUCCESS;
+	} while(0);
+	return return_code;
+}
+
+int rmnetctl_batch_commit(rmnetctl_batch_t *batch, uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	uint32_t first, window, i;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!error_code) || batch->in_flight) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
+
+	return_code = RMNETCTL_SUCCESS;
+	*error_code = RMNETCTL_API_SUCCESS;
+	for (first = 0; first < batch->count; first += window) {
+		window = min(batch->count - first, RMNETCTL_BATCH_WINDOW);
+		if (_rmnetctl_batch_exchange(batch, first, window, error_code)
+			!= RMNETCTL_SUCCESS) {
+			/* requests after a failed window are not sent */
+			for (i = first + window; i < batch->count; i++) {
+				entry = &batch->entries[i];
+				entry->pending.answered = 0;
+				entry->return_code = RMNETCTL_LIB_ERR;
+				entry->error_code =
+					RMNETCTL_API_ERR_MESSAGE_SEND;
+			}
+			return_code = RMNETCTL_LIB_ERR;
+			break;
+		}
+		for (i = first; i < first + window; i++) {
+			entry = &batch->entries[i];
+			if ((return_code == RMNETCTL_SUCCESS) &&
+			    (entry->return_code != RMNETCTL_SUCCESS)) {
+				return_code = entry->return_code;
+				*error_code = entry->error_code;
+			}
+		}
+	}
+	} while(0);
+	return return_code;
+}
+
+int rmnetctl_batch_status(rmnetctl_batch_t *batch,
+			  uint32_t index,
+			  uint16_t *error_code)
+{
+	if ((!batch) || (!error_code) || (index >= batch->count))
+		return RMNETCTL_INVALID_ARG;
+	*error_code = batch->entries[index].error_code;
+	return batch->entries[index].return_code;
+}
+
+const struct rmnet_nl_msg_s *rmnetctl_batch_response(rmnetctl_batch_t *batch,
+						     uint32_t index)
+{
+	if ((!batch) || (index >= batch->count) ||
+	    (!batch->entries[index].pending.answered))
+		return NULL;
+	return &batch->entries[index].response;
+}
+
+int rmnet_batch_associate_network_device(rmnetctl_batch_t *batch,
+					 const char *dev_name,
+					 uint16_t *error_code,
+					 uint8_t assoc_dev)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
+		break;
+	}
 
-	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	return_code = _rmnetctl_set_codes(response.return_code, error_code);
+	return_code = _rmnetctl_fill_associate_network_device(
+			&entry->buf.rmnet_nl_msg_s_val, dev_name, assoc_dev,
+			error_code);
+	if (return_code == RMNETCTL_SUCCESS)
+		batch->count++;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_get_link_ingress_data_format_tailspace(rmnetctl_hndl_t *hndl,
-						 const char *dev_name,
-						 uint32_t *ingress_flags,
-						 uint8_t  *tail_spacing,
-						 uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
-	size_t str_len = 0;
-	int  return_code = RMNETCTL_LIB_ERR;
+int rmnet_batch_set_link_egress_data_format(rmnetctl_batch_t *batch,
+					    uint32_t egress_flags,
+					    uint16_t agg_size,
+					    uint16_t agg_count,
+					    const char *dev_name,
+					    uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!error_code) ||
-		_rmnetctl_check_dev_name(dev_name)) {
+	if ((!batch) || (!error_code)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_GET_LINK_INGRESS_DATA_FORMAT;
-
-	request.arg_length = RMNET_MAX_STR_LEN;
-	str_len = strlcpy((char *)(request.data_format.dev),
-			  dev_name,
-			  RMNET_MAX_STR_LEN);
-	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
-		break;
+	return_code = _rmnetctl_fill_set_link_egress_data_format(
+			&entry->buf.rmnet_nl_msg_s_val, egress_flags,
+			agg_size, agg_count, dev_name, error_code);
+	if (return_code == RMNETCTL_SUCCESS)
+		batch->count++;
+	} while(0);
+	return return_code;
+}
 
-	if (_rmnetctl_check_data(response.crd, error_code)
-		!= RMNETCTL_SUCCESS) {
-		if (_rmnetctl_check_code(response.crd, error_code)
-			== RMNETCTL_SUCCESS)
-			return_code = _rmnetctl_set_codes(response.return_code,
-							  error_code);
+int rmnet_batch_set_link_ingress_data_format_tailspace(
+						rmnetctl_batch_t *batch,
+						uint32_t ingress_flags,
+						uint8_t  tail_spacing,
+						const char *dev_name,
+						uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	if (ingress_flags)
-		*ingress_flags = response.data_format.flags;
-
-	if (tail_spacing)
-		*tail_spacing = response.data_format.tail_spacing;
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
+		break;
 
-	return_code = RMNETCTL_SUCCESS;
+	return_code = _rmnetctl_fill_set_link_ingress_data_format_tailspace(
+			&entry->buf.rmnet_nl_msg_s_val, ingress_flags,
+			tail_spacing, dev_name, error_code);
+	if (return_code == RMNETCTL_SUCCESS)
+		batch->count++;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_set_logical_ep_config(rmnetctl_hndl_t *hndl,
-				int32_t ep_id,
-				uint8_t operating_mode,
-				const char *dev_name,
-				const char *next_dev,
-				uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
-	size_t str_len = 0;
+int rmnet_batch_set_logical_ep_config(rmnetctl_batch_t *batch,
+				      int32_t ep_id,
+				      uint8_t operating_mode,
+				      const char *dev_name,
+				      const char *next_dev,
+				      uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
 	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || ((ep_id < -1) || (ep_id > 31)) || (!error_code) ||
-		_rmnetctl_check_dev_name(dev_name) ||
-		_rmnetctl_check_dev_name(next_dev) ||
-		operating_mode >= RMNET_EPMODE_LENGTH) {
+	if ((!batch) || (!error_code)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_SET_LOGICAL_EP_CONFIG;
-
-	request.arg_length = RMNET_MAX_STR_LEN +
-	RMNET_MAX_STR_LEN + sizeof(int32_t) + sizeof(uint8_t);
-	str_len = strlcpy((char *)(request.local_ep_config.dev),
-			  dev_name,
-			  RMNET_MAX_STR_LEN);
-	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	str_len = strlcpy((char *)(request.local_ep_config.next_dev),
-			  next_dev,
-			  RMNET_MAX_STR_LEN);
-	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
-		break;
-	request.local_ep_config.ep_id = ep_id;
-	request.local_ep_config.operating_mode = operating_mode;
+	return_code = _rmnetctl_fill_set_logical_ep_config(
+			&entry->buf.rmnet_nl_msg_s_val, ep_id, operating_mode,
+			dev_name, next_dev, error_code);
+	if (return_code == RMNETCTL_SUCCESS)
+		batch->count++;
+	} while(0);
+	return return_code;
+}
 
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
+int rmnet_batch_unset_logical_ep_config(rmnetctl_batch_t *batch,
+					int32_t ep_id,
+					const char *dev_name,
+					uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
 		break;
-	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
+	}
+
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	return_code = _rmnetctl_set_codes(response.return_code, error_code);
+	return_code = _rmnetctl_fill_unset_logical_ep_config(
+			&entry->buf.rmnet_nl_msg_s_val, ep_id, dev_name,
+			error_code);
+	if (return_code == RMNETCTL_SUCCESS)
+		batch->count++;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_unset_logical_ep_config(rmnetctl_hndl_t *hndl,
-				  int32_t ep_id,
-				  const char *dev_name,
-				  uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
-	size_t str_len = 0;
+int rmnet_batch_new_vnd_prefix(rmnetctl_batch_t *batch,
+			       uint32_t id,
+			       uint16_t *error_code,
+			       uint8_t new_vnd,
+			       const char *prefix)
+{
+	struct rmnetctl_batch_entry_s *entry;
 	int return_code = RMNETCTL_LIB_ERR;
 	do {
-
-	if ((!hndl) || ((ep_id < -1) || (ep_id > 31)) || (!error_code) ||
-		_rmnetctl_check_dev_name(dev_name)) {
+	if ((!batch) || (!error_code)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_UNSET_LOGICAL_EP_CONFIG;
-
-	request.arg_length = RMNET_MAX_STR_LEN + sizeof(int32_t);
-	str_len = strlcpy((char *)(request.local_ep_config.dev),
-			  dev_name,
-			  RMNET_MAX_STR_LEN);
-
-	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	request.local_ep_config.ep_id = ep_id;
+	return_code = _rmnetctl_fill_new_vnd_prefix(
+			&entry->buf.rmnet_nl_msg_s_val, id, new_vnd, prefix,
+			error_code);
+	if (return_code == RMNETCTL_SUCCESS)
+		batch->count++;
+	} while(0);
+	return return_code;
+}
 
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
+int rmnet_batch_new_vnd(rmnetctl_batch_t *batch,
+			uint32_t id,
+			uint16_t *error_code,
+			uint8_t new_vnd)
+{
+	return rmnet_batch_new_vnd_prefix(batch, id, error_code, new_vnd, 0);
+}
+
+int rmnet_batch_add_del_vnd_tc_flow(rmnetctl_batch_t *batch,
+				    uint32_t id,
+				    uint32_t map_flow_id,
+				    uint32_t tc_flow_id,
+				    uint8_t set_flow,
+				    uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
 		break;
-	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
+	}
+
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	return_code = _rmnetctl_set_codes(response.return_code, error_code);
+	return_code = _rmnetctl_fill_add_del_vnd_tc_flow(
+			&entry->buf.rmnet_nl_msg_s_val, id, map_flow_id,
+			tc_flow_id, set_flow);
+	if (return_code == RMNETCTL_SUCCESS)
+		batch->count++;
 	} while(0);
-
 	return return_code;
 }
 
-int rmnet_get_logical_ep_config(rmnetctl_hndl_t *hndl,
-				int32_t ep_id,
-				const char *dev_name,
-				uint8_t *operating_mode,
-				char **next_dev,
-				uint32_t next_dev_len,
-				uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
-	size_t str_len = 0;
+int rmnet_batch_get_network_device_associated(rmnetctl_batch_t *batch,
+					      const char *dev_name,
+					      int *register_status,
+					      uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
 	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!operating_mode) || (!error_code) || ((ep_id < -1) ||
-	    (ep_id > 31)) || _rmnetctl_check_dev_name(dev_name) || (!next_dev)
-	    || (0 == next_dev_len)) {
+	if ((!batch) || (!register_status) || (!error_code)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_GET_LOGICAL_EP_CONFIG;
-
-	request.arg_length = RMNET_MAX_STR_LEN + sizeof(int32_t);
-	str_len = strlcpy((char *)(request.local_ep_config.dev),
-			  dev_name,
-			  RMNET_MAX_STR_LEN);
-	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	request.local_ep_config.ep_id = ep_id;
-
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
+	return_code = _rmnetctl_fill_get_network_device_associated(
+			&entry->buf.rmnet_nl_msg_s_val, dev_name, error_code);
+	if (return_code != RMNETCTL_SUCCESS)
 		break;
+	entry->out.register_status = register_status;
+	batch->count++;
+	} while(0);
+	return return_code;
+}
 
-	if (_rmnetctl_check_data(response.crd, error_code)
-		!= RMNETCTL_SUCCESS) {
-		if (_rmnetctl_check_code(response.crd, error_code)
-			== RMNETCTL_SUCCESS)
-			return_code = _rmnetctl_set_codes(response.return_code,
-							  error_code);
+int rmnet_batch_get_link_egress_data_format(rmnetctl_batch_t *batch,
+					    const char *dev_name,
+					    uint32_t *egress_flags,
+					    uint16_t *agg_size,
+					    uint16_t *agg_count,
+					    uint16_t *error_code)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!egress_flags) || (!agg_size) || (!agg_count) ||
+	    (!error_code)) {
+		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	str_len = strlcpy(*next_dev,
-			  (char *)(response.local_ep_config.next_dev),
-			  min(RMNET_MAX_STR_LEN, next_dev_len));
-	if (_rmnetctl_check_len(str_len, error_code) != RMNETCTL_SUCCESS)
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	*operating_mode = response.local_ep_config.operating_mode;
-	return_code = RMNETCTL_SUCCESS;
+	return_code = _rmnetctl_fill_get_link_data_format(
+			&entry->buf.rmnet_nl_msg_s_val,
+			RMNET_NETLINK_GET_LINK_EGRESS_DATA_FORMAT, dev_name,
+			error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+	entry->out.data_format.flags = egress_flags;
+	entry->out.data_format.agg_size = agg_size;
+	entry->out.data_format.agg_count = agg_count;
+	batch->count++;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_new_vnd_prefix(rmnetctl_hndl_t *hndl,
-			 uint32_t id,
-			 uint16_t *error_code,
-			 uint8_t new_vnd,
-			 const char *prefix)
+int rmnet_batch_get_link_ingress_data_format_tailspace(
+						rmnetctl_batch_t *batch,
+						const char *dev_name,
+						uint32_t *ingress_flags,
+						uint8_t  *tail_spacing,
+						uint16_t *error_code)
 {
-	struct rmnet_nl_msg_s request, response;
+	struct rmnetctl_batch_entry_s *entry;
 	int return_code = RMNETCTL_LIB_ERR;
-	size_t str_len = 0;
 	do {
-	if ((!hndl) || (!error_code) ||
-	((new_vnd != RMNETCTL_NEW_VND) && (new_vnd != RMNETCTL_FREE_VND))) {
+	if ((!batch) || (!error_code)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	memset(request.vnd.vnd_name, 0, RMNET_MAX_STR_LEN);
-	if (new_vnd ==  RMNETCTL_NEW_VND) {
-		if (prefix) {
-			request.message_type =RMNET_NETLINK_NEW_VND_WITH_PREFIX;
-			str_len = strlcpy((char *)request.vnd.vnd_name,
-					  prefix, RMNET_MAX_STR_LEN);
-			if (_rmnetctl_check_len(str_len, error_code)
-						!= RMNETCTL_SUCCESS)
-				break;
-		} else {
-			request.message_type = RMNET_NETLINK_NEW_VND;
-		}
-	} else {
-		request.message_type = RMNET_NETLINK_FREE_VND;
-	}
-
-	request.arg_length = sizeof(uint32_t);
-	request.vnd.id = id;
-
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
-		break;
-	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
 
-	return_code = _rmnetctl_set_codes(response.return_code, error_code);
+	return_code = _rmnetctl_fill_get_link_data_format(
+			&entry->buf.rmnet_nl_msg_s_val,
+			RMNET_NETLINK_GET_LINK_INGRESS_DATA_FORMAT, dev_name,
+			error_code);
+	if (return_code != RMNETCTL_SUCCESS)
+		break;
+	entry->out.data_format.flags = ingress_flags;
+	entry->out.data_format.tail_spacing = tail_spacing;
+	batch->count++;
 	} while(0);
 	return return_code;
 }
 
-int rmnet_new_vnd(rmnetctl_hndl_t *hndl,
-		  uint32_t id,
-		  uint16_t *error_code,
-		  uint8_t new_vnd)
-{
-	return rmnet_new_vnd_prefix(hndl, id, error_code, new_vnd, 0);
-}
-
-int rmnet_get_vnd_name(rmnetctl_hndl_t *hndl,
-		       uint32_t id,
-		       uint16_t *error_code,
-		       char *buf,
-		       uint32_t buflen)
+int rmnet_batch_get_logical_ep_config(rmnetctl_batch_t *batch,
+				      int32_t ep_id,
+				      const char *dev_name,
+				      uint8_t *operating_mode,
+				      char *next_dev,
+				      uint32_t next_dev_len,
+				      uint16_t *error_code)
 {
-	struct rmnet_nl_msg_s request, response;
-	uint32_t str_len;
+	struct rmnetctl_batch_entry_s *entry;
 	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!error_code) || (!buf) || (0 == buflen)) {
+	if ((!batch) || (!operating_mode) || (!next_dev) ||
+	    (0 == next_dev_len) || (!error_code)) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	request.message_type = RMNET_NETLINK_GET_VND_NAME;
-	request.arg_length = sizeof(uint32_t);
-	request.vnd.id = id;
-
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
+		break;
 
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-		!= RMNETCTL_SUCCESS)
+	return_code = _rmnetctl_fill_get_logical_ep_config(
+			&entry->buf.rmnet_nl_msg_s_val, ep_id, dev_name,
+			error_code);
+	if (return_code != RMNETCTL_SUCCESS)
 		break;
+	entry->out.local_ep_config.operating_mode = operating_mode;
+	entry->out.local_ep_config.next_dev = next_dev;
+	entry->out.local_ep_config.next_dev_len = next_dev_len;
+	batch->count++;
+	} while(0);
+	return return_code;
+}
 
-	if (_rmnetctl_check_data(response.crd, error_code)
-		!= RMNETCTL_SUCCESS) {
-		if (_rmnetctl_check_code(response.crd, error_code)
-			== RMNETCTL_SUCCESS)
-			return_code = _rmnetctl_set_codes(response.return_code,
-							  error_code);
+int rmnet_batch_get_vnd_name(rmnetctl_batch_t *batch,
+			     uint32_t id,
+			     uint16_t *error_code,
+			     char *buf,
+			     uint32_t buflen)
+{
+	struct rmnetctl_batch_entry_s *entry;
+	int return_code = RMNETCTL_LIB_ERR;
+	do {
+	if ((!batch) || (!error_code) || (!buf) || (0 == buflen)) {
+		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
 
-	str_len = (uint32_t)strlcpy(buf,
-			  (char *)(response.vnd.vnd_name),
-			  buflen);
-	if (str_len >= buflen) {
-		*error_code = RMNETCTL_API_ERR_STRING_TRUNCATION;
+	if (!(entry = _rmnetctl_batch_next(batch, error_code)))
 		break;
-	}
 
+	_rmnetctl_fill_get_vnd_name(&entry->buf.rmnet_nl_msg_s_val, id);
+	entry->out.vnd.buf = buf;
+	entry->out.vnd.buflen = buflen;
+	batch->count++;
 	return_code = RMNETCTL_SUCCESS;
-	} while (0);
+	} while(0);
 	return return_code;
 }
 
-int rmnet_add_del_vnd_tc_flow(rmnetctl_hndl_t *hndl,
-			      uint32_t id,
-			      uint32_t map_flow_id,
-			      uint32_t tc_flow_id,
-			      uint8_t set_flow,
-			      uint16_t *error_code) {
-	struct rmnet_nl_msg_s request, response;
+/*===========================================================================
+			ASYNCHRONOUS REQUESTS
+===========================================================================*/
+
+int rmnetctl_batch_commit_async(rmnetctl_batch_t *batch,
+				uint32_t timeout_ms,
+				rmnetctl_async_cb_t cb,
+				void *user_data,
+				uint32_t *token,
+				uint16_t *error_code)
+{
+	rmnetctl_hndl_t *hndl;
+	rmnetctl_batch_t **link;
+	struct rmnetctl_batch_entry_s *entry;
+	uint64_t now_ms;
+	uint32_t i;
 	int return_code = RMNETCTL_LIB_ERR;
 	do {
-	if ((!hndl) || (!error_code) || ((set_flow != RMNETCTL_ADD_FLOW) &&
-	    (set_flow != RMNETCTL_DEL_FLOW))) {
+	if ((!batch) || (!cb) || (!token) || (!error_code) ||
+	    (0 == timeout_ms) || (0 == batch->count) || batch->in_flight) {
 		return_code = RMNETCTL_INVALID_ARG;
 		break;
 	}
-	if (set_flow ==  RMNETCTL_ADD_FLOW)
-		request.message_type = RMNET_NETLINK_ADD_VND_TC_FLOW;
-	else
-		request.message_type = RMNET_NETLINK_DEL_VND_TC_FLOW;
+	hndl = batch->hndl;
 
-	request.arg_length = (sizeof(uint32_t))*3;
-	request.flow_control.id = id;
-	request.flow_control.map_flow_id = map_flow_id;
-	request.flow_control.tc_flow_id = tc_flow_id;
-
-	if ((*error_code = rmnetctl_transact(hndl, &request, &response))
-	!= RMNETCTL_SUCCESS)
-		break;
-	if (_rmnetctl_check_code(response.crd, error_code) != RMNETCTL_SUCCESS)
+	for (i = 0; i < batch->count; i++) {
+		entry = &batch->entries[i];
+		entry->pending.answered = 0;
+		entry->return_code = RMNETCTL_LIB_ERR;
+		entry->error_code = RMNETCTL_API_ERR_MESSAGE_SEND;
+	}
+	batch->cb = cb;
+	batch->user_data = user_data;
+	batch->first = 0;
+	batch->sent = 0;
+	batch->remaining = 0;
+	batch->async_error = RMNETCTL_API_SUCCESS;
+	now_ms = _rmnetctl_now_ms();
+	/* now_ms is truncated, never fail before timeout_ms went by */
+	batch->deadline_ms = now_ms + timeout_ms + 1;
+
+	pthread_mutex_lock(&hndl->lock);
+	_rmnetctl_async_advance(batch, now_ms);
+	if (!batch->sent) {
+		pthread_mutex_unlock(&hndl->lock);
+		*error_code = RMNETCTL_API_ERR_MESSAGE_SEND;
 		break;
-	return_code = _rmnetctl_set_codes(response.return_code, error_code);
+	}
+	if (!++hndl->async_token)
+		++hndl->async_token;
+	batch->token = hndl->async_token;
+	batch->in_flight = 1;
+	for (link = &hndl->async_head; *link; link = &(*link)->next_async)
+		;
+	*link = batch;
+	batch->next_async = NULL;
+	pthread_mutex_unlock(&hndl->lock);
+
+	*token = batch->token;
+	return_code = RMNETCTL_SUCCESS;
 	} while(0);
 	return return_code;
 }
 
+int rmnetctl_async_process(rmnetctl_hndl_t *hndl, uint16_t *error_code)
+{
+	rmnetctl_batch_t *batch, *done = NULL, **link, **done_tail = &done;
+	struct rmnetctl_batch_entry_s *entry;
+	uint64_t now_ms;
+	uint32_t i;
+	uint16_t status;
+	eventfd_t wakes;
+	int rc, recv_errno, return_code = RMNETCTL_SUCCESS;
+
+	if ((!hndl) || (!error_code))
+		return RMNETCTL_INVALID_ARG;
+
+	pthread_mutex_lock(&hndl->lock);
+	/* the commits a blocking caller completed are picked up below */
+	if (hndl->wake_fd >= 0)
+		eventfd_read(hndl->wake_fd, &wakes);
+	/* a blocking call holding the reader role receives for everyone and
+	 * moves the commits along itself */
+	while (!hndl->reading) {
+		hndl->reading = 1;
+		pthread_mutex_unlock(&hndl->lock);
+		rc = _rmnetctl_recv(hndl, MSG_DONTWAIT);
+		recv_errno = errno;
+		pthread_mutex_lock(&hndl->lock);
+		hndl->reading = 0;
+
+		for (i = 0; (int)i < rc; i++)
+			_rmnetctl_dispatch(hndl, &hndl->recv_buf[i],
+					   hndl->recv_msg[i].msg_len);
+		pthread_cond_broadcast(&hndl->answered);
+
+		if ((rc < 0) && (recv_errno != EAGAIN) &&
+		    (recv_errno != EWOULDBLOCK)) {
+			*error_code = RMNETCTL_API_ERR_MESSAGE_RECEIVE;
+			return_code = RMNETCTL_LIB_ERR;
+		}
+		if (rc < RMNETCTL_RECV_WINDOW)
+			break;
+	}
+
+	now_ms = _rmnetctl_now_ms();
+	link = &hndl->async_head;
+	while ((batch = *link)) {
+		if (!_rmnetctl_async_advance(batch, now_ms)) {
+			link = &batch->next_async;
+			continue;
+		}
+		*link = batch->next_async;
+		batch->next_async = NULL;
+		batch->in_flight = 0;
+		*done_tail = batch;
+		done_tail = &batch->next_async;
+	}
+	pthread_mutex_unlock(&hndl->lock);
+
+	/* in commit order, the callback may free or commit the batch again */
+	while ((batch = done)) {
+		done = batch->next_async;
+		batch->next_async = NULL;
+		rc = RMNETCTL_SUCCESS;
+		status = batch->async_error;
+		if (status != RMNETCTL_API_SUCCESS)
+			rc = RMNETCTL_LIB_ERR;
+		for (i = 0; (rc == RMNETCTL_SUCCESS) && (i < batch->count);
+		     i++) {
+			entry = &batch->entries[i];
+			rc = entry->return_code;
+			status = entry->error_code;
+		}
+		batch->cb(batch, batch->token, rc, status, batch->user_data);
+	}
+	return return_code;
+}
+
+int rmnetctl_async_timeout(rmnetctl_hndl_t *hndl)
+{
+	rmnetctl_batch_t *batch;
+	uint64_t deadline_ms = 0, now_ms;
+	if (!hndl)
+		return -1;
+
+	pthread_mutex_lock(&hndl->lock);
+	for (batch = hndl->async_head; batch; batch = batch->next_async)
+		if ((!deadline_ms) || (batch->deadline_ms < deadline_ms))
+			deadline_ms = batch->deadline_ms;
+	pthread_mutex_unlock(&hndl->lock);
+
+	if (!deadline_ms)
+		return -1;
+	now_ms = _rmnetctl_now_ms();
+	if (deadline_ms <= now_ms)
+		return 0;
+	return (int)min(deadline_ms - now_ms, (uint64_t)INT32_MAX);
+}
@@ -0,0 +1,650 @@
+/******************************************************************************
+			S O C K E V _ C L I . C
+Copyright (c) 2013, The Linux Foundation. All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above
+	  copyright notice, this list of conditions and the following
+	  disclaimer in the documentation and/or other materials provided
+	  with the distribution.
+	* Neither the name of The Linux Foundation nor the names of its
+	  contributors may be used to endorse or promote products derived
+	  from this software without specific prior written permission.
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/******************************************************************************
+  @file    sockev_cli.c
+  @brief   collector of sockev netlink messages.
+
+  DESCRIPTION
+  Keeps up with socket churn of thousands of events per second: messages
+  are drained in batches by libsockev, the receive buffer is raised, and
+  what the kernel could not queue (ENOBUFS) is counted instead of silently
+  lost. Events are aggregated per pid and protocol and printed as periodic
+  summaries, and can be written to a binary log of fixed size records.
+  A filter expression keeps the other events in the kernel. With -t,
+  socket lifecycles are tracked too: creates, connects and shutdowns are
+  paired into lifetime, connect delay and inter-arrival histograms and the
+  apps with the most churn, which -o appends to a file as JSON lines.
+
+  usage: sockev [-i interval] [-n rows] [-b rcvbuf] [-w log] [-e] [-d]
+                [-t] [-o export] [-x stale] [expression]
+    -i  seconds between summaries, 0 for one summary at exit (default 10)
+    -n  pid/protocol rows of each summary (default 10)
+    -b  receive buffer size in bytes (default 4194304)
+    -w  append every event to log, as struct sockev_log_record_s
+    -e  also print every event as one line of text
+    -d  print the BPF program of expression and exit
+    -t  track socket lifecycles, see sockev_tracker_init()
+    -o  append one JSON object per summary to export, implies -t
+    -x  seconds after which a tracked app with no event is forgotten
+        (default 300)
+    expression  events to receive, see sockev_filter_compile(), such as
+                "tcp and (event connect or event shutdown)"
+******************************************************************************/
+
+#include <sys/socket.h>
+#include <linux/sockev.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include "libsockev.h"
+
+#define SOCKEVCLI_ERROR -1
+
+#define SOCKEV_RCVBUF_DEFAULT (4 << 20)
+#define SOCKEV_INTERVAL_DEFAULT 10
+#define SOCKEV_ROWS_DEFAULT 10
+/* slots of the pid/protocol table, a power of 2 */
+#define SOCKEV_TABLE_SIZE 4096
+#define SOCKEV_TABLE_MAX_USED (SOCKEV_TABLE_SIZE / 4 * 3)
+#define SOCKEV_LOG_MAGIC "SKEV"
+#define SOCKEV_LOG_VERSION 1
+/* event of a log record: events were lost before the next record */
+#define SOCKEV_EV_OVERRUN 0xFF
+#define SOCKEV_EXPR_LEN 512
+/* apps a tracker follows at once */
+#define SOCKEV_TRACK_APPS 4096
+#define SOCKEV_STALE_DEFAULT 300
+
+/*!
+* @brief Start of a log written with -w, in host byte order. The records
+* that follow are timed on CLOCK_MONOTONIC, start_realtime_ns places them
+* on the wall clock.
+*/
+struct sockev_log_header_s {
+	char magic[4];
+	uint16_t version;
+	uint16_t record_len;
+	uint64_t start_realtime_ns;
+	uint64_t start_monotonic_ns;
+};
+
+/*!
+* @brief One event of the log. An overrun record has event
+* SOCKEV_EV_OVERRUN and the number of ENOBUFS reports in pid.
+*/
+struct sockev_log_record_s {
+	uint64_t time_ns;
+	uint64_t skflags;
+	uint32_t pid;
+	uint16_t skfamily;
+	uint16_t sktype;
+	uint8_t event;
+	uint8_t skstate;
+	uint8_t skprotocol;
+	uint8_t reserved[5];
+};
+
+/* Counters of one pid and protocol, free if total is 0 */
+struct sockev_entry_s {
+	uint32_t pid;
+	uint16_t skfamily;
+	uint16_t sktype;
+	uint8_t skprotocol;
+	uint32_t total;
+	uint32_t count[SOCKEV_EV_MAX];
+};
+
+/* State of the collector, counters are since the last summary */
+struct sockev_s {
+	sockev_hndl_t *hndl;
+	struct sockev_entry_s *table;
+	uint32_t used;
+	/* events that found the table full */
+	uint32_t untracked;
+	uint64_t events;
+	uint64_t overruns;
+	uint64_t malformed;
+	uint64_t last_malformed;
+	uint64_t total_events;
+	uint64_t total_overruns;
+	uint64_t interval_start_ns;
+	FILE *log;
+	sockev_tracker_t *tracker;
+	FILE *export;
+	int print_events;
+	int rows;
+};
+
+static volatile sig_atomic_t sockev_stop;
+
+static void sockev_on_signal(int sig)
+{
+	(void)sig;
+	sockev_stop = 1;
+}
+
+static uint64_t sockev_now_ns(clockid_t clock)
+{
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*===========================================================================
+			 AGGREGATION
+===========================================================================*/
+
+static uint32_t sockev_hash(const struct sknlsockevmsg *msg)
+{
+	uint32_t h = msg->pid * 0x9E3779B1u;
+	h ^= ((uint32_t)msg->skfamily << 16 | (uint32_t)msg->sktype << 8 |
+	      msg->skprotocol) * 0x85EBCA6Bu;
+	return h ^ (h >> 15);
+}
+
+/*!
+* @brief Counter of the pid and protocol of msg, by linear probing
+* @return NULL if the table is full
+*/
+static struct sockev_entry_s *sockev_entry(struct sockev_s *sockev,
+					   const struct sknlsockevmsg *msg)
+{
+	uint32_t slot = sockev_hash(msg) & (SOCKEV_TABLE_SIZE - 1);
+	struct sockev_entry_s *entry;
+
+	for (;; slot = (slot + 1) & (SOCKEV_TABLE_SIZE - 1)) {
+		entry = &sockev->table[slot];
+		if (!entry->total)
+			break;
+		if (entry->pid == msg->pid && entry->skfamily == msg->skfamily &&
+		    entry->sktype == msg->sktype &&
+		    entry->skprotocol == msg->skprotocol)
+			return entry;
+	}
+	if (sockev->used == SOCKEV_TABLE_MAX_USED)
+		return NULL;
+	sockev->used++;
+	entry->pid = msg->pid;
+	entry->skfamily = msg->skfamily;
+	entry->sktype = msg->sktype;
+	entry->skprotocol = msg->skprotocol;
+	return entry;
+}
+
+static void sockev_log_write(struct sockev_s *sockev,
+			     const struct sockev_log_record_s *record)
+{
+	if (sockev->log && fwrite(record, sizeof(*record), 1, sockev->log) != 1) {
+		fprintf(stderr, "sockev: log write failed, logging stopped\n");
+		fclose(sockev->log);
+		sockev->log = NULL;
+	}
+}
+
+/* sockev_event_cb_t of the collector */
+static void sockev_count(const struct sknlsockevmsg *msg, uint8_t event,
+			 uint64_t time_ns, void *user_data)
+{
+	struct sockev_s *sockev = (struct sockev_s *)user_data;
+	struct sockev_log_record_s record;
+	struct sockev_entry_s *entry;
+
+	sockev->events++;
+	entry = sockev_entry(sockev, msg);
+	if (entry) {
+		entry->total++;
+		entry->count[event]++;
+	} else {
+		sockev->untracked++;
+	}
+	if (sockev->tracker)
+		sockev_tracker_event(sockev->tracker, msg, event, time_ns);
+
+	if (sockev->log) {
+		memset(&record, 0, sizeof(record));
+		record.time_ns = time_ns;
+		record.skflags = msg->skflags;
+		record.pid = msg->pid;
+		record.skfamily = msg->skfamily;
+		record.sktype = msg->sktype;
+		record.event = event;
+		record.skstate = msg->skstate;
+		record.skprotocol = msg->skprotocol;
+		sockev_log_write(sockev, &record);
+	}
+	if (sockev->print_events)
+		printf("%s pid %u family 0x%04X type 0x%04X protocol %u "
+		       "state %u flags 0x%016llX\n", sockev_event_name(event),
+		       msg->pid, msg->skfamily, msg->sktype, msg->skprotocol,
+		       msg->skstate, (unsigned long long)msg->skflags);
+}
+
+static void sockev_overrun(struct sockev_s *sockev, uint64_t time_ns)
+{
+	struct sockev_log_record_s record;
+
+	sockev->overruns++;
+	memset(&record, 0, sizeof(record));
+	record.time_ns = time_ns;
+	record.pid = 1;
+	record.event = SOCKEV_EV_OVERRUN;
+	sockev_log_write(sockev, &record);
+}
+
+/*===========================================================================
+			 LIFECYCLE TRACKING
+===========================================================================*/
+
+static void sockev_hist_print(const char *name,
+			      const struct sockev_hist_s *hist)
+{
+	if (!hist->count)
+		return;
+	printf("%-13s %8llu  avg %9llu us  p50 <%9llu us  p90 <%9llu us  "
+	       "p99 <%9llu us\n", name, (unsigned long long)hist->count,
+	       (unsigned long long)(hist->sum_us / hist->count),
+	       (unsigned long long)sockev_hist_percentile(hist, 50),
+	       (unsigned long long)sockev_hist_percentile(hist, 90),
+	       (unsigned long long)sockev_hist_percentile(hist, 99));
+}
+
+static void sockev_hist_export(FILE *export, const char *name,
+			       const struct sockev_hist_s *hist)
+{
+	int i, last = -1;
+
+	for (i = 0; i < SOCKEV_HIST_BUCKETS; i++)
+		if (hist->buckets[i])
+			last = i;
+	/* buckets past the last used one are left out */
+	fprintf(export, ",\"%s\":{\"count\":%llu,\"sum_us\":%llu,"
+		"\"buckets\":[", name, (unsigned long long)hist->count,
+		(unsigned long long)hist->sum_us);
+	for (i = 0; i <= last; i++)
+		fprintf(export, "%s%llu", i ? "," : "",
+			(unsigned long long)hist->buckets[i]);
+	fprintf(export, "]}");
+}
+
+/*!
+* @brief Appends a report to the export file as one line of JSON
+* @details Times are CLOCK_MONOTONIC ns, bucket i of a histogram holds
+* the durations of [2^i, 2^(i+1)) us and bucket 0 those under 2 us.
+*/
+static void sockev_track_export(struct sockev_s *sockev,
+				const struct sockev_track_report_s *report)
+{
+	const struct sockev_track_app_s *app;
+	uint32_t i;
+
+	fprintf(sockev->export, "{\"start_ns\":%llu,\"end_ns\":%llu,"
+		"\"events\":%llu,\"apps\":%u,\"evicted\":%u,"
+		"\"untracked\":%u,\"unpaired\":%u",
+		(unsigned long long)report->start_ns,
+		(unsigned long long)report->end_ns,
+		(unsigned long long)report->events, report->apps,
+		report->evicted, report->untracked, report->unpaired);
+	sockev_hist_export(sockev->export, "lifetime_us", &report->lifetime);
+	sockev_hist_export(sockev->export, "connect_delay_us",
+			   &report->connect_delay);
+	sockev_hist_export(sockev->export, "interarrival_us",
+			   &report->interarrival);
+	fprintf(sockev->export, ",\"top\":[");
+	for (i = 0; i < report->num_top; i++) {
+		app = &report->top[i];
+		fprintf(sockev->export, "%s{\"pid\":%u,\"family\":%u,"
+			"\"type\":%u,\"protocol\":%u,\"created\":%u,"
+			"\"connected\":%u,\"shut_down\":%u,\"open\":%u}",
+			i ? "," : "", app->pid, app->skfamily, app->sktype,
+			app->skprotocol, app->created, app->connected,
+			app->shut_down, app->open);
+	}
+	fprintf(sockev->export, "]}\n");
+	if (fflush(sockev->export) != 0) {
+		fprintf(stderr, "sockev: export failed, exporting stopped\n");
+		fclose(sockev->export);
+		sockev->export = NULL;
+	}
+}
+
+/*!
+* @brief Prints the histograms and the churners of the tracker since the
+* last summary, and exports them
+*/
+static void sockev_track_summary(struct sockev_s *sockev, uint64_t now_ns)
+{
+	struct sockev_track_report_s report;
+	const struct sockev_track_app_s *app;
+	uint32_t i;
+
+	sockev_tracker_report(sockev->tracker, now_ns, sockev->rows > 0 ?
+			      (uint32_t)sockev->rows : 0, &report);
+	printf("tracking %u apps, %u evicted, %u untracked events, "
+	       "%u unpaired\n", report.apps, report.evicted,
+	       report.untracked, report.unpaired);
+	sockev_hist_print("lifetime", &report.lifetime);
+	sockev_hist_print("connect delay", &report.connect_delay);
+	sockev_hist_print("interarrival", &report.interarrival);
+	if (report.num_top)
+		printf("%8s %6s %6s %5s %8s %9s %8s %5s\n", "pid", "family",
+		       "type", "proto", "created", "connected", "shutdown",
+		       "open");
+	for (i = 0; i < report.num_top; i++) {
+		app = &report.top[i];
+		printf("%8u %6u %6u %5u %8u %9u %8u %5u\n", app->pid,
+		       app->skfamily, app->sktype, app->skprotocol,
+		       app->created, app->connected, app->shut_down,
+		       app->open);
+	}
+	if (sockev->export)
+		sockev_track_export(sockev, &report);
+}
+
+static int sockev_compare_entries(const void *a, const void *b)
+{
+	const struct sockev_entry_s *x = *(const struct sockev_entry_s **)a;
+	const struct sockev_entry_s *y = *(const struct sockev_entry_s **)b;
+	return (x->total < y->total) - (x->total > y->total);
+}
+
+/*!
+* @brief Prints the counters since the last summary, busiest pid and
+* protocol first, and clears them
+*/
+static void sockev_summary(struct sockev_s *sockev, uint64_t now_ns)
+{
+	struct sockev_entry_s *rows[SOCKEV_TABLE_MAX_USED];
+	double seconds = (now_ns - sockev->interval_start_ns) / 1e9;
+	uint32_t i, n = 0;
+
+	sockev->total_events += sockev->events;
+	sockev->total_overruns += sockev->overruns;
+	sockev->malformed = sockev_get_malformed(sockev->hndl) -
+			    sockev->last_malformed;
+	sockev->last_malformed += sockev->malformed;
+	for (i = 0; i < SOCKEV_TABLE_SIZE; i++)
+		if (sockev->table[i].total)
+			rows[n++] = &sockev->table[i];
+	qsort(rows, n, sizeof(rows[0]), sockev_compare_entries);
+
+	printf("----------------------------\n");
+	printf("%.1f s: %llu events (%.0f/s), %llu overruns, %u pid/protocols"
+	       "\n", seconds, (unsigned long long)sockev->events,
+	       seconds > 0 ? sockev->events / seconds : 0.0,
+	       (unsigned long long)sockev->overruns, n);
+	if (sockev->untracked || sockev->malformed)
+		printf("%u events over the pid/protocol limit, %llu malformed\n",
+		       sockev->untracked, (unsigned long long)sockev->malformed);
+	if (n)
+		printf("%8s %6s %6s %5s %8s %7s %7s %7s %7s %7s %8s\n", "pid",
+		       "family", "type", "proto", "total", "socket", "bind",
+		       "listen", "accept", "connect", "shutdown");
+	for (i = 0; i < n && i < (uint32_t)sockev->rows; i++)
+		printf("%8u %6u %6u %5u %8u %7u %7u %7u %7u %7u %8u\n",
+		       rows[i]->pid, rows[i]->skfamily, rows[i]->sktype,
+		       rows[i]->skprotocol, rows[i]->total,
+		       rows[i]->count[SOCKEV_EV_SOCKET],
+		       rows[i]->count[SOCKEV_EV_BIND],
+		       rows[i]->count[SOCKEV_EV_LISTEN],
+		       rows[i]->count[SOCKEV_EV_ACCEPT],
+		       rows[i]->count[SOCKEV_EV_CONNECT],
+		       rows[i]->count[SOCKEV_EV_SHUTDOWN]);
+	if (sockev->tracker)
+		sockev_track_summary(sockev, now_ns);
+	fflush(stdout);
+	if (sockev->log)
+		fflush(sockev->log);
+
+	memset(sockev->table, 0, SOCKEV_TABLE_SIZE * sizeof(sockev->table[0]));
+	sockev->used = 0;
+	sockev->untracked = 0;
+	sockev->events = 0;
+	sockev->overruns = 0;
+	sockev->malformed = 0;
+	sockev->interval_start_ns = now_ns;
+}
+
+/*===========================================================================
+			 COLLECTION
+===========================================================================*/
+
+/*!
+* @brief Drains the socket until stopped or the socket goes away, with a
+* summary every interval seconds and at the end
+*/
+static int sockev_collect(struct sockev_s *sockev, int interval)
+{
+	struct pollfd pfd;
+	uint64_t now, next_summary = 0;
+	int n, timeout, rc = 0;
+
+	pfd.fd = sockev_get_fd(sockev->hndl);
+	pfd.events = POLLIN;
+	sockev->interval_start_ns = sockev_now_ns(CLOCK_MONOTONIC);
+	if (interval > 0)
+		next_summary = sockev->interval_start_ns +
+			       (uint64_t)interval * 1000000000ULL;
+
+	while (!sockev_stop) {
+		n = sockev_receive(sockev->hndl, sockev_count, sockev);
+		if (n > 0) {
+			/* a short batch emptied the queue */
+			if (n == SOCKEV_RECV_BATCH)
+				continue;
+		} else if (n == 0) {
+			/* the socket was shut down */
+			break;
+		} else if (errno == ENOBUFS) {
+			/* the kernel dropped events, the next ones are queued */
+			sockev_overrun(sockev, sockev_now_ns(CLOCK_MONOTONIC));
+			continue;
+		} else if (errno != EAGAIN && errno != EINTR) {
+			fprintf(stderr, "sockev: recvmmsg failed, %s\n",
+				strerror(errno));
+			rc = SOCKEVCLI_ERROR;
+			break;
+		}
+
+		now = sockev_now_ns(CLOCK_MONOTONIC);
+		if (next_summary && now >= next_summary) {
+			sockev_summary(sockev, now);
+			next_summary = now + (uint64_t)interval * 1000000000ULL;
+		}
+		timeout = next_summary ?
+			  (int)((next_summary - now + 999999) / 1000000) : -1;
+		if (poll(&pfd, 1, timeout) < 0 && errno != EINTR) {
+			rc = SOCKEVCLI_ERROR;
+			break;
+		}
+	}
+
+	sockev_summary(sockev, sockev_now_ns(CLOCK_MONOTONIC));
+	printf("total: %llu events, %llu overruns\n",
+	       (unsigned long long)sockev->total_events,
+	       (unsigned long long)sockev->total_overruns);
+	return rc;
+}
+
+static FILE *sockev_log_open(const char *path)
+{
+	struct sockev_log_header_s header;
+	FILE *log = fopen(path, "ab");
+
+	if (!log) {
+		fprintf(stderr, "sockev: could not open %s\n", path);
+		return NULL;
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SOCKEV_LOG_MAGIC, sizeof(header.magic));
+	header.version = SOCKEV_LOG_VERSION;
+	header.record_len = sizeof(struct sockev_log_record_s);
+	header.start_realtime_ns = sockev_now_ns(CLOCK_REALTIME);
+	header.start_monotonic_ns = sockev_now_ns(CLOCK_MONOTONIC);
+	/* records are written a stdio buffer at a time */
+	setvbuf(log, NULL, _IOFBF, 1 << 16);
+	if (fwrite(&header, sizeof(header), 1, log) != 1) {
+		fclose(log);
+		return NULL;
+	}
+	return log;
+}
+
+static void sockev_usage(void)
+{
+	fprintf(stderr, "usage: sockev [-i interval] [-n rows] [-b rcvbuf] "
+		"[-w log] [-e] [-d]\n"
+		"              [-t] [-o export] [-x stale] [expression]\n"
+		"  -i  seconds between summaries, 0 for one at exit (default "
+		"%d)\n"
+		"  -n  pid/protocol rows of each summary (default %d)\n"
+		"  -b  receive buffer size in bytes (default %d)\n"
+		"  -w  append every event to log as a binary record\n"
+		"  -e  also print every event\n"
+		"  -d  print the BPF program of expression and exit\n"
+		"  -t  track socket lifecycles\n"
+		"  -o  append tracking summaries to export as JSON lines, "
+		"implies -t\n"
+		"  -x  seconds after which an idle app is no longer tracked "
+		"(default %d)\n"
+		"  expression  events to receive, of the primitives\n"
+		"    pid <n>, event <socket|bind|listen|accept|connect|"
+		"shutdown>,\n"
+		"    family <inet|inet6|unix|netlink|n>, type <stream|dgram|"
+		"raw|seqpacket|n>,\n"
+		"    protocol <tcp|udp|icmp|icmpv6|n>, state <n>, tcp, udp\n"
+		"    with not, and, or and parentheses\n",
+		SOCKEV_INTERVAL_DEFAULT, SOCKEV_ROWS_DEFAULT,
+		SOCKEV_RCVBUF_DEFAULT, SOCKEV_STALE_DEFAULT);
+}
+
+int main(int argc, char *argv[])
+{
+	struct sockev_s sockev;
+	struct sockev_filter_s filter;
+	struct sigaction sa;
+	char expr[SOCKEV_EXPR_LEN] = "", error[128];
+	const char *log_path = NULL, *export_path = NULL;
+	int interval = SOCKEV_INTERVAL_DEFAULT;
+	int stale = SOCKEV_STALE_DEFAULT, track = 0;
+	int rcvbuf = SOCKEV_RCVBUF_DEFAULT;
+	int opt, rc, dump = 0;
+	size_t len;
+
+	memset(&sockev, 0, sizeof(sockev));
+	sockev.rows = SOCKEV_ROWS_DEFAULT;
+	optind = 1;
+	while ((opt = getopt(argc, argv, "i:n:b:w:edto:x:")) != -1) {
+		switch (opt) {
+		case 'i': interval = atoi(optarg); break;
+		case 'n': sockev.rows = atoi(optarg); break;
+		case 'b': rcvbuf = atoi(optarg); break;
+		case 'w': log_path = optarg; break;
+		case 'e': sockev.print_events = 1; break;
+		case 'd': dump = 1; break;
+		case 't': track = 1; break;
+		case 'o': export_path = optarg; track = 1; break;
+		case 'x': stale = atoi(optarg); break;
+		default:
+			sockev_usage();
+			return SOCKEVCLI_ERROR;
+		}
+	}
+
+	/* the expression may come as one argument or as many words */
+	for (; optind < argc; optind++) {
+		len = strlen(expr);
+		snprintf(expr + len, sizeof(expr) - len, "%s%s",
+			 len ? " " : "", argv[optind]);
+	}
+	if (expr[0] &&
+	    sockev_filter_compile(&filter, expr, error, sizeof(error)) < 0) {
+		fprintf(stderr, "sockev: %s\n", error);
+		return SOCKEVCLI_ERROR;
+	}
+	if (dump) {
+		sockev_filter_dump(expr[0] ? &filter : NULL, stdout);
+		return 0;
+	}
+
+	/* no SA_RESTART, so that a signal wakes poll() */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sockev_on_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	sockev_stop = 0;
+
+	sockev.table = (struct sockev_entry_s *)
+		calloc(SOCKEV_TABLE_SIZE, sizeof(struct sockev_entry_s));
+	if (!sockev.table) {
+		fprintf(stderr, "malloc() failed\n");
+		return SOCKEVCLI_ERROR;
+	}
+	if (log_path && !(sockev.log = sockev_log_open(log_path))) {
+		free(sockev.table);
+		return SOCKEVCLI_ERROR;
+	}
+	if (track && sockev_tracker_init(&sockev.tracker, SOCKEV_TRACK_APPS,
+					 stale > 0 ? (uint32_t)stale : 0) < 0) {
+		fprintf(stderr, "malloc() failed\n");
+		rc = SOCKEVCLI_ERROR;
+		goto cleanup;
+	}
+	if (export_path && !(sockev.export = fopen(export_path, "a"))) {
+		fprintf(stderr, "sockev: could not open %s\n", export_path);
+		rc = SOCKEVCLI_ERROR;
+		goto cleanup;
+	}
+	if (sockev_open(&sockev.hndl, rcvbuf, expr[0] ? &filter : NULL) < 0) {
+		fprintf(stderr, "sockev: could not open the socket, %s\n",
+			strerror(errno));
+		rc = SOCKEVCLI_ERROR;
+		goto cleanup;
+	}
+	printf("receive buffer %d bytes\n", sockev_get_rcvbuf(sockev.hndl));
+	if (expr[0])
+		printf("filter \"%s\", %u instructions\n", expr, filter.len);
+
+	rc = sockev_collect(&sockev, interval);
+
+	sockev_close(sockev.hndl);
+cleanup:
+	if (sockev.export)
+		fclose(sockev.export);
+	sockev_tracker_free(sockev.tracker);
+	if (sockev.log)
+		fclose(sockev.log);
+	free(sockev.table);
+	return rc;
+}
@@ -0,0 +1,293 @@
+/******************************************************************************
+
+			  L I B S O C K E V . H
+
+Copyright (c) 2016, The Linux Foundation. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above
+	  copyright notice, this list of conditions and the following
+	  disclaimer in the documentation and/or other materials provided
+	  with the distribution.
+	* Neither the name of The Linux Foundation nor the names of its
+	  contributors may be used to endorse or promote products derived
+	  from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************/
+
+/*!
+*  @file    libsockev.h
+*  @brief   socket event (NETLINK_SOCKEV) receiver API's header file
+*/
+
+#ifndef LIBSOCKEV_H
+#define LIBSOCKEV_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <linux/filter.h>
+#include <linux/sockev.h>
+
+/* Datagrams taken per sockev_receive() */
+#define SOCKEV_RECV_BATCH 64
+/* Instructions of the longest filter program */
+#define SOCKEV_FILTER_MAX_INSNS 128
+
+/* Events of the sockev messages, by their name in struct sknlsockevmsg */
+enum sockev_event_e {
+	SOCKEV_EV_SOCKET,
+	SOCKEV_EV_BIND,
+	SOCKEV_EV_LISTEN,
+	SOCKEV_EV_ACCEPT,
+	SOCKEV_EV_CONNECT,
+	SOCKEV_EV_SHUTDOWN,
+	SOCKEV_EV_UNKNOWN,
+	SOCKEV_EV_MAX
+};
+
+/*!
+* @brief Classic BPF program that keeps the sockev messages a filter
+* expression matches
+*/
+struct sockev_filter_s {
+	struct sock_filter insns[SOCKEV_FILTER_MAX_INSNS];
+	uint16_t len;
+};
+
+typedef struct sockev_hndl_s sockev_hndl_t;
+
+/* Buckets of a histogram: bucket 0 holds [0, 2) us, bucket i [2^i,
+ * 2^(i+1)) us, the last one everything longer */
+#define SOCKEV_HIST_BUCKETS 40
+/* Most apps in the top of a tracker report */
+#define SOCKEV_TRACK_MAX_TOP 32
+/* Sockets of an app a tracker remembers as open, oldest are forgotten */
+#define SOCKEV_TRACK_MAX_OPEN 8
+
+/*!
+* @brief Histogram of durations in microseconds, log2 bucketed
+*/
+struct sockev_hist_s {
+	uint64_t count;
+	uint64_t sum_us;
+	uint64_t buckets[SOCKEV_HIST_BUCKETS];
+};
+
+/*!
+* @brief Sockets of one kind of an app, as counted by a tracker
+* @var open Sockets created and not shut down, up to SOCKEV_TRACK_MAX_OPEN
+*/
+struct sockev_track_app_s {
+	uint32_t pid;
+	uint16_t skfamily;
+	uint16_t sktype;
+	uint8_t skprotocol;
+	uint32_t created;
+	uint32_t connected;
+	uint32_t shut_down;
+	uint32_t open;
+};
+
+/*!
+* @brief What a tracker saw between two reports
+* @var lifetime From the creation of a socket to its shutdown
+* @var connect_delay From the creation of a socket to its connect
+* @var interarrival Between two sockets created by the same app
+* @var apps Apps being tracked when the report was made
+* @var evicted Apps forgotten as stale, or to make room
+* @var untracked Events of apps there was no room for
+* @var unpaired Connects and shutdowns of sockets not seen created, and
+* open sockets forgotten for newer ones
+* @var top Apps that created and shut down the most sockets, busiest first
+*/
+struct sockev_track_report_s {
+	uint64_t start_ns;
+	uint64_t end_ns;
+	uint64_t events;
+	struct sockev_hist_s lifetime;
+	struct sockev_hist_s connect_delay;
+	struct sockev_hist_s interarrival;
+	uint32_t apps;
+	uint32_t evicted;
+	uint32_t untracked;
+	uint32_t unpaired;
+	uint32_t num_top;
+	struct sockev_track_app_s top[SOCKEV_TRACK_MAX_TOP];
+};
+
+typedef struct sockev_tracker_s sockev_tracker_t;
+
+/*!
+* @brief Called by sockev_receive() for every message received
+* @param msg Message as the kernel sent it
+* @param event Event of the message, one of enum sockev_event_e
+* @param time_ns CLOCK_MONOTONIC time the message was received at, the same
+* for all the messages of a batch
+* @param user_data As passed to sockev_receive()
+*/
+typedef void (*sockev_event_cb_t)(const struct sknlsockevmsg *msg,
+				  uint8_t event, uint64_t time_ns,
+				  void *user_data);
+
+/*===========================================================================
+			 FUNCTION DEFINITIONS
+===========================================================================*/
+
+/*!
+* @brief Event of a sockev message name, such as "SOCKEV_CONNECT"
+* @return One of enum sockev_event_e, SOCKEV_EV_UNKNOWN if name is none
+*/
+uint8_t sockev_event(const __u8 *name);
+
+/*!
+* @brief Name of an event, such as "SOCKEV_CONNECT"
+*/
+const char *sockev_event_name(uint8_t event);
+
+/*!
+* @brief Compiles a filter expression into a BPF program
+* @details An expression is made of the primitives
+*   pid <n>
+*   event socket|bind|listen|accept|connect|shutdown
+*   family inet|inet6|unix|netlink|<n>
+*   type stream|dgram|raw|seqpacket|<n>
+*   protocol tcp|udp|icmp|icmpv6|<n>      (or proto <n>)
+*   state <n>
+*   tcp, udp                               (for protocol tcp, udp)
+* combined with "not" ("!"), "and" ("&&"), "or" ("||") and parentheses.
+* "and" binds tighter than "or", as in "tcp and event connect or pid 1".
+* @param filter Program to compile into
+* @param expr Filter expression
+* @param error Buffer for a description of what is wrong with expr
+* @param error_len Length of error
+* @return 0 if compiled, -1 if expr is invalid or too long
+*/
+int sockev_filter_compile(struct sockev_filter_s *filter, const char *expr,
+			  char *error, size_t error_len);
+
+/*!
+* @brief Prints the instructions of a filter program, one per line
+*/
+void sockev_filter_dump(const struct sockev_filter_s *filter, FILE *out);
+
+/*!
+* @brief Opens a socket that receives the sockev multicast group
+* @details The receive buffer is raised to rcvbuf, past rmem_max if the
+* process has CAP_NET_ADMIN. Filter, if not NULL, is attached before the
+* socket joins the group, so no event it rejects is received.
+* @param hndl Set to the new handle
+* @param rcvbuf Receive buffer size in bytes, 0 to keep the default
+* @param filter Program of the events to receive, NULL for all of them
+* @return 0 on success, -1 with errno set on failure
+*/
+int sockev_open(sockev_hndl_t **hndl, int rcvbuf,
+		const struct sockev_filter_s *filter);
+
+/*!
+* @brief Replaces the filter of a socket
+* @param filter Program of the events to receive, NULL for all of them
+* @return 0 on success, -1 with errno set on failure
+*/
+int sockev_set_filter(sockev_hndl_t *hndl,
+		      const struct sockev_filter_s *filter);
+
+/*!
+* @brief File descriptor to poll for events
+*/
+int sockev_get_fd(const sockev_hndl_t *hndl);
+
+/*!
+* @brief Receive buffer size the kernel reports, which counts its overhead
+*/
+int sockev_get_rcvbuf(const sockev_hndl_t *hndl);
+
+/*!
+* @brief Number of datagrams dropped as truncated or too short so far
+*/
+uint64_t sockev_get_malformed(const sockev_hndl_t *hndl);
+
+/*!
+* @brief Takes up to SOCKEV_RECV_BATCH queued datagrams with one system
+* call, without blocking, and calls cb for every message in them
+* @return Number of datagrams received, 0 if the socket was shut down, -1
+* with errno EAGAIN if none is queued, ENOBUFS if the kernel dropped events
+* because the receive buffer was full (the ones after are still queued),
+* or any other errno of recvmmsg()
+*/
+int sockev_receive(sockev_hndl_t *hndl, sockev_event_cb_t cb,
+		   void *user_data);
+
+/*!
+* @brief Closes the socket and frees the handle
+*/
+void sockev_close(sockev_hndl_t *hndl);
+
+/*===========================================================================
+			 LIFECYCLE TRACKING
+===========================================================================*/
+
+/*!
+* @brief Creates a tracker of socket lifecycles
+* @details Events are paired per app, which is a pid and a socket family,
+* type and protocol: sockev messages do not tell sockets apart, so a
+* connect goes to the oldest socket of the app not connected yet and a
+* shutdown to the oldest one still open. The apps are kept in an open
+* addressed table of a fixed size; an app with no event for stale_s
+* seconds is forgotten at the next report, and sooner if the table is
+* full.
+* @param tracker Set to the new tracker
+* @param capacity Most apps tracked at once
+* @param stale_s Seconds without an event after which an app is forgotten
+* @return 0 on success, -1 with errno set on failure
+*/
+int sockev_tracker_init(sockev_tracker_t **tracker, uint32_t capacity,
+			uint32_t stale_s);
+
+/*!
+* @brief Counts one event, with the arguments of a sockev_event_cb_t
+*/
+void sockev_tracker_event(sockev_tracker_t *tracker,
+			  const struct sknlsockevmsg *msg, uint8_t event,
+			  uint64_t time_ns);
+
+/*!
+* @brief Reports what the tracker saw since the last report and starts
+* over, forgetting the apps that went stale
+* @param now_ns CLOCK_MONOTONIC time of the report
+* @param top_n Apps to put in the top, up to SOCKEV_TRACK_MAX_TOP
+*/
+void sockev_tracker_report(sockev_tracker_t *tracker, uint64_t now_ns,
+			   uint32_t top_n,
+			   struct sockev_track_report_s *report);
+
+/*!
+* @brief Upper bound of the bucket a percentile of a histogram falls in
+* @param pct Percentile, 0 to 100
+* @return Microseconds, 0 for an empty histogram
+*/
+uint64_t sockev_hist_percentile(const struct sockev_hist_s *hist,
+				uint32_t pct);
+
+/*!
+* @brief Frees a tracker
+*/
+void sockev_tracker_free(sockev_tracker_t *tracker);
+
+#endif /* not defined LIBSOCKEV_H */
@@ -1,15 +1,19 @@
 LOCAL_PATH := $(call my-dir)
 
 include $(CLEAR_VARS)
+LOCAL_COPY_HEADERS_TO   := dataservices/sockev
+LOCAL_COPY_HEADERS      := ../inc/libsockev.h
 
-LOCAL_SRC_FILES := sockev_cli.c
+LOCAL_SRC_FILES := libsockev.c libsockev_track.c
 LOCAL_CFLAGS := -Wall -Werror
 
-LOCAL_C_INCLUDES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../inc
+LOCAL_C_INCLUDES += $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
 LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
 
 LOCAL_CLANG := true
-LOCAL_MODULE := sockev
+LOCAL_MODULE := libsockev
 LOCAL_MODULE_TAGS := optional
+LOCAL_PRELINK_MODULE := false
 
-include $(BUILD_EXECUTABLE)
+include $(BUILD_SHARED_LIBRARY)
@@ -0,0 +1,714 @@
+/******************************************************************************
+
+			L I B S O C K E V . C
+
+Copyright (c) 2016, The Linux Foundation. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above
+	  copyright notice, this list of conditions and the following
+	  disclaimer in the documentation and/or other materials provided
+	  with the distribution.
+	* Neither the name of The Linux Foundation nor the names of its
+	  contributors may be used to endorse or promote products derived
+	  from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************/
+
+/*!
+* @file    libsockev.c
+* @brief   socket event (NETLINK_SOCKEV) receiver API's implementation file
+*/
+
+/*===========================================================================
+			INCLUDE FILES
+===========================================================================*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <linux/netlink.h>
+#include <linux/filter.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <linux/sockev.h>
+#include "libsockev.h"
+
+/* Buffer of one datagram, which holds one message */
+#define SOCKEV_BUF_LEN 1024
+#define SOCKEV_FILTER_MAX_NODES 64
+#define SOCKEV_FILTER_MAX_DEPTH 32
+#define SOCKEV_TOKEN_LEN 32
+/* what a BPF program returns to keep the whole message */
+#define SOCKEV_FILTER_ACCEPT 0xFFFF
+/* message fields, as the offset of a BPF load */
+#define SOCKEV_FIELD(f) (NLMSG_HDRLEN + offsetof(struct sknlsockevmsg, f))
+/* the first character of the event names that tells them apart */
+#define SOCKEV_EVENT_KEY_POS 7
+
+static const char *sockev_event_names[SOCKEV_EV_MAX] = {
+	"SOCKEV_SOCKET",
+	"SOCKEV_BIND",
+	"SOCKEV_LISTEN",
+	"SOCKEV_ACCEPT",
+	"SOCKEV_CONNECT",
+	"SOCKEV_SHUTDOWN",
+	"UNKNOWN"
+};
+
+/*!
+* @brief Socket of a sockev receiver and the buffers it receives into
+* @var fd Netlink socket
+* @var rcvbuf Receive buffer size reported by the kernel
+* @var malformed Datagrams dropped as truncated or too short
+* @var slab SOCKEV_RECV_BATCH buffers of SOCKEV_BUF_LEN bytes
+*/
+struct sockev_hndl_s {
+	int fd;
+	int rcvbuf;
+	uint64_t malformed;
+	uint8_t *slab;
+	struct iovec iov[SOCKEV_RECV_BATCH];
+	struct mmsghdr msgs[SOCKEV_RECV_BATCH];
+};
+
+/*===========================================================================
+			FILTER EXPRESSIONS
+===========================================================================*/
+
+enum sockev_node_type_e {
+	SOCKEV_NODE_MATCH,
+	SOCKEV_NODE_NOT,
+	SOCKEV_NODE_AND,
+	SOCKEV_NODE_OR
+};
+
+/*!
+* @brief Node of a parsed filter expression
+* @details A match loads size (BPF_W, BPF_H or BPF_B) bytes at offset of the
+* message and compares them with value, in the byte order a BPF load gives
+*/
+struct sockev_node_s {
+	uint8_t type;
+	uint8_t size;
+	uint32_t offset;
+	uint32_t value;
+	int left;
+	int right;
+};
+
+struct sockev_parser_s {
+	const char *pos;
+	char token[SOCKEV_TOKEN_LEN];
+	struct sockev_node_s nodes[SOCKEV_FILTER_MAX_NODES];
+	int num_nodes;
+	int depth;
+	char *error;
+	size_t error_len;
+};
+
+/* Names a field takes for its values */
+struct sockev_value_name_s {
+	const char *name;
+	uint32_t value;
+};
+
+static const struct sockev_value_name_s sockev_families[] = {
+	{ "unix", AF_UNIX }, { "inet", AF_INET }, { "inet6", AF_INET6 },
+	{ "netlink", AF_NETLINK }, { NULL, 0 }
+};
+
+static const struct sockev_value_name_s sockev_types[] = {
+	{ "stream", SOCK_STREAM }, { "dgram", SOCK_DGRAM },
+	{ "raw", SOCK_RAW }, { "seqpacket", SOCK_SEQPACKET }, { NULL, 0 }
+};
+
+static const struct sockev_value_name_s sockev_protocols[] = {
+	{ "tcp", IPPROTO_TCP }, { "udp", IPPROTO_UDP },
+	{ "icmp", IPPROTO_ICMP }, { "icmpv6", IPPROTO_ICMPV6 }, { NULL, 0 }
+};
+
+/* Fields of the "<field> <value>" primitives */
+static const struct {
+	const char *name;
+	uint8_t size;
+	uint32_t offset;
+	const struct sockev_value_name_s *names;
+} sockev_fields[] = {
+	{ "pid", BPF_W, SOCKEV_FIELD(pid), NULL },
+	{ "family", BPF_H, SOCKEV_FIELD(skfamily), sockev_families },
+	{ "type", BPF_H, SOCKEV_FIELD(sktype), sockev_types },
+	{ "protocol", BPF_B, SOCKEV_FIELD(skprotocol), sockev_protocols },
+	{ "proto", BPF_B, SOCKEV_FIELD(skprotocol), sockev_protocols },
+	{ "state", BPF_B, SOCKEV_FIELD(skstate), NULL },
+};
+
+static int _sockev_fail(struct sockev_parser_s *parser, const char *what)
+{
+	if (parser->error && parser->error_len)
+		snprintf(parser->error, parser->error_len, "%s%s%s%s", what,
+			 parser->token[0] ? " at \"" : " at the end",
+			 parser->token, parser->token[0] ? "\"" : "");
+	return -1;
+}
+
+/*!
+* @brief Moves to the next token of the expression, an empty one at the end
+* @return 0 on success, -1 on a character no token starts with
+*/
+static int _sockev_next(struct sockev_parser_s *parser)
+{
+	const char *start;
+	size_t len;
+
+	while (*parser->pos == ' ' || *parser->pos == '\t')
+		parser->pos++;
+	start = parser->pos;
+	if (!strncmp(start, "&&", 2) || !strncmp(start, "||", 2))
+		parser->pos += 2;
+	else if (*start == '(' || *start == ')' || *start == '!')
+		parser->pos++;
+	else
+		while ((*parser->pos >= 'a' && *parser->pos <= 'z') ||
+		       (*parser->pos >= 'A' && *parser->pos <= 'Z') ||
+		       (*parser->pos >= '0' && *parser->pos <= '9') ||
+		       *parser->pos == '_')
+			parser->pos++;
+
+	len = parser->pos - start;
+	if (len >= sizeof(parser->token))
+		len = sizeof(parser->token) - 1;
+	memcpy(parser->token, start, len);
+	parser->token[len] = '\0';
+	if (!len && *start) {
+		parser->token[0] = *start;
+		parser->token[1] = '\0';
+		return _sockev_fail(parser, "unexpected character");
+	}
+	return 0;
+}
+
+static int _sockev_is(const struct sockev_parser_s *parser, const char *a,
+		      const char *b)
+{
+	return !strcasecmp(parser->token, a) ||
+	       (b && !strcmp(parser->token, b));
+}
+
+static int _sockev_node(struct sockev_parser_s *parser, uint8_t type,
+			int left, int right)
+{
+	struct sockev_node_s *node;
+	if (parser->num_nodes == SOCKEV_FILTER_MAX_NODES)
+		return _sockev_fail(parser, "expression too long");
+	node = &parser->nodes[parser->num_nodes];
+	memset(node, 0, sizeof(*node));
+	node->type = type;
+	node->left = left;
+	node->right = right;
+	return parser->num_nodes++;
+}
+
+static int _sockev_match(struct sockev_parser_s *parser, uint8_t size,
+			 uint32_t offset, uint32_t value)
+{
+	int n = _sockev_node(parser, SOCKEV_NODE_MATCH, -1, -1);
+	if (n < 0)
+		return -1;
+	parser->nodes[n].size = size;
+	parser->nodes[n].offset = offset;
+	/* loads are in network byte order, the message is in host order */
+	switch (size) {
+	case BPF_W: parser->nodes[n].value = ntohl(value); break;
+	case BPF_H: parser->nodes[n].value = ntohs((uint16_t)value); break;
+	default: parser->nodes[n].value = value; break;
+	}
+	return n;
+}
+
+/*!
+* @brief Parses the value of a field and makes the match of it
+*/
+static int _sockev_field(struct sockev_parser_s *parser, int field)
+{
+	const struct sockev_value_name_s *names = sockev_fields[field].names;
+	uint32_t max = (sockev_fields[field].size == BPF_W) ? UINT32_MAX :
+		       (sockev_fields[field].size == BPF_H) ? UINT16_MAX :
+		       UINT8_MAX;
+	unsigned long value;
+	char *end;
+
+	for (; names && names->name; names++)
+		if (_sockev_is(parser, names->name, NULL))
+			break;
+	if (names && names->name) {
+		value = names->value;
+	} else {
+		errno = 0;
+		value = strtoul(parser->token, &end, 0);
+		if (!parser->token[0] || *end || errno || value > max)
+			return _sockev_fail(parser, "invalid value");
+	}
+	if (_sockev_next(parser) < 0)
+		return -1;
+	return _sockev_match(parser, sockev_fields[field].size,
+			     sockev_fields[field].offset, (uint32_t)value);
+}
+
+static int _sockev_event_match(struct sockev_parser_s *parser)
+{
+	const char *name = parser->token, *key;
+	uint8_t event;
+
+	if (!strncasecmp(name, "sockev_", 7))
+		name += 7;
+	for (event = 0; event < SOCKEV_EV_UNKNOWN; event++)
+		if (!strcasecmp(name, sockev_event_names[event] + 7))
+			break;
+	if (event == SOCKEV_EV_UNKNOWN)
+		return _sockev_fail(parser, "unknown event");
+	if (_sockev_next(parser) < 0)
+		return -1;
+	/* four characters of the name tell all the events apart */
+	key = sockev_event_names[event] + SOCKEV_EVENT_KEY_POS;
+	return _sockev_match(parser, BPF_W,
+			     SOCKEV_FIELD(event) + SOCKEV_EVENT_KEY_POS,
+			     htonl((uint32_t)(uint8_t)key[0] << 24 |
+				   (uint32_t)(uint8_t)key[1] << 16 |
+				   (uint32_t)(uint8_t)key[2] << 8 |
+				   (uint32_t)(uint8_t)key[3]));
+}
+
+static int _sockev_expr(struct sockev_parser_s *parser);
+
+/* factor := "not" factor | "(" expr ")" | primitive */
+static int _sockev_factor(struct sockev_parser_s *parser)
+{
+	int n, field;
+
+	if (++parser->depth > SOCKEV_FILTER_MAX_DEPTH)
+		return _sockev_fail(parser, "expression nested too deep");
+
+	if (_sockev_is(parser, "not", "!")) {
+		if (_sockev_next(parser) < 0 || (n = _sockev_factor(parser)) < 0)
+			return -1;
+		n = _sockev_node(parser, SOCKEV_NODE_NOT, n, -1);
+	} else if (_sockev_is(parser, "(", NULL)) {
+		if (_sockev_next(parser) < 0 || (n = _sockev_expr(parser)) < 0)
+			return -1;
+		if (!_sockev_is(parser, ")", NULL))
+			return _sockev_fail(parser, "expected \")\"");
+		if (_sockev_next(parser) < 0)
+			return -1;
+	} else if (_sockev_is(parser, "tcp", NULL) ||
+		   _sockev_is(parser, "udp", NULL)) {
+		n = _sockev_match(parser, BPF_B, SOCKEV_FIELD(skprotocol),
+				  _sockev_is(parser, "tcp", NULL) ?
+				  IPPROTO_TCP : IPPROTO_UDP);
+		if (n >= 0 && _sockev_next(parser) < 0)
+			return -1;
+	} else if (_sockev_is(parser, "event", NULL)) {
+		if (_sockev_next(parser) < 0)
+			return -1;
+		n = _sockev_event_match(parser);
+	} else {
+		for (field = 0; field < (int)(sizeof(sockev_fields) /
+					      sizeof(sockev_fields[0])); field++)
+			if (_sockev_is(parser, sockev_fields[field].name, NULL))
+				break;
+		if (field == (int)(sizeof(sockev_fields) /
+				   sizeof(sockev_fields[0])))
+			return _sockev_fail(parser, "expected a primitive");
+		if (_sockev_next(parser) < 0)
+			return -1;
+		n = _sockev_field(parser, field);
+	}
+	parser->depth--;
+	return n;
+}
+
+/* term := factor ("and" factor)* */
+static int _sockev_term(struct sockev_parser_s *parser)
+{
+	int left, right;
+	if ((left = _sockev_factor(parser)) < 0)
+		return -1;
+	while (_sockev_is(parser, "and", "&&")) {
+		if (_sockev_next(parser) < 0 ||
+		    (right = _sockev_factor(parser)) < 0 ||
+		    (left = _sockev_node(parser, SOCKEV_NODE_AND, left,
+					 right)) < 0)
+			return -1;
+	}
+	return left;
+}
+
+/* expr := term ("or" term)* */
+static int _sockev_expr(struct sockev_parser_s *parser)
+{
+	int left, right;
+	if ((left = _sockev_term(parser)) < 0)
+		return -1;
+	while (_sockev_is(parser, "or", "||")) {
+		if (_sockev_next(parser) < 0 ||
+		    (right = _sockev_term(parser)) < 0 ||
+		    (left = _sockev_node(parser, SOCKEV_NODE_OR, left,
+					 right)) < 0)
+			return -1;
+	}
+	return left;
+}
+
+/*===========================================================================
+			FILTER PROGRAMS
+===========================================================================*/
+
+/*!
+* @brief Program being generated. Until all of it is, the jt and jf of a
+* jump are labels, which get their instruction once placed.
+*/
+struct sockev_codegen_s {
+	struct sockev_filter_s *filter;
+	const struct sockev_node_s *nodes;
+	uint8_t label_pos[SOCKEV_FILTER_MAX_INSNS];
+	uint8_t num_labels;
+	int failed;
+};
+
+static void _sockev_emit(struct sockev_codegen_s *gen, uint16_t code,
+			 uint8_t jt, uint8_t jf, uint32_t k)
+{
+	struct sock_filter *insn;
+	/* two more for the returns */
+	if (gen->filter->len + 2 >= SOCKEV_FILTER_MAX_INSNS) {
+		gen->failed = 1;
+		return;
+	}
+	insn = &gen->filter->insns[gen->filter->len++];
+	insn->code = code;
+	insn->jt = jt;
+	insn->jf = jf;
+	insn->k = k;
+}
+
+static uint8_t _sockev_label(struct sockev_codegen_s *gen)
+{
+	return gen->num_labels++;
+}
+
+static void _sockev_place(struct sockev_codegen_s *gen, uint8_t label)
+{
+	gen->label_pos[label] = (uint8_t)gen->filter->len;
+}
+
+/*!
+* @brief Generates node, which jumps to label t if it matches and to f if
+* not. Every jump is forward, to a label placed after the node.
+*/
+static void _sockev_gen(struct sockev_codegen_s *gen, int n, uint8_t t,
+			uint8_t f)
+{
+	const struct sockev_node_s *node = &gen->nodes[n];
+	uint8_t mid;
+
+	switch (node->type) {
+	case SOCKEV_NODE_MATCH:
+		_sockev_emit(gen, BPF_LD | node->size | BPF_ABS, 0, 0,
+			     node->offset);
+		_sockev_emit(gen, BPF_JMP | BPF_JEQ | BPF_K, t, f,
+			     node->value);
+		break;
+	case SOCKEV_NODE_NOT:
+		_sockev_gen(gen, node->left, f, t);
+		break;
+	case SOCKEV_NODE_AND:
+		mid = _sockev_label(gen);
+		_sockev_gen(gen, node->left, mid, f);
+		_sockev_place(gen, mid);
+		_sockev_gen(gen, node->right, t, f);
+		break;
+	case SOCKEV_NODE_OR:
+		mid = _sockev_label(gen);
+		_sockev_gen(gen, node->left, t, mid);
+		_sockev_place(gen, mid);
+		_sockev_gen(gen, node->right, t, f);
+		break;
+	}
+}
+
+int sockev_filter_compile(struct sockev_filter_s *filter, const char *expr,
+			  char *error, size_t error_len)
+{
+	struct sockev_parser_s parser;
+	struct sockev_codegen_s gen;
+	struct sock_filter *insn;
+	uint8_t accept, reject;
+	int root, i;
+
+	if (!filter || !expr) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(&parser, 0, sizeof(parser));
+	parser.pos = expr;
+	parser.error = error;
+	parser.error_len = error_len;
+	if (_sockev_next(&parser) < 0 || (root = _sockev_expr(&parser)) < 0)
+		return -1;
+	if (parser.token[0])
+		return _sockev_fail(&parser, "expected \"and\" or \"or\"");
+
+	memset(filter, 0, sizeof(*filter));
+	memset(&gen, 0, sizeof(gen));
+	gen.filter = filter;
+	gen.nodes = parser.nodes;
+	accept = _sockev_label(&gen);
+	reject = _sockev_label(&gen);
+	_sockev_gen(&gen, root, accept, reject);
+	if (gen.failed) {
+		parser.token[0] = '\0';
+		return _sockev_fail(&parser, "expression too long");
+	}
+	_sockev_place(&gen, accept);
+	_sockev_emit(&gen, BPF_RET | BPF_K, 0, 0, SOCKEV_FILTER_ACCEPT);
+	_sockev_place(&gen, reject);
+	_sockev_emit(&gen, BPF_RET | BPF_K, 0, 0, 0);
+
+	/* labels to offsets, which fit as the program is short */
+	for (i = 0; i < filter->len; i++) {
+		insn = &filter->insns[i];
+		if (BPF_CLASS(insn->code) != BPF_JMP)
+			continue;
+		insn->jt = (uint8_t)(gen.label_pos[insn->jt] - i - 1);
+		insn->jf = (uint8_t)(gen.label_pos[insn->jf] - i - 1);
+	}
+	return 0;
+}
+
+void sockev_filter_dump(const struct sockev_filter_s *filter, FILE *out)
+{
+	const struct sock_filter *insn;
+	int i;
+
+	for (i = 0; filter && i < filter->len; i++) {
+		insn = &filter->insns[i];
+		switch (insn->code) {
+		case BPF_LD | BPF_W | BPF_ABS:
+		case BPF_LD | BPF_H | BPF_ABS:
+		case BPF_LD | BPF_B | BPF_ABS:
+			fprintf(out, "(%03d) %-8s [%u]\n", i,
+				(BPF_SIZE(insn->code) == BPF_W) ? "ld" :
+				(BPF_SIZE(insn->code) == BPF_H) ? "ldh" : "ldb",
+				insn->k);
+			break;
+		case BPF_JMP | BPF_JEQ | BPF_K:
+			fprintf(out, "(%03d) %-8s #0x%-14x jt %-4d jf %d\n", i,
+				"jeq", insn->k, i + 1 + insn->jt,
+				i + 1 + insn->jf);
+			break;
+		case BPF_RET | BPF_K:
+			fprintf(out, "(%03d) %-8s #%u\n", i, "ret", insn->k);
+			break;
+		default:
+			fprintf(out, "(%03d) code 0x%04x k %u\n", i, insn->code,
+				insn->k);
+			break;
+		}
+	}
+}
+
+/*===========================================================================
+			EXPOSED API
+===========================================================================*/
+
+uint8_t sockev_event(const __u8 *name)
+{
+	uint8_t event;
+	for (event = 0; event < SOCKEV_EV_UNKNOWN; event++)
+		if (!strncmp((const char *)name, sockev_event_names[event],
+			     SOCKEV_STR_MAX))
+			return event;
+	return SOCKEV_EV_UNKNOWN;
+}
+
+const char *sockev_event_name(uint8_t event)
+{
+	return sockev_event_names[(event < SOCKEV_EV_MAX) ?
+				  event : SOCKEV_EV_UNKNOWN];
+}
+
+int sockev_set_filter(sockev_hndl_t *hndl,
+		      const struct sockev_filter_s *filter)
+{
+	struct sock_fprog prog;
+	int dummy = 0;
+
+	if (!hndl) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (!filter) {
+		if (setsockopt(hndl->fd, SOL_SOCKET, SO_DETACH_FILTER, &dummy,
+			       sizeof(dummy)) < 0 && errno != ENOENT)
+			return -1;
+		return 0;
+	}
+	prog.len = filter->len;
+	prog.filter = (struct sock_filter *)filter->insns;
+	return setsockopt(hndl->fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog,
+			  sizeof(prog));
+}
+
+int sockev_open(sockev_hndl_t **hndl, int rcvbuf,
+		const struct sockev_filter_s *filter)
+{
+	struct sockaddr_nl addr;
+	socklen_t len = sizeof(int);
+	sockev_hndl_t *h;
+	int i, saved;
+
+	if (!hndl) {
+		errno = EINVAL;
+		return -1;
+	}
+	h = (sockev_hndl_t *)calloc(1, sizeof(sockev_hndl_t));
+	if (!h)
+		return -1;
+	h->slab = (uint8_t *)malloc(SOCKEV_RECV_BATCH * SOCKEV_BUF_LEN);
+	h->fd = -1;
+	do {
+		if (!h->slab)
+			break;
+		h->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_SOCKEV);
+		if (h->fd < 0)
+			break;
+
+		/* past rmem_max needs CAP_NET_ADMIN, take what there is
+		 * without */
+		if (rcvbuf > 0 &&
+		    setsockopt(h->fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf,
+			       sizeof(rcvbuf)) < 0)
+			setsockopt(h->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+				   sizeof(rcvbuf));
+		if (getsockopt(h->fd, SOL_SOCKET, SO_RCVBUF, &h->rcvbuf,
+			       &len) < 0)
+			break;
+		if (filter && sockev_set_filter(h, filter) < 0)
+			break;
+
+		/* the kernel picks the port id, so handles can coexist */
+		memset(&addr, 0, sizeof(addr));
+		addr.nl_family = AF_NETLINK;
+		addr.nl_groups = 1 << (SKNLGRP_SOCKEV - 1);
+		if (bind(h->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+			break;
+
+		for (i = 0; i < SOCKEV_RECV_BATCH; i++) {
+			h->iov[i].iov_base = h->slab + i * SOCKEV_BUF_LEN;
+			h->iov[i].iov_len = SOCKEV_BUF_LEN;
+			h->msgs[i].msg_hdr.msg_iov = &h->iov[i];
+			h->msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		*hndl = h;
+		return 0;
+	} while (0);
+
+	saved = errno;
+	if (h->fd >= 0)
+		close(h->fd);
+	free(h->slab);
+	free(h);
+	errno = saved;
+	return -1;
+}
+
+int sockev_get_fd(const sockev_hndl_t *hndl)
+{
+	return hndl ? hndl->fd : -1;
+}
+
+int sockev_get_rcvbuf(const sockev_hndl_t *hndl)
+{
+	return hndl ? hndl->rcvbuf : 0;
+}
+
+uint64_t sockev_get_malformed(const sockev_hndl_t *hndl)
+{
+	return hndl ? hndl->malformed : 0;
+}
+
+int sockev_receive(sockev_hndl_t *hndl, sockev_event_cb_t cb,
+		   void *user_data)
+{
+	const struct sknlsockevmsg *msg;
+	struct nlmsghdr *nlh;
+	struct timespec ts;
+	uint64_t time_ns;
+	int i, n, len;
+
+	if (!hndl || !cb) {
+		errno = EINVAL;
+		return -1;
+	}
+	n = recvmmsg(hndl->fd, hndl->msgs, SOCKEV_RECV_BATCH, MSG_DONTWAIT,
+		     NULL);
+	if (n <= 0)
+		return n;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	time_ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	for (i = 0; i < n; i++) {
+		nlh = (struct nlmsghdr *)hndl->iov[i].iov_base;
+		len = (int)hndl->msgs[i].msg_len;
+		if (hndl->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+			hndl->malformed++;
+			continue;
+		}
+		for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+			if (nlh->nlmsg_len <
+			    NLMSG_LENGTH(sizeof(struct sknlsockevmsg))) {
+				hndl->malformed++;
+				continue;
+			}
+			msg = (const struct sknlsockevmsg *)NLMSG_DATA(nlh);
+			cb(msg, sockev_event(msg->event), time_ns, user_data);
+		}
+	}
+	return n;
+}
+
+void sockev_close(sockev_hndl_t *hndl)
+{
+	if (!hndl)
+		return;
+	close(hndl->fd);
+	free(hndl->slab);
+	free(hndl);
+}
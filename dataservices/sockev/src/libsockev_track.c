@@ -0,0 +1,415 @@
+/******************************************************************************
+
+			L I B S O C K E V _ T R A C K . C
+
+Copyright (c) 2016, The Linux Foundation. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+	* Redistributions of source code must retain the above copyright
+	  notice, this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above
+	  copyright notice, this list of conditions and the following
+	  disclaimer in the documentation and/or other materials provided
+	  with the distribution.
+	* Neither the name of The Linux Foundation nor the names of its
+	  contributors may be used to endorse or promote products derived
+	  from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************/
+
+/*!
+* @file    libsockev_track.c
+* @brief   socket lifecycle tracking of the sockev receiver API's
+*/
+
+/*===========================================================================
+			INCLUDE FILES
+===========================================================================*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <linux/sockev.h>
+#include "libsockev.h"
+
+/* the table is kept at most this full, in percent */
+#define SOCKEV_TRACK_MAX_LOAD 75
+#define SOCKEV_NS_PER_S 1000000000ULL
+
+/*!
+* @brief App of a tracker, free if not used
+* @var head Slot of open_ns of the oldest open socket
+* @var num_connected Open sockets connected, which are the oldest ones
+* @var created Sockets created since the last report, and so on
+* @var last_ns Time of the last event, to tell the app went stale
+* @var last_create_ns Time of the last socket created, 0 if none yet
+*/
+struct sockev_track_entry_s {
+	uint32_t pid;
+	uint16_t skfamily;
+	uint16_t sktype;
+	uint8_t skprotocol;
+	uint8_t used;
+	uint8_t head;
+	uint8_t num_open;
+	uint8_t num_connected;
+	uint32_t created;
+	uint32_t connected;
+	uint32_t shut_down;
+	uint64_t last_ns;
+	uint64_t last_create_ns;
+	uint64_t open_ns[SOCKEV_TRACK_MAX_OPEN];
+};
+
+/*!
+* @brief Apps in an open addressed table of mask + 1 slots with linear
+* probing, and what was seen of them since the last report
+*/
+struct sockev_tracker_s {
+	struct sockev_track_entry_s *table;
+	uint32_t mask;
+	uint32_t capacity;
+	uint32_t used;
+	uint64_t stale_ns;
+	struct sockev_track_report_s current;
+};
+
+/*===========================================================================
+			LOCAL FUNCTIONS
+===========================================================================*/
+
+static uint32_t _sockev_track_hash(uint32_t pid, uint16_t skfamily,
+				   uint16_t sktype, uint8_t skprotocol)
+{
+	uint32_t h = pid * 0x9E3779B1u;
+	h ^= ((uint32_t)skfamily << 16 | (uint32_t)sktype << 8 |
+	      skprotocol) * 0x85EBCA6Bu;
+	return h ^ (h >> 15);
+}
+
+static uint32_t _sockev_track_home(const sockev_tracker_t *tracker,
+				   const struct sockev_track_entry_s *entry)
+{
+	return _sockev_track_hash(entry->pid, entry->skfamily, entry->sktype,
+				  entry->skprotocol) & tracker->mask;
+}
+
+/*!
+* @brief Frees a slot, moving back the apps after it that probed past it
+* so that every app stays reachable from its home slot
+*/
+static void _sockev_track_remove(sockev_tracker_t *tracker, uint32_t slot)
+{
+	struct sockev_track_entry_s *table = tracker->table;
+	uint32_t next, home;
+
+	tracker->used--;
+	tracker->current.evicted++;
+	for (;;) {
+		table[slot].used = 0;
+		next = slot;
+		for (;;) {
+			next = (next + 1) & tracker->mask;
+			if (!table[next].used)
+				return;
+			home = _sockev_track_home(tracker, &table[next]);
+			/* it may move if its home is not in (slot, next] */
+			if ((slot < next) ? (home <= slot || home > next) :
+					    (home <= slot && home > next))
+				break;
+		}
+		table[slot] = table[next];
+		slot = next;
+	}
+}
+
+/*!
+* @brief App of msg, which is added if new
+* @details If the table is full, the least recently seen app on the probe
+* path of msg makes room.
+* @return NULL if there is no room
+*/
+static struct sockev_track_entry_s *
+_sockev_track_entry(sockev_tracker_t *tracker,
+		    const struct sknlsockevmsg *msg)
+{
+	uint32_t home = _sockev_track_hash(msg->pid, msg->skfamily,
+					   msg->sktype, msg->skprotocol) &
+			tracker->mask;
+	struct sockev_track_entry_s *entry;
+	uint32_t slot, oldest = home;
+
+	for (slot = home;; slot = (slot + 1) & tracker->mask) {
+		entry = &tracker->table[slot];
+		if (!entry->used)
+			break;
+		if (entry->pid == msg->pid && entry->skfamily == msg->skfamily &&
+		    entry->sktype == msg->sktype &&
+		    entry->skprotocol == msg->skprotocol)
+			return entry;
+		if (entry->last_ns < tracker->table[oldest].last_ns)
+			oldest = slot;
+	}
+
+	if (tracker->used >= tracker->capacity) {
+		if (!tracker->table[oldest].used) {
+			tracker->current.untracked++;
+			return NULL;
+		}
+		_sockev_track_remove(tracker, oldest);
+		/* the probe path of msg may have moved */
+		for (slot = home; tracker->table[slot].used;
+		     slot = (slot + 1) & tracker->mask)
+			;
+		entry = &tracker->table[slot];
+	}
+
+	memset(entry, 0, sizeof(*entry));
+	entry->used = 1;
+	entry->pid = msg->pid;
+	entry->skfamily = msg->skfamily;
+	entry->sktype = msg->sktype;
+	entry->skprotocol = msg->skprotocol;
+	tracker->used++;
+	return entry;
+}
+
+static void _sockev_hist_add(struct sockev_hist_s *hist, uint64_t ns)
+{
+	uint64_t us = ns / 1000;
+	uint32_t bucket = (us < 2) ? 0 : 63 - __builtin_clzll(us);
+
+	if (bucket >= SOCKEV_HIST_BUCKETS)
+		bucket = SOCKEV_HIST_BUCKETS - 1;
+	hist->count++;
+	hist->sum_us += us;
+	hist->buckets[bucket]++;
+}
+
+static void _sockev_hist_merge(struct sockev_hist_s *to,
+			       const struct sockev_hist_s *from)
+{
+	int i;
+	to->count += from->count;
+	to->sum_us += from->sum_us;
+	for (i = 0; i < SOCKEV_HIST_BUCKETS; i++)
+		to->buckets[i] += from->buckets[i];
+}
+
+/* Puts app in the top of report if it is busy enough, busiest first */
+static void _sockev_track_rank(struct sockev_track_report_s *report,
+			       uint32_t top_n,
+			       const struct sockev_track_entry_s *entry)
+{
+	uint32_t churn = entry->created + entry->shut_down;
+	struct sockev_track_app_s *app;
+	uint32_t i;
+
+	if (!churn || !top_n)
+		return;
+	for (i = report->num_top; i > 0; i--) {
+		app = &report->top[i - 1];
+		if (app->created + app->shut_down >= churn)
+			break;
+	}
+	if (i >= top_n)
+		return;
+	if (report->num_top < top_n)
+		report->num_top++;
+	memmove(&report->top[i + 1], &report->top[i],
+		(report->num_top - 1 - i) * sizeof(report->top[0]));
+	app = &report->top[i];
+	app->pid = entry->pid;
+	app->skfamily = entry->skfamily;
+	app->sktype = entry->sktype;
+	app->skprotocol = entry->skprotocol;
+	app->created = entry->created;
+	app->connected = entry->connected;
+	app->shut_down = entry->shut_down;
+	app->open = entry->num_open;
+}
+
+/*===========================================================================
+			EXPOSED API
+===========================================================================*/
+
+int sockev_tracker_init(sockev_tracker_t **tracker, uint32_t capacity,
+			uint32_t stale_s)
+{
+	sockev_tracker_t *t;
+	uint32_t slots = 1;
+
+	if (!tracker || !capacity || capacity > (1U << 24)) {
+		errno = EINVAL;
+		return -1;
+	}
+	while ((uint64_t)slots * SOCKEV_TRACK_MAX_LOAD / 100 < capacity)
+		slots <<= 1;
+	t = (sockev_tracker_t *)calloc(1, sizeof(sockev_tracker_t));
+	if (!t)
+		return -1;
+	t->table = (struct sockev_track_entry_s *)
+		   calloc(slots, sizeof(struct sockev_track_entry_s));
+	if (!t->table) {
+		free(t);
+		return -1;
+	}
+	t->mask = slots - 1;
+	t->capacity = capacity;
+	t->stale_ns = (uint64_t)stale_s * SOCKEV_NS_PER_S;
+	*tracker = t;
+	return 0;
+}
+
+void sockev_tracker_event(sockev_tracker_t *tracker,
+			  const struct sknlsockevmsg *msg, uint8_t event,
+			  uint64_t time_ns)
+{
+	struct sockev_track_entry_s *entry;
+	uint8_t slot;
+
+	if (!tracker || !msg)
+		return;
+	if (!tracker->current.events++)
+		tracker->current.start_ns = time_ns;
+	entry = _sockev_track_entry(tracker, msg);
+	if (!entry)
+		return;
+	entry->last_ns = time_ns;
+
+	switch (event) {
+	case SOCKEV_EV_SOCKET:
+		entry->created++;
+		if (entry->last_create_ns)
+			_sockev_hist_add(&tracker->current.interarrival,
+					 time_ns - entry->last_create_ns);
+		entry->last_create_ns = time_ns;
+		if (entry->num_open == SOCKEV_TRACK_MAX_OPEN) {
+			/* forget the oldest, it was closed without shutdown */
+			entry->head = (entry->head + 1) % SOCKEV_TRACK_MAX_OPEN;
+			entry->num_open--;
+			if (entry->num_connected)
+				entry->num_connected--;
+			tracker->current.unpaired++;
+		}
+		slot = (entry->head + entry->num_open) % SOCKEV_TRACK_MAX_OPEN;
+		entry->open_ns[slot] = time_ns;
+		entry->num_open++;
+		break;
+	case SOCKEV_EV_CONNECT:
+		entry->connected++;
+		if (entry->num_connected == entry->num_open) {
+			tracker->current.unpaired++;
+			break;
+		}
+		slot = (entry->head + entry->num_connected) %
+		       SOCKEV_TRACK_MAX_OPEN;
+		_sockev_hist_add(&tracker->current.connect_delay,
+				 time_ns - entry->open_ns[slot]);
+		entry->num_connected++;
+		break;
+	case SOCKEV_EV_SHUTDOWN:
+		entry->shut_down++;
+		if (!entry->num_open) {
+			tracker->current.unpaired++;
+			break;
+		}
+		_sockev_hist_add(&tracker->current.lifetime,
+				 time_ns - entry->open_ns[entry->head]);
+		entry->head = (entry->head + 1) % SOCKEV_TRACK_MAX_OPEN;
+		entry->num_open--;
+		if (entry->num_connected)
+			entry->num_connected--;
+		break;
+	default:
+		break;
+	}
+}
+
+void sockev_tracker_report(sockev_tracker_t *tracker, uint64_t now_ns,
+			   uint32_t top_n,
+			   struct sockev_track_report_s *report)
+{
+	struct sockev_track_entry_s *entry;
+	uint32_t slot;
+
+	if (!tracker || !report)
+		return;
+	if (top_n > SOCKEV_TRACK_MAX_TOP)
+		top_n = SOCKEV_TRACK_MAX_TOP;
+
+	/* a removal may move the next app into slot, so look again */
+	for (slot = 0; slot <= tracker->mask; slot++)
+		while (tracker->table[slot].used &&
+		       now_ns - tracker->table[slot].last_ns >
+		       tracker->stale_ns)
+			_sockev_track_remove(tracker, slot);
+
+	memset(report, 0, sizeof(*report));
+	report->start_ns = tracker->current.events ?
+			   tracker->current.start_ns : now_ns;
+	report->end_ns = now_ns;
+	report->events = tracker->current.events;
+	_sockev_hist_merge(&report->lifetime, &tracker->current.lifetime);
+	_sockev_hist_merge(&report->connect_delay,
+			   &tracker->current.connect_delay);
+	_sockev_hist_merge(&report->interarrival,
+			   &tracker->current.interarrival);
+	report->apps = tracker->used;
+	report->evicted = tracker->current.evicted;
+	report->untracked = tracker->current.untracked;
+	report->unpaired = tracker->current.unpaired;
+
+	for (slot = 0; slot <= tracker->mask; slot++) {
+		entry = &tracker->table[slot];
+		if (!entry->used)
+			continue;
+		_sockev_track_rank(report, top_n, entry);
+		entry->created = 0;
+		entry->connected = 0;
+		entry->shut_down = 0;
+	}
+	memset(&tracker->current, 0, sizeof(tracker->current));
+}
+
+uint64_t sockev_hist_percentile(const struct sockev_hist_s *hist,
+				uint32_t pct)
+{
+	uint64_t target, seen = 0;
+	int i;
+
+	if (!hist || !hist->count)
+		return 0;
+	target = (hist->count * (pct > 100 ? 100 : pct) + 99) / 100;
+	if (!target)
+		target = 1;
+	for (i = 0; i < SOCKEV_HIST_BUCKETS - 1; i++) {
+		seen += hist->buckets[i];
+		if (seen >= target)
+			break;
+	}
+	return 2ULL << i;
+}
+
+void sockev_tracker_free(sockev_tracker_t *tracker)
+{
+	if (!tracker)
+		return;
+	free(tracker->table);
+	free(tracker);
+}
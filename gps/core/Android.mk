@@ -23,6 +23,7 @@ LOCAL_SHARED_LIBRARIES := \
 LOCAL_SRC_FILES += \
     LocApiBase.cpp \
     LocAdapterBase.cpp \
+    LocFix.cpp \
     ContextBase.cpp \
     LocDualContext.cpp \
     loc_core_log.cpp
@@ -31,6 +32,10 @@ LOCAL_CFLAGS += \
      -fno-short-enums \
      -D_ANDROID_
 
+ifeq ($(TARGET_BUILD_VARIANT),user)
+   LOCAL_CFLAGS += -DTARGET_BUILD_VARIANT_USER
+endif
+
 LOCAL_C_INCLUDES:= \
     $(TARGET_OUT_HEADERS)/gps.utils \
     $(TARGET_OUT_HEADERS)/libflp
@@ -39,6 +44,7 @@ LOCAL_COPY_HEADERS_TO:= libloc_core/
 LOCAL_COPY_HEADERS:= \
     LocApiBase.h \
     LocAdapterBase.h \
+    LocFix.h \
     ContextBase.h \
     LocDualContext.h \
     LBSProxyBase.h \
@@ -79,6 +79,17 @@ void LocAdapterBase::
     }
 }
 
+// Adapters that only override the struct based reportPosition() still
+// get the fix, by reference, through this default.
+void LocAdapterBase::
+    reportPosition(LocFix& fix) {
+    reportPosition(const_cast<UlpLocation&>(fix.getLocation()),
+                   const_cast<GpsLocationExtended&>(fix.getLocationExtended()),
+                   fix.getLocationExt(),
+                   fix.getStatus(),
+                   fix.getTechMask());
+}
+
 void LocAdapterBase::
     reportSv(HaxxSvStatus &svStatus,
              GpsLocationExtended &locationExtended,
@@ -132,6 +143,10 @@ bool LocAdapterBase::
     reportDataCallClosed()
 DEFAULT_IMPL(false)
 
+bool LocAdapterBase::
+    reportDataCallRetry()
+DEFAULT_IMPL(false)
+
 bool LocAdapterBase::
     requestNiNotify(GpsNiNotification &notify, const void* data)
 DEFAULT_IMPL(false)
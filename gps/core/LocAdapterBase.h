@@ -92,6 +92,7 @@ public:
                                 void* locationExt,
                                 enum loc_sess_status status,
                                 LocPosTechMask loc_technology_mask);
+    virtual void reportPosition(LocFix& fix);
     virtual void reportSv(HaxxSvStatus &svStatus,
                           GpsLocationExtended &locationExtended,
                           void* svExt);
@@ -107,6 +108,7 @@ public:
     virtual bool requestSuplES(int connHandle);
     virtual bool reportDataCallOpened();
     virtual bool reportDataCallClosed();
+    virtual bool reportDataCallRetry();
     virtual bool requestNiNotify(GpsNiNotification &notify,
                                  const void* data);
     inline virtual bool isInSession() { return false; }
@@ -30,6 +30,8 @@
 #define LOG_TAG "LocSvc_LocApiBase"
 
 #include <dlfcn.h>
+#include <sched.h>
+#include <cutils/atomic.h>
 #include <LocApiBase.h>
 #include <LocAdapterBase.h>
 #include <log_util.h>
@@ -39,6 +41,25 @@ namespace loc_core {
 
 #define TO_ALL_LOCADAPTERS(call) TO_ALL_ADAPTERS(mLocAdapters, (call))
 #define TO_1ST_HANDLING_LOCADAPTERS(call) TO_1ST_HANDLING_ADAPTER(mLocAdapters, (call))
+// 'call' reaches the adapters through subscribers[i]
+#define TO_SUBSCRIBED_LOCADAPTERS(event, call)                         \
+    {                                                                  \
+        int idx = acquireSubscribers();                                \
+        LocAdapterBase** subscribers = mEvtSubscribers[idx][(event)];  \
+        TO_ALL_ADAPTERS(subscribers, (call));                          \
+        releaseSubscribers(idx);                                       \
+    }
+
+// event mask bits that subscribe an adapter to each loc_api_dispatch_event
+static const LOC_API_ADAPTER_EVENT_MASK_T
+    sDispatchMasks[LOC_API_DISPATCH_MAX] = {
+    LOC_API_ADAPTER_BIT_PARSED_POSITION_REPORT,  // LOC_API_DISPATCH_POSITION
+    LOC_API_ADAPTER_BIT_SATELLITE_REPORT,        // LOC_API_DISPATCH_SV
+    LOC_API_ADAPTER_BIT_NMEA_1HZ_REPORT |
+    LOC_API_ADAPTER_BIT_NMEA_POSITION_REPORT,    // LOC_API_DISPATCH_NMEA
+    LOC_API_ADAPTER_BIT_STATUS_REPORT,           // LOC_API_DISPATCH_STATUS
+    LOC_API_ADAPTER_BIT_GNSS_MEASUREMENT         // LOC_API_DISPATCH_GNSS_MEASUREMENT
+};
 
 int hexcode(char *hexstring, int string_size,
             const char *data, int data_size)
@@ -129,18 +150,94 @@ LocApiBase::LocApiBase(const MsgTask* msgTask,
                        LOC_API_ADAPTER_EVENT_MASK_T excludedMask,
                        ContextBase* context) :
     mExcludedMask(excludedMask), mMsgTask(msgTask),
-    mMask(0), mSupportedMsg(0), mContext(context)
+    mMask(0), mAggregateMask(0), mSupportedMsg(0), mContext(context),
+    mEvtSubscribersIdx(0)
 {
     memset(mLocAdapters, 0, sizeof(mLocAdapters));
+    memset(mAdapterMasks, 0, sizeof(mAdapterMasks));
+    memset(mEvtSubscribers, 0, sizeof(mEvtSubscribers));
+    memset((void*)mEvtSubscribersReaders, 0, sizeof(mEvtSubscribersReaders));
+    pthread_mutex_init(&mEvtSubscribersLock, NULL);
+    memset(mEvtBitRefs, 0, sizeof(mEvtBitRefs));
 }
 
 LOC_API_ADAPTER_EVENT_MASK_T LocApiBase::getEvtMask()
 {
-    LOC_API_ADAPTER_EVENT_MASK_T mask = 0;
+    return mAggregateMask & ~mExcludedMask;
+}
+
+// moves one adapter's contribution to mAggregateMask from oldMask to newMask
+void LocApiBase::accountMask(LOC_API_ADAPTER_EVENT_MASK_T oldMask,
+                             LOC_API_ADAPTER_EVENT_MASK_T newMask)
+{
+    LOC_API_ADAPTER_EVENT_MASK_T changed = oldMask ^ newMask;
+
+    for (unsigned int bit = 0; 0 != changed; bit++, changed >>= 1) {
+        if (changed & 1) {
+            LOC_API_ADAPTER_EVENT_MASK_T bitMask = 1 << bit;
+            if (newMask & bitMask) {
+                if (0 == mEvtBitRefs[bit]++) {
+                    mAggregateMask |= bitMask;
+                }
+            } else if (0 != mEvtBitRefs[bit] && 0 == --mEvtBitRefs[bit]) {
+                mAggregateMask &= ~bitMask;
+            }
+        }
+    }
+}
 
-    TO_ALL_LOCADAPTERS(mask |= mLocAdapters[i]->getEvtMask());
+// Called whenever mLocAdapters or mAdapterMasks change, which is much
+// less frequent than event handling. Each list keeps the order of
+// mLocAdapters, so delivery order is the same as broadcasting to all.
+// Events are delivered on the loc api callback thread, so the lists are
+// built in the copy that is not in use and then published. Once this
+// returns, no delivery walks the previous lists any more, so a removed
+// adapter can be destroyed.
+void LocApiBase::rebuildSubscribers()
+{
+    pthread_mutex_lock(&mEvtSubscribersLock);
+    int prev = android_atomic_acquire_load(&mEvtSubscribersIdx);
+    int next = prev ^ 1;
+
+    for (int event = 0; event < LOC_API_DISPATCH_MAX; event++) {
+        LocAdapterBase** subscribers = mEvtSubscribers[next][event];
+        int n = 0;
+        for (int i = 0; i < MAX_ADAPTERS && NULL != mLocAdapters[i]; i++) {
+            if (mAdapterMasks[i] & sDispatchMasks[event]) {
+                subscribers[n++] = mLocAdapters[i];
+            }
+        }
+        if (n < MAX_ADAPTERS) {
+            subscribers[n] = NULL;
+        }
+    }
+
+    android_atomic_release_store(next, &mEvtSubscribersIdx);
+
+    // let the deliveries that started before the flip finish
+    while (0 != android_atomic_acquire_load(&mEvtSubscribersReaders[prev])) {
+        sched_yield();
+    }
+    pthread_mutex_unlock(&mEvtSubscribersLock);
+}
+
+int LocApiBase::acquireSubscribers()
+{
+    for (;;) {
+        int idx = android_atomic_acquire_load(&mEvtSubscribersIdx);
+        android_atomic_inc(&mEvtSubscribersReaders[idx]);
+        // if the copy was flipped away before we were counted, it may be
+        // being rebuilt already, and the flip did not wait for us
+        if (idx == android_atomic_acquire_load(&mEvtSubscribersIdx)) {
+            return idx;
+        }
+        android_atomic_dec(&mEvtSubscribersReaders[idx]);
+    }
+}
 
-    return mask & ~mExcludedMask;
+void LocApiBase::releaseSubscribers(int idx)
+{
+    android_atomic_dec(&mEvtSubscribersReaders[idx]);
 }
 
 bool LocApiBase::isInSession()
@@ -161,6 +258,9 @@ void LocApiBase::addAdapter(LocAdapterBase* adapter)
     for (int i = 0; i < MAX_ADAPTERS && mLocAdapters[i] != adapter; i++) {
         if (mLocAdapters[i] == NULL) {
             mLocAdapters[i] = adapter;
+            mAdapterMasks[i] = adapter->getEvtMask();
+            accountMask(0, mAdapterMasks[i]);
+            rebuildSubscribers();
             mMsgTask->sendMsg(new LocOpenMsg(this,
                                              (adapter->getEvtMask())));
             break;
@@ -175,6 +275,7 @@ void LocApiBase::removeAdapter(LocAdapterBase* adapter)
          i++) {
         if (mLocAdapters[i] == adapter) {
             mLocAdapters[i] = NULL;
+            accountMask(mAdapterMasks[i], 0);
 
             // shift the rest of the adapters up so that the pointers
             // in the array do not have holes.  This should be more
@@ -190,8 +291,11 @@ void LocApiBase::removeAdapter(LocAdapterBase* adapter)
             // range although i could be equal to j, but it won't hurt.
             // No need to check it, as it gains nothing.
             mLocAdapters[j] = mLocAdapters[i];
+            mAdapterMasks[j] = mAdapterMasks[i];
             // this makes sure that we exit the for loop
             mLocAdapters[i] = NULL;
+            mAdapterMasks[i] = 0;
+            rebuildSubscribers();
 
             // if we have an empty list of adapters
             if (0 == i) {
@@ -206,6 +310,22 @@ void LocApiBase::removeAdapter(LocAdapterBase* adapter)
 
 void LocApiBase::updateEvtMask()
 {
+    bool changed = false;
+
+    // pick up whichever adapters changed their masks since last accounted
+    for (int i = 0; i < MAX_ADAPTERS && NULL != mLocAdapters[i]; i++) {
+        LOC_API_ADAPTER_EVENT_MASK_T mask = mLocAdapters[i]->getEvtMask();
+        if (mask != mAdapterMasks[i]) {
+            accountMask(mAdapterMasks[i], mask);
+            mAdapterMasks[i] = mask;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        rebuildSubscribers();
+    }
+
     mMsgTask->sendMsg(new LocOpenMsg(this, getEvtMask()));
 }
 
@@ -232,6 +352,16 @@ void LocApiBase::reportPosition(UlpLocation &location,
                                 enum loc_sess_status status,
                                 LocPosTechMask loc_technology_mask)
 {
+    LocFix* fix = LocFix::obtain(location, locationExtended, locationExt,
+                                 status, loc_technology_mask);
+    reportPosition(*fix);
+    fix->drop();
+}
+
+void LocApiBase::reportPosition(LocFix& fix)
+{
+    const UlpLocation& location = fix.getLocation();
+
     // print the location info before delivering
     LOC_LOGV("flags: %d\n  source: %d\n  latitude: %f\n  longitude: %f\n  "
              "altitude: %f\n  speed: %f\n  bearing: %f\n  accuracy: %f\n  "
@@ -242,14 +372,10 @@ void LocApiBase::reportPosition(UlpLocation &location,
              location.gpsLocation.altitude, location.gpsLocation.speed,
              location.gpsLocation.bearing, location.gpsLocation.accuracy,
              location.gpsLocation.timestamp, location.rawDataSize,
-             location.rawData, status, loc_technology_mask);
-    // loop through adapters, and deliver to all adapters.
-    TO_ALL_LOCADAPTERS(
-        mLocAdapters[i]->reportPosition(location,
-                                        locationExtended,
-                                        locationExt,
-                                        status,
-                                        loc_technology_mask)
+             location.rawData, fix.getStatus(), fix.getTechMask());
+    // loop through adapters, and deliver to all subscribed adapters.
+    TO_SUBSCRIBED_LOCADAPTERS(LOC_API_DISPATCH_POSITION,
+        subscribers[i]->reportPosition(fix)
     );
 }
 
@@ -271,24 +397,26 @@ void LocApiBase::reportSv(HaxxSvStatus &svStatus,
                  svStatus.sv_list[i].elevation,
                  svStatus.sv_list[i].azimuth);
     }
-    // loop through adapters, and deliver to all adapters.
-    TO_ALL_LOCADAPTERS(
-        mLocAdapters[i]->reportSv(svStatus,
-                                     locationExtended,
-                                     svExt)
+    // loop through adapters, and deliver to all subscribed adapters.
+    TO_SUBSCRIBED_LOCADAPTERS(LOC_API_DISPATCH_SV,
+        subscribers[i]->reportSv(svStatus,
+                                                          locationExtended,
+                                                          svExt)
     );
 }
 
 void LocApiBase::reportStatus(GpsStatusValue status)
 {
-    // loop through adapters, and deliver to all adapters.
-    TO_ALL_LOCADAPTERS(mLocAdapters[i]->reportStatus(status));
+    // loop through adapters, and deliver to all subscribed adapters.
+    TO_SUBSCRIBED_LOCADAPTERS(LOC_API_DISPATCH_STATUS,
+        subscribers[i]->reportStatus(status));
 }
 
 void LocApiBase::reportNmea(const char* nmea, int length)
 {
-    // loop through adapters, and deliver to all adapters.
-    TO_ALL_LOCADAPTERS(mLocAdapters[i]->reportNmea(nmea, length));
+    // loop through adapters, and deliver to all subscribed adapters.
+    TO_SUBSCRIBED_LOCADAPTERS(LOC_API_DISPATCH_NMEA,
+        subscribers[i]->reportNmea(nmea, length));
 }
 
 void LocApiBase::reportXtraServer(const char* url1, const char* url2,
@@ -347,6 +475,12 @@ void LocApiBase::reportDataCallClosed()
     TO_1ST_HANDLING_LOCADAPTERS(mLocAdapters[i]->reportDataCallClosed());
 }
 
+void LocApiBase::reportDataCallRetry()
+{
+    // loop through adapters, and deliver to the first handling adapter.
+    TO_1ST_HANDLING_LOCADAPTERS(mLocAdapters[i]->reportDataCallRetry());
+}
+
 void LocApiBase::requestNiNotify(GpsNiNotification &notify, const void* data)
 {
     // loop through adapters, and deliver to the first handling adapter.
@@ -366,8 +500,9 @@ LocApiProxyBase* LocApiBase :: getLocApiProxy()
 
 void LocApiBase::reportGpsMeasurementData(GpsData &gpsMeasurementData)
 {
-    // loop through adapters, and deliver to all adapters.
-    TO_ALL_LOCADAPTERS(mLocAdapters[i]->reportGpsMeasurementData(gpsMeasurementData));
+    // loop through adapters, and deliver to all subscribed adapters.
+    TO_SUBSCRIBED_LOCADAPTERS(LOC_API_DISPATCH_GNSS_MEASUREMENT,
+        subscribers[i]->reportGpsMeasurementData(gpsMeasurementData));
 }
 
 enum loc_api_adapter_err LocApiBase::
@@ -436,6 +571,11 @@ enum loc_api_adapter_err LocApiBase::
               LocServerType type)
 DEFAULT_IMPL(LOC_API_ADAPTER_ERR_SUCCESS)
 
+enum loc_api_adapter_err LocApiBase::
+    setServerIpv6(const uint8_t* ip, int port,
+                  LocServerType type)
+DEFAULT_IMPL(LOC_API_ADAPTER_ERR_SUCCESS)
+
 enum loc_api_adapter_err LocApiBase::
     informNiResponse(GpsUserResponseType userResponse,
                      const void* passThroughData)
@@ -31,7 +31,9 @@
 
 #include <stddef.h>
 #include <ctype.h>
+#include <pthread.h>
 #include <gps_extended.h>
+#include <LocFix.h>
 #include <MsgTask.h>
 #include <log_util.h>
 
@@ -53,6 +55,17 @@ int decodeAddress(char *addr_string, int string_size,
 #define TO_1ST_HANDLING_ADAPTER(adapters, call)                              \
     for (int i = 0; i <MAX_ADAPTERS && NULL != (adapters)[i] && !(call); i++);
 
+// Broadcast events that are delivered only to the adapters whose event
+// mask subscribes to them. See LocApiBase::mEvtSubscribers.
+enum loc_api_dispatch_event {
+    LOC_API_DISPATCH_POSITION = 0,
+    LOC_API_DISPATCH_SV,
+    LOC_API_DISPATCH_NMEA,
+    LOC_API_DISPATCH_STATUS,
+    LOC_API_DISPATCH_GNSS_MEASUREMENT,
+    LOC_API_DISPATCH_MAX
+};
+
 enum xtra_version_check {
     DISABLED,
     AUTO,
@@ -80,8 +93,32 @@ class LocApiBase {
     const MsgTask* mMsgTask;
     ContextBase *mContext;
     LocAdapterBase* mLocAdapters[MAX_ADAPTERS];
+    // event masks mLocAdapters were last accounted with, same order
+    LOC_API_ADAPTER_EVENT_MASK_T mAdapterMasks[MAX_ADAPTERS];
+    // NULL terminated adapter lists, one per loc_api_dispatch_event, in
+    // two copies. Event delivery walks mEvtSubscribers[mEvtSubscribersIdx]
+    // while rebuildSubscribers() fills in the other copy and then flips
+    // the index, so that lists are never changed under a reader.
+    LocAdapterBase* mEvtSubscribers[2][LOC_API_DISPATCH_MAX][MAX_ADAPTERS];
+    volatile int32_t mEvtSubscribersIdx;
+    // number of event deliveries walking each copy
+    volatile int32_t mEvtSubscribersReaders[2];
+    // serializes rebuildSubscribers()
+    pthread_mutex_t mEvtSubscribersLock;
+    // number of adapters subscribed to each event mask bit
+    uint8_t mEvtBitRefs[sizeof(LOC_API_ADAPTER_EVENT_MASK_T) << 3];
+    // OR of all adapter event masks, kept in step with mEvtBitRefs
+    LOC_API_ADAPTER_EVENT_MASK_T mAggregateMask;
     uint64_t mSupportedMsg;
 
+    void accountMask(LOC_API_ADAPTER_EVENT_MASK_T oldMask,
+                     LOC_API_ADAPTER_EVENT_MASK_T newMask);
+    void rebuildSubscribers();
+    // returns the index of the subscriber lists to deliver events with,
+    // to be handed back with releaseSubscribers() once done
+    int acquireSubscribers();
+    void releaseSubscribers(int idx);
+
 protected:
     virtual enum loc_api_adapter_err
         open(LOC_API_ADAPTER_EVENT_MASK_T mask);
@@ -92,7 +129,10 @@ protected:
     LocApiBase(const MsgTask* msgTask,
                LOC_API_ADAPTER_EVENT_MASK_T excludedMask,
                ContextBase* context = NULL);
-    inline virtual ~LocApiBase() { close(); }
+    inline virtual ~LocApiBase() {
+        close();
+        pthread_mutex_destroy(&mEvtSubscribersLock);
+    }
     bool isInSession();
     const LOC_API_ADAPTER_EVENT_MASK_T mExcludedMask;
 
@@ -113,6 +153,7 @@ public:
                         enum loc_sess_status status,
                         LocPosTechMask loc_technology_mask =
                                   LOC_POS_TECH_MASK_DEFAULT);
+    void reportPosition(LocFix& fix);
     void reportSv(HaxxSvStatus &svStatus,
                   GpsLocationExtended &locationExtended,
                   void* svExt);
@@ -128,6 +169,7 @@ public:
     void requestSuplES(int connHandle);
     void reportDataCallOpened();
     void reportDataCallClosed();
+    void reportDataCallRetry();
     void requestNiNotify(GpsNiNotification &notify, const void* data);
     void saveSupportedMsgList(uint64_t supportedMsgList);
     void reportGpsMeasurementData(GpsData &gpsMeasurementData);
@@ -167,6 +209,9 @@ public:
     virtual enum loc_api_adapter_err
         setServer(unsigned int ip, int port,
                   LocServerType type);
+    virtual enum loc_api_adapter_err
+        setServerIpv6(const uint8_t* ip, int port,
+                      LocServerType type);
     virtual enum loc_api_adapter_err
         informNiResponse(GpsUserResponseType userResponse, const void* passThroughData);
     virtual enum loc_api_adapter_err
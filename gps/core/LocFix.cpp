@@ -0,0 +1,125 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDDEBUG 0
+#define LOG_TAG "LocSvc_LocFix"
+
+#include <pthread.h>
+#include <LocFix.h>
+#include <log_util.h>
+
+namespace loc_core {
+
+// fixes kept around for reuse; a session has at most a few in flight
+#define LOC_FIX_POOL_MAX 8
+
+static pthread_mutex_t sPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+static LocFix* sPool = NULL;
+static int sPoolSize = 0;
+
+void LocFix::reset()
+{
+    mRef = 1;
+    mNext = NULL;
+    memset(&mLocation, 0, sizeof(mLocation));
+    mLocation.size = sizeof(mLocation);
+    memset(&mLocationExtended, 0, sizeof(mLocationExtended));
+    mLocationExtended.size = sizeof(mLocationExtended);
+    mLocationExt = NULL;
+    mStatus = LOC_SESS_FAILURE;
+    mTechMask = LOC_POS_TECH_MASK_DEFAULT;
+}
+
+LocFix* LocFix::obtain()
+{
+    LocFix* fix = NULL;
+
+    pthread_mutex_lock(&sPoolMutex);
+    if (NULL != sPool) {
+        fix = sPool;
+        sPool = fix->mNext;
+        sPoolSize--;
+    }
+    pthread_mutex_unlock(&sPoolMutex);
+
+    if (NULL == fix) {
+        fix = new LocFix();
+    }
+    fix->reset();
+
+    return fix;
+}
+
+LocFix* LocFix::obtain(const UlpLocation& location,
+                       const GpsLocationExtended& locationExtended,
+                       void* locationExt,
+                       enum loc_sess_status status,
+                       LocPosTechMask techMask)
+{
+    LocFix* fix = obtain();
+
+    fix->mLocation = location;
+    // the caller keeps its rawData; the fix holds a copy of its own
+    fix->mLocation.rawData = NULL;
+    fix->mLocation.rawDataSize = 0;
+    if (NULL != location.rawData && location.rawDataSize > 0) {
+        char* rawData = new char[location.rawDataSize];
+        memcpy(rawData, location.rawData, location.rawDataSize);
+        fix->mLocation.rawData = rawData;
+        fix->mLocation.rawDataSize = location.rawDataSize;
+    }
+    fix->mLocationExtended = locationExtended;
+    fix->mLocationExt = locationExt;
+    fix->mStatus = status;
+    fix->mTechMask = techMask;
+
+    return fix;
+}
+
+void LocFix::recycle(LocFix* fix)
+{
+    // rawData is always a new[] buffer owned by the fix
+    if (NULL != fix->mLocation.rawData) {
+        delete[] (char*)fix->mLocation.rawData;
+        fix->mLocation.rawData = NULL;
+        fix->mLocation.rawDataSize = 0;
+    }
+
+    pthread_mutex_lock(&sPoolMutex);
+    if (sPoolSize < LOC_FIX_POOL_MAX) {
+        fix->mNext = sPool;
+        sPool = fix;
+        sPoolSize++;
+        fix = NULL;
+    }
+    pthread_mutex_unlock(&sPoolMutex);
+
+    delete fix;
+}
+
+} // namespace loc_core
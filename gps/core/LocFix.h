@@ -0,0 +1,97 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef LOC_FIX_H
+#define LOC_FIX_H
+
+#include <stddef.h>
+#include <cutils/atomic.h>
+#include <gps_extended.h>
+
+namespace loc_core {
+
+// An immutable, reference counted position report. It is filled in once
+// where the report enters the HAL, and from then on handed by pointer
+// through LocApiBase, the adapters, the ULP proxy and the engine messages,
+// instead of each hop copying UlpLocation and GpsLocationExtended.
+// Like LocSharedLock, the creator holds the first reference, every other
+// holder share()s it and drop()s it when done. Fixes whose last reference
+// is dropped go back to a small pool for the next report.
+class LocFix {
+    volatile int32_t mRef;
+    LocFix* mNext;                      // pool link, only while pooled
+    UlpLocation mLocation;
+    GpsLocationExtended mLocationExtended;
+    void* mLocationExt;
+    enum loc_sess_status mStatus;
+    LocPosTechMask mTechMask;
+
+    inline LocFix() : mRef(1), mNext(NULL) {}
+    inline ~LocFix() {}
+    void reset();
+    static void recycle(LocFix* fix);
+
+public:
+    // a blank fix with a single reference, for the creator to fill in
+    static LocFix* obtain();
+    // a fix filled with copies of the given report, for callers
+    // that still hand out positions as separate structs; rawData is
+    // copied too, so the caller still owns and frees its own buffer
+    static LocFix* obtain(const UlpLocation& location,
+                          const GpsLocationExtended& locationExtended,
+                          void* locationExt,
+                          enum loc_sess_status status,
+                          LocPosTechMask techMask);
+
+    inline LocFix* share() { android_atomic_inc(&mRef); return this; }
+    inline void drop() { if (1 == android_atomic_dec(&mRef)) recycle(this); }
+
+    // creator only, and only before the fix is shared; a rawData set
+    // here must come from new char[], the fix delete[]s it when recycled
+    inline UlpLocation& editLocation() { return mLocation; }
+    inline GpsLocationExtended& editLocationExtended() {
+        return mLocationExtended;
+    }
+    inline void setLocationExt(void* locationExt) { mLocationExt = locationExt; }
+    inline void setStatus(enum loc_sess_status status) { mStatus = status; }
+    inline void setTechMask(LocPosTechMask techMask) { mTechMask = techMask; }
+
+    inline const UlpLocation& getLocation() const { return mLocation; }
+    inline const GpsLocationExtended& getLocationExtended() const {
+        return mLocationExtended;
+    }
+    // the raw report this fix was made from; only valid during the
+    // synchronous LocApiBase::reportPosition() call, not after it returns
+    inline void* getLocationExt() const { return mLocationExt; }
+    inline enum loc_sess_status getStatus() const { return mStatus; }
+    inline LocPosTechMask getTechMask() const { return mTechMask; }
+};
+
+} // namespace loc_core
+
+#endif // LOC_FIX_H
@@ -30,6 +30,7 @@
 #define ULP_PROXY_BASE_H
 
 #include <gps_extended.h>
+#include <LocFix.h>
 
 struct FlpExtLocation_s;
 struct FlpExtBatchOptions;
@@ -61,6 +62,15 @@ public:
                                        LocPosTechMask loc_technology_mask) {
         return false;
     }
+    // proxies that can hold on to the fix should override this one
+    inline virtual bool reportPosition(LocFix& fix) {
+        return reportPosition(const_cast<UlpLocation&>(fix.getLocation()),
+                              const_cast<GpsLocationExtended&>(
+                                  fix.getLocationExtended()),
+                              fix.getLocationExt(),
+                              fix.getStatus(),
+                              fix.getTechMask());
+    }
     inline virtual bool reportSv(HaxxSvStatus &svStatus,
                                  GpsLocationExtended &locationExtended,
                                  void* svExt) {
@@ -79,6 +89,11 @@ public:
                                         int32_t number_of_locations) {
         return false;
     }
+    // proxies that take batches through reportPositions() should override
+    // this one, fixes are only held back for batching when it is true
+    inline virtual bool canReportPositions() {
+        return false;
+    }
 };
 
 } // namespace loc_core
@@ -48,56 +48,45 @@ void LocPosMode::logv() const
               provider);
 }
 
-/* GPS status names */
-static const loc_name_val_s_type gps_status_name[] =
-{
-    NAME_VAL( GPS_STATUS_NONE ),
-    NAME_VAL( GPS_STATUS_SESSION_BEGIN ),
-    NAME_VAL( GPS_STATUS_SESSION_END ),
-    NAME_VAL( GPS_STATUS_ENGINE_ON ),
-    NAME_VAL( GPS_STATUS_ENGINE_OFF ),
-};
-static const int gps_status_num = sizeof(gps_status_name) / sizeof(loc_name_val_s_type);
-
 /* Find Android GPS status name */
 const char* loc_get_gps_status_name(GpsStatusValue gps_status)
 {
-   return loc_get_name_from_val(gps_status_name, gps_status_num,
-         (long) gps_status);
+    switch (gps_status) {
+    NAME_CASE( GPS_STATUS_NONE )
+    NAME_CASE( GPS_STATUS_SESSION_BEGIN )
+    NAME_CASE( GPS_STATUS_SESSION_END )
+    NAME_CASE( GPS_STATUS_ENGINE_ON )
+    NAME_CASE( GPS_STATUS_ENGINE_OFF )
+    default: return UNKNOWN_STR;
+    }
 }
 
 
 
-static const loc_name_val_s_type loc_eng_position_modes[] =
-{
-    NAME_VAL( LOC_POSITION_MODE_STANDALONE ),
-    NAME_VAL( LOC_POSITION_MODE_MS_BASED ),
-    NAME_VAL( LOC_POSITION_MODE_MS_ASSISTED ),
-    NAME_VAL( LOC_POSITION_MODE_RESERVED_1 ),
-    NAME_VAL( LOC_POSITION_MODE_RESERVED_2 ),
-    NAME_VAL( LOC_POSITION_MODE_RESERVED_3 ),
-    NAME_VAL( LOC_POSITION_MODE_RESERVED_4 ),
-    NAME_VAL( LOC_POSITION_MODE_RESERVED_5 )
-};
-static const int loc_eng_position_mode_num = sizeof(loc_eng_position_modes) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_position_mode_name(GpsPositionMode mode)
 {
-    return loc_get_name_from_val(loc_eng_position_modes, loc_eng_position_mode_num, (long) mode);
+    switch (mode) {
+    NAME_CASE( LOC_POSITION_MODE_STANDALONE )
+    NAME_CASE( LOC_POSITION_MODE_MS_BASED )
+    NAME_CASE( LOC_POSITION_MODE_MS_ASSISTED )
+    NAME_CASE( LOC_POSITION_MODE_RESERVED_1 )
+    NAME_CASE( LOC_POSITION_MODE_RESERVED_2 )
+    NAME_CASE( LOC_POSITION_MODE_RESERVED_3 )
+    NAME_CASE( LOC_POSITION_MODE_RESERVED_4 )
+    NAME_CASE( LOC_POSITION_MODE_RESERVED_5 )
+    default: return UNKNOWN_STR;
+    }
 }
 
 
 
-static const loc_name_val_s_type loc_eng_position_recurrences[] =
-{
-    NAME_VAL( GPS_POSITION_RECURRENCE_PERIODIC ),
-    NAME_VAL( GPS_POSITION_RECURRENCE_SINGLE )
-};
-static const int loc_eng_position_recurrence_num = sizeof(loc_eng_position_recurrences) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_position_recurrence_name(GpsPositionRecurrence recur)
 {
-    return loc_get_name_from_val(loc_eng_position_recurrences, loc_eng_position_recurrence_num, (long) recur);
+    switch (recur) {
+    NAME_CASE( GPS_POSITION_RECURRENCE_PERIODIC )
+    NAME_CASE( GPS_POSITION_RECURRENCE_SINGLE )
+    default: return UNKNOWN_STR;
+    }
 }
 
 
@@ -126,118 +115,96 @@ const char* loc_get_aiding_data_mask_names(GpsAidingData data)
 }
 
 
-static const loc_name_val_s_type loc_eng_agps_types[] =
-{
-    NAME_VAL( AGPS_TYPE_INVALID ),
-    NAME_VAL( AGPS_TYPE_ANY ),
-    NAME_VAL( AGPS_TYPE_SUPL ),
-    NAME_VAL( AGPS_TYPE_C2K ),
-    NAME_VAL( AGPS_TYPE_WWAN_ANY )
-};
-static const int loc_eng_agps_type_num = sizeof(loc_eng_agps_types) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_agps_type_name(AGpsType type)
 {
-    return loc_get_name_from_val(loc_eng_agps_types, loc_eng_agps_type_num, (long) type);
+    // callers pass AGpsExtType, whose AGPS_TYPE_INVALID (-1) arrives here
+    // as 0xffff; switching on the signed type maps it back
+    switch ((AGpsExtType)type) {
+    NAME_CASE( AGPS_TYPE_INVALID )
+    NAME_CASE( AGPS_TYPE_ANY )
+    NAME_CASE( AGPS_TYPE_SUPL )
+    NAME_CASE( AGPS_TYPE_C2K )
+    NAME_CASE( AGPS_TYPE_WWAN_ANY )
+    default: return UNKNOWN_STR;
+    }
 }
 
 
-static const loc_name_val_s_type loc_eng_ni_types[] =
-{
-    NAME_VAL( GPS_NI_TYPE_VOICE ),
-    NAME_VAL( GPS_NI_TYPE_UMTS_SUPL ),
-    NAME_VAL( GPS_NI_TYPE_UMTS_CTRL_PLANE ),
-    NAME_VAL( GPS_NI_TYPE_EMERGENCY_SUPL )
-};
-static const int loc_eng_ni_type_num = sizeof(loc_eng_ni_types) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_ni_type_name(GpsNiType type)
 {
-    return loc_get_name_from_val(loc_eng_ni_types, loc_eng_ni_type_num, (long) type);
+    switch (type) {
+    NAME_CASE( GPS_NI_TYPE_VOICE )
+    NAME_CASE( GPS_NI_TYPE_UMTS_SUPL )
+    NAME_CASE( GPS_NI_TYPE_UMTS_CTRL_PLANE )
+    NAME_CASE( GPS_NI_TYPE_EMERGENCY_SUPL )
+    default: return UNKNOWN_STR;
+    }
 }
 
 
-static const loc_name_val_s_type loc_eng_ni_responses[] =
-{
-    NAME_VAL( GPS_NI_RESPONSE_ACCEPT ),
-    NAME_VAL( GPS_NI_RESPONSE_DENY ),
-    NAME_VAL( GPS_NI_RESPONSE_DENY )
-};
-static const int loc_eng_ni_reponse_num = sizeof(loc_eng_ni_responses) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_ni_response_name(GpsUserResponseType response)
 {
-    return loc_get_name_from_val(loc_eng_ni_responses, loc_eng_ni_reponse_num, (long) response);
+    switch (response) {
+    NAME_CASE( GPS_NI_RESPONSE_ACCEPT )
+    NAME_CASE( GPS_NI_RESPONSE_DENY )
+    NAME_CASE( GPS_NI_RESPONSE_NORESP )
+    default: return UNKNOWN_STR;
+    }
 }
 
 
-static const loc_name_val_s_type loc_eng_ni_encodings[] =
-{
-    NAME_VAL( GPS_ENC_NONE ),
-    NAME_VAL( GPS_ENC_SUPL_GSM_DEFAULT ),
-    NAME_VAL( GPS_ENC_SUPL_UTF8 ),
-    NAME_VAL( GPS_ENC_SUPL_UCS2 ),
-    NAME_VAL( GPS_ENC_UNKNOWN )
-};
-static const int loc_eng_ni_encoding_num = sizeof(loc_eng_ni_encodings) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_ni_encoding_name(GpsNiEncodingType encoding)
 {
-    return loc_get_name_from_val(loc_eng_ni_encodings, loc_eng_ni_encoding_num, (long) encoding);
+    switch (encoding) {
+    NAME_CASE( GPS_ENC_NONE )
+    NAME_CASE( GPS_ENC_SUPL_GSM_DEFAULT )
+    NAME_CASE( GPS_ENC_SUPL_UTF8 )
+    NAME_CASE( GPS_ENC_SUPL_UCS2 )
+    NAME_CASE( GPS_ENC_UNKNOWN )
+    default: return UNKNOWN_STR;
+    }
 }
 
-static const loc_name_val_s_type loc_eng_agps_bears[] =
-{
-    NAME_VAL( AGPS_APN_BEARER_INVALID ),
-    NAME_VAL( AGPS_APN_BEARER_IPV4 ),
-    NAME_VAL( AGPS_APN_BEARER_IPV6 ),
-    NAME_VAL( AGPS_APN_BEARER_IPV4V6 )
-};
-static const int loc_eng_agps_bears_num = sizeof(loc_eng_agps_bears) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_agps_bear_name(AGpsBearerType bearer)
 {
-    return loc_get_name_from_val(loc_eng_agps_bears, loc_eng_agps_bears_num, (long) bearer);
+    switch (bearer) {
+    NAME_CASE( AGPS_APN_BEARER_INVALID )
+    NAME_CASE( AGPS_APN_BEARER_IPV4 )
+    NAME_CASE( AGPS_APN_BEARER_IPV6 )
+    NAME_CASE( AGPS_APN_BEARER_IPV4V6 )
+    default: return UNKNOWN_STR;
+    }
 }
 
-static const loc_name_val_s_type loc_eng_server_types[] =
-{
-    NAME_VAL( LOC_AGPS_CDMA_PDE_SERVER ),
-    NAME_VAL( LOC_AGPS_CUSTOM_PDE_SERVER ),
-    NAME_VAL( LOC_AGPS_MPC_SERVER ),
-    NAME_VAL( LOC_AGPS_SUPL_SERVER )
-};
-static const int loc_eng_server_types_num = sizeof(loc_eng_server_types) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_server_type_name(LocServerType type)
 {
-    return loc_get_name_from_val(loc_eng_server_types, loc_eng_server_types_num, (long) type);
+    switch (type) {
+    NAME_CASE( LOC_AGPS_CDMA_PDE_SERVER )
+    NAME_CASE( LOC_AGPS_CUSTOM_PDE_SERVER )
+    NAME_CASE( LOC_AGPS_MPC_SERVER )
+    NAME_CASE( LOC_AGPS_SUPL_SERVER )
+    default: return UNKNOWN_STR;
+    }
 }
 
-static const loc_name_val_s_type loc_eng_position_sess_status_types[] =
-{
-    NAME_VAL( LOC_SESS_SUCCESS ),
-    NAME_VAL( LOC_SESS_INTERMEDIATE ),
-    NAME_VAL( LOC_SESS_FAILURE )
-};
-static const int loc_eng_position_sess_status_num = sizeof(loc_eng_position_sess_status_types) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_position_sess_status_name(enum loc_sess_status status)
 {
-    return loc_get_name_from_val(loc_eng_position_sess_status_types, loc_eng_position_sess_status_num, (long) status);
+    switch (status) {
+    NAME_CASE( LOC_SESS_SUCCESS )
+    NAME_CASE( LOC_SESS_INTERMEDIATE )
+    NAME_CASE( LOC_SESS_FAILURE )
+    default: return UNKNOWN_STR;
+    }
 }
 
-static const loc_name_val_s_type loc_eng_agps_status_names[] =
-{
-    NAME_VAL( GPS_REQUEST_AGPS_DATA_CONN ),
-    NAME_VAL( GPS_RELEASE_AGPS_DATA_CONN ),
-    NAME_VAL( GPS_AGPS_DATA_CONNECTED ),
-    NAME_VAL( GPS_AGPS_DATA_CONN_DONE ),
-    NAME_VAL( GPS_AGPS_DATA_CONN_FAILED )
-};
-static const int loc_eng_agps_status_num = sizeof(loc_eng_agps_status_names) / sizeof(loc_name_val_s_type);
-
 const char* loc_get_agps_status_name(AGpsStatusValue status)
 {
-    return loc_get_name_from_val(loc_eng_agps_status_names, loc_eng_agps_status_num, (long) status);
+    switch (status) {
+    NAME_CASE( GPS_REQUEST_AGPS_DATA_CONN )
+    NAME_CASE( GPS_RELEASE_AGPS_DATA_CONN )
+    NAME_CASE( GPS_AGPS_DATA_CONNECTED )
+    NAME_CASE( GPS_AGPS_DATA_CONN_DONE )
+    NAME_CASE( GPS_AGPS_DATA_CONN_FAILED )
+    default: return UNKNOWN_STR;
+    }
 }
@@ -0,0 +1,60 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef __FAKES_FOR_HOST_COMMON_V01_H__
+#define __FAKES_FOR_HOST_COMMON_V01_H__
+
+// Host stand-in for the QMI common service types.
+
+#include <stdint.h>
+
+typedef enum {
+    QMI_RESULT_SUCCESS_V01 = 0,
+    QMI_RESULT_FAILURE_V01 = 1
+} qmi_result_type_v01;
+
+typedef enum {
+    QMI_ERR_NONE_V01 = 0x0000,
+    QMI_ERR_INTERNAL_V01 = 0x0003
+} qmi_error_type_v01;
+
+typedef struct {
+    qmi_result_type_v01 result;
+    qmi_error_type_v01 error;
+} qmi_response_type_v01;
+
+#define QMI_SUPPORTED_MSGS_MAX_V01 8188
+
+typedef struct {
+    qmi_response_type_v01 resp;
+    uint8_t supported_msgs_valid;
+    uint32_t supported_msgs_len;
+    uint8_t supported_msgs[QMI_SUPPORTED_MSGS_MAX_V01];
+} qmi_get_supported_msgs_resp_v01;
+
+#endif //__FAKES_FOR_HOST_COMMON_V01_H__
@@ -0,0 +1,92 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef __FAKES_FOR_HOST_CUTILS_ATOMIC_H__
+#define __FAKES_FOR_HOST_CUTILS_ATOMIC_H__
+
+// Host stand-in for the cutils atomics, on top of the gcc __atomic builtins.
+// Return values follow cutils: inc/dec/add/and/or return the old value, the
+// cas functions return 0 on success.
+
+#include <stdint.h>
+#include <sys/types.h>
+
+static inline int32_t android_atomic_inc(volatile int32_t* addr) {
+    return __atomic_fetch_add(addr, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline int32_t android_atomic_dec(volatile int32_t* addr) {
+    return __atomic_fetch_sub(addr, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline int32_t android_atomic_add(int32_t value, volatile int32_t* addr) {
+    return __atomic_fetch_add(addr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline int32_t android_atomic_and(int32_t value, volatile int32_t* addr) {
+    return __atomic_fetch_and(addr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline int32_t android_atomic_or(int32_t value, volatile int32_t* addr) {
+    return __atomic_fetch_or(addr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline int32_t android_atomic_acquire_load(volatile const int32_t* addr) {
+    return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+}
+
+static inline int32_t android_atomic_release_load(volatile const int32_t* addr) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return __atomic_load_n(addr, __ATOMIC_RELAXED);
+}
+
+static inline void android_atomic_acquire_store(int32_t value, volatile int32_t* addr) {
+    __atomic_store_n(addr, value, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void android_atomic_release_store(int32_t value, volatile int32_t* addr) {
+    __atomic_store_n(addr, value, __ATOMIC_RELEASE);
+}
+
+static inline int android_atomic_acquire_cas(int32_t oldvalue, int32_t newvalue,
+                                             volatile int32_t* addr) {
+    return !__atomic_compare_exchange_n(addr, &oldvalue, newvalue, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+}
+
+static inline int android_atomic_release_cas(int32_t oldvalue, int32_t newvalue,
+                                             volatile int32_t* addr) {
+    return !__atomic_compare_exchange_n(addr, &oldvalue, newvalue, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+#define android_atomic_cas android_atomic_acquire_cas
+#define android_memory_barrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif //__FAKES_FOR_HOST_CUTILS_ATOMIC_H__
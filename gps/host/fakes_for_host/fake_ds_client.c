@@ -0,0 +1,70 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Stand-in for libloc_ds_api on the host: there is no modem data service,
+// so every emergency data call fails the way it does when dsi is absent.
+
+#include <stddef.h>
+#include <ds_client.h>
+
+int ds_client_init()
+{
+    return E_DS_CLIENT_FAILURE_SERVICE_NOT_PRESENT;
+}
+
+ds_client_status_enum_type ds_client_open_call(dsClientHandleType *client_handle,
+                                               ds_client_cb_data *callback,
+                                               void *loc_adapter_cookie,
+                                               int *profile_index,
+                                               int *pdp_type)
+{
+    if (NULL != client_handle) {
+        *client_handle = NULL;
+    }
+    return E_DS_CLIENT_FAILURE_SERVICE_NOT_PRESENT;
+}
+
+ds_client_status_enum_type ds_client_start_call(dsClientHandleType client_handle,
+                                                int profile_index,
+                                                int pdp_type)
+{
+    return E_DS_CLIENT_FAILURE_INVALID_HANDLE;
+}
+
+ds_client_status_enum_type ds_client_stop_call(dsClientHandleType client_handle)
+{
+    return E_DS_CLIENT_FAILURE_INVALID_HANDLE;
+}
+
+void ds_client_close_call(dsClientHandleType *client_handle)
+{
+    if (NULL != client_handle) {
+        *client_handle = NULL;
+    }
+}
@@ -0,0 +1,156 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+// Host implementations of the Android system library functions used by
+// libgps.utils, libloc_core and libloc_eng. See the headers next to this
+// file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+#include <cutils/log.h>
+#include <cutils/properties.h>
+#include <cutils/sched_policy.h>
+#include <utils/SystemClock.h>
+
+static int sLogPrio = -1;
+
+static int getLogPrio() {
+    if (sLogPrio < 0) {
+        const char* prio = getenv("LOC_HOST_LOG_PRIO");
+        sLogPrio = (NULL == prio) ? ANDROID_LOG_WARN : atoi(prio);
+    }
+    return sLogPrio;
+}
+
+extern "C" int __android_log_print(int prio, const char* tag,
+                                   const char* fmt, ...) {
+    static const char kPrioChar[] = "??VDIWEFS";
+    if (prio < getLogPrio()) {
+        return 0;
+    }
+
+    char msg[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    // the loc libraries end most messages with a newline of their own
+    size_t len = strlen(msg);
+    if (len > 0 && '\n' == msg[len - 1]) {
+        msg[len - 1] = '\0';
+    }
+    return fprintf(stderr, "%c/%s: %s\n",
+                   kPrioChar[(prio > 0 && prio <= ANDROID_LOG_SILENT) ? prio : 0],
+                   (NULL == tag) ? "" : tag, msg);
+}
+
+extern "C" int property_get(const char* key, char* value,
+                            const char* default_value) {
+    char envKey[PROPERTY_KEY_MAX * 2];
+    const char* found = NULL;
+    int len = 0;
+
+    strlcpy(envKey, key, sizeof(envKey));
+    for (char* p = envKey; *p != '\0'; p++) {
+        if ('.' == *p) {
+            *p = '_';
+        }
+    }
+    found = getenv(envKey);
+    if (NULL == found) {
+        found = default_value;
+    }
+    if (NULL != found) {
+        len = strlcpy(value, found, PROPERTY_VALUE_MAX);
+        if (len >= PROPERTY_VALUE_MAX) {
+            len = PROPERTY_VALUE_MAX - 1;
+        }
+    } else {
+        value[0] = '\0';
+    }
+    return len;
+}
+
+extern "C" int property_set(const char* key, const char* value) {
+    return -1;
+}
+
+extern "C" int set_sched_policy(int tid, SchedPolicy policy) {
+    return 0;
+}
+
+extern "C" int get_sched_policy(int tid, SchedPolicy* policy) {
+    *policy = SP_FOREGROUND;
+    return 0;
+}
+
+static int64_t clockNs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+namespace android {
+
+int64_t uptimeMillis() {
+    return clockNs(CLOCK_MONOTONIC) / 1000000;
+}
+
+int64_t elapsedRealtime() {
+    return clockNs(CLOCK_BOOTTIME) / 1000000;
+}
+
+int64_t elapsedRealtimeNano() {
+    return clockNs(CLOCK_BOOTTIME);
+}
+
+} // namespace android
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t copy = (len < size - 1) ? len : size - 1;
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return len;
+}
+
+extern "C" size_t strlcat(char* dst, const char* src, size_t size) {
+    size_t dstLen = strnlen(dst, size);
+    if (dstLen == size) {
+        return size + strlen(src);
+    }
+    return dstLen + strlcpy(dst + dstLen, src, size - dstLen);
+}
+#endif
@@ -0,0 +1,497 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef __FAKES_FOR_HOST_HARDWARE_GPS_H__
+#define __FAKES_FOR_HOST_HARDWARE_GPS_H__
+
+// Host stand-in for the subset of <hardware/gps.h> that libloc_core,
+// libloc_eng and the HAL entry points in loc.cpp use. Types, field order
+// and values follow the platform header.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <pthread.h>
+
+#define GPS_HARDWARE_MODULE_ID "gps"
+
+typedef int64_t GpsUtcTime;
+
+#define GPS_XTRA_INTERFACE              "gps-xtra"
+#define AGPS_INTERFACE                  "agps"
+#define SUPL_CERTIFICATE_INTERFACE      "supl-certificate"
+#define GPS_NI_INTERFACE                "gps-ni"
+#define AGPS_RIL_INTERFACE              "agps_ril"
+#define GPS_GEOFENCING_INTERFACE        "gps_geofencing"
+#define GPS_MEASUREMENT_INTERFACE       "gps_measurement"
+#define GNSS_CONFIGURATION_INTERFACE    "gnss_configuration"
+
+#define GPS_MAX_SVS 32
+#define GPS_MAX_MEASUREMENT 32
+
+typedef uint32_t GpsPositionMode;
+#define GPS_POSITION_MODE_STANDALONE    0
+#define GPS_POSITION_MODE_MS_BASED      1
+#define GPS_POSITION_MODE_MS_ASSISTED   2
+
+typedef uint32_t GpsPositionRecurrence;
+#define GPS_POSITION_RECURRENCE_PERIODIC    0
+#define GPS_POSITION_RECURRENCE_SINGLE      1
+
+typedef uint16_t GpsStatusValue;
+#define GPS_STATUS_NONE             0
+#define GPS_STATUS_SESSION_BEGIN    1
+#define GPS_STATUS_SESSION_END      2
+#define GPS_STATUS_ENGINE_ON        3
+#define GPS_STATUS_ENGINE_OFF       4
+
+typedef uint16_t GpsLocationFlags;
+#define GPS_LOCATION_HAS_LAT_LONG   0x0001
+#define GPS_LOCATION_HAS_ALTITUDE   0x0002
+#define GPS_LOCATION_HAS_SPEED      0x0004
+#define GPS_LOCATION_HAS_BEARING    0x0008
+#define GPS_LOCATION_HAS_ACCURACY   0x0010
+
+typedef uint16_t GpsAidingData;
+#define GPS_DELETE_EPHEMERIS        0x0001
+#define GPS_DELETE_ALMANAC          0x0002
+#define GPS_DELETE_POSITION         0x0004
+#define GPS_DELETE_TIME             0x0008
+#define GPS_DELETE_IONO             0x0010
+#define GPS_DELETE_UTC              0x0020
+#define GPS_DELETE_HEALTH           0x0040
+#define GPS_DELETE_SVDIR            0x0080
+#define GPS_DELETE_SVSTEER          0x0100
+#define GPS_DELETE_SADATA           0x0200
+#define GPS_DELETE_RTI              0x0400
+#define GPS_DELETE_CELLDB_INFO      0x8000
+#define GPS_DELETE_ALL              0xFFFF
+
+typedef uint32_t GpsCapabilityFlags;
+#define GPS_CAPABILITY_SCHEDULING       0x0000001
+#define GPS_CAPABILITY_MSB              0x0000002
+#define GPS_CAPABILITY_MSA              0x0000004
+#define GPS_CAPABILITY_SINGLE_SHOT      0x0000008
+#define GPS_CAPABILITY_ON_DEMAND_TIME   0x0000010
+#define GPS_CAPABILITY_GEOFENCING       0x0000020
+#define GPS_CAPABILITY_MEASUREMENTS     0x0000040
+#define GPS_CAPABILITY_NAV_MESSAGES     0x0000080
+
+typedef uint16_t AGpsType;
+#define AGPS_TYPE_SUPL          1
+#define AGPS_TYPE_C2K           2
+
+typedef uint16_t AGpsSetIDType;
+#define AGPS_SETID_TYPE_NONE    0
+#define AGPS_SETID_TYPE_IMSI    1
+#define AGPS_SETID_TYPE_MSISDN  2
+
+typedef uint16_t AGpsRefLocationType;
+#define AGPS_REF_LOCATION_TYPE_GSM_CELLID   1
+#define AGPS_REF_LOCATION_TYPE_UMTS_CELLID  2
+#define AGPS_REG_LOCATION_TYPE_MAC          3
+#define AGPS_REF_LOCATION_TYPE_LTE_CELLID   4
+
+typedef uint16_t ApnIpType;
+#define APN_IP_INVALID          0
+#define APN_IP_IPV4             1
+#define APN_IP_IPV6             2
+#define APN_IP_IPV4V6           3
+
+typedef uint16_t AGpsStatusValue;
+#define GPS_REQUEST_AGPS_DATA_CONN  1
+#define GPS_RELEASE_AGPS_DATA_CONN  2
+#define GPS_AGPS_DATA_CONNECTED     3
+#define GPS_AGPS_DATA_CONN_DONE     4
+#define GPS_AGPS_DATA_CONN_FAILED   5
+
+#define AGPS_CERTIFICATE_OPERATION_SUCCESS               0
+#define AGPS_CERTIFICATE_ERROR_GENERIC                -100
+#define AGPS_CERTIFICATE_ERROR_TOO_MANY_CERTIFICATES  -101
+
+typedef uint32_t GpsNiType;
+#define GPS_NI_TYPE_VOICE              1
+#define GPS_NI_TYPE_UMTS_SUPL          2
+#define GPS_NI_TYPE_UMTS_CTRL_PLANE    3
+
+typedef uint32_t GpsNiNotifyFlags;
+#define GPS_NI_NEED_NOTIFY          0x0001
+#define GPS_NI_NEED_VERIFY          0x0002
+#define GPS_NI_PRIVACY_OVERRIDE     0x0004
+
+typedef int GpsUserResponseType;
+#define GPS_NI_RESPONSE_ACCEPT         1
+#define GPS_NI_RESPONSE_DENY           2
+#define GPS_NI_RESPONSE_NORESP         3
+
+typedef int GpsNiEncodingType;
+#define GPS_ENC_NONE                   0
+#define GPS_ENC_SUPL_GSM_DEFAULT       1
+#define GPS_ENC_SUPL_UTF8              2
+#define GPS_ENC_SUPL_UCS2              3
+#define GPS_ENC_UNKNOWN                -1
+
+#define GPS_NI_SHORT_STRING_MAXLEN      256
+#define GPS_NI_LONG_STRING_MAXLEN       2048
+
+#define GPS_MEASUREMENT_OPERATION_SUCCESS          0
+#define GPS_MEASUREMENT_ERROR_ALREADY_INIT      -100
+#define GPS_MEASUREMENT_ERROR_GENERIC           -101
+
+typedef uint8_t GpsClockType;
+#define GPS_CLOCK_TYPE_UNKNOWN                  0
+#define GPS_CLOCK_TYPE_LOCAL_HW_TIME            1
+#define GPS_CLOCK_TYPE_GPS_TIME                 2
+
+typedef uint16_t GpsClockFlags;
+#define GPS_CLOCK_HAS_LEAP_SECOND               (1<<0)
+#define GPS_CLOCK_HAS_TIME_UNCERTAINTY          (1<<1)
+#define GPS_CLOCK_HAS_FULL_BIAS                 (1<<2)
+#define GPS_CLOCK_HAS_BIAS                      (1<<3)
+#define GPS_CLOCK_HAS_BIAS_UNCERTAINTY          (1<<4)
+#define GPS_CLOCK_HAS_DRIFT                     (1<<5)
+#define GPS_CLOCK_HAS_DRIFT_UNCERTAINTY         (1<<6)
+
+typedef uint32_t GpsMeasurementFlags;
+typedef uint16_t GpsMeasurementState;
+#define GPS_MEASUREMENT_STATE_UNKNOWN           0
+#define GPS_MEASUREMENT_STATE_CODE_LOCK         (1<<0)
+#define GPS_MEASUREMENT_STATE_BIT_SYNC          (1<<1)
+#define GPS_MEASUREMENT_STATE_SUBFRAME_SYNC     (1<<2)
+#define GPS_MEASUREMENT_STATE_TOW_DECODED       (1<<3)
+
+typedef uint16_t GpsAccumulatedDeltaRangeState;
+#define GPS_ADR_STATE_UNKNOWN                   0
+#define GPS_ADR_STATE_VALID                     (1<<0)
+#define GPS_ADR_STATE_RESET                     (1<<1)
+#define GPS_ADR_STATE_CYCLE_SLIP                (1<<2)
+
+typedef struct {
+    size_t          size;
+    uint16_t        flags;
+    double          latitude;
+    double          longitude;
+    double          altitude;
+    float           speed;
+    float           bearing;
+    float           accuracy;
+    GpsUtcTime      timestamp;
+} GpsLocation;
+
+typedef struct {
+    size_t size;
+    GpsStatusValue status;
+} GpsStatus;
+
+typedef struct {
+    size_t size;
+    int prn;
+    float snr;
+    float elevation;
+    float azimuth;
+} GpsSvInfo;
+
+typedef struct {
+    size_t size;
+    int num_svs;
+    GpsSvInfo sv_list[GPS_MAX_SVS];
+    uint32_t ephemeris_mask;
+    uint32_t almanac_mask;
+    uint32_t used_in_fix_mask;
+} GpsSvStatus;
+
+typedef struct {
+    size_t size;
+    AGpsType type;
+    AGpsStatusValue status;
+    uint32_t ipaddr;
+    struct sockaddr_storage addr;
+} AGpsStatus;
+
+typedef struct {
+    size_t size;
+    int notification_id;
+    GpsNiType ni_type;
+    GpsNiNotifyFlags notify_flags;
+    int timeout;
+    GpsUserResponseType default_response;
+    char requestor_id[GPS_NI_SHORT_STRING_MAXLEN];
+    char text[GPS_NI_LONG_STRING_MAXLEN];
+    GpsNiEncodingType requestor_id_encoding;
+    GpsNiEncodingType text_encoding;
+    char extras[GPS_NI_LONG_STRING_MAXLEN];
+} GpsNiNotification;
+
+typedef struct {
+    size_t length;
+    unsigned char* data;
+} DerEncodedCertificate;
+
+typedef struct {
+    unsigned char data[20];
+} Sha1CertificateFingerprint;
+
+typedef struct {
+    AGpsRefLocationType type;
+    uint16_t mcc;
+    uint16_t mnc;
+    uint16_t lac;
+    uint32_t cid;
+    uint16_t tac;
+    uint16_t pcid;
+} AGpsRefLocationCellID;
+
+typedef struct {
+    uint8_t mac[6];
+} AGpsRefLocationMac;
+
+typedef struct {
+    AGpsRefLocationType type;
+    union {
+        AGpsRefLocationCellID cellID;
+        AGpsRefLocationMac mac;
+    } u;
+} AGpsRefLocation;
+
+typedef struct {
+    size_t size;
+    GpsClockFlags flags;
+    int16_t leap_second;
+    GpsClockType type;
+    int64_t time_ns;
+    double time_uncertainty_ns;
+    int64_t full_bias_ns;
+    double bias_ns;
+    double bias_uncertainty_ns;
+    double drift_nsps;
+    double drift_uncertainty_nsps;
+} GpsClock;
+
+typedef struct {
+    size_t size;
+    GpsMeasurementFlags flags;
+    int8_t prn;
+    double time_offset_ns;
+    GpsMeasurementState state;
+    int64_t received_gps_tow_ns;
+    int64_t received_gps_tow_uncertainty_ns;
+    double c_n0_dbhz;
+    double pseudorange_rate_mps;
+    double pseudorange_rate_uncertainty_mps;
+    GpsAccumulatedDeltaRangeState accumulated_delta_range_state;
+    double accumulated_delta_range_m;
+    double accumulated_delta_range_uncertainty_m;
+} GpsMeasurement;
+
+typedef struct {
+    size_t size;
+    size_t measurement_count;
+    GpsMeasurement measurements[GPS_MAX_MEASUREMENT];
+    GpsClock clock;
+} GpsData;
+
+typedef void (* gps_location_callback)(GpsLocation* location);
+typedef void (* gps_status_callback)(GpsStatus* status);
+typedef void (* gps_sv_status_callback)(GpsSvStatus* sv_info);
+typedef void (* gps_nmea_callback)(GpsUtcTime timestamp, const char* nmea, int length);
+typedef void (* gps_set_capabilities)(uint32_t capabilities);
+typedef void (* gps_acquire_wakelock)();
+typedef void (* gps_release_wakelock)();
+typedef void (* gps_request_utc_time)();
+typedef pthread_t (* gps_create_thread)(const char* name, void (*start)(void *), void* arg);
+typedef void (* gps_xtra_download_request)();
+typedef void (* agps_status_callback)(AGpsStatus* status);
+typedef void (* gps_ni_notify_callback)(GpsNiNotification *notification);
+typedef void (* gps_measurement_callback)(GpsData* data);
+typedef void (* agps_ril_request_set_id)(uint32_t flags);
+typedef void (* agps_ril_request_ref_loc)(uint32_t flags);
+
+typedef struct {
+    size_t      size;
+    gps_location_callback location_cb;
+    gps_status_callback status_cb;
+    gps_sv_status_callback sv_status_cb;
+    gps_nmea_callback nmea_cb;
+    gps_set_capabilities set_capabilities_cb;
+    gps_acquire_wakelock acquire_wakelock_cb;
+    gps_release_wakelock release_wakelock_cb;
+    gps_create_thread create_thread_cb;
+    gps_request_utc_time request_utc_time_cb;
+} GpsCallbacks;
+
+typedef struct {
+    size_t          size;
+    int   (*init)( GpsCallbacks* callbacks );
+    int   (*start)( void );
+    int   (*stop)( void );
+    void  (*cleanup)( void );
+    int   (*inject_time)(GpsUtcTime time, int64_t timeReference,
+                         int uncertainty);
+    int  (*inject_location)(double latitude, double longitude, float accuracy);
+    void  (*delete_aiding_data)(GpsAidingData flags);
+    int   (*set_position_mode)(GpsPositionMode mode,
+            GpsPositionRecurrence recurrence, uint32_t min_interval,
+            uint32_t preferred_accuracy, uint32_t preferred_time);
+    const void* (*get_extension)(const char* name);
+} GpsInterface;
+
+typedef struct {
+    size_t size;
+    gps_measurement_callback measurement_callback;
+} GpsMeasurementCallbacks;
+
+typedef struct {
+    size_t size;
+    int   (*init)(GpsMeasurementCallbacks* callbacks);
+    void  (*close)();
+} GpsMeasurementInterface;
+
+typedef struct {
+    size_t size;
+    agps_status_callback status_cb;
+    gps_create_thread create_thread_cb;
+} AGpsCallbacks;
+
+typedef struct {
+    size_t          size;
+    void  (*init)( AGpsCallbacks* callbacks );
+    int   (*data_conn_open)( const char* apn );
+    int   (*data_conn_closed)();
+    int   (*data_conn_failed)();
+    int   (*set_server)( AGpsType type, const char* hostname, int port );
+    int   (*data_conn_open_with_apn_ip_type)( const char* apn,
+                                              ApnIpType apnIpType );
+} AGpsInterface;
+
+typedef struct {
+    size_t size;
+    int (*install_certificates)(const DerEncodedCertificate* certificates,
+                                size_t length);
+    int (*revoke_certificates)(const Sha1CertificateFingerprint* fingerprints,
+                               size_t length);
+} SuplCertificateInterface;
+
+typedef struct {
+    size_t size;
+    gps_xtra_download_request download_request_cb;
+    gps_create_thread create_thread_cb;
+} GpsXtraCallbacks;
+
+typedef struct {
+    size_t          size;
+    int  (*init)( GpsXtraCallbacks* callbacks );
+    int  (*inject_xtra_data)( char* data, int length );
+} GpsXtraInterface;
+
+typedef struct {
+    size_t size;
+    gps_ni_notify_callback notify_cb;
+    gps_create_thread create_thread_cb;
+} GpsNiCallbacks;
+
+typedef struct {
+    size_t          size;
+    void (*init)( GpsNiCallbacks *callbacks );
+    void (*respond)( int notif_id, GpsUserResponseType user_response );
+} GpsNiInterface;
+
+typedef struct {
+    agps_ril_request_set_id request_setid;
+    agps_ril_request_ref_loc request_refloc;
+    gps_create_thread create_thread_cb;
+} AGpsRilCallbacks;
+
+typedef struct {
+    size_t          size;
+    void (*init)( AGpsRilCallbacks* callbacks );
+    void (*set_ref_location)( const AGpsRefLocation *agps_reflocation,
+                              size_t sz_struct );
+    void (*set_set_id)( AGpsSetIDType type, const char* setid );
+    void (*ni_message)( uint8_t *msg, size_t len );
+    void (*update_network_state)( int connected, int type, int roaming,
+                                  const char* extra_info );
+    void (*update_network_availability)( int avaiable, const char* apn );
+} AGpsRilInterface;
+
+typedef struct {
+    size_t size;
+    void (*configuration_update)(const char* config_data, int32_t length);
+} GnssConfigurationInterface;
+
+#define GPS_GEOFENCE_ENTERED     (1<<0L)
+#define GPS_GEOFENCE_EXITED      (1<<1L)
+#define GPS_GEOFENCE_UNCERTAIN   (1<<2L)
+
+#define GPS_GEOFENCE_UNAVAILABLE (1<<0L)
+#define GPS_GEOFENCE_AVAILABLE   (1<<1L)
+
+#define GPS_GEOFENCE_OPERATION_SUCCESS           0
+#define GPS_GEOFENCE_ERROR_TOO_MANY_GEOFENCES -100
+#define GPS_GEOFENCE_ERROR_ID_EXISTS          -101
+#define GPS_GEOFENCE_ERROR_ID_UNKNOWN         -102
+#define GPS_GEOFENCE_ERROR_INVALID_TRANSITION -103
+#define GPS_GEOFENCE_ERROR_GENERIC            -149
+
+typedef void (* gps_geofence_transition_callback) (int32_t geofence_id,
+        GpsLocation* location, int32_t transition, GpsUtcTime timestamp);
+typedef void (* gps_geofence_status_callback) (int32_t status,
+        GpsLocation* last_location);
+typedef void (* gps_geofence_add_callback) (int32_t geofence_id,
+        int32_t status);
+typedef void (* gps_geofence_remove_callback) (int32_t geofence_id,
+        int32_t status);
+typedef void (* gps_geofence_pause_callback) (int32_t geofence_id,
+        int32_t status);
+typedef void (* gps_geofence_resume_callback) (int32_t geofence_id,
+        int32_t status);
+
+typedef struct {
+    gps_geofence_transition_callback geofence_transition_callback;
+    gps_geofence_status_callback geofence_status_callback;
+    gps_geofence_add_callback geofence_add_callback;
+    gps_geofence_remove_callback geofence_remove_callback;
+    gps_geofence_pause_callback geofence_pause_callback;
+    gps_geofence_resume_callback geofence_resume_callback;
+    gps_create_thread create_thread_cb;
+} GpsGeofenceCallbacks;
+
+typedef struct {
+    size_t          size;
+    void  (*init)( GpsGeofenceCallbacks* callbacks );
+    void (*add_geofence_area) (int32_t geofence_id, double latitude,
+                               double longitude, double radius_meters,
+                               int last_transition, int monitor_transitions,
+                               int notification_responsiveness_ms,
+                               int unknown_timer_ms);
+    void (*pause_geofence) (int32_t geofence_id);
+    void (*resume_geofence) (int32_t geofence_id, int monitor_transitions);
+    void (*remove_geofence_area) (int32_t geofence_id);
+} GpsGeofencingInterface;
+
+#endif //__FAKES_FOR_HOST_HARDWARE_GPS_H__
@@ -0,0 +1,1331 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Host benchmark suite for libgps.utils, libloc_core and libloc_eng.
+// Build and run with "make bench" in this directory. Every result is one
+// {"benchmark", "params", "metric", "value", "unit"} record in a JSON
+// document written with -o (stdout gets a readable summary), so that runs
+// can be diffed across changes.
+//
+// usage: loc_bench [-f filter] [-s scale] [-o results.json]
+//   -f  only run benchmarks whose name contains filter
+//   -s  multiply iteration counts by scale (default 1)
+
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_bench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <msg_q.h>
+#include <MsgTask.h>
+#include <LocTimer.h>
+#include <LocHeap.h>
+#include <loc_cfg.h>
+#include <log_util.h>
+#include <loc_log.h>
+#include <loc_core_log.h>
+#include <LocApiBase.h>
+#include <LocAdapterBase.h>
+#include <loc_eng.h>
+#include <loc_eng_nmea.h>
+#include <loc_eng_batching.h>
+#include <loc_eng_geofence.h>
+#include <loc_eng_resolver.h>
+#include <loc_eng_dmn_conn.h>
+#include <loc_eng_dmn_conn_handler.h>
+#include <fused_location_extended.h>
+#include <math.h>
+
+struct BenchResult {
+    std::string benchmark;
+    std::string params;
+    std::string metric;
+    double value;
+    std::string unit;
+};
+
+static std::vector<BenchResult> sResults;
+static double sScale = 1.0;
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t scaled(uint32_t count)
+{
+    uint32_t n = (uint32_t)(count * sScale);
+    return n > 0 ? n : 1;
+}
+
+static void report(const char* benchmark, const std::string& params,
+                   const char* metric, double value, const char* unit)
+{
+    BenchResult result = { benchmark, params, metric, value, unit };
+    sResults.push_back(result);
+    printf("%-22s %-20s %-18s %14.3f %s\n",
+           benchmark, params.c_str(), metric, value, unit);
+}
+
+static std::string param(const char* name, uint32_t value)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s=%u", name, value);
+    return buf;
+}
+
+// reports min, p50, p99 and max of samples, which gets sorted
+static void reportLatency(const char* benchmark, const std::string& params,
+                          std::vector<uint64_t>& samples)
+{
+    if (samples.empty()) {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    report(benchmark, params, "latency_min", samples.front() / 1e3, "us");
+    report(benchmark, params, "latency_p50",
+           samples[(samples.size() - 1) / 2] / 1e3, "us");
+    report(benchmark, params, "latency_p99",
+           samples[(samples.size() - 1) * 99 / 100] / 1e3, "us");
+    report(benchmark, params, "latency_max", samples.back() / 1e3, "us");
+}
+
+/*****************************************************************************
+ * msg_q: N producers, one consumer
+ *****************************************************************************/
+
+struct MsgQProducer {
+    void* mQ;
+    uint32_t mCount;
+};
+
+static void* msgQProduce(void* arg)
+{
+    MsgQProducer* producer = (MsgQProducer*)arg;
+    static int sDummy;
+    for (uint32_t i = 0; i < producer->mCount; i++) {
+        msg_q_snd(producer->mQ, &sDummy, NULL);
+    }
+    return NULL;
+}
+
+static void benchMsgQ()
+{
+    static const uint32_t kProducers[] = { 1, 2, 4, 8 };
+    const uint32_t total = scaled(400000);
+
+    for (size_t p = 0; p < sizeof(kProducers) / sizeof(kProducers[0]); p++) {
+        uint32_t numProducers = kProducers[p];
+        void* q = (void*)msg_q_init2();
+        std::vector<pthread_t> threads(numProducers);
+        MsgQProducer producer = { q, total / numProducers };
+        uint32_t expected = producer.mCount * numProducers;
+
+        uint64_t start = nowNs();
+        for (uint32_t i = 0; i < numProducers; i++) {
+            pthread_create(&threads[i], NULL, msgQProduce, &producer);
+        }
+        for (uint32_t i = 0; i < expected; i++) {
+            void* msg = NULL;
+            msg_q_rcv(q, &msg);
+        }
+        uint64_t elapsed = nowNs() - start;
+        for (uint32_t i = 0; i < numProducers; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        msg_q_destroy(&q);
+
+        report("msg_q", param("producers", numProducers), "throughput",
+               expected / (elapsed / 1e9), "msgs/s");
+    }
+}
+
+/*****************************************************************************
+ * MsgTask: sendMsg() to proc() latency
+ *****************************************************************************/
+
+struct BenchMsg : public LocMsg {
+    const uint64_t mSent;
+    std::vector<uint64_t>* const mSamples;
+    sem_t* const mDone;
+    inline BenchMsg(std::vector<uint64_t>* samples, sem_t* done) :
+        LocMsg(), mSent(nowNs()), mSamples(samples), mDone(done) {}
+    virtual void proc() const {
+        mSamples->push_back(nowNs() - mSent);
+        if (NULL != mDone) {
+            sem_post(mDone);
+        }
+    }
+};
+
+static void benchMsgTask()
+{
+    MsgTask* task = new MsgTask("LocBenchTask", false);
+    std::vector<uint64_t> samples;
+    sem_t done;
+    sem_init(&done, 0, 0);
+
+    // one message in flight at a time: pure dispatch latency
+    uint32_t count = scaled(20000);
+    samples.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        task->sendMsg(new BenchMsg(&samples, &done));
+        sem_wait(&done);
+    }
+    reportLatency("msg_task", "mode=ping_pong", samples);
+
+    // back to back: queueing included
+    count = scaled(200000);
+    samples.clear();
+    samples.reserve(count);
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        task->sendMsg(new BenchMsg(&samples, (i == count - 1) ? &done : NULL));
+    }
+    sem_wait(&done);
+    uint64_t elapsed = nowNs() - start;
+    report("msg_task", "mode=burst", "throughput",
+           count / (elapsed / 1e9), "msgs/s");
+    reportLatency("msg_task", "mode=burst", samples);
+
+    task->destroy();
+    sem_destroy(&done);
+}
+
+/*****************************************************************************
+ * LocTimer: start / stop / expire
+ *****************************************************************************/
+
+class BenchTimer : public LocTimer {
+public:
+    uint64_t mDue;
+    uint64_t mFired;
+    volatile int32_t* mPending;
+    const MsgTask* mRelay;
+    inline BenchTimer() : LocTimer(), mDue(0), mFired(0), mPending(NULL),
+        mRelay(NULL) {}
+    // delivered on 'task' by LocTimer itself, or relayed there by the
+    // callback on the timer thread
+    inline BenchTimer(const MsgTask* task, bool relay) :
+        LocTimer(relay ? NULL : task), mDue(0), mFired(0), mPending(NULL),
+        mRelay(relay ? task : NULL) {}
+    void fired() {
+        mFired = nowNs();
+        __atomic_fetch_sub(mPending, 1, __ATOMIC_SEQ_CST);
+    }
+    virtual void timeOutCallback();
+};
+
+struct BenchTimerRelay : public LocMsg {
+    BenchTimer* mTimer;
+    inline BenchTimerRelay(BenchTimer* timer) : LocMsg(), mTimer(timer) {}
+    inline virtual void proc() const { mTimer->fired(); }
+};
+
+void BenchTimer::timeOutCallback() {
+    if (mRelay) {
+        mRelay->sendMsg(new BenchTimerRelay(this));
+    } else {
+        fired();
+    }
+}
+
+// expires 'count' timers spread over 1..50 ms, returns their lateness
+static void benchTimerExpiry(std::vector<BenchTimer*>& timers, uint32_t count,
+                             std::vector<uint64_t>& lateness, uint64_t& elapsed)
+{
+    volatile int32_t pending = count;
+    lateness.clear();
+    lateness.reserve(count);
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t timeoutMs = 1 + (i % 50);
+        timers[i]->mPending = &pending;
+        timers[i]->mDue = nowNs() + timeoutMs * 1000000ULL;
+        timers[i]->start(timeoutMs, false);
+    }
+    while (__atomic_load_n(&pending, __ATOMIC_SEQ_CST) > 0) {
+        usleep(1000);
+    }
+    elapsed = nowNs() - start;
+    for (uint32_t i = 0; i < count; i++) {
+        lateness.push_back(timers[i]->mFired > timers[i]->mDue ?
+                           timers[i]->mFired - timers[i]->mDue : 0);
+    }
+}
+
+static void benchLocTimer()
+{
+    uint32_t count = scaled(20000);
+    std::vector<BenchTimer> timers(count);
+
+    // long timeouts so nothing expires while measuring start / stop
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        timers[i].start(60000 + i, false);
+    }
+    uint64_t elapsed = nowNs() - start;
+    report("loc_timer", param("timers", count), "start_rate",
+           count / (elapsed / 1e9), "ops/s");
+
+    start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        timers[i].stop();
+    }
+    elapsed = nowNs() - start;
+    report("loc_timer", param("timers", count), "stop_rate",
+           count / (elapsed / 1e9), "ops/s");
+
+    // short timeouts spread over 1..50 ms, all left to expire
+    count = scaled(5000);
+    std::vector<uint64_t> lateness;
+    std::vector<BenchTimer*> expiring(count);
+    for (uint32_t i = 0; i < count; i++) {
+        expiring[i] = &timers[i];
+    }
+    benchTimerExpiry(expiring, count, lateness, elapsed);
+    report("loc_timer", param("timers", count), "expire_rate",
+           count / (elapsed / 1e9), "ops/s");
+    reportLatency("loc_timer", param("timers", count) + ",lateness", lateness);
+
+    // the same, handled on a client MsgTask: relayed by the callback as
+    // a LocMsg, or delivered there by LocTimer
+    MsgTask* task = new MsgTask("LocBenchTask", false);
+    for (int relay = 1; relay >= 0; relay--) {
+        for (uint32_t i = 0; i < count; i++) {
+            expiring[i] = new BenchTimer(task, relay);
+        }
+        benchTimerExpiry(expiring, count, lateness, elapsed);
+        std::string params = param("timers", count) +
+            (relay ? ",msg_task=relay" : ",msg_task=direct");
+        report("loc_timer", params, "expire_rate", count / (elapsed / 1e9), "ops/s");
+        reportLatency("loc_timer", params + ",lateness", lateness);
+        for (uint32_t i = 0; i < count; i++) {
+            delete expiring[i];
+        }
+    }
+    task->destroy();
+}
+
+/*****************************************************************************
+ * LocHeap: push / pop / remove
+ *****************************************************************************/
+
+class BenchRankable : public LocRankable {
+public:
+    int mRank;
+    inline BenchRankable() : mRank(0) {}
+    virtual int ranks(LocRankable& rankable) {
+        BenchRankable* other = (BenchRankable*)&rankable;
+        return other->mRank - mRank;
+    }
+};
+
+static void benchLocHeap()
+{
+    uint32_t count = scaled(200000);
+    std::vector<BenchRankable> nodes(count);
+    LocHeap heap;
+
+    srand(1);
+    for (uint32_t i = 0; i < count; i++) {
+        nodes[i].mRank = rand();
+    }
+
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        heap.push(nodes[i]);
+    }
+    uint64_t elapsed = nowNs() - start;
+    report("loc_heap", param("nodes", count), "push", elapsed / (double)count,
+           "ns/op");
+
+    start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        heap.pop();
+    }
+    elapsed = nowNs() - start;
+    report("loc_heap", param("nodes", count), "pop", elapsed / (double)count,
+           "ns/op");
+
+    // remove() walks the tree, so keep this one smaller
+    uint32_t removes = scaled(2000);
+    for (uint32_t i = 0; i < removes; i++) {
+        heap.push(nodes[i]);
+    }
+    start = nowNs();
+    for (uint32_t i = 0; i < removes; i++) {
+        heap.remove(nodes[(i * 7919) % removes]);
+    }
+    elapsed = nowNs() - start;
+    report("loc_heap", param("nodes", removes), "remove",
+           elapsed / (double)removes, "ns/op");
+}
+
+/*****************************************************************************
+ * loc_cfg: gps.conf sized file parsed into a gps.conf sized table
+ *****************************************************************************/
+
+#define BENCH_CFG_PARAMS 48
+
+static void benchLocCfg()
+{
+    char path[] = "/tmp/loc_bench_cfgXXXXXX";
+    int fd = mkstemp(path);
+    FILE* file = (fd < 0) ? NULL : fdopen(fd, "w");
+    if (NULL == file) {
+        LOC_LOGE("could not create %s", path);
+        return;
+    }
+
+    static char names[BENCH_CFG_PARAMS][LOC_MAX_PARAM_NAME];
+    static uint32_t numbers[BENCH_CFG_PARAMS];
+    static char strings[BENCH_CFG_PARAMS][LOC_MAX_PARAM_STRING];
+    static double floats[BENCH_CFG_PARAMS];
+    loc_param_s_type table[BENCH_CFG_PARAMS];
+
+    for (int i = 0; i < BENCH_CFG_PARAMS; i++) {
+        snprintf(names[i], sizeof(names[i]), "BENCH_PARAM_%d", i);
+        table[i].param_name = names[i];
+        table[i].param_set = NULL;
+        switch (i % 3) {
+        case 0:
+            table[i].param_ptr = &numbers[i];
+            table[i].param_type = 'n';
+            fprintf(file, "# number parameter %d\n%s=%d\n\n", i, names[i], i);
+            break;
+        case 1:
+            table[i].param_ptr = strings[i];
+            table[i].param_type = 's';
+            fprintf(file, "# string parameter %d\n%s=supl.host%d.com\n\n",
+                    i, names[i], i);
+            break;
+        default:
+            table[i].param_ptr = &floats[i];
+            table[i].param_type = 'f';
+            fprintf(file, "# float parameter %d\n%s=%d.5\n\n", i, names[i], i);
+            break;
+        }
+    }
+    // entries nobody asks for, as in the real gps.conf
+    for (int i = 0; i < BENCH_CFG_PARAMS; i++) {
+        fprintf(file, "#UNUSED_PARAM_%d=%d\n", i, i);
+    }
+    fclose(file);
+
+    uint32_t count = scaled(5000);
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        loc_read_conf(path, table, BENCH_CFG_PARAMS);
+    }
+    uint64_t elapsed = nowNs() - start;
+    unlink(path);
+
+    report("loc_cfg", param("params", BENCH_CFG_PARAMS), "read_conf",
+           elapsed / 1e3 / count, "us/call");
+}
+
+/*****************************************************************************
+ * NMEA generation from a position and an SV report
+ *****************************************************************************/
+
+static uint64_t sNmeaBytes = 0;
+
+static void benchNmeaCb(GpsUtcTime timestamp, const char* nmea, int length)
+{
+    sNmeaBytes += length;
+}
+
+static void benchNmea()
+{
+    loc_eng_data_s_type locEng;
+    memset(&locEng, 0, sizeof(locEng));
+    locEng.nmea_cb = benchNmeaCb;
+    locEng.adapter = new LocEngAdapter(0, &locEng, NULL, NULL);
+
+    UlpLocation location;
+    memset(&location, 0, sizeof(location));
+    location.size = sizeof(location);
+    location.gpsLocation.size = sizeof(location.gpsLocation);
+    location.gpsLocation.flags = GPS_LOCATION_HAS_LAT_LONG |
+        GPS_LOCATION_HAS_ALTITUDE | GPS_LOCATION_HAS_SPEED |
+        GPS_LOCATION_HAS_BEARING | GPS_LOCATION_HAS_ACCURACY;
+    location.gpsLocation.latitude = 37.4219999;
+    location.gpsLocation.longitude = -122.0840575;
+    location.gpsLocation.altitude = 21.5;
+    location.gpsLocation.speed = 13.2f;
+    location.gpsLocation.bearing = 271.0f;
+    location.gpsLocation.accuracy = 4.0f;
+    location.gpsLocation.timestamp = 1450000000000LL;
+
+    GpsLocationExtended locationExtended;
+    memset(&locationExtended, 0, sizeof(locationExtended));
+    locationExtended.size = sizeof(locationExtended);
+    locationExtended.flags = GPS_LOCATION_EXTENDED_HAS_DOP |
+        GPS_LOCATION_EXTENDED_HAS_ALTITUDE_MEAN_SEA_LEVEL;
+    locationExtended.pdop = 1.6f;
+    locationExtended.hdop = 0.9f;
+    locationExtended.vdop = 1.3f;
+    locationExtended.altitudeMeanSeaLevel = 50.0f;
+
+    HaxxSvStatus svStatus;
+    memset(&svStatus, 0, sizeof(svStatus));
+    svStatus.size = sizeof(svStatus);
+    svStatus.num_svs = 20;
+    for (int i = 0; i < svStatus.num_svs; i++) {
+        GpsSvInfo& sv = svStatus.sv_list[i];
+        sv.size = sizeof(sv);
+        // 12 GPS and 8 GLONASS satellites
+        sv.prn = (i < 12) ? (i + 1) : (65 + i);
+        sv.snr = 20.0f + i;
+        sv.elevation = 5.0f * i;
+        sv.azimuth = 17.0f * i;
+    }
+    svStatus.gps_used_in_fix_mask = 0x3ff;
+
+    uint32_t count = scaled(50000);
+    sNmeaBytes = 0;
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        loc_eng_nmea_generate_pos(&locEng, location, locationExtended, true);
+    }
+    uint64_t elapsed = nowNs() - start;
+    report("nmea", "sentences=pos", "generate",
+           elapsed / 1e3 / count, "us/fix");
+    report("nmea", "sentences=pos", "bytes", sNmeaBytes / (double)count,
+           "bytes/fix");
+
+    sNmeaBytes = 0;
+    start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        loc_eng_nmea_generate_sv(&locEng, svStatus, locationExtended);
+    }
+    elapsed = nowNs() - start;
+    report("nmea", "sentences=sv", "generate",
+           elapsed / 1e3 / count, "us/report");
+    report("nmea", "sentences=sv", "bytes", sNmeaBytes / (double)count,
+           "bytes/report");
+}
+
+/*****************************************************************************/
+
+// takes the batches the way a ULP would, and checks them against the track
+struct BenchBatchUlp : public UlpProxyBase {
+    uint32_t mBatches;
+    uint32_t mFixes;
+    double mMaxErrorM;
+    inline BenchBatchUlp() : mBatches(0), mFixes(0), mMaxErrorM(0) {}
+    virtual bool reportPositions(const struct FlpExtLocation_s* locations,
+                                 int32_t number_of_locations);
+    inline virtual bool canReportPositions() { return true; }
+};
+
+// 1 Hz fixes walking a circle of 2 km radius at 1.4 m/s
+static void benchBatchTrack(uint32_t i, UlpLocation& location)
+{
+    double angle = i * 1.4 / 2000.0;
+    location.gpsLocation.latitude = 37.4219999 + 0.018 * sin(angle);
+    location.gpsLocation.longitude = -122.0840575 + 0.0227 * cos(angle);
+    location.gpsLocation.altitude = 21.5 + 5.0 * sin(angle * 7);
+    location.gpsLocation.speed = 1.4f;
+    location.gpsLocation.bearing = (float)fmod(i * 0.04, 360.0);
+    location.gpsLocation.accuracy = 4.0f + (i % 16);
+    location.gpsLocation.timestamp = 1450000000000LL + i * 1000LL;
+}
+
+bool BenchBatchUlp::reportPositions(const struct FlpExtLocation_s* locations,
+                                    int32_t number_of_locations)
+{
+    UlpLocation track;
+    for (int32_t i = 0; i < number_of_locations; i++) {
+        const FlpExtLocation& location = locations[i];
+        benchBatchTrack((location.timestamp - 1450000000000LL) / 1000, track);
+        double dLat = (location.latitude - track.gpsLocation.latitude) *
+            111320.0;
+        double dLon = (location.longitude - track.gpsLocation.longitude) *
+            111320.0 * cos(location.latitude * M_PI / 180.0);
+        double error = sqrt(dLat * dLat + dLon * dLon);
+        if (error > mMaxErrorM) {
+            mMaxErrorM = error;
+        }
+    }
+    mBatches++;
+    mFixes += number_of_locations;
+    return true;
+}
+
+static void benchBatching()
+{
+    static const uint32_t sizes[] = { 10, 40, 100 };
+    uint32_t count = scaled(200000);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        loc_eng_data_s_type locEng;
+        memset(&locEng, 0, sizeof(locEng));
+        LocEngAdapter* adapter = new LocEngAdapter(0, &locEng, NULL, NULL);
+        locEng.adapter = adapter;
+        BenchBatchUlp* ulp = new BenchBatchUlp();
+        adapter->setUlpProxy(ulp);
+        // the age trigger is armed for every batch, but never fires here
+        LocEngBatcher* batcher = new LocEngBatcher(adapter, sizes[s],
+                                                   3600000, 0);
+
+        UlpLocation location;
+        memset(&location, 0, sizeof(location));
+        location.size = sizeof(location);
+        location.gpsLocation.size = sizeof(location.gpsLocation);
+        location.gpsLocation.flags = GPS_LOCATION_HAS_LAT_LONG |
+            GPS_LOCATION_HAS_ALTITUDE | GPS_LOCATION_HAS_SPEED |
+            GPS_LOCATION_HAS_BEARING | GPS_LOCATION_HAS_ACCURACY;
+
+        uint64_t elapsed = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            benchBatchTrack(i, location);
+            uint64_t start = nowNs();
+            batcher->add(location);
+            elapsed += nowNs() - start;
+        }
+        batcher->flush();
+
+        std::string params = param("size", sizes[s]);
+        report("batching", params, "add", elapsed / (double)count, "ns/fix");
+        report("batching", params, "upcalls",
+               ulp->mBatches * 1000.0 / count, "per_1000_fixes");
+        report("batching", params, "storage",
+               sizeof(LocEngBatcher::Record), "bytes/fix");
+        report("batching", params, "max_error", ulp->mMaxErrorM * 100.0, "cm");
+        if (ulp->mFixes != count) {
+            fprintf(stderr, "batching: %u fixes reported of %u\n",
+                    ulp->mFixes, count);
+        }
+        delete batcher;
+    }
+}
+
+/*****************************************************************************/
+
+static uint32_t sGeofenceTransitions;
+
+static void benchGeofenceTransitionCb(int32_t geofence_id,
+                                      GpsLocation* location,
+                                      int32_t transition,
+                                      GpsUtcTime timestamp)
+{
+    sGeofenceTransitions++;
+}
+
+// fences of 50 to 500 m all over a 100 x 100 km area, and a drive through
+// it at 15 m/s with 1 Hz fixes
+static void benchGeofence()
+{
+    static const uint32_t counts[] = { 10000, 100000 };
+    const double lat0 = 37.0, lon0 = -122.5;
+    const double spanDeg = 100000.0 / 111320.0;
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        uint32_t count = counts[c];
+        loc_eng_data_s_type locEng;
+        memset(&locEng, 0, sizeof(locEng));
+        LocEngAdapter* adapter = new LocEngAdapter(0, &locEng, NULL, NULL);
+        GpsGeofenceCallbacks callbacks;
+        memset(&callbacks, 0, sizeof(callbacks));
+        callbacks.geofence_transition_callback = benchGeofenceTransitionCb;
+        LocEngGeofence* geofence =
+            new LocEngGeofence(adapter, callbacks, count, 1000, 20, 0);
+
+        srand(1);
+        uint64_t start = nowNs();
+        for (uint32_t i = 0; i < count; i++) {
+            geofence->add(i, lat0 + spanDeg * rand() / RAND_MAX,
+                          lon0 + spanDeg * rand() / RAND_MAX,
+                          50.0 + 450.0 * rand() / RAND_MAX,
+                          GPS_GEOFENCE_UNCERTAIN,
+                          GPS_GEOFENCE_ENTERED | GPS_GEOFENCE_EXITED, 0);
+        }
+        uint64_t elapsed = nowNs() - start;
+        std::string params = param("fences", count);
+        report("geofence", params, "add", elapsed / 1e3 / count, "us/fence");
+
+        GpsLocation location;
+        memset(&location, 0, sizeof(location));
+        location.size = sizeof(location);
+        location.flags = GPS_LOCATION_HAS_LAT_LONG | GPS_LOCATION_HAS_ACCURACY;
+        location.accuracy = 5.0f;
+        location.latitude = lat0 + spanDeg / 2;
+        location.longitude = lon0 + spanDeg / 2;
+        location.timestamp = 1450000000000LL;
+        // the first fix sets the state of every fence
+        start = nowNs();
+        geofence->onPosition(location);
+        report("geofence", params, "first_fix",
+               (nowNs() - start) / 1e3, "us");
+
+        uint32_t fixes = scaled(20000);
+        uint64_t candidates = 0;
+        double heading = 0.3;
+        sGeofenceTransitions = 0;
+        start = nowNs();
+        for (uint32_t i = 0; i < fixes; i++) {
+            // turn a little every now and then, bounce off the edges
+            if (0 == i % 60) {
+                heading += 0.5 * rand() / RAND_MAX - 0.25;
+            }
+            location.latitude += 15.0 * cos(heading) / 111320.0;
+            location.longitude += 15.0 * sin(heading) /
+                (111320.0 * cos(location.latitude * M_PI / 180.0));
+            if (location.latitude < lat0 || location.latitude > lat0 + spanDeg ||
+                location.longitude < lon0 ||
+                location.longitude > lon0 + spanDeg) {
+                heading += M_PI;
+            }
+            location.timestamp += 1000;
+            geofence->onPosition(location);
+            candidates += geofence->getCandidates();
+        }
+        elapsed = nowNs() - start;
+        report("geofence", params, "fix", elapsed / 1e3 / fixes, "us/fix");
+        report("geofence", params, "candidates",
+               candidates / (double)fixes, "fences/fix");
+        report("geofence", params, "transitions",
+               sGeofenceTransitions * 1000.0 / fixes, "per_1000_fixes");
+
+        start = nowNs();
+        for (uint32_t i = 0; i < count; i++) {
+            geofence->remove(i);
+        }
+        elapsed = nowNs() - start;
+        report("geofence", params, "remove", elapsed / 1e3 / count,
+               "us/fence");
+        delete geofence;
+    }
+
+    // 1 m cells: fences as big as the earth go to the shared list, bigger
+    // ones are refused
+    loc_eng_data_s_type locEng;
+    memset(&locEng, 0, sizeof(locEng));
+    LocEngAdapter* adapter = new LocEngAdapter(0, &locEng, NULL, NULL);
+    GpsGeofenceCallbacks callbacks;
+    memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.geofence_transition_callback = benchGeofenceTransitionCb;
+    LocEngGeofence* geofence = new LocEngGeofence(adapter, callbacks, 4, 1, 0, 0);
+    uint32_t errors = 0;
+    errors += (GPS_GEOFENCE_OPERATION_SUCCESS !=
+               geofence->add(1, 89.99, 0.0, 20000000.0, GPS_GEOFENCE_UNCERTAIN,
+                             GPS_GEOFENCE_ENTERED, 0));
+    errors += (GPS_GEOFENCE_ERROR_GENERIC !=
+               geofence->add(2, 0.0, 0.0, 1e300, GPS_GEOFENCE_UNCERTAIN,
+                             GPS_GEOFENCE_ENTERED, 0));
+    errors += (GPS_GEOFENCE_ERROR_GENERIC !=
+               geofence->add(3, 0.0, 0.0, INFINITY, GPS_GEOFENCE_UNCERTAIN,
+                             GPS_GEOFENCE_ENTERED, 0));
+    GpsLocation location;
+    memset(&location, 0, sizeof(location));
+    location.size = sizeof(location);
+    location.flags = GPS_LOCATION_HAS_LAT_LONG;
+    location.latitude = 10.0;
+    location.longitude = 120.0;
+    sGeofenceTransitions = 0;
+    geofence->onPosition(location);
+    errors += (1 != sGeofenceTransitions);
+    delete geofence;
+    if (errors) {
+        report("geofence", "check=huge_radius", "errors", errors, "count");
+    }
+}
+
+/*****************************************************************************
+ * Formatted logging versus binary tracing of a debug message
+ *****************************************************************************/
+
+static void benchTrace()
+{
+    static const char* kEvent = "LOC_EVENT_POSITION_REPORT_IND";
+    uint32_t count = scaled(500000);
+    char msg[1024];
+    void* client = &count;
+
+    // what every enabled log costs before it reaches the logger
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        snprintf(msg, sizeof(msg),
+                 "D/%s:%d] client = %p, event id = %d (%s), cookie = %p\n",
+                 __func__, __LINE__, client, (int)i, kEvent, msg);
+    }
+    report("trace", "", "format", (nowNs() - start) / (double)count, "ns/msg");
+
+    unsigned long debugLevel = loc_logger.DEBUG_LEVEL;
+    // what DEBUG_LEVEL filters out is not traced either
+    loc_logger.DEBUG_LEVEL = 3;
+    loc_trace_init(4);
+    if (loc_trace_level != 3) {
+        report("trace", "check=debug_level", "errors", 1, "count");
+    }
+    loc_logger.DEBUG_LEVEL = 4;
+    loc_trace_init(4);
+    start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        LOC_LOGD("%s:%d] client = %p, event id = %d (%s), cookie = %p\n",
+                 __func__, __LINE__, client, (int)i, kEvent, msg);
+    }
+    report("trace", "", "record", (nowNs() - start) / (double)count, "ns/msg");
+
+    int fd = open("/dev/null", O_WRONLY);
+    start = nowNs();
+    int records = loc_trace_dump(fd);
+    uint64_t elapsed = nowNs() - start;
+    close(fd);
+    report("trace", "", "dump", (records > 0) ? elapsed / (double)records : 0,
+           "ns/record");
+
+    // the same dump as the loc_trace_dump tool gets it
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s%s%d",
+             LOC_TRACE_SOCK_DIR, LOC_TRACE_SOCK_NAME, (int)getpid());
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    uint32_t lines = 0;
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        ssize_t len;
+        while ((len = read(fd, msg, sizeof(msg))) > 0) {
+            lines += std::count(msg, msg + len, '\n');
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (records <= 0 || lines < (uint32_t)records) {
+        report("trace", "check=socket", "errors", 1, "count");
+    }
+
+    // more arguments than a record holds, logged as it is instead
+    FILE* log = tmpfile();
+    int savedStderr = dup(STDERR_FILENO);
+    fflush(stderr);
+    dup2(fileno(log), STDERR_FILENO);
+    LOC_LOGD("%s:%d] args %d %d %d %d %d %d %d %d %d\n", __func__, __LINE__,
+             1, 2, 3, 4, 5, 6, 7, 8, 9);
+    fflush(stderr);
+    dup2(savedStderr, STDERR_FILENO);
+    close(savedStderr);
+    rewind(log);
+    size_t logged = fread(msg, 1, sizeof(msg) - 1, log);
+    msg[logged] = '\0';
+    fclose(log);
+    if (NULL == strstr(msg, "args 1 2 3 4 5 6 7 8 9")) {
+        report("trace", "check=untraceable", "errors", 1, "count");
+    }
+
+    // values wider than a dump line are cut at the line
+    LOC_LOGD("%s:%d] wide %600d\n", __func__, __LINE__, 1);
+    FILE* dump = tmpfile();
+    loc_trace_dump(fileno(dump));
+    rewind(dump);
+    uint32_t longLines = 0;
+    std::string line;
+    for (int c; (c = fgetc(dump)) != EOF; ) {
+        line += (char)c;
+        if ('\n' == c) {
+            longLines += (line.size() > 511);
+            line.clear();
+        }
+    }
+    fclose(dump);
+    if (longLines > 0 || !line.empty()) {
+        report("trace", "check=line_size", "errors", longLines, "count");
+    }
+
+    loc_trace_init(0);
+    loc_logger.DEBUG_LEVEL = debugLevel;
+}
+
+/*****************************************************************************
+ * Enum to name lookups, linear table scan against switch and direct index
+ *****************************************************************************/
+
+static volatile size_t sNameSink = 0;
+
+static void benchLogNames()
+{
+    // shaped like the QMI LOC event table: REQ, RESP and IND of 0x1e..0x9d
+    // sharing their IDs, listed in order
+    static const long kFirstId = 0x1e, kIds = 120;
+    static char names[kIds * 3][16];
+    static loc_name_val_s_type table[kIds * 3];
+    static const char* dense[kFirstId + kIds];
+    size_t entries = 0;
+    for (long id = kFirstId; id < kFirstId + kIds; id++) {
+        for (int kind = 0; kind < 3; kind++, entries++) {
+            snprintf(names[entries], sizeof(names[entries]), "MSG_%lx_%d", id, kind);
+            table[entries].name = names[entries];
+            table[entries].val = id;
+        }
+        dense[id] = table[entries - 3].name;
+    }
+
+    uint32_t count = scaled(2000000);
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        sNameSink += (size_t)loc_get_name_from_val(table, entries,
+                                                   kFirstId + i % kIds);
+    }
+    report("log_names", param("entries", entries), "linear",
+           (nowNs() - start) / (double)count, "ns/call");
+
+    start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        sNameSink += (size_t)LOC_NAME_FROM_IDX(dense, kFirstId + i % kIds);
+    }
+    report("log_names", param("entries", entries), "indexed",
+           (nowNs() - start) / (double)count, "ns/call");
+
+    // the loc_core_log tables, a handful of entries each
+    static const loc_name_val_s_type agpsStatus[] = {
+        NAME_VAL( GPS_REQUEST_AGPS_DATA_CONN ),
+        NAME_VAL( GPS_RELEASE_AGPS_DATA_CONN ),
+        NAME_VAL( GPS_AGPS_DATA_CONNECTED ),
+        NAME_VAL( GPS_AGPS_DATA_CONN_DONE ),
+        NAME_VAL( GPS_AGPS_DATA_CONN_FAILED )
+    };
+    start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        sNameSink += (size_t)loc_get_name_from_val(agpsStatus,
+                                                   LOC_TABLE_SIZE(agpsStatus),
+                                                   1 + i % 5);
+    }
+    report("log_names", param("entries", 5), "linear",
+           (nowNs() - start) / (double)count, "ns/call");
+
+    start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        sNameSink += (size_t)loc_get_agps_status_name(1 + i % 5);
+    }
+    report("log_names", param("entries", 5), "switch",
+           (nowNs() - start) / (double)count, "ns/call");
+}
+
+/*****************************************************************************
+ * LocApiBase event delivery while adapters come and go
+ *****************************************************************************/
+
+using namespace loc_core;
+
+struct BenchLocApi : public LocApiBase {
+    inline BenchLocApi(const MsgTask* msgTask) : LocApiBase(msgTask, 0) {}
+};
+
+struct BenchAdapter : public LocAdapterBase {
+    volatile int32_t mAlive;
+    volatile uint32_t mDelivered;
+    uint32_t mLate;
+    inline BenchAdapter(const MsgTask* msgTask, LocApiBase* locApi) :
+        LocAdapterBase(msgTask), mAlive(1), mDelivered(0), mLate(0) {
+        mEvtMask = LOC_API_ADAPTER_BIT_NMEA_1HZ_REPORT;
+        mLocApi = locApi;
+    }
+    virtual void reportNmea(const char* nmea, int length) {
+        if (!mAlive) {
+            mLate++;
+        }
+        mDelivered++;
+    }
+};
+
+struct DispatchState {
+    BenchLocApi* mLocApi;
+    volatile bool mStop;
+    uint32_t mEvents;
+};
+
+static void* dispatchDeliver(void* arg)
+{
+    DispatchState* state = (DispatchState*)arg;
+    while (!state->mStop) {
+        state->mLocApi->reportNmea("$GPGGA", 6);
+        state->mEvents++;
+        // keep both sides moving on a single core
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void benchDispatch()
+{
+    MsgTask* task = new MsgTask("LocBenchTask", false);
+    BenchLocApi* locApi = new BenchLocApi(task);
+    // one adapter stays for the whole run, the others come and go
+    BenchAdapter* resident = new BenchAdapter(task, locApi);
+    locApi->addAdapter(resident);
+
+    DispatchState state = { locApi, false, 0 };
+    pthread_t thread;
+    pthread_create(&thread, NULL, dispatchDeliver, &state);
+
+    uint32_t count = scaled(20000), late = 0;
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < count; i++) {
+        BenchAdapter* adapter = new BenchAdapter(task, locApi);
+        locApi->addAdapter(adapter);
+        // give the delivery thread a chance to pick it up
+        for (uint32_t delivered = adapter->mDelivered;
+             delivered == adapter->mDelivered && (i & 7) == 0;) {
+            sched_yield();
+        }
+        locApi->removeAdapter(adapter);
+        // no delivery may reach it from here on
+        adapter->mAlive = 0;
+        for (int spin = 0; spin < 4; spin++) {
+            sched_yield();
+        }
+        late += adapter->mLate;
+        delete adapter;
+    }
+    uint64_t elapsed = nowNs() - start;
+    state.mStop = true;
+    pthread_join(thread, NULL);
+
+    report("dispatch", param("adapters", count), "add_remove",
+           elapsed / (double)count / 1000.0, "us/pair");
+    report("dispatch", param("adapters", count), "events",
+           state.mEvents, "count");
+    report("dispatch", "check=late", "errors", late, "count");
+    if (resident->mDelivered != state.mEvents) {
+        report("dispatch", "check=resident", "errors",
+               state.mEvents - resident->mDelivered, "count");
+    }
+
+    delete resident;
+    delete locApi;
+    task->destroy();
+}
+
+/*****************************************************************************/
+
+struct ResolverLocApi : public LocApiBase {
+    volatile uint32_t mIp;
+    volatile int mPort;
+    inline ResolverLocApi(const MsgTask* msgTask) :
+        LocApiBase(msgTask, 0), mIp(0), mPort(0) {}
+    virtual enum loc_api_adapter_err
+        setServer(unsigned int ip, int port, LocServerType type) {
+        mIp = ip;
+        mPort = port;
+        return LOC_API_ADAPTER_ERR_SUCCESS;
+    }
+};
+
+// serves 'locApi' in place of the one it created
+struct ResolverContext : public ContextBase {
+    LocApiBase* mCreated;
+    inline ResolverContext(const MsgTask* msgTask, LocApiBase* locApi) :
+        ContextBase(msgTask, 0, "liblbs_core.so") {
+        mCreated = mLocApi;
+        mLocApi = locApi;
+    }
+    inline ~ResolverContext() { mLocApi = mCreated; }
+};
+
+struct ResolverFence : public LocMsg {
+    sem_t* mSem;
+    inline ResolverFence(sem_t* sem) : LocMsg(), mSem(sem) {}
+    inline virtual void proc() const { sem_post(mSem); }
+};
+
+// a server name still being resolved must not overwrite the literal
+// address set after it
+static void benchResolverLastWins(LocEngResolver* resolver)
+{
+    MsgTask* task = new MsgTask("LocBenchTask", false);
+    ResolverLocApi* locApi = new ResolverLocApi(task);
+    ResolverContext* context = new ResolverContext(task, locApi);
+    LocEngAdapter* adapter = new LocEngAdapter(0, NULL, context, NULL);
+    LocEngResolver::Address address;
+    sem_t sem;
+    sem_init(&sem, 0, 0);
+
+    uint32_t count = scaled(100), stale = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        resolver->flush();
+        resolver->setServer(adapter, LOC_AGPS_MPC_SERVER, "localhost", 1);
+        resolver->setServer(adapter, LOC_AGPS_MPC_SERVER, "127.0.0.2", 2);
+        // the worker is done once localhost is cached, and has posted its
+        // address by the time the fence comes back from the adapter
+        while (!resolver->peek("localhost", address)) {
+            usleep(100);
+        }
+        usleep(1000);
+        task->sendMsg(new ResolverFence(&sem));
+        sem_wait(&sem);
+        if (locApi->mPort != 2) {
+            stale++;
+        }
+    }
+    report("resolver", "check=last_wins", "errors", stale, "count");
+
+    std::string longName(LocEngResolver::MAX_HOST_LEN + 1, 'a');
+    if (resolver->setServer(adapter, LOC_AGPS_MPC_SERVER, longName.c_str(), 3) >= 0) {
+        report("resolver", "check=long_name", "errors", 1, "count");
+    }
+
+    // the adapter stays, its LocInternalAdapter has no LocApi to leave
+    sem_destroy(&sem);
+    task->destroy();
+}
+
+// resolution of an AGPS server name from the hosts file, as done on the
+// resolver thread, against the cached address handed out to the caller
+static void benchResolver()
+{
+    LocEngResolver* resolver = LocEngResolver::getInstance();
+    LocEngResolver::Address address;
+    static const char* hosts[] = { "localhost", "ip6-localhost" };
+
+    for (size_t h = 0; h < sizeof(hosts) / sizeof(hosts[0]); h++) {
+        uint32_t count = scaled(200);
+        uint32_t resolved = 0;
+        uint64_t start = nowNs();
+        for (uint32_t i = 0; i < count; i++) {
+            resolver->flush();
+            resolved += resolver->resolve(hosts[h], address);
+        }
+        if (resolved != count) {
+            report("resolver", hosts[h], "unresolved", count - resolved, "lookups");
+            continue;
+        }
+        report("resolver", hosts[h], address.ipv6 ? "resolve_ipv6" : "resolve_ipv4",
+               (nowNs() - start) / (double)count / 1000.0, "us/call");
+
+        count = scaled(2000000);
+        start = nowNs();
+        for (uint32_t i = 0; i < count; i++) {
+            resolved += resolver->peek(hosts[h], address);
+        }
+        report("resolver", hosts[h], "cached",
+               (nowNs() - start) / (double)count, "ns/call");
+    }
+
+    benchResolverLastWins(resolver);
+}
+
+/*****************************************************************************
+ * dmn_conn: daemon requests over the loc api server socket
+ *****************************************************************************/
+
+static int dmnConnect()
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strlcpy(addr.sun_path, GPSONE_LOC_API_SOCK_PATH, sizeof(addr.sun_path));
+    // the server thread may not be listening yet
+    for (int i = 0; i < 1000; i++) {
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+        usleep(1000);
+    }
+    return -1;
+}
+
+static void dmnRequest(int fd, int sender, size_t length)
+{
+    struct ctrl_msgbuf cmsgbuf;
+    memset(&cmsgbuf, 0, sizeof(cmsgbuf));
+    cmsgbuf.msgsz = length;
+    cmsgbuf.ctrl_type = GPSONE_LOC_API_IF_REQUEST;
+    cmsgbuf.cmsg.cmsg_if_request.type = IF_REQUEST_TYPE_ANY;
+    cmsgbuf.cmsg.cmsg_if_request.sender_id = (ctrl_if_req_sender_id_e_type)sender;
+    send(fd, &cmsgbuf, length, 0);
+}
+
+// answers sender until the response shows up on fd, that is until the
+// server has routed sender to fd; responses on other are thrown away
+static bool dmnAwait(int fd, int other, int sender)
+{
+    struct ctrl_msgbuf cmsgbuf;
+    for (int i = 0; i < 100000; i++) {
+        loc_eng_dmn_conn_loc_api_server_data_conn(sender, GPSONE_LOC_API_IF_REQUEST_SUCCESS);
+        if (recv(fd, &cmsgbuf, sizeof(cmsgbuf), MSG_DONTWAIT) > 0) {
+            return true;
+        }
+        recv(other, &cmsgbuf, sizeof(cmsgbuf), MSG_DONTWAIT);
+        sched_yield();
+    }
+    return false;
+}
+
+// time from a request on one connection until the server answers the
+// sender there instead of on the connection it used before
+static void benchDmnConn()
+{
+    if (loc_eng_dmn_conn_loc_api_server_launch(NULL, "/tmp/loc_bench_dmn_q",
+                                               "/tmp/loc_bench_dmn_resp_q", NULL) != 0) {
+        report("dmn_conn", "check=launch", "errors", 1, "count");
+        return;
+    }
+    int conn[2] = { dmnConnect(), dmnConnect() };
+    if (conn[0] < 0 || conn[1] < 0) {
+        report("dmn_conn", "check=connect", "errors", 1, "count");
+    } else {
+        uint32_t count = scaled(2000);
+        uint32_t lost = 0;
+        std::vector<uint64_t> samples;
+        samples.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            int fd = conn[i & 1], other = conn[!(i & 1)];
+            uint64_t start = nowNs();
+            dmnRequest(fd, IF_REQUEST_SENDER_ID_MSAPM, sizeof(struct ctrl_msgbuf));
+            if (dmnAwait(fd, other, IF_REQUEST_SENDER_ID_MSAPM)) {
+                samples.push_back(nowNs() - start);
+            } else {
+                lost++;
+            }
+        }
+        reportLatency("dmn_conn", "", samples);
+        if (lost > 0) {
+            report("dmn_conn", "check=response", "errors", lost, "count");
+        }
+
+        // the last request, for MSAPM on conn[1], is still in the server's
+        // receive buffer; a request cut short after the header must not
+        // pick up its sender and move MSAPM over to conn[0]
+        dmnRequest(conn[0], IF_REQUEST_SENDER_ID_MSAPM, sizeof(struct ctrl_msgbuf));
+        dmnAwait(conn[0], conn[1], IF_REQUEST_SENDER_ID_MSAPM);
+        dmnRequest(conn[1], IF_REQUEST_SENDER_ID_MSAPM, sizeof(struct ctrl_msgbuf));
+        dmnAwait(conn[1], conn[0], IF_REQUEST_SENDER_ID_MSAPM);
+        dmnRequest(conn[0], IF_REQUEST_SENDER_ID_MSAPU,
+                   offsetof(struct ctrl_msgbuf, cmsg));
+        dmnRequest(conn[0], IF_REQUEST_SENDER_ID_MSAPU, sizeof(struct ctrl_msgbuf));
+        dmnAwait(conn[0], conn[1], IF_REQUEST_SENDER_ID_MSAPU);
+        if (!dmnAwait(conn[1], conn[0], IF_REQUEST_SENDER_ID_MSAPM)) {
+            report("dmn_conn", "check=short", "errors", 1, "count");
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        if (conn[i] >= 0) {
+            close(conn[i]);
+        }
+    }
+    loc_eng_dmn_conn_loc_api_server_unblock();
+    loc_eng_dmn_conn_loc_api_server_join();
+}
+
+/*****************************************************************************/
+
+struct Bench {
+    const char* name;
+    void (*run)();
+};
+
+static const Bench sBenches[] = {
+    { "msg_q",      benchMsgQ },
+    { "msg_task",   benchMsgTask },
+    { "loc_timer",  benchLocTimer },
+    { "loc_heap",   benchLocHeap },
+    { "loc_cfg",    benchLocCfg },
+    { "nmea",       benchNmea },
+    { "batching",   benchBatching },
+    { "geofence",   benchGeofence },
+    { "trace",      benchTrace },
+    { "log_names",  benchLogNames },
+    { "resolver",   benchResolver },
+    { "dispatch",   benchDispatch },
+    { "dmn_conn",   benchDmnConn },
+};
+
+static void writeJson(FILE* out)
+{
+    char host[64] = "";
+    gethostname(host, sizeof(host) - 1);
+    fprintf(out, "{\n  \"suite\": \"loc_bench\",\n  \"host\": \"%s\",\n"
+            "  \"scale\": %g,\n  \"results\": [\n", host, sScale);
+    for (size_t i = 0; i < sResults.size(); i++) {
+        const BenchResult& r = sResults[i];
+        fprintf(out, "    {\"benchmark\": \"%s\", \"params\": \"%s\", "
+                "\"metric\": \"%s\", \"value\": %.3f, \"unit\": \"%s\"}%s\n",
+                r.benchmark.c_str(), r.params.c_str(), r.metric.c_str(),
+                r.value, r.unit.c_str(),
+                (i + 1 < sResults.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = NULL;
+    const char* outPath = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:s:o:")) != -1) {
+        switch (opt) {
+        case 'f': filter = optarg; break;
+        case 's': sScale = atof(optarg); break;
+        case 'o': outPath = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-f filter] [-s scale] "
+                    "[-o results.json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(sBenches) / sizeof(sBenches[0]); i++) {
+        if (NULL == filter || NULL != strstr(sBenches[i].name, filter)) {
+            sBenches[i].run();
+        }
+    }
+
+    if (NULL != outPath) {
+        FILE* out = fopen(outPath, "w");
+        if (NULL == out) {
+            fprintf(stderr, "could not open %s\n", outPath);
+            return 1;
+        }
+        writeJson(out);
+        fclose(out);
+    }
+    return 0;
+}
@@ -34,6 +34,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <pthread.h>
+#include <time.h>
 #include <wireless_data_service_v01.h>
 #include <utils/Log.h>
 #include <log_util.h>
@@ -54,6 +56,9 @@
 #define DS_CLIENT_SERVICE_TIMEOUT_TOTAL (40000)
 //Timeout for the service to respond to sync msg
 #define DS_CLIENT_SYNC_MSG_TIMEOUT (5000)
+//How long a looked up emergency profile is used before the profiles
+//are queried from the modem again
+#define DS_CLIENT_PROFILE_CACHE_TTL_MS (10 * 60 * 1000)
 /*Request messages the WDS client can send to the WDS service*/
 typedef union
 {
@@ -93,21 +98,118 @@ typedef struct
     void *caller_cookie;
 }ds_caller_data;
 
+typedef enum {
+    //dsi_start_data_call() not sent yet
+    DS_CLIENT_CALL_IDLE = 0,
+    //dsi_start_data_call() in progress on the start thread
+    DS_CLIENT_CALL_STARTING,
+    DS_CLIENT_CALL_STARTED
+}ds_client_call_state_enum_type;
+
 typedef struct {
     //Global dsi handle
     dsi_hndl_t dsi_net_handle;
     //Handle to caller's data
     ds_caller_data caller_data;
+    //Guards the members below, which are shared with the start thread
+    pthread_mutex_t lock;
+    //One reference is held by the caller until ds_client_close_call(),
+    //one by the start thread while it runs. The last one to go releases
+    //the dsi handle.
+    int refs;
+    //Profile to start the call with, DS_CLIENT_PROFILE_INDEX_UNKNOWN
+    //if the start thread has to look it up
+    int profile_index;
+    int pdp_type;
+    ds_client_call_state_enum_type call_state;
+    unsigned char stop_requested;
+    unsigned char connected;
+    unsigned char closed;
 } ds_client_session_data;
 
+/*Emergency profile last found in the modem, with the result of the
+  lookup: E_DS_CLIENT_SUCCESS, or E_DS_CLIENT_FAILURE_UNSUPPORTED if no
+  profile supports emergency calls. Failed queries are not cached.*/
+typedef struct {
+    pthread_mutex_t lock;
+    //Serializes the queries to the modem, so that concurrent lookups
+    //wait for the one in progress instead of repeating it
+    pthread_mutex_t query_lock;
+    unsigned char valid;
+    ds_client_status_enum_type status;
+    int profile_index;
+    int pdp_type;
+    uint64_t fetched_ms;
+} ds_client_profile_cache_type;
+
+static ds_client_profile_cache_type profile_cache = {
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+    0, E_DS_CLIENT_SUCCESS, 0, 0, 0
+};
+
+static uint64_t ds_client_now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*Returns 1 and the result of the last lookup if it is still fresh*/
+static int ds_client_get_cached_profile(ds_client_status_enum_type *status,
+                                        int *profile_index,
+                                        int *pdp_type)
+{
+    int fresh;
+    pthread_mutex_lock(&profile_cache.lock);
+    fresh = profile_cache.valid &&
+        ds_client_now_ms() - profile_cache.fetched_ms <
+        DS_CLIENT_PROFILE_CACHE_TTL_MS;
+    if(fresh) {
+        *status = profile_cache.status;
+        *profile_index = profile_cache.profile_index;
+        *pdp_type = profile_cache.pdp_type;
+    }
+    pthread_mutex_unlock(&profile_cache.lock);
+    return fresh;
+}
+
+/*Drops the cached profile, so the next call queries the modem again*/
+static void ds_client_invalidate_profile()
+{
+    pthread_mutex_lock(&profile_cache.lock);
+    if(profile_cache.valid) {
+        LOC_LOGD("%s:%d]: Dropping cached emergency profile %d\n",
+                 __func__, __LINE__, profile_cache.profile_index);
+        profile_cache.valid = 0;
+    }
+    pthread_mutex_unlock(&profile_cache.lock);
+}
+
+static void ds_client_session_put(ds_client_session_data *session)
+{
+    int refs;
+    pthread_mutex_lock(&session->lock);
+    refs = --session->refs;
+    pthread_mutex_unlock(&session->lock);
+    if(refs == 0) {
+        if(session->dsi_net_handle)
+            dsi_rel_data_srvc_hndl(session->dsi_net_handle);
+        pthread_mutex_destroy(&session->lock);
+        free(session);
+        LOC_LOGD("%s:%d]: Released Data handle\n", __func__, __LINE__);
+    }
+}
+
 void net_ev_cb(dsi_hndl_t handle, void* user_data,
                dsi_net_evt_t evt, dsi_evt_payload_t *payload_ptr)
 {
     int i;
+    unsigned char closed, invalidate = 0;
     (void)handle;
-    (void)user_data;
     (void)payload_ptr;
-    ds_caller_data *callback_data = (ds_caller_data *)user_data;
+    ds_client_session_data *session = (ds_client_session_data *)user_data;
+    ds_caller_data *callback_data = &session->caller_data;
 
     LOC_LOGD("%s:%d]: Enter. Callback data: %p\n", __func__, __LINE__, callback_data);
     if(evt > DSI_EVT_INVALID && evt < DSI_EVT_MAX)
@@ -118,6 +220,28 @@ void net_ev_cb(dsi_hndl_t handle, void* user_data,
                 LOC_LOGE("%s:%d]: Callback received: %s",
                          __func__, __LINE__, event_string_tbl[i].str);
         }
+        pthread_mutex_lock(&session->lock);
+        closed = session->closed;
+        if(evt == DSI_EVT_NET_IS_CONN || evt == DSI_EVT_WDS_CONNECTED) {
+            session->connected = 1;
+        }
+        else if(evt == DSI_EVT_NET_NO_NET) {
+            //A call that fails to come up on its own may have been
+            //started with a profile that is gone from the modem. A call
+            //that dsi_start_data_call() turned down is left to
+            //ds_client_report_start_failure().
+            invalidate = !session->connected && !session->stop_requested &&
+                !session->closed &&
+                session->call_state != DS_CLIENT_CALL_IDLE;
+            session->connected = 0;
+        }
+        pthread_mutex_unlock(&session->lock);
+        if(invalidate)
+            ds_client_invalidate_profile();
+        if(closed) {
+            LOC_LOGD("%s:%d]: Handle closed. Dropping event\n", __func__, __LINE__);
+            goto err;
+        }
         switch(evt) {
         case DSI_EVT_NET_IS_CONN:
         case DSI_EVT_WDS_CONNECTED:
@@ -138,9 +262,43 @@ void net_ev_cb(dsi_hndl_t handle, void* user_data,
             LOC_LOGD("%s:%d]: uninteresting event\n", __func__, __LINE__);
         }
     }
+err:
     LOC_LOGD("%s:%d]:Exit\n", __func__, __LINE__);
 }
 
+/*
+  Reports a call that the start thread could not start. The failures
+  that may go away on their own, such as a WDS query that timed out or
+  a dsi_start_data_call() that was turned down, are reported as
+  E_DS_CLIENT_RETRY_LATER, like a dsi handle that ds_client_open_call()
+  can't get yet. A missing emergency profile or a call stopped before
+  it was started is reported as E_DS_CLIENT_DATA_CALL_DISCONNECTED.
+*/
+static void ds_client_report_start_failure(ds_client_session_data *session,
+                                           ds_client_status_enum_type status)
+{
+    ds_caller_data *callback_data = &session->caller_data;
+    ds_client_status_enum_type event = E_DS_CLIENT_RETRY_LATER;
+    unsigned char closed;
+
+    pthread_mutex_lock(&session->lock);
+    session->connected = 0;
+    closed = session->closed;
+    if(session->stop_requested ||
+       status == E_DS_CLIENT_FAILURE_UNSUPPORTED ||
+       status == E_DS_CLIENT_FAILURE_INVALID_PARAMETER)
+        event = E_DS_CLIENT_DATA_CALL_DISCONNECTED;
+    pthread_mutex_unlock(&session->lock);
+
+    LOC_LOGE("%s:%d]: Emergency call not started. status: %d event: %d\n",
+             __func__, __LINE__, status, event);
+    if(closed) {
+        LOC_LOGD("%s:%d]: Handle closed. Dropping event\n", __func__, __LINE__);
+        return;
+    }
+    callback_data->event_cb(event, callback_data->caller_cookie);
+}
+
 /*This function is called to obtain a handle to the QMI WDS service*/
 static ds_client_status_enum_type
 ds_client_qmi_ctrl_point_init(qmi_client_type *p_wds_qmi_client)
@@ -440,75 +598,21 @@ err:
     return ret;
 }
 
-/*
-  Starts data call using the handle and the profile index
-*/
-ds_client_status_enum_type
-ds_client_start_call(dsClientHandleType client_handle, int profile_index, int pdp_type)
-{
-    ds_client_status_enum_type ret = E_DS_CLIENT_FAILURE_GENERAL;
-    dsi_call_param_value_t param_info;
-    dsi_hndl_t dsi_handle;
-    ds_client_session_data *ds_global_data = (ds_client_session_data *)client_handle;
-    LOC_LOGD("%s:%d]:Enter\n", __func__, __LINE__);
-    if(ds_global_data == NULL) {
-        LOC_LOGE("%s:%d]: Null callback parameter\n", __func__, __LINE__);
-        goto err;
-    }
-    dsi_handle = ds_global_data->dsi_net_handle;
-    //Set profile index as call parameter
-    param_info.buf_val = NULL;
-    param_info.num_val = profile_index;
-    dsi_set_data_call_param(dsi_handle,
-                            DSI_CALL_INFO_UMTS_PROFILE_IDX,
-                            &param_info);
-
-    //Set IP Version as call parameter
-    param_info.buf_val = NULL;
-    param_info.num_val = pdp_type;
-    dsi_set_data_call_param(dsi_handle,
-                            DSI_CALL_INFO_IP_VERSION,
-                            &param_info);
-    LOC_LOGD("%s:%d]: Starting emergency call with profile index %d; pdp_type:%d\n",
-             __func__, __LINE__, profile_index, pdp_type);
-    if(dsi_start_data_call(dsi_handle) == DSI_SUCCESS) {
-        LOC_LOGD("%s:%d]: Sent request to start data call\n",
-                 __func__, __LINE__);
-        ret = E_DS_CLIENT_SUCCESS;
-    }
-    else {
-        LOC_LOGE("%s:%d]: Could not send req to start data call \n", __func__, __LINE__);
-        ret = E_DS_CLIENT_FAILURE_GENERAL;
-        goto err;
-    }
-
-err:
-    LOC_LOGD("%s:%d]:Exit\n", __func__, __LINE__);
-    return ret;
-
-}
-
-/*Function to open an emergency call. Does the following things:
+/*Queries the modem for the profile to make emergency calls with:
  - Obtains a handle to the WDS service
  - Obtains a list of profiles configured in the modem
  - Queries each profile and obtains settings to check if emergency calls
    are supported
- - Returns the profile index that supports emergency calls
- - Returns handle to dsi_netctrl*/
-ds_client_status_enum_type
-ds_client_open_call(dsClientHandleType *client_handle,
-                    ds_client_cb_data *callback,
-                    void *caller_cookie,
-                    int *profile_index,
-                    int *pdp_type)
+ - Returns the profile index that supports emergency calls, or
+   E_DS_CLIENT_FAILURE_UNSUPPORTED if there is none*/
+static ds_client_status_enum_type
+ds_client_query_emergency_profile(int *profile_index, int *pdp_type)
 {
     ds_client_status_enum_type ret = E_DS_CLIENT_FAILURE_GENERAL;
     ds_client_resp_union_type profile_list_resp_msg;
     ds_client_resp_union_type profile_settings_resp_msg;
     wds_profile_identifier_type_v01 profile_identifier;
     uint32_t i=0;
-    dsi_hndl_t dsi_handle;
-    ds_client_session_data **ds_global_data = (ds_client_session_data **)client_handle;
     unsigned char call_profile_index_found = 0;
     uint32_t emergency_profile_index=0;
     qmi_client_type wds_qmi_client;
@@ -517,11 +621,6 @@ ds_client_open_call(dsClientHandleType *client_handle,
     profile_settings_resp_msg.p_get_profile_setting_resp = NULL;
 
     LOC_LOGD("%s:%d]:Enter\n", __func__, __LINE__);
-    if(callback == NULL || ds_global_data == NULL) {
-        LOC_LOGE("%s:%d]: Null callback parameter\n", __func__, __LINE__);
-        goto err;
-    }
-
     ret = ds_client_qmi_ctrl_point_init(&wds_qmi_client);
     if(ret != E_DS_CLIENT_SUCCESS) {
         LOC_LOGE("%s:%d]: ds_client_qmi_ctrl_point_init failed. ret: %d\n",
@@ -536,7 +635,7 @@ ds_client_open_call(dsClientHandleType *client_handle,
         LOC_LOGE("%s:%d]: Could not allocate memory for"
                  "p_get_profile_list_resp\n", __func__, __LINE__);
         ret = E_DS_CLIENT_FAILURE_NOT_ENOUGH_MEMORY;
-        goto err;
+        goto release;
     }
 
     LOC_LOGD("%s:%d]: Getting profile list\n", __func__, __LINE__);
@@ -546,7 +645,7 @@ ds_client_open_call(dsClientHandleType *client_handle,
     if(ret != E_DS_CLIENT_SUCCESS) {
         LOC_LOGE("%s:%d]: ds_client_get_profile_list failed. ret: %d\n",
                  __func__, __LINE__, ret);
-        goto err;
+        goto release;
     }
     LOC_LOGD("%s:%d]: Got profile list; length = %d\n", __func__, __LINE__,
              profile_list_resp_msg.p_get_profile_list_resp->profile_list_len);
@@ -560,7 +659,7 @@ ds_client_open_call(dsClientHandleType *client_handle,
         LOC_LOGE("%s:%d]: Could not allocate memory for"
                  "p_get_profile_setting_resp\n", __func__, __LINE__);
         ret = E_DS_CLIENT_FAILURE_NOT_ENOUGH_MEMORY;
-        goto err;
+        goto release;
     }
 
     //Loop over the list of profiles to find a profile that supports
@@ -583,7 +682,7 @@ ds_client_open_call(dsClientHandleType *client_handle,
         if(ret != E_DS_CLIENT_SUCCESS) {
             LOC_LOGE("%s:%d]: ds_client_get_profile_settings failed. ret: %d\n",
                      __func__, __LINE__, ret);
-            goto err;
+            goto release;
         }
         LOC_LOGD("%s:%d]: Got profile setting for profile %d; name: %s\n",
                  __func__, __LINE__, i,
@@ -635,45 +734,245 @@ ds_client_open_call(dsClientHandleType *client_handle,
                0, sizeof(wds_get_profile_settings_resp_msg_v01));
     }
 
+    if(call_profile_index_found) {
+        *profile_index = emergency_profile_index;
+        ret = E_DS_CLIENT_SUCCESS;
+    }
+    else {
+        LOC_LOGE("%s:%d]: Could not find a profile that supports emergency calls",
+                 __func__, __LINE__);
+        ret = E_DS_CLIENT_FAILURE_UNSUPPORTED;
+    }
+
+release:
     //Release qmi client handle
     if(qmi_client_release(wds_qmi_client) != QMI_NO_ERR) {
         LOC_LOGE("%s:%d]: Could not release qmi client handle\n",
                  __func__, __LINE__);
-        ret = E_DS_CLIENT_FAILURE_GENERAL;
     }
+err:
+    if(profile_list_resp_msg.p_get_profile_list_resp)
+        free(profile_list_resp_msg.p_get_profile_list_resp);
+    if(profile_settings_resp_msg.p_get_profile_setting_resp)
+        free(profile_settings_resp_msg.p_get_profile_setting_resp);
+    LOC_LOGD("%s:%d]:Exit\n", __func__, __LINE__);
+    return ret;
+}
 
-    if(call_profile_index_found) {
-        *profile_index = emergency_profile_index;
-        *ds_global_data = (ds_client_session_data *)calloc(1, sizeof(ds_client_session_data));
-        if(*ds_global_data == NULL) {
-            LOC_LOGE("%s:%d]: Could not allocate memory for ds_global_data. Failing\n",
-                     __func__, __LINE__);
-            ret = E_DS_CLIENT_FAILURE_NOT_ENOUGH_MEMORY;
+/*Returns the emergency profile from the cache, or from the modem once
+  the cache has expired or been invalidated*/
+static ds_client_status_enum_type
+ds_client_get_emergency_profile(int *profile_index, int *pdp_type)
+{
+    ds_client_status_enum_type ret = E_DS_CLIENT_FAILURE_GENERAL;
+
+    pthread_mutex_lock(&profile_cache.query_lock);
+    //The cache may have been filled while we waited for the query lock
+    if(!ds_client_get_cached_profile(&ret, profile_index, pdp_type)) {
+        ret = ds_client_query_emergency_profile(profile_index, pdp_type);
+        if(ret == E_DS_CLIENT_SUCCESS || ret == E_DS_CLIENT_FAILURE_UNSUPPORTED) {
+            pthread_mutex_lock(&profile_cache.lock);
+            profile_cache.valid = 1;
+            profile_cache.status = ret;
+            profile_cache.profile_index = *profile_index;
+            profile_cache.pdp_type = *pdp_type;
+            profile_cache.fetched_ms = ds_client_now_ms();
+            pthread_mutex_unlock(&profile_cache.lock);
+        }
+    }
+    pthread_mutex_unlock(&profile_cache.query_lock);
+    return ret;
+}
+
+/*
+  Runs the blocking part of ds_client_start_call(): the profile lookup,
+  if open did not find it in the cache, and dsi_start_data_call().
+  A call that can't be started is reported through
+  ds_client_report_start_failure().
+*/
+static void *ds_client_start_call_thread(void *arg)
+{
+    ds_client_status_enum_type ret = E_DS_CLIENT_SUCCESS;
+    ds_client_session_data *session = (ds_client_session_data *)arg;
+    dsi_call_param_value_t param_info;
+    dsi_hndl_t dsi_handle = session->dsi_net_handle;
+    int profile_index, pdp_type;
+    unsigned char stop_requested;
+
+    LOC_LOGD("%s:%d]:Enter\n", __func__, __LINE__);
+    pthread_mutex_lock(&session->lock);
+    profile_index = session->profile_index;
+    pdp_type = session->pdp_type;
+    pthread_mutex_unlock(&session->lock);
+
+    if(profile_index == DS_CLIENT_PROFILE_INDEX_UNKNOWN) {
+        ret = ds_client_get_emergency_profile(&profile_index, &pdp_type);
+        if(ret != E_DS_CLIENT_SUCCESS) {
+            LOC_LOGE("%s:%d]: No emergency profile. ret: %d\n",
+                     __func__, __LINE__, ret);
             goto err;
         }
+    }
+
+    pthread_mutex_lock(&session->lock);
+    stop_requested = session->stop_requested || session->closed;
+    if(!stop_requested)
+        session->call_state = DS_CLIENT_CALL_STARTING;
+    pthread_mutex_unlock(&session->lock);
+    if(stop_requested) {
+        LOC_LOGD("%s:%d]: Call stopped before it was started\n", __func__, __LINE__);
+        ret = E_DS_CLIENT_FAILURE_GENERAL;
+        goto err;
+    }
+
+    //Set profile index as call parameter
+    param_info.buf_val = NULL;
+    param_info.num_val = profile_index;
+    dsi_set_data_call_param(dsi_handle,
+                            DSI_CALL_INFO_UMTS_PROFILE_IDX,
+                            &param_info);
+
+    //Set IP Version as call parameter
+    param_info.buf_val = NULL;
+    param_info.num_val = pdp_type;
+    dsi_set_data_call_param(dsi_handle,
+                            DSI_CALL_INFO_IP_VERSION,
+                            &param_info);
+    LOC_LOGD("%s:%d]: Starting emergency call with profile index %d; pdp_type:%d\n",
+             __func__, __LINE__, profile_index, pdp_type);
+    if(dsi_start_data_call(dsi_handle) == DSI_SUCCESS) {
+        LOC_LOGD("%s:%d]: Sent request to start data call\n",
+                 __func__, __LINE__);
+    }
+    else {
+        LOC_LOGE("%s:%d]: Could not send req to start data call \n", __func__, __LINE__);
+        ret = E_DS_CLIENT_FAILURE_GENERAL;
+    }
+
+    pthread_mutex_lock(&session->lock);
+    session->call_state = (ret == E_DS_CLIENT_SUCCESS) ?
+        DS_CLIENT_CALL_STARTED : DS_CLIENT_CALL_IDLE;
+    stop_requested = session->stop_requested;
+    pthread_mutex_unlock(&session->lock);
+    //ds_client_stop_call() came in while the call was being started
+    if(ret == E_DS_CLIENT_SUCCESS && stop_requested &&
+       dsi_stop_data_call(dsi_handle) != DSI_SUCCESS) {
+        LOC_LOGE("%s:%d]: Could not send request to stop data call\n",
+                 __func__, __LINE__);
+    }
+
+err:
+    if(ret != E_DS_CLIENT_SUCCESS)
+        ds_client_report_start_failure(session, ret);
+    ds_client_session_put(session);
+    LOC_LOGD("%s:%d]:Exit\n", __func__, __LINE__);
+    return NULL;
+}
+
+/*
+  Starts data call using the handle and the profile index.
+  The call is started on a thread of its own; the outcome is reported
+  through the event callback passed to ds_client_open_call().
+*/
+ds_client_status_enum_type
+ds_client_start_call(dsClientHandleType client_handle, int profile_index, int pdp_type)
+{
+    ds_client_status_enum_type ret = E_DS_CLIENT_FAILURE_GENERAL;
+    ds_client_session_data *ds_global_data = (ds_client_session_data *)client_handle;
+    pthread_attr_t attr;
+    pthread_t thread;
+    LOC_LOGD("%s:%d]:Enter\n", __func__, __LINE__);
+    if(ds_global_data == NULL) {
+        LOC_LOGE("%s:%d]: Null callback parameter\n", __func__, __LINE__);
+        goto err;
+    }
+
+    pthread_mutex_lock(&ds_global_data->lock);
+    ds_global_data->profile_index = profile_index;
+    ds_global_data->pdp_type = pdp_type;
+    //Reference held by the start thread
+    ds_global_data->refs++;
+    pthread_mutex_unlock(&ds_global_data->lock);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if(pthread_create(&thread, &attr, ds_client_start_call_thread,
+                      ds_global_data) == 0) {
+        ret = E_DS_CLIENT_SUCCESS;
+    }
+    else {
+        LOC_LOGE("%s:%d]: Could not create start call thread\n", __func__, __LINE__);
+        ds_client_session_put(ds_global_data);
+        ret = E_DS_CLIENT_FAILURE_INTERNAL;
+    }
+    pthread_attr_destroy(&attr);
+
+err:
+    LOC_LOGD("%s:%d]:Exit\n", __func__, __LINE__);
+    return ret;
+
+}
 
-        (*ds_global_data)->caller_data.event_cb = callback->event_cb;
-        (*ds_global_data)->caller_data.caller_cookie = caller_cookie;
-        dsi_handle = dsi_get_data_srvc_hndl(net_ev_cb, &(*ds_global_data)->caller_data);
-        if(dsi_handle == NULL) {
-            LOC_LOGE("%s:%d]: Could not get data handle. Retry Later\n",
+/*Function to open an emergency call. Does the following things:
+ - Returns the profile index that supports emergency calls, if it is
+   cached. Otherwise the profile is looked up by ds_client_start_call()
+ - Returns handle to dsi_netctrl*/
+ds_client_status_enum_type
+ds_client_open_call(dsClientHandleType *client_handle,
+                    ds_client_cb_data *callback,
+                    void *caller_cookie,
+                    int *profile_index,
+                    int *pdp_type)
+{
+    ds_client_status_enum_type ret = E_DS_CLIENT_FAILURE_GENERAL;
+    dsi_hndl_t dsi_handle;
+    ds_client_session_data **ds_global_data = (ds_client_session_data **)client_handle;
+
+    LOC_LOGD("%s:%d]:Enter\n", __func__, __LINE__);
+    if(callback == NULL || ds_global_data == NULL) {
+        LOC_LOGE("%s:%d]: Null callback parameter\n", __func__, __LINE__);
+        goto err;
+    }
+
+    if(ds_client_get_cached_profile(&ret, profile_index, pdp_type)) {
+        if(ret != E_DS_CLIENT_SUCCESS) {
+            LOC_LOGE("%s:%d]: Could not find a profile that supports emergency calls",
                      __func__, __LINE__);
-            ret = E_DS_CLIENT_RETRY_LATER;
             goto err;
         }
-        else
-            (*ds_global_data)->dsi_net_handle = dsi_handle;
+        LOC_LOGD("%s:%d]: Cached emergency profile %d; pdp_type: %d\n",
+                 __func__, __LINE__, *profile_index, *pdp_type);
     }
     else {
-        LOC_LOGE("%s:%d]: Could not find a profile that supports emergency calls",
+        *profile_index = DS_CLIENT_PROFILE_INDEX_UNKNOWN;
+        *pdp_type = DSI_IP_VERSION_4;
+    }
+
+    *ds_global_data = (ds_client_session_data *)calloc(1, sizeof(ds_client_session_data));
+    if(*ds_global_data == NULL) {
+        LOC_LOGE("%s:%d]: Could not allocate memory for ds_global_data. Failing\n",
                  __func__, __LINE__);
-        ret = E_DS_CLIENT_FAILURE_GENERAL;
+        ret = E_DS_CLIENT_FAILURE_NOT_ENOUGH_MEMORY;
+        goto err;
     }
+
+    pthread_mutex_init(&(*ds_global_data)->lock, NULL);
+    (*ds_global_data)->refs = 1;
+    (*ds_global_data)->caller_data.event_cb = callback->event_cb;
+    (*ds_global_data)->caller_data.caller_cookie = caller_cookie;
+    dsi_handle = dsi_get_data_srvc_hndl(net_ev_cb, *ds_global_data);
+    if(dsi_handle == NULL) {
+        LOC_LOGE("%s:%d]: Could not get data handle. Retry Later\n",
+                 __func__, __LINE__);
+        ds_client_session_put(*ds_global_data);
+        *ds_global_data = NULL;
+        ret = E_DS_CLIENT_RETRY_LATER;
+        goto err;
+    }
+    (*ds_global_data)->dsi_net_handle = dsi_handle;
+    ret = E_DS_CLIENT_SUCCESS;
+
 err:
-    if(profile_list_resp_msg.p_get_profile_list_resp)
-        free(profile_list_resp_msg.p_get_profile_list_resp);
-    if(profile_settings_resp_msg.p_get_profile_setting_resp)
-        free(profile_settings_resp_msg.p_get_profile_setting_resp);
     LOC_LOGD("%s:%d]:Exit\n", __func__, __LINE__);
     return ret;
 }
@@ -682,6 +981,7 @@ ds_client_status_enum_type ds_client_stop_call(dsClientHandleType client_handle)
 {
     ds_client_status_enum_type ret = E_DS_CLIENT_SUCCESS;
     ds_client_session_data *p_ds_global_data = (ds_client_session_data *)client_handle;
+    ds_client_call_state_enum_type call_state;
     LOC_LOGD("%s:%d]:Enter\n", __func__, __LINE__);
 
     if(client_handle == NULL) {
@@ -690,6 +990,17 @@ ds_client_status_enum_type ds_client_stop_call(dsClientHandleType client_handle)
         goto err;
     }
 
+    pthread_mutex_lock(&p_ds_global_data->lock);
+    p_ds_global_data->stop_requested = 1;
+    call_state = p_ds_global_data->call_state;
+    pthread_mutex_unlock(&p_ds_global_data->lock);
+    if(call_state != DS_CLIENT_CALL_STARTED) {
+        //The start thread stops the call once it has been started, or
+        //reports it disconnected without starting it
+        LOC_LOGD("%s:%d]: Call not started yet. Stop deferred\n", __func__, __LINE__);
+        goto err;
+    }
+
     if(dsi_stop_data_call(p_ds_global_data->dsi_net_handle) == DSI_SUCCESS) {
         LOC_LOGD("%s:%d]: Sent request to stop data call\n", __func__, __LINE__);
     }
@@ -716,11 +1027,13 @@ void ds_client_close_call(dsClientHandleType *client_handle)
         LOC_LOGE("%s:%d]: Null argument received. Failing\n", __func__, __LINE__);
         goto err;
     }
-    dsi_rel_data_srvc_hndl((*ds_global_data)->dsi_net_handle);
-    (*ds_global_data)->dsi_net_handle = NULL;
-    free(*ds_global_data);
+    //No more events to the caller. The dsi handle is released once the
+    //start thread, if it is still running, is done with it.
+    pthread_mutex_lock(&(*ds_global_data)->lock);
+    (*ds_global_data)->closed = 1;
+    pthread_mutex_unlock(&(*ds_global_data)->lock);
+    ds_client_session_put(*ds_global_data);
     *ds_global_data = NULL;
-    LOC_LOGD("%s:%d]: Released Data handle\n", __func__, __LINE__);
 err:
     LOC_LOGD("%s:%d]:Exit\n", __func__, __LINE__);
     return;
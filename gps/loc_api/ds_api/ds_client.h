@@ -35,6 +35,10 @@ extern "C" {
 
 typedef void* dsClientHandleType;
 
+/*Profile index returned by ds_client_open_call() when the emergency
+  profile is not cached; ds_client_start_call() looks it up*/
+#define DS_CLIENT_PROFILE_INDEX_UNKNOWN (-1)
+
 typedef enum
 {
   E_DS_CLIENT_SUCCESS                              = 0,
@@ -110,9 +114,11 @@ typedef struct {
 int ds_client_init();
 
 /*
-  Obtains a handle to the dsi_netctrl layer and looks up the profile
-  to make the call. As of now. It only searches for profiles that
-  support emergency calls
+  Obtains a handle to the dsi_netctrl layer and returns the profile
+  to make the call with, if it is cached. As of now. It only searches
+  for profiles that support emergency calls. The profile is cached for
+  a while after it has been looked up in the modem; until then,
+  profile_index is DS_CLIENT_PROFILE_INDEX_UNKNOWN.
  */
 ds_client_status_enum_type ds_client_open_call(dsClientHandleType *client_handle,
                                                ds_client_cb_data *callback,
@@ -121,7 +127,12 @@ ds_client_status_enum_type ds_client_open_call(dsClientHandleType *client_handle
                                                int *pdp_type);
 
 /*
-  Starts a data call using the profile number provided
+  Starts a data call using the profile number provided, without waiting
+  for it. E_DS_CLIENT_DATA_CALL_CONNECTED or E_DS_CLIENT_DATA_CALL_DISCONNECTED
+  is reported through the callback once the call is up or has failed.
+  E_DS_CLIENT_RETRY_LATER is reported instead if the call could not be
+  started for a reason that may go away; the handle should be closed and
+  the call opened again after a delay.
  */
 ds_client_status_enum_type ds_client_start_call(dsClientHandleType client_handle,
                                                 int profile_index,
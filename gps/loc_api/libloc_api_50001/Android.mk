@@ -24,6 +24,9 @@ LOCAL_SRC_FILES += \
     loc_eng_ni.cpp \
     loc_eng_log.cpp \
     loc_eng_nmea.cpp \
+    loc_eng_batching.cpp \
+    loc_eng_geofence.cpp \
+    loc_eng_resolver.cpp \
     LocEngAdapter.cpp
 
 LOCAL_SRC_FILES += \
@@ -31,12 +34,17 @@ LOCAL_SRC_FILES += \
     loc_eng_dmn_conn_handler.cpp \
     loc_eng_dmn_conn_thread_helper.c \
     loc_eng_dmn_conn_glue_msg.c \
-    loc_eng_dmn_conn_glue_pipe.c
+    loc_eng_dmn_conn_glue_pipe.c \
+    loc_eng_dmn_conn_glue_sock.c
 
 LOCAL_CFLAGS += \
      -fno-short-enums \
      -D_ANDROID_
 
+ifeq ($(TARGET_BUILD_VARIANT),user)
+   LOCAL_CFLAGS += -DTARGET_BUILD_VARIANT_USER
+endif
+
 LOCAL_C_INCLUDES:= \
     $(TARGET_OUT_HEADERS)/gps.utils \
     $(TARGET_OUT_HEADERS)/libloc_core \
@@ -52,7 +60,10 @@ LOCAL_COPY_HEADERS:= \
    loc_eng_ni.h \
    loc_eng_agps.h \
    loc_eng_msg.h \
-   loc_eng_log.h
+   loc_eng_log.h \
+   loc_eng_batching.h \
+   loc_eng_geofence.h \
+   loc_eng_resolver.h
 
 LOCAL_PRELINK_MODULE := false
 
@@ -84,6 +95,10 @@ LOCAL_CFLAGS += \
     -fno-short-enums \
     -D_ANDROID_ \
 
+ifeq ($(TARGET_BUILD_VARIANT),user)
+   LOCAL_CFLAGS += -DTARGET_BUILD_VARIANT_USER
+endif
+
 ifeq ($(TARGET_USES_QCOM_BSP), true)
 LOCAL_CFLAGS += -DTARGET_USES_QCOM_BSP
 endif
@@ -34,6 +34,7 @@
 #include <ctype.h>
 #include <cutils/properties.h>
 #include <LocEngAdapter.h>
+#include <loc_eng_batching.h>
 #include "loc_eng_msg.h"
 #include "loc_log.h"
 
@@ -298,6 +299,12 @@ void LocEngAdapter::setUlpProxy(UlpProxyBase* ulp)
         ulp->sendStartFix();
     }
 
+    // fixes batched for the old ULP go to it before it is gone
+    loc_eng_data_s_type* locEng = (loc_eng_data_s_type*)mOwner;
+    if (NULL != locEng && NULL != locEng->batcher) {
+        locEng->batcher->flush();
+    }
+
     delete mUlp;
     mUlp = ulp;
 }
@@ -347,12 +354,15 @@ void LocInternalAdapter::reportPosition(UlpLocation &location,
                                         enum loc_sess_status status,
                                         LocPosTechMask loc_technology_mask)
 {
-    sendMsg(new LocEngReportPosition(mLocEngAdapter,
-                                     location,
-                                     locationExtended,
-                                     locationExt,
-                                     status,
-                                     loc_technology_mask));
+    LocFix* fix = LocFix::obtain(location, locationExtended, locationExt,
+                                 status, loc_technology_mask);
+    reportPosition(*fix);
+    fix->drop();
+}
+
+void LocInternalAdapter::reportPosition(LocFix& fix)
+{
+    sendMsg(new LocEngReportPosition(mLocEngAdapter, fix));
 }
 
 
@@ -362,16 +372,16 @@ void LocEngAdapter::reportPosition(UlpLocation &location,
                                    enum loc_sess_status status,
                                    LocPosTechMask loc_technology_mask)
 {
-    if (! mUlp->reportPosition(location,
-                               locationExtended,
-                               locationExt,
-                               status,
-                               loc_technology_mask )) {
-        mInternalAdapter->reportPosition(location,
-                                         locationExtended,
-                                         locationExt,
-                                         status,
-                                         loc_technology_mask);
+    LocFix* fix = LocFix::obtain(location, locationExtended, locationExt,
+                                 status, loc_technology_mask);
+    reportPosition(*fix);
+    fix->drop();
+}
+
+void LocEngAdapter::reportPosition(LocFix& fix)
+{
+    if (! mUlp->reportPosition(fix)) {
+        mInternalAdapter->reportPosition(fix);
     }
 }
 
@@ -508,6 +518,14 @@ bool LocEngAdapter::reportDataCallClosed()
     return mSupportsAgpsRequests;
 }
 
+inline
+bool LocEngAdapter::reportDataCallRetry()
+{
+    if(mSupportsAgpsRequests)
+        sendMsg(new LocEngSuplEsRetry(mOwner));
+    return mSupportsAgpsRequests;
+}
+
 inline
 void LocEngAdapter::handleEngineDownEvent()
 {
@@ -55,6 +55,7 @@ public:
                                 void* locationExt,
                                 enum loc_sess_status status,
                                 LocPosTechMask loc_technology_mask);
+    virtual void reportPosition(LocFix& fix);
     virtual void reportSv(HaxxSvStatus &svStatus,
                           GpsLocationExtended &locationExtended,
                           void* svExt);
@@ -176,6 +177,12 @@ public:
     {
         return mLocApi->setServer(ip, port, type);
     }
+    inline enum loc_api_adapter_err
+        setServerIpv6(const uint8_t* ip, int port,
+                      LocServerType type)
+    {
+        return mLocApi->setServerIpv6(ip, port, type);
+    }
     inline enum loc_api_adapter_err
         informNiResponse(GpsUserResponseType userResponse, const void* passThroughData)
     {
@@ -269,6 +276,7 @@ public:
                                 void* locationExt,
                                 enum loc_sess_status status,
                                 LocPosTechMask loc_technology_mask);
+    virtual void reportPosition(LocFix& fix);
     virtual void reportSv(HaxxSvStatus &svStatus,
                           GpsLocationExtended &locationExtended,
                           void* svExt);
@@ -284,6 +292,7 @@ public:
     virtual bool requestSuplES(int connHandle);
     virtual bool reportDataCallOpened();
     virtual bool reportDataCallClosed();
+    virtual bool reportDataCallRetry();
     virtual void reportGpsMeasurementData(GpsData &gpsMeasurementData);
 
     inline const LocPosMode& getPositionMode() const
@@ -134,6 +134,26 @@ static const GpsMeasurementInterface sLocEngGpsMeasurementInterface =
     loc_gps_measurement_close
 };
 
+static void loc_geofence_init(GpsGeofenceCallbacks* callbacks);
+static void loc_geofence_add_area(int32_t geofence_id, double latitude,
+                                  double longitude, double radius_meters,
+                                  int last_transition, int monitor_transitions,
+                                  int notification_responsiveness_ms,
+                                  int unknown_timer_ms);
+static void loc_geofence_pause(int32_t geofence_id);
+static void loc_geofence_resume(int32_t geofence_id, int monitor_transitions);
+static void loc_geofence_remove_area(int32_t geofence_id);
+
+static const GpsGeofencingInterface sLocEngGeofenceInterface =
+{
+    sizeof(GpsGeofencingInterface),
+    loc_geofence_init,
+    loc_geofence_add_area,
+    loc_geofence_pause,
+    loc_geofence_resume,
+    loc_geofence_remove_area
+};
+
 static void loc_agps_ril_init( AGpsRilCallbacks* callbacks );
 static void loc_agps_ril_set_ref_location(const AGpsRefLocation *agps_reflocation, size_t sz_struct);
 static void loc_agps_ril_set_set_id(AGpsSetIDType type, const char* setid);
@@ -552,6 +572,11 @@ const GpsGeofencingInterface* get_geofence_interface(void)
     get_gps_geofence_interface_function get_gps_geofence_interface;
     static const GpsGeofencingInterface* geofence_interface = NULL;
 
+    if (gps_conf.AP_GEOFENCE) {
+        geofence_interface = &sLocEngGeofenceInterface;
+        goto exit;
+    }
+
     dlerror();    /* Clear any existing error */
 
     handle = dlopen ("libgeofence.so", RTLD_NOW);
@@ -941,6 +966,134 @@ static void loc_gps_measurement_close()
     EXIT_LOG(%s, VOID_RET);
 }
 
+/*===========================================================================
+FUNCTION    loc_geofence_init
+
+DESCRIPTION
+   This function initializes the geofence interface of the AP geofence
+   engine, used instead of libgeofence.so when AP_GEOFENCE is set
+
+DEPENDENCIES
+   NONE
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_geofence_init(GpsGeofenceCallbacks* callbacks)
+{
+    ENTRY_LOG();
+    loc_eng_geofence_init(loc_afw_data, callbacks);
+
+    EXIT_LOG(%s, VOID_RET);
+}
+
+/*===========================================================================
+FUNCTION    loc_geofence_add_area
+
+DESCRIPTION
+   This function adds a circular geofence, the result is reported through
+   geofence_add_callback. unknown_timer_ms is not supported.
+
+DEPENDENCIES
+   NONE
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_geofence_add_area(int32_t geofence_id, double latitude,
+                                  double longitude, double radius_meters,
+                                  int last_transition, int monitor_transitions,
+                                  int notification_responsiveness_ms,
+                                  int unknown_timer_ms)
+{
+    ENTRY_LOG();
+    loc_eng_geofence_add(loc_afw_data, geofence_id, latitude, longitude,
+                         radius_meters, last_transition, monitor_transitions,
+                         notification_responsiveness_ms);
+
+    EXIT_LOG(%s, VOID_RET);
+}
+
+/*===========================================================================
+FUNCTION    loc_geofence_pause
+
+DESCRIPTION
+   This function stops monitoring a geofence
+
+DEPENDENCIES
+   NONE
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_geofence_pause(int32_t geofence_id)
+{
+    ENTRY_LOG();
+    loc_eng_geofence_pause(loc_afw_data, geofence_id);
+
+    EXIT_LOG(%s, VOID_RET);
+}
+
+/*===========================================================================
+FUNCTION    loc_geofence_resume
+
+DESCRIPTION
+   This function resumes monitoring a paused geofence
+
+DEPENDENCIES
+   NONE
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_geofence_resume(int32_t geofence_id, int monitor_transitions)
+{
+    ENTRY_LOG();
+    loc_eng_geofence_resume(loc_afw_data, geofence_id, monitor_transitions);
+
+    EXIT_LOG(%s, VOID_RET);
+}
+
+/*===========================================================================
+FUNCTION    loc_geofence_remove_area
+
+DESCRIPTION
+   This function removes a geofence
+
+DEPENDENCIES
+   NONE
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_geofence_remove_area(int32_t geofence_id)
+{
+    ENTRY_LOG();
+    loc_eng_geofence_remove(loc_afw_data, geofence_id);
+
+    EXIT_LOG(%s, VOID_RET);
+}
+
 /*===========================================================================
 FUNCTION    loc_ni_init
 
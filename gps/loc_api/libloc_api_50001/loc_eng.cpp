@@ -66,7 +66,11 @@
 #include <loc_eng_dmn_conn_handler.h>
 #include <loc_eng_msg.h>
 #include <loc_eng_nmea.h>
+#include <loc_eng_batching.h>
+#include <loc_eng_geofence.h>
+#include <loc_eng_resolver.h>
 #include <msg_q.h>
+#include <loc_thread_policy.h>
 #include <loc.h>
 #include "log_util.h"
 #include "platform_lib_includes.h"
@@ -111,6 +115,15 @@ static const loc_param_s_type gps_conf_table[] =
   {"XTRA_SERVER_2",                  &gps_conf.XTRA_SERVER_2,                  NULL, 's'},
   {"XTRA_SERVER_3",                  &gps_conf.XTRA_SERVER_3,                  NULL, 's'},
   {"USE_EMERGENCY_PDN_FOR_EMERGENCY_SUPL",  &gps_conf.USE_EMERGENCY_PDN_FOR_EMERGENCY_SUPL,          NULL, 'n'},
+  {"AP_BATCH_SIZE",                  &gps_conf.AP_BATCH_SIZE,                  NULL, 'n'},
+  {"AP_BATCH_AGE_MS",                &gps_conf.AP_BATCH_AGE_MS,                NULL, 'n'},
+  {"AP_BATCH_DISTANCE",              &gps_conf.AP_BATCH_DISTANCE,              NULL, 'n'},
+  {"AP_GEOFENCE",                    &gps_conf.AP_GEOFENCE,                    NULL, 'n'},
+  {"AP_GEOFENCE_MAX",                &gps_conf.AP_GEOFENCE_MAX,                NULL, 'n'},
+  {"AP_GEOFENCE_CELL_SIZE",          &gps_conf.AP_GEOFENCE_CELL_SIZE,          NULL, 'n'},
+  {"AP_GEOFENCE_HYSTERESIS",         &gps_conf.AP_GEOFENCE_HYSTERESIS,         NULL, 'n'},
+  {"AP_GEOFENCE_DWELL_MS",           &gps_conf.AP_GEOFENCE_DWELL_MS,           NULL, 'n'},
+  {"AGPS_DNS_CACHE_TTL",             &gps_conf.AGPS_DNS_CACHE_TTL,             NULL, 'n'},
 };
 
 static const loc_param_s_type sap_conf_table[] =
@@ -152,6 +165,18 @@ static void loc_default_parameters(void)
    gps_conf.XTRA_VERSION_CHECK=0;
    /*Use emergency PDN by default*/
    gps_conf.USE_EMERGENCY_PDN_FOR_EMERGENCY_SUPL = 1;
+   /*No batching on the AP by default*/
+   gps_conf.AP_BATCH_SIZE = 0;
+   gps_conf.AP_BATCH_AGE_MS = 60000;
+   gps_conf.AP_BATCH_DISTANCE = 0;
+   /*Geofences are handed to libgeofence.so by default*/
+   gps_conf.AP_GEOFENCE = 0;
+   gps_conf.AP_GEOFENCE_MAX = 100000;
+   gps_conf.AP_GEOFENCE_CELL_SIZE = 1000;
+   gps_conf.AP_GEOFENCE_HYSTERESIS = 20;
+   gps_conf.AP_GEOFENCE_DWELL_MS = 0;
+   /*Resolved AGPS server addresses are kept for 5 minutes*/
+   gps_conf.AGPS_DNS_CACHE_TTL = 300;
 
    /*Defaults for sap.conf*/
    sap_conf.GYRO_BIAS_RANDOM_WALK = 0;
@@ -209,6 +234,7 @@ static void deleteAidingData(loc_eng_data_s_type &logEng);
 static AgpsStateMachine*
 getAgpsStateMachine(loc_eng_data_s_type& logEng, AGpsExtType agpsType);
 static int dataCallCb(void *cb_data);
+static void loc_eng_config_changed(const char* conf_file_name, void* user_data);
 static void update_aiding_data_for_deletion(loc_eng_data_s_type& loc_eng_data) {
     if (loc_eng_data.engine_status != GPS_STATUS_ENGINE_ON &&
         loc_eng_data.aiding_data_for_deletion != 0)
@@ -392,33 +418,6 @@ struct LocEngInjectLocation : public LocMsg {
     }
 };
 
-//        case LOC_ENG_MSG_SET_SERVER_IPV4:
-struct LocEngSetServerIpv4 : public LocMsg {
-    LocEngAdapter* mAdapter;
-    const unsigned int mNlAddr;
-    const int mPort;
-    const LocServerType mServerType;
-    inline LocEngSetServerIpv4(LocEngAdapter* adapter,
-                               unsigned int ip,
-                               int port,
-                               LocServerType type) :
-        LocMsg(), mAdapter(adapter),
-        mNlAddr(ip), mPort(port), mServerType(type)
-    {
-        locallog();
-    }
-    inline virtual void proc() const {
-        mAdapter->setServer(mNlAddr, mPort, mServerType);
-    }
-    inline void locallog() const {
-        LOC_LOGV("LocEngSetServerIpv4 - addr: %x, port: %d, type: %s",
-                 mNlAddr, mPort, loc_get_server_type_name(mServerType));
-    }
-    inline virtual void log() const {
-        locallog();
-    }
-};
-
 //        case LOC_ENG_MSG_SET_SERVER_URL:
 struct LocEngSetServerUrl : public LocMsg {
     LocEngAdapter* mAdapter;
@@ -724,20 +723,22 @@ struct LocEngExtPowerConfig : public LocMsg {
 
 //        case LOC_ENG_MSG_REPORT_POSITION:
 LocEngReportPosition::LocEngReportPosition(LocAdapterBase* adapter,
-                                           UlpLocation &loc,
-                                           GpsLocationExtended &locExtended,
-                                           void* locExt,
-                                           enum loc_sess_status st,
-                                           LocPosTechMask technology) :
-    LocMsg(), mAdapter(adapter), mLocation(loc),
-    mLocationExtended(locExtended),
+                                           LocFix& fix) :
+    LocMsg(), mAdapter(adapter), mFix(fix.share()),
+    mLocation(fix.getLocation()),
+    mLocationExtended(fix.getLocationExtended()),
+    // the raw report behind getLocationExt() is gone once we return
     mLocationExt(((loc_eng_data_s_type*)
                   ((LocEngAdapter*)
-                   (mAdapter))->getOwner())->location_ext_parser(locExt)),
-    mStatus(st), mTechMask(technology)
+                   (mAdapter))->getOwner())->location_ext_parser(
+                                                fix.getLocationExt())),
+    mStatus(fix.getStatus()), mTechMask(fix.getTechMask())
 {
     locallog();
 }
+LocEngReportPosition::~LocEngReportPosition() {
+    mFix->drop();
+}
 void LocEngReportPosition::proc() const {
     LocEngAdapter* adapter = (LocEngAdapter*)mAdapter;
     loc_eng_data_s_type* locEng = (loc_eng_data_s_type*)adapter->getOwner();
@@ -771,12 +772,24 @@ void LocEngReportPosition::proc() const {
                         (gps_conf.ACCURACY_THRES != 0) &&
                         (mLocation.gpsLocation.accuracy >
                          gps_conf.ACCURACY_THRES)))) {
-                locEng->location_cb((UlpLocation*)&(mLocation),
-                                    (void*)mLocationExt);
+                // periodic fixes may be held back and reported in batches,
+                // if the ULP takes them that way
+                if (NULL == locEng->batcher ||
+                    GPS_POSITION_RECURRENCE_PERIODIC !=
+                    locEng->adapter->getPositionMode().recurrence ||
+                    !locEng->adapter->getUlpProxy()->canReportPositions() ||
+                    !locEng->batcher->add(mLocation)) {
+                    locEng->location_cb((UlpLocation*)&(mLocation),
+                                        (void*)mLocationExt);
+                }
                 reported = true;
             }
         }
 
+        if (NULL != locEng->geofence && LOC_SESS_SUCCESS == mStatus) {
+            locEng->geofence->onPosition(mLocation.gpsLocation);
+        }
+
         // if we have reported this fix
         if (reported &&
             // and if this is a singleshot
@@ -804,15 +817,7 @@ void LocEngReportPosition::proc() const {
             loc_eng_nmea_generate_pos(locEng, mLocation, mLocationExtended,
                                       generate_nmea);
         }
-
-        // Free the allocated memory for rawData
-        UlpLocation* gp = (UlpLocation*)&(mLocation);
-        if (gp != NULL && gp->rawData != NULL)
-        {
-            delete (char*)gp->rawData;
-            gp->rawData = NULL;
-            gp->rawDataSize = 0;
-        }
+        // rawData, if any, is freed with the last reference to mFix
     }
 }
 void LocEngReportPosition::locallog() const {
@@ -1082,6 +1087,25 @@ void LocEngSuplEsClosed::log() const {
     locallog();
 }
 
+//        LocEngSuplEsRetry
+LocEngSuplEsRetry::LocEngSuplEsRetry(void* locEng) :
+    LocMsg(), mLocEng(locEng) {
+    locallog();
+}
+void LocEngSuplEsRetry::proc() const {
+    loc_eng_data_s_type* locEng = (loc_eng_data_s_type*)mLocEng;
+    if (locEng->ds_nif) {
+        DSStateMachine* sm = (DSStateMachine*)locEng->ds_nif;
+        sm->onRsrcRetry();
+    }
+}
+void LocEngSuplEsRetry::locallog() const {
+    LOC_LOGV("LocEngSuplEsRetry");
+}
+void LocEngSuplEsRetry::log() const {
+    locallog();
+}
+
 
 //        case LOC_ENG_MSG_REQUEST_SUPL_ES:
 LocEngRequestSuplEs::LocEngRequestSuplEs(void* locEng, int id) :
@@ -1389,6 +1413,8 @@ struct LocEngInit : public LocMsg {
         loc_eng_reinit(*mLocEng);
         // set the capabilities
         mLocEng->adapter->sendMsg(new LocEngSetCapabilities(mLocEng));
+        // where the threads started so far ended up
+        loc_thread_policy_report();
     }
     inline void locallog() const
     {
@@ -1771,9 +1797,19 @@ int loc_eng_init(loc_eng_data_s_type &loc_eng_data, LocCallbacks* callbacks,
         new LocEngAdapter(event, &loc_eng_data, context,
                           (LocThread::tCreate)callbacks->create_thread_cb);
 
+    if (gps_conf.AP_BATCH_SIZE > 0) {
+        loc_eng_data.batcher =
+            new LocEngBatcher(loc_eng_data.adapter, gps_conf.AP_BATCH_SIZE,
+                              gps_conf.AP_BATCH_AGE_MS,
+                              gps_conf.AP_BATCH_DISTANCE);
+    }
+
     LOC_LOGD("loc_eng_init created client, id = %p\n",
              loc_eng_data.adapter);
     loc_eng_data.adapter->sendMsg(new LocEngInit(&loc_eng_data));
+    // changes to gps.conf are applied on the engine thread from now on
+    loc_cfg_register_change_cb(GPS_CONF_FILE, loc_eng_config_changed,
+                               &loc_eng_data);
 
     EXIT_LOG(%d, ret_val);
     return ret_val;
@@ -1980,6 +2016,11 @@ static int loc_eng_stop_handler(loc_eng_data_s_type &loc_eng_data)
        loc_eng_data.adapter->setInSession(FALSE);
    }
 
+   // fixes held back by the batcher are not to outlive the session
+   if (NULL != loc_eng_data.batcher) {
+       loc_eng_data.batcher->flush();
+   }
+
     EXIT_LOG(%d, ret_val);
     return ret_val;
 }
@@ -2461,49 +2502,6 @@ int loc_eng_agps_open_failed(loc_eng_data_s_type &loc_eng_data, AGpsExtType agps
     return 0;
 }
 
-/*===========================================================================
-
-FUNCTION resolve_in_addr
-
-DESCRIPTION
-   Translates a hostname to in_addr struct
-
-DEPENDENCIES
-   n/a
-
-RETURN VALUE
-   TRUE if successful
-
-SIDE EFFECTS
-   n/a
-
-===========================================================================*/
-static boolean resolve_in_addr(const char *host_addr, struct in_addr *in_addr_ptr)
-{
-    ENTRY_LOG();
-    boolean ret_val = TRUE;
-
-    struct hostent             *hp;
-    hp = gethostbyname(host_addr);
-    if (hp != NULL) /* DNS OK */
-    {
-        memcpy(in_addr_ptr, hp->h_addr_list[0], hp->h_length);
-    }
-    else
-    {
-        /* Try IP representation */
-        if (inet_aton(host_addr, in_addr_ptr) == 0)
-        {
-            /* IP not valid */
-            LOC_LOGE("DNS query on '%s' failed\n", host_addr);
-            ret_val = FALSE;
-        }
-    }
-
-    EXIT_LOG(%s, loc_logger_boolStr[ret_val!=0]);
-    return ret_val;
-}
-
 /*===========================================================================
 FUNCTION    loc_eng_set_server
 
@@ -2545,14 +2543,14 @@ static int loc_eng_set_server(loc_eng_data_s_type &loc_eng_data,
     } else if (LOC_AGPS_CDMA_PDE_SERVER == type ||
                LOC_AGPS_CUSTOM_PDE_SERVER == type ||
                LOC_AGPS_MPC_SERVER == type) {
-        struct in_addr addr;
-        if (!resolve_in_addr(hostname, &addr))
-        {
-            LOC_LOGE("loc_eng_set_server, hostname %s cannot be resolved.\n", hostname);
+        // resolved off this thread, the address is set once known
+        LocEngResolver* resolver = LocEngResolver::getInstance();
+        resolver->setTtl(gps_conf.AGPS_DNS_CACHE_TTL);
+        if (hostname == NULL) {
+            LOC_LOGE("loc_eng_set_server, no hostname for type %d.\n", type);
             ret = -2;
-        } else {
-            unsigned int ip = htonl(addr.s_addr);
-            adapter->sendMsg(new LocEngSetServerIpv4(adapter, ip, port, type));
+        } else if (resolver->setServer(adapter, type, hostname, port) < 0) {
+            ret = -1;
         }
     } else {
         LOC_LOGE("loc_eng_set_server, type %d cannot be resolved.\n", type);
@@ -2885,6 +2883,69 @@ static int set_sched_policy(int tid, SchedPolicy policy)
 }
 #endif /* USE_GLIB */
 
+#define GPS_CONF_TABLE_SIZE (sizeof(gps_conf_table) / sizeof(gps_conf_table[0]))
+
+/* gps.conf as re-read on the thread that noticed the change, into a copy
+   of its own. proc() then applies the items found in the file to gps_conf
+   on the engine thread, which is the only one that writes gps_conf. */
+struct LocEngConfigChanged : public LocMsg {
+    loc_gps_cfg_s_type mConf;
+    uint8_t mSet[GPS_CONF_TABLE_SIZE];
+    inline LocEngConfigChanged() :
+        LocMsg()
+    {
+        loc_param_s_type conf_table[GPS_CONF_TABLE_SIZE];
+        memset(&mConf, 0, sizeof(mConf));
+        memset(mSet, 0, sizeof(mSet));
+        for (size_t i = 0; i < GPS_CONF_TABLE_SIZE; i++) {
+            conf_table[i] = gps_conf_table[i];
+            conf_table[i].param_ptr = (char*)&mConf + offset(i);
+            conf_table[i].param_set = &mSet[i];
+        }
+        UTIL_READ_CONF(GPS_CONF_FILE, conf_table);
+        locallog();
+    }
+    static inline size_t offset(size_t i) {
+        return (char*)gps_conf_table[i].param_ptr - (char*)&gps_conf;
+    }
+    inline virtual void proc() const {
+        for (size_t i = 0; i < GPS_CONF_TABLE_SIZE; i++) {
+            if (!mSet[i]) {
+                continue;
+            }
+            const char* from = (const char*)&mConf + offset(i);
+            void* to = gps_conf_table[i].param_ptr;
+            switch (gps_conf_table[i].param_type) {
+            case 's':
+                strlcpy((char*)to, from, LOC_MAX_PARAM_STRING + 1);
+                break;
+            case 'n':
+                *(int*)to = *(const int*)from;
+                break;
+            case 'f':
+                *(double*)to = *(const double*)from;
+                break;
+            }
+        }
+    }
+    inline void locallog() const {
+        LOC_LOGV("LocEngConfigChanged");
+    }
+    inline virtual void log() const {
+        locallog();
+    }
+};
+
+/* Re-reads gps.conf after it has been changed on disk. Defaults are not
+   restored, a removed item keeps its last value. Items that only take
+   effect at init, e.g. the AGPS servers, still need a restart. */
+static void loc_eng_config_changed(const char* conf_file_name, void* user_data)
+{
+    loc_eng_data_s_type* loc_eng_data_p = (loc_eng_data_s_type*)user_data;
+    LOC_LOGI("%s: re-reading %s", __FUNCTION__, conf_file_name);
+    loc_eng_data_p->adapter->sendMsg(new LocEngConfigChanged());
+}
+
 /*===========================================================================
 FUNCTION    loc_eng_read_config
 
@@ -80,6 +80,9 @@ enum loc_mute_session_e_type {
    LOC_MUTE_SESS_IN_SESSION
 };
 
+class LocEngBatcher;
+class LocEngGeofence;
+
 // Module data
 typedef struct loc_eng_data_s
 {
@@ -137,6 +140,11 @@ typedef struct loc_eng_data_s
 
     loc_ext_parser location_ext_parser;
     loc_ext_parser sv_ext_parser;
+
+    // AP side batching of periodic fixes, NULL if not configured
+    LocEngBatcher* batcher;
+    // AP side geofencing, NULL until the geofence interface is initialized
+    LocEngGeofence* geofence;
 } loc_eng_data_s_type;
 
 /* GPS.conf support */
@@ -160,6 +168,15 @@ typedef struct loc_gps_cfg_s
     uint32_t       GPS_LOCK;
     uint32_t       A_GLONASS_POS_PROTOCOL_SELECT;
     uint32_t       AGPS_CERT_WRITABLE_MASK;
+    uint32_t       AP_BATCH_SIZE;
+    uint32_t       AP_BATCH_AGE_MS;
+    uint32_t       AP_BATCH_DISTANCE;
+    uint32_t       AP_GEOFENCE;
+    uint32_t       AP_GEOFENCE_MAX;
+    uint32_t       AP_GEOFENCE_CELL_SIZE;
+    uint32_t       AP_GEOFENCE_HYSTERESIS;
+    uint32_t       AP_GEOFENCE_DWELL_MS;
+    uint32_t       AGPS_DNS_CACHE_TTL;
 } loc_gps_cfg_s_type;
 
 /* NOTE: the implementaiton of the parser casts number
@@ -263,6 +280,18 @@ int loc_eng_gps_measurement_init(loc_eng_data_s_type &loc_eng_data,
                                  GpsMeasurementCallbacks* callbacks);
 void loc_eng_gps_measurement_close(loc_eng_data_s_type &loc_eng_data);
 
+//loc_eng_geofence functions
+void loc_eng_geofence_init(loc_eng_data_s_type &loc_eng_data,
+                           GpsGeofenceCallbacks* callbacks);
+void loc_eng_geofence_add(loc_eng_data_s_type &loc_eng_data, int32_t id,
+                          double latitude, double longitude, double radius,
+                          int last_transition, int monitor_transitions,
+                          int notification_responsiveness_ms);
+void loc_eng_geofence_remove(loc_eng_data_s_type &loc_eng_data, int32_t id);
+void loc_eng_geofence_pause(loc_eng_data_s_type &loc_eng_data, int32_t id);
+void loc_eng_geofence_resume(loc_eng_data_s_type &loc_eng_data, int32_t id,
+                             int monitor_transitions);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -849,6 +849,34 @@ void DSStateMachine :: retryCallback(void)
     return;
 }
 
+//The data call could not be started for a reason that may go away;
+//go back to the released state and request it again after a delay,
+//as when opening the call fails with LOC_API_ADAPTER_ERR_ENGINE_BUSY
+void DSStateMachine :: onRsrcRetry(void)
+{
+    LOC_LOGD("Enter DSStateMachine :: onRsrcRetry\n");
+    if(mStatePtr != mStatePtr->mPendingState) {
+        LOC_LOGW("DSStateMachine :: onRsrcRetry - not pending in %s\n",
+                 mStatePtr->whoami());
+        return;
+    }
+    incRetries();
+    if(mRetries > MAX_START_DATA_CALL_RETRIES) {
+        LOC_LOGE(" Failed to start Data call. Fallback to normal ATL SUPL\n");
+        onRsrcEvent(RSRC_DENIED);
+    }
+    else if(loc_timer_start(DATA_CALL_RETRY_DELAY_MSEC, delay_callback, (void *)this)) {
+        LOC_LOGE("Error: Could not start delay thread\n");
+        onRsrcEvent(RSRC_DENIED);
+    }
+    else {
+        //The retry opens a new handle, this one is done with
+        mLocAdapter->closeDataCall();
+        mStatePtr = mStatePtr->mReleasedState;
+    }
+    LOC_LOGD("Exit DSStateMachine :: onRsrcRetry; state %s\n", mStatePtr->whoami());
+}
+
 int DSStateMachine :: sendRsrcRequest(AGpsStatusValue action) const
 {
     DSSubscriber* s = NULL;
@@ -954,6 +982,9 @@ void DSStateMachine :: informStatus(AgpsRsrcStatus status, int ID) const
         mLocAdapter->closeDataCall();
         break;
     case RSRC_DENIED:
+        //The call failed before it was granted, but its client handle
+        //may have been opened already; no RSRC_RELEASED will close it
+        mLocAdapter->closeDataCall();
         ((DSStateMachine *)this)->mRetries = 0;
         mLocAdapter->requestATL(ID, AGPS_TYPE_SUPL);
         break;
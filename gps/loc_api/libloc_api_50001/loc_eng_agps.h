@@ -259,6 +259,7 @@ public:
     int sendRsrcRequest(AGpsStatusValue action) const;
     void onRsrcEvent(AgpsRsrcStatus event);
     void retryCallback();
+    void onRsrcRetry();
     void informStatus(AgpsRsrcStatus status, int ID) const;
     inline void incRetries() {mRetries++;}
     inline virtual char *whoami() {return (char*)"DSStateMachine";}
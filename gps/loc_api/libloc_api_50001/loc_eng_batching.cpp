@@ -0,0 +1,257 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDDEBUG 0
+#define LOG_TAG "LocSvc_eng"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fused_location_extended.h>
+#include <loc_eng_batching.h>
+#include <LocEngAdapter.h>
+#include <LocTimer.h>
+#include "log_util.h"
+#include "platform_lib_includes.h"
+
+using namespace loc_core;
+
+#define ALT_NONE        INT16_MIN
+#define ACCURACY_NONE   0xFFFF
+#define UINT8_NONE      0xFF
+
+#define LAT_LON_SCALE   1e7
+#define ALT_SCALE       10.0
+#define TIME_UNIT_MS    10
+#define ACCURACY_SCALE  10.0
+#define SPEED_SCALE     4.0
+#define BEARING_SCALE   (255.0 / 360.0)
+#define EARTH_RADIUS_M  6371000.0
+
+// expires on the MsgTask thread, with the rest of the batcher
+class LocEngBatchTimer : public LocTimer {
+    LocEngBatcher* mBatcher;
+public:
+    uint32_t mBatchId;
+    inline LocEngBatchTimer(LocEngAdapter* adapter, LocEngBatcher* batcher) :
+        LocTimer(adapter->getMsgTask()), mBatcher(batcher), mBatchId(0) {}
+    inline virtual void timeOutCallback() {
+        mBatcher->onAgeTimeout(mBatchId);
+    }
+};
+
+static inline uint16_t quantizeU16(double value, double scale, uint16_t max)
+{
+    double q = value * scale + 0.5;
+    return (q < 0) ? 0 : (q >= max) ? max : (uint16_t)q;
+}
+
+static inline uint8_t quantizeU8(double value, double scale, uint8_t max)
+{
+    double q = value * scale + 0.5;
+    return (q < 0) ? 0 : (q >= max) ? max : (uint8_t)q;
+}
+
+// flat earth between two fixes, which are close to each other
+static double distanceMeters(int32_t lat1, int32_t lon1,
+                             int32_t lat2, int32_t lon2)
+{
+    double rad = M_PI / 180.0 / LAT_LON_SCALE;
+    double x = (lon2 - lon1) * rad * cos((lat1 + lat2) * 0.5 * rad);
+    double y = (lat2 - lat1) * rad;
+    return sqrt(x * x + y * y) * EARTH_RADIUS_M;
+}
+
+LocEngBatcher::LocEngBatcher(LocEngAdapter* adapter, uint32_t flushCount,
+                             uint32_t flushAgeMs, uint32_t flushDistanceM) :
+    mAdapter(adapter), mFlushCount(flushCount),
+    mFlushAgeMs(flushAgeMs), mFlushDistanceM(flushDistanceM),
+    mRecords(new Record[flushCount]),
+    mDecoded(new FlpExtLocation[flushCount]),
+    mTimer(new LocEngBatchTimer(adapter, this)),
+    mCount(0), mBatchId(0), mDistance(0),
+    mFirstLat(0), mFirstLon(0), mFirstAlt(0), mFirstTime(0),
+    mLastLat(0), mLastLon(0), mLastAlt(0), mLastTime(0)
+{
+    LOC_LOGD("%s: count %u age %u ms distance %u m", __func__,
+             mFlushCount, mFlushAgeMs, mFlushDistanceM);
+}
+
+LocEngBatcher::~LocEngBatcher()
+{
+    mTimer->stop();
+    delete mTimer;
+    delete[] mDecoded;
+    delete[] mRecords;
+}
+
+// false if the deltas to the latest fix do not fit a record
+bool LocEngBatcher::append(const UlpLocation& location)
+{
+    const GpsLocation& gpsLocation = location.gpsLocation;
+    int32_t lat = (int32_t)lround(gpsLocation.latitude * LAT_LON_SCALE);
+    int32_t lon = (int32_t)lround(gpsLocation.longitude * LAT_LON_SCALE);
+    int64_t time = (gpsLocation.timestamp + TIME_UNIT_MS / 2) / TIME_UNIT_MS;
+    bool hasAlt = (gpsLocation.flags & GPS_LOCATION_HAS_ALTITUDE);
+    int32_t alt = hasAlt ?
+        (int32_t)lround(gpsLocation.altitude * ALT_SCALE) : mLastAlt;
+
+    if (0 == mCount) {
+        mFirstLat = mLastLat = lat;
+        mFirstLon = mLastLon = lon;
+        mFirstAlt = mLastAlt = alt;
+        mFirstTime = mLastTime = time;
+        mDistance = 0;
+    } else {
+        int64_t dLat = (int64_t)lat - mLastLat;
+        int64_t dLon = (int64_t)lon - mLastLon;
+        int64_t dTime = time - mLastTime;
+        int64_t dAlt = (int64_t)alt - mLastAlt;
+        if (dLat != (int32_t)dLat || dLon != (int32_t)dLon ||
+            dTime < 0 || dTime > UINT16_MAX ||
+            dAlt <= ALT_NONE || dAlt > INT16_MAX) {
+            return false;
+        }
+    }
+
+    Record& record = mRecords[mCount++];
+    record.dLat = lat - mLastLat;
+    record.dLon = lon - mLastLon;
+    record.dTime = (uint16_t)(time - mLastTime);
+    record.dAlt = hasAlt ? (int16_t)(alt - mLastAlt) : ALT_NONE;
+    record.accuracy = (gpsLocation.flags & GPS_LOCATION_HAS_ACCURACY) ?
+        quantizeU16(gpsLocation.accuracy, ACCURACY_SCALE, ACCURACY_NONE - 1) :
+        ACCURACY_NONE;
+    record.speed = (gpsLocation.flags & GPS_LOCATION_HAS_SPEED) ?
+        quantizeU8(gpsLocation.speed, SPEED_SCALE, UINT8_NONE - 1) :
+        UINT8_NONE;
+    record.bearing = (gpsLocation.flags & GPS_LOCATION_HAS_BEARING) ?
+        quantizeU8(fmod(gpsLocation.bearing + 360.0, 360.0),
+                   BEARING_SCALE, UINT8_NONE - 1) :
+        UINT8_NONE;
+
+    mDistance += distanceMeters(mLastLat, mLastLon, lat, lon);
+    mLastLat = lat;
+    mLastLon = lon;
+    mLastAlt = alt;
+    mLastTime = time;
+    return true;
+}
+
+bool LocEngBatcher::add(const UlpLocation& location)
+{
+    if (!(location.gpsLocation.flags & GPS_LOCATION_HAS_LAT_LONG)) {
+        return false;
+    }
+
+    if (!append(location)) {
+        // too far from the last fix, this one starts a new batch
+        flush();
+        append(location);
+    }
+
+    if (1 == mCount && mFlushAgeMs) {
+        mTimer->mBatchId = mBatchId;
+        mTimer->start(mFlushAgeMs, true);
+    }
+
+    if (mCount >= mFlushCount ||
+        (mFlushAgeMs &&
+         (mLastTime - mFirstTime) * TIME_UNIT_MS >= mFlushAgeMs) ||
+        (mFlushDistanceM && mDistance >= mFlushDistanceM)) {
+        flush();
+    }
+    return true;
+}
+
+void LocEngBatcher::flush()
+{
+    if (mCount) {
+        mTimer->stop();
+        report(mCount);
+        mCount = 0;
+        mBatchId++;
+    }
+}
+
+void LocEngBatcher::onAgeTimeout(uint32_t batchId)
+{
+    if (batchId == mBatchId) {
+        LOC_LOGD("%s: %u fixes", __func__, mCount);
+        flush();
+    }
+}
+
+void LocEngBatcher::report(uint32_t count)
+{
+    int32_t lat = mFirstLat, lon = mFirstLon, alt = mFirstAlt;
+    int64_t time = mFirstTime;
+
+    memset(mDecoded, 0, sizeof(FlpExtLocation) * count);
+    for (uint32_t i = 0; i < count; i++) {
+        const Record& record = mRecords[i];
+        FlpExtLocation& location = mDecoded[i];
+
+        // the first record has all deltas 0 against the first fix
+        lat += record.dLat;
+        lon += record.dLon;
+        time += record.dTime;
+        location.size = sizeof(FlpExtLocation);
+        location.flags = GPS_LOCATION_HAS_LAT_LONG;
+        location.latitude = lat / LAT_LON_SCALE;
+        location.longitude = lon / LAT_LON_SCALE;
+        location.timestamp = time * TIME_UNIT_MS;
+        if (ALT_NONE != record.dAlt) {
+            alt += record.dAlt;
+            location.flags |= GPS_LOCATION_HAS_ALTITUDE;
+            location.altitude = alt / ALT_SCALE;
+        }
+        if (ACCURACY_NONE != record.accuracy) {
+            location.flags |= GPS_LOCATION_HAS_ACCURACY;
+            location.accuracy = record.accuracy / ACCURACY_SCALE;
+        }
+        if (UINT8_NONE != record.speed) {
+            location.flags |= GPS_LOCATION_HAS_SPEED;
+            location.speed = record.speed / SPEED_SCALE;
+        }
+        if (UINT8_NONE != record.bearing) {
+            location.flags |= GPS_LOCATION_HAS_BEARING;
+            location.bearing = record.bearing / BEARING_SCALE;
+        }
+    }
+
+    LOC_LOGD("%s: %u fixes over %u ms, %.0f m", __func__, count,
+             (uint32_t)((mLastTime - mFirstTime) * TIME_UNIT_MS), mDistance);
+
+    // fixes are only batched for a ULP which takes batches, and flushed
+    // to it before it is replaced
+    if (!mAdapter->getUlpProxy()->reportPositions(mDecoded, count)) {
+        LOC_LOGE("%s:%d]: ULP did not take %u fixes", __func__, __LINE__,
+                 count);
+    }
+}
@@ -0,0 +1,109 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef LOC_ENG_BATCHING_H
+#define LOC_ENG_BATCHING_H
+
+#include <stdint.h>
+#include <gps_extended.h>
+
+class LocEngAdapter;
+class LocEngBatchTimer;
+struct FlpExtLocation_s;
+
+// Holds the fixes of a periodic session on the AP side and hands them to
+// the framework in batches, through UlpProxyBase::reportPositions(), so
+// that a background tracking session costs one upcall per batch instead
+// of one per fix. A batch is flushed when it holds mFlushCount fixes,
+// when its oldest fix is mFlushAgeMs old, or when the path through its
+// fixes is mFlushDistanceM long, whichever comes first. Fixes are only
+// batched while the ULP says it takes batches, see
+// UlpProxyBase::canReportPositions(); otherwise they go up one at a time.
+//
+// Fixes are kept in a fixed array of 16 byte records, quantized and
+// delta encoded against the previous fix of the batch:
+//   lat / lon   1e-7 deg        (about 1 cm)
+//   altitude    0.1 m
+//   timestamp   10 ms
+//   accuracy    0.1 m           (saturates at 6553.4 m)
+//   speed       0.25 m/s        (saturates at 63.5 m/s)
+//   bearing     360/255 deg
+// A fix whose deltas do not fit a record closes the batch and starts the
+// next one.
+//
+// All methods are to be called from the MsgTask thread of the adapter,
+// which is also where the age timer expires.
+class LocEngBatcher {
+public:
+    struct Record {
+        int32_t  dLat;
+        int32_t  dLon;
+        uint16_t dTime;
+        int16_t  dAlt;          // ALT_NONE: no altitude
+        uint16_t accuracy;      // ACCURACY_NONE: no accuracy
+        uint8_t  speed;         // UINT8_NONE: no speed
+        uint8_t  bearing;       // UINT8_NONE: no bearing
+    };
+
+    LocEngBatcher(LocEngAdapter* adapter, uint32_t flushCount,
+                  uint32_t flushAgeMs, uint32_t flushDistanceM);
+    ~LocEngBatcher();
+
+    // false if the fix can't be batched and has to be reported right away
+    bool add(const UlpLocation& location);
+    // reports all batched fixes, if any
+    void flush();
+    // called on the MsgTask thread when the age timer of batch 'batchId'
+    // expired. A batch that has been flushed since is left alone.
+    void onAgeTimeout(uint32_t batchId);
+
+    inline uint32_t getCount() const { return mCount; }
+    inline uint32_t getCapacity() const { return mFlushCount; }
+
+private:
+    LocEngAdapter* mAdapter;
+    const uint32_t mFlushCount;
+    const uint32_t mFlushAgeMs;
+    const uint32_t mFlushDistanceM;
+    Record* mRecords;
+    struct FlpExtLocation_s* mDecoded;
+    LocEngBatchTimer* mTimer;
+    uint32_t mCount;
+    uint32_t mBatchId;
+    double mDistance;
+    // quantized values of the first and the latest fix of the batch
+    int32_t mFirstLat, mFirstLon, mFirstAlt;
+    int64_t mFirstTime;
+    int32_t mLastLat, mLastLon, mLastAlt;
+    int64_t mLastTime;
+
+    bool append(const UlpLocation& location);
+    void report(uint32_t count);
+};
+
+#endif // LOC_ENG_BATCHING_H
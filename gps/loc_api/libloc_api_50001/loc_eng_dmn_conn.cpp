@@ -29,17 +29,21 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <linux/stat.h>
 #include <fcntl.h>
 #include <linux/types.h>
 #include <unistd.h>
 #include <errno.h>
 #include <grp.h>
+#include <pthread.h>
 #include <sys/stat.h>
+#include <sys/epoll.h>
 
 #include "log_util.h"
 #include "platform_lib_includes.h"
 #include "loc_eng_dmn_conn_glue_msg.h"
+#include "loc_eng_dmn_conn_glue_sock.h"
 #include "loc_eng_dmn_conn_handler.h"
 #include "loc_eng_dmn_conn.h"
 #include "loc_eng_msg.h"
@@ -55,6 +59,35 @@ static const char * global_loc_api_resp_q_path = GPSONE_LOC_API_RESP_Q_PATH;
 static const char * global_quipc_ctrl_q_path = QUIPC_CTRL_Q_PATH;
 static const char * global_msapm_ctrl_q_path = MSAPM_CTRL_Q_PATH;
 static const char * global_msapu_ctrl_q_path = MSAPU_CTRL_Q_PATH;
+static const char * global_loc_api_sock_path = GPSONE_LOC_API_SOCK_PATH;
+
+/* The daemons may connect on the SOCK_SEQPACKET socket instead of using
+   the pipes. All channels, the request pipe included, are served by one
+   epoll loop; without epoll the server falls back to blocking on the
+   request pipe. Responses go back on the connection a sender last made
+   a request on, or on its pipe. */
+#define LOC_API_SERVER_MAX_CONN     8
+#define LOC_API_SERVER_MAX_SENDERS  (LOC_ENG_IF_REQUEST_SENDER_ID_UNKNOWN)
+#define LOC_API_SERVER_MSGBUF_SIZE  (sizeof(struct ctrl_msgbuf) + 256)
+
+enum {
+    LOC_API_SERVER_EV_PIPE = 0,
+    LOC_API_SERVER_EV_LISTEN,
+    LOC_API_SERVER_EV_CONN  /* + connection index */
+};
+
+static int loc_api_server_epollfd = -1;
+static int loc_api_server_sockfd = -1;
+static int loc_api_server_conn[LOC_API_SERVER_MAX_CONN];
+/* connection of each sender, guarded by loc_api_server_lock as responses
+   are sent from the AGPS state machine */
+static int loc_api_server_sender_conn[LOC_API_SERVER_MAX_SENDERS];
+static pthread_mutex_t loc_api_server_lock = PTHREAD_MUTEX_INITIALIZER;
+/* the one receive buffer, only used on the server thread */
+static union {
+    struct ctrl_msgbuf msg;
+    uint8_t bytes[LOC_API_SERVER_MSGBUF_SIZE];
+} loc_api_server_msgbuf;
 
 static int loc_api_server_proc_init(void *context)
 {
@@ -105,6 +138,43 @@ static int loc_api_server_proc_init(void *context)
     msapm_msgqid = loc_eng_dmn_conn_glue_msgget(global_msapm_ctrl_q_path , O_RDWR);
     msapu_msgqid = loc_eng_dmn_conn_glue_msgget(global_msapu_ctrl_q_path , O_RDWR);
 
+    for (int i = 0; i < LOC_API_SERVER_MAX_CONN; i++) {
+        loc_api_server_conn[i] = -1;
+    }
+    for (int i = 0; i < LOC_API_SERVER_MAX_SENDERS; i++) {
+        loc_api_server_sender_conn[i] = -1;
+    }
+
+    loc_api_server_epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (loc_api_server_epollfd >= 0) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u32 = LOC_API_SERVER_EV_PIPE;
+        if (epoll_ctl(loc_api_server_epollfd, EPOLL_CTL_ADD, loc_api_server_msgqid, &ev) < 0) {
+            LOC_LOGE("%s:%d] epoll on %s failed: %s, no epoll\n", __func__, __LINE__,
+                     global_loc_api_q_path, strerror(errno));
+            close(loc_api_server_epollfd);
+            loc_api_server_epollfd = -1;
+        }
+    }
+
+    if (loc_api_server_epollfd >= 0) {
+        loc_api_server_sockfd = loc_eng_dmn_conn_glue_sockget(global_loc_api_sock_path);
+        if (loc_api_server_sockfd >= 0) {
+            struct epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = EPOLLIN;
+            ev.data.u32 = LOC_API_SERVER_EV_LISTEN;
+            epoll_ctl(loc_api_server_epollfd, EPOLL_CTL_ADD, loc_api_server_sockfd, &ev);
+            if (gps_group != NULL &&
+                chown(global_loc_api_sock_path, -1, gps_group->gr_gid) != 0) {
+                LOC_LOGE("chown for socket failed, %s, gid = %d, error = %s\n",
+                         global_loc_api_sock_path, gps_group->gr_gid, strerror(errno));
+            }
+        }
+    }
+
     LOC_LOGD("%s:%d] loc_api_server_msgqid = %d\n", __func__, __LINE__, loc_api_server_msgqid);
     return 0;
 }
@@ -114,41 +184,47 @@ static int loc_api_server_proc_pre(void *context)
     return 0;
 }
 
-static int loc_api_server_proc(void *context)
+/* the part of ctrl_msgbuf a message of the given ctrl_type has to carry;
+   whatever is past the end of a shorter message is left over from the one
+   before it in the receive buffer */
+static int loc_api_server_msg_min_length(uint8_t ctrl_type)
 {
-    int length, sz;
-    int result = 0;
-    static int cnt = 0;
-    struct ctrl_msgbuf * p_cmsgbuf;
-    struct ctrl_msgbuf cmsg_resp;
-
-    sz = sizeof(struct ctrl_msgbuf) + 256;
-    p_cmsgbuf = (struct ctrl_msgbuf *) malloc(sz);
-
-    if (!p_cmsgbuf) {
-        LOC_LOGE("%s:%d] Out of memory\n", __func__, __LINE__);
-        return -1;
-    }
-
-    cnt ++;
-    LOC_LOGD("%s:%d] %d listening on %s...\n", __func__, __LINE__, cnt, (char *) context);
-    length = loc_eng_dmn_conn_glue_msgrcv(loc_api_server_msgqid, p_cmsgbuf, sz);
-    if (length <= 0) {
-        free(p_cmsgbuf);
-        LOC_LOGE("%s:%d] fail receiving msg from gpsone_daemon, retry later\n", __func__, __LINE__);
-        usleep(1000);
-        return -1;
+    switch(ctrl_type) {
+        case GPSONE_LOC_API_IF_REQUEST:
+        case GPSONE_LOC_API_IF_RELEASE:
+            return offsetof(struct ctrl_msgbuf, cmsg) + sizeof(struct ctrl_msg_if_request);
+        case GPSONE_UNBLOCK:
+            return offsetof(struct ctrl_msgbuf, cmsg) + sizeof(struct ctrl_msg_unblock);
+        default:
+            return offsetof(struct ctrl_msgbuf, cmsg);
     }
+}
 
+static void loc_api_server_dispatch(struct ctrl_msgbuf *p_cmsgbuf, int length, int conn)
+{
     LOC_LOGD("%s:%d] received ctrl_type = %d\n", __func__, __LINE__, p_cmsgbuf->ctrl_type);
+    if (length < loc_api_server_msg_min_length(p_cmsgbuf->ctrl_type)) {
+        LOC_LOGE("%s:%d] ctrl_type = %d, length = %d too short, dropped\n",
+                 __func__, __LINE__, p_cmsgbuf->ctrl_type, length);
+        return;
+    }
     switch(p_cmsgbuf->ctrl_type) {
         case GPSONE_LOC_API_IF_REQUEST:
-            result = loc_eng_dmn_conn_loc_api_server_if_request_handler(p_cmsgbuf, length);
-            break;
-
         case GPSONE_LOC_API_IF_RELEASE:
-            result = loc_eng_dmn_conn_loc_api_server_if_release_handler(p_cmsgbuf, length);
+        {
+            int sender = p_cmsgbuf->cmsg.cmsg_if_request.sender_id;
+            if (sender >= 0 && sender < LOC_API_SERVER_MAX_SENDERS) {
+                pthread_mutex_lock(&loc_api_server_lock);
+                loc_api_server_sender_conn[sender] = conn;
+                pthread_mutex_unlock(&loc_api_server_lock);
+            }
+            if (GPSONE_LOC_API_IF_REQUEST == p_cmsgbuf->ctrl_type) {
+                loc_eng_dmn_conn_loc_api_server_if_request_handler(p_cmsgbuf, length);
+            } else {
+                loc_eng_dmn_conn_loc_api_server_if_release_handler(p_cmsgbuf, length);
+            }
             break;
+        }
 
         case GPSONE_UNBLOCK:
             LOC_LOGD("%s:%d] GPSONE_UNBLOCK\n", __func__, __LINE__);
@@ -159,14 +235,123 @@ static int loc_api_server_proc(void *context)
                 __func__, __LINE__, p_cmsgbuf->ctrl_type);
             break;
     }
+}
+
+static void loc_api_server_close_conn(int index)
+{
+    int fd = loc_api_server_conn[index];
+
+    pthread_mutex_lock(&loc_api_server_lock);
+    for (int i = 0; i < LOC_API_SERVER_MAX_SENDERS; i++) {
+        if (loc_api_server_sender_conn[i] == fd) {
+            loc_api_server_sender_conn[i] = -1;
+        }
+    }
+    loc_api_server_conn[index] = -1;
+    pthread_mutex_unlock(&loc_api_server_lock);
+
+    epoll_ctl(loc_api_server_epollfd, EPOLL_CTL_DEL, fd, NULL);
+    loc_eng_dmn_conn_glue_sockremove(NULL, fd);
+}
+
+static void loc_api_server_accept(void)
+{
+    int fd = loc_eng_dmn_conn_glue_sockaccept(loc_api_server_sockfd);
+    if (fd < 0) {
+        return;
+    }
+
+    for (int i = 0; i < LOC_API_SERVER_MAX_CONN; i++) {
+        if (loc_api_server_conn[i] < 0) {
+            struct epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = EPOLLIN;
+            ev.data.u32 = LOC_API_SERVER_EV_CONN + i;
+            if (epoll_ctl(loc_api_server_epollfd, EPOLL_CTL_ADD, fd, &ev) == 0) {
+                loc_api_server_conn[i] = fd;
+                LOC_LOGD("%s:%d] connection %d, fd = %d\n", __func__, __LINE__, i, fd);
+                return;
+            }
+            break;
+        }
+    }
+    LOC_LOGE("%s:%d] can't serve connection fd = %d\n", __func__, __LINE__, fd);
+    loc_eng_dmn_conn_glue_sockremove(NULL, fd);
+}
+
+static int loc_api_server_proc(void *context)
+{
+    int length;
+    struct ctrl_msgbuf * p_cmsgbuf = &loc_api_server_msgbuf.msg;
+    const int sz = sizeof(loc_api_server_msgbuf);
+
+    if (loc_api_server_epollfd < 0) {
+        LOC_LOGD("%s:%d] listening on %s...\n", __func__, __LINE__, (char *) context);
+        length = loc_eng_dmn_conn_glue_msgrcv(loc_api_server_msgqid, p_cmsgbuf, sz);
+        if (length <= 0) {
+            LOC_LOGE("%s:%d] fail receiving msg from gpsone_daemon\n", __func__, __LINE__);
+            return -1;
+        }
+        loc_api_server_dispatch(p_cmsgbuf, length, -1);
+        return 0;
+    }
 
-    free(p_cmsgbuf);
+    struct epoll_event events[LOC_API_SERVER_MAX_CONN + 2];
+    int count = epoll_wait(loc_api_server_epollfd, events,
+                           sizeof(events) / sizeof(events[0]), -1);
+    if (count < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        LOC_LOGE("%s:%d] epoll_wait failed: %s\n", __func__, __LINE__, strerror(errno));
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        uint32_t tag = events[i].data.u32;
+        if (LOC_API_SERVER_EV_PIPE == tag) {
+            length = loc_eng_dmn_conn_glue_msgrcv(loc_api_server_msgqid, p_cmsgbuf, sz);
+            if (length <= 0) {
+                LOC_LOGE("%s:%d] fail receiving msg from gpsone_daemon\n", __func__, __LINE__);
+                continue;
+            }
+            loc_api_server_dispatch(p_cmsgbuf, length, -1);
+        } else if (LOC_API_SERVER_EV_LISTEN == tag) {
+            loc_api_server_accept();
+        } else {
+            int index = tag - LOC_API_SERVER_EV_CONN;
+            int fd = loc_api_server_conn[index];
+            length = loc_eng_dmn_conn_glue_sockread(fd, p_cmsgbuf, sz);
+            if (length >= (int) offsetof(struct ctrl_msgbuf, cmsg)) {
+                loc_api_server_dispatch(p_cmsgbuf, length, fd);
+            } else if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                continue;
+            } else {
+                LOC_LOGD("%s:%d] connection %d closed, length = %d\n",
+                         __func__, __LINE__, index, length);
+                loc_api_server_close_conn(index);
+            }
+        }
+    }
     return 0;
 }
 
 static int loc_api_server_proc_post(void *context)
 {
     LOC_LOGD("%s:%d]\n", __func__, __LINE__);
+    if (loc_api_server_epollfd >= 0) {
+        for (int i = 0; i < LOC_API_SERVER_MAX_CONN; i++) {
+            if (loc_api_server_conn[i] >= 0) {
+                loc_api_server_close_conn(i);
+            }
+        }
+        if (loc_api_server_sockfd >= 0) {
+            loc_eng_dmn_conn_glue_sockremove(global_loc_api_sock_path, loc_api_server_sockfd);
+            loc_api_server_sockfd = -1;
+        }
+        close(loc_api_server_epollfd);
+        loc_api_server_epollfd = -1;
+    }
     loc_eng_dmn_conn_glue_msgremove( global_loc_api_q_path, loc_api_server_msgqid);
     loc_eng_dmn_conn_glue_msgremove( global_loc_api_resp_q_path, loc_api_resp_msgqid);
     loc_eng_dmn_conn_glue_msgremove( global_quipc_ctrl_q_path, quipc_msgqid);
@@ -228,6 +413,26 @@ int loc_eng_dmn_conn_loc_api_server_data_conn(int sender_id, int status) {
   LOC_LOGD("%s:%d] quipc_msgqid = %d\n", __func__, __LINE__, quipc_msgqid);
   cmsgbuf.ctrl_type = GPSONE_LOC_API_RESPONSE;
   cmsgbuf.cmsg.cmsg_response.result = status;
+
+  if (sender_id >= 0 && sender_id < LOC_API_SERVER_MAX_SENDERS) {
+    pthread_mutex_lock(&loc_api_server_lock);
+    int conn = loc_api_server_sender_conn[sender_id];
+    int result = -1;
+    if (conn >= 0) {
+      cmsgbuf.msgsz = sizeof(struct ctrl_msgbuf);
+      result = loc_eng_dmn_conn_glue_sockwrite(conn, &cmsgbuf, sizeof(struct ctrl_msgbuf));
+    }
+    pthread_mutex_unlock(&loc_api_server_lock);
+    if (conn >= 0) {
+      if (result == (int) sizeof(struct ctrl_msgbuf)) {
+        LOC_LOGD("%s:%d] sender_id = %d, sent on connection\n", __func__, __LINE__, sender_id);
+        return 0;
+      }
+      LOC_LOGE("%s:%d] sender_id = %d, send failed: %s, using pipe\n",
+               __func__, __LINE__, sender_id, strerror(errno));
+    }
+  }
+
   switch (sender_id) {
     case LOC_ENG_IF_REQUEST_SENDER_ID_QUIPC: {
       LOC_LOGD("%s:%d] sender_id = LOC_ENG_IF_REQUEST_SENDER_ID_QUIPC", __func__, __LINE__);
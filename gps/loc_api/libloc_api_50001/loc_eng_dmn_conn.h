@@ -38,6 +38,9 @@
 #define QUIPC_CTRL_Q_PATH "/data/misc/location/gpsone_d/quipc_ctrl_q"
 #define MSAPM_CTRL_Q_PATH "/data/misc/location/gpsone_d/msapm_ctrl_q"
 #define MSAPU_CTRL_Q_PATH "/data/misc/location/gpsone_d/msapu_ctrl_q"
+#ifndef GPSONE_LOC_API_SOCK_PATH
+#define GPSONE_LOC_API_SOCK_PATH "/data/misc/location/gpsone_d/gpsone_loc_api_sock"
+#endif
 
 #else
 
@@ -46,6 +49,7 @@
 #define QUIPC_CTRL_Q_PATH "/tmp/quipc_ctrl_q"
 #define MSAPM_CTRL_Q_PATH "/tmp/msapm_ctrl_q"
 #define MSAPU_CTRL_Q_PATH "/tmp/msapu_ctrl_q"
+#define GPSONE_LOC_API_SOCK_PATH "/tmp/gpsone_loc_api_sock"
 
 #endif
 
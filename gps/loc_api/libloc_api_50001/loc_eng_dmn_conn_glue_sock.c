@@ -0,0 +1,223 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "loc_eng_dmn_conn_glue_sock.h"
+#include "log_util.h"
+#include "platform_lib_includes.h"
+
+/*===========================================================================
+FUNCTION    loc_eng_dmn_conn_glue_sockget
+
+DESCRIPTION
+   create a listening SOCK_SEQPACKET unix socket. Every packet on a
+   connection carries one message, so no framing is needed.
+
+   sock_path - socket name path
+
+DEPENDENCIES
+   None
+
+RETURN VALUE
+   fd of the socket or negative value for failure
+
+SIDE EFFECTS
+   A stale socket at sock_path is removed
+
+===========================================================================*/
+int loc_eng_dmn_conn_glue_sockget(const char * sock_path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(sock_path) >= sizeof(addr.sun_path)) {
+        LOC_LOGE("%s: path too long %s\n", __func__, sock_path);
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOC_LOGE("%s: socket failed: %s\n", __func__, strerror(errno));
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strlcpy(addr.sun_path, sock_path, sizeof(addr.sun_path));
+    unlink(sock_path);
+
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 ||
+        listen(fd, 4) < 0) {
+        LOC_LOGE("%s: %s failed: %s\n", __func__, sock_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    if (chmod(sock_path, 0660) != 0) {
+        LOC_LOGE("%s failed to change mode for %s, error = %s\n", __func__,
+                 sock_path, strerror(errno));
+    }
+    LOC_LOGD("fd = %d, %s\n", fd, sock_path);
+    return fd;
+}
+
+/*===========================================================================
+FUNCTION    loc_eng_dmn_conn_glue_sockaccept
+
+DESCRIPTION
+   accept a connection on a listening socket
+
+   listen_fd - fd of the listening socket
+
+DEPENDENCIES
+   None
+
+RETURN VALUE
+   fd of the connection or negative value for failure
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+int loc_eng_dmn_conn_glue_sockaccept(int listen_fd)
+{
+    int fd;
+
+    do {
+        fd = accept(listen_fd, NULL, NULL);
+    } while (fd < 0 && errno == EINTR);
+
+    if (fd < 0) {
+        LOC_LOGE("%s: accept failed: %s\n", __func__, strerror(errno));
+        return fd;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+/*===========================================================================
+FUNCTION    loc_eng_dmn_conn_glue_sockremove
+
+DESCRIPTION
+   close a socket, and remove its path for a listening one
+
+   sock_path - socket name path, NULL for a connection
+   fd - fd of the socket
+
+DEPENDENCIES
+   None
+
+RETURN VALUE
+   0: success
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+int loc_eng_dmn_conn_glue_sockremove(const char * sock_path, int fd)
+{
+    close(fd);
+    if (sock_path) unlink(sock_path);
+    LOC_LOGD("fd = %d, %s\n", fd, sock_path ? sock_path : "");
+    return 0;
+}
+
+/*===========================================================================
+FUNCTION    loc_eng_dmn_conn_glue_sockwrite
+
+DESCRIPTION
+   send one message on a connection, without blocking
+
+   fd - fd of the connection
+   buf - buffer for the data to write
+   sz - size of the data in buffer
+
+DEPENDENCIES
+   None
+
+RETURN VALUE
+   number of bytes written or negative value for failure
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+int loc_eng_dmn_conn_glue_sockwrite(int fd, const void * buf, size_t sz)
+{
+    int result;
+
+    do {
+        result = send(fd, buf, sz, MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (result < 0 && errno == EINTR);
+
+    return result;
+}
+
+/*===========================================================================
+FUNCTION    loc_eng_dmn_conn_glue_sockread
+
+DESCRIPTION
+   receive one message from a connection
+
+   fd - fd of the connection
+   buf - buffer to hold the message
+   sz - size of the buffer
+
+DEPENDENCIES
+   None
+
+RETURN VALUE
+   number of bytes received, 0 if the peer has closed the connection,
+   or negative value for failure, including a message larger than sz
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+int loc_eng_dmn_conn_glue_sockread(int fd, void * buf, size_t sz)
+{
+    int len;
+
+    do {
+        len = recv(fd, buf, sz, MSG_TRUNC | MSG_DONTWAIT);
+    } while (len < 0 && errno == EINTR);
+
+    if (len > (int) sz) {
+        LOC_LOGE("%s: message of %d bytes truncated to %d\n", __func__, len, (int) sz);
+        return -1;
+    }
+    return len;
+}
@@ -0,0 +1,762 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDDEBUG 0
+#define LOG_TAG "LocSvc_eng"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <loc_eng_geofence.h>
+#include <loc_eng.h>
+#include <LocEngAdapter.h>
+#include <LocTimer.h>
+#include <utils/SystemClock.h>
+#include "log_util.h"
+#include "platform_lib_includes.h"
+
+using namespace loc_core;
+
+#define METERS_PER_DEG          111320.0
+// half way around the earth, a fence this big covers all of it
+#define MAX_RADIUS_M            (METERS_PER_DEG * 180.0)
+// fences covering more cells than this go to the shared list
+#define MAX_CELLS_PER_AREA      64
+#define WIDE_CELL_KEY           INT64_MIN
+#define INITIAL_AREA_BUCKETS    64
+#define INITIAL_CELL_BUCKETS    256
+#define NO_TIME                 INT64_MAX
+
+#define ALL_TRANSITIONS (GPS_GEOFENCE_ENTERED | GPS_GEOFENCE_EXITED | \
+                         GPS_GEOFENCE_UNCERTAIN)
+
+enum {
+    AREA_UNKNOWN = 0,
+    AREA_OUTSIDE,
+    AREA_ENTERING,
+    AREA_INSIDE
+};
+
+struct LocEngGeofenceCell {
+    int64_t key;
+    LocEngGeofenceArea* area;
+    LocEngGeofenceCell* next;
+};
+
+struct LocEngGeofenceArea {
+    int32_t id;
+    uint8_t state;
+    bool paused;
+    int monitor;
+    int lastTransition;
+    int responsivenessMs;
+    double latitude;
+    double longitude;
+    double radius;
+    double metersPerDegLon;
+    // squared distances to enter / exit at, hysteresis included
+    double enter2;
+    double exit2;
+    int64_t dwellTime;
+    uint32_t stamp;
+    LocEngGeofenceArea* idNext;
+    // the mInside or mUnknown list this fence is on, if any
+    LocEngGeofenceArea** list;
+    LocEngGeofenceArea* prev;
+    LocEngGeofenceArea* next;
+    LocEngGeofenceCell* cells;
+    uint32_t cellCount;
+};
+
+// expires on the MsgTask thread of the adapter
+class LocEngGeofenceTimer : public LocTimer {
+    LocEngGeofence* mGeofence;
+public:
+    inline LocEngGeofenceTimer(LocEngAdapter* adapter,
+                               LocEngGeofence* geofence) :
+        LocTimer(adapter->getMsgTask()), mGeofence(geofence) {}
+    inline virtual void timeOutCallback() {
+        mGeofence->onTimer();
+    }
+};
+
+static inline uint32_t hashKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static inline int64_t cellKey(int32_t latIndex, int32_t lonIndex)
+{
+    return (int64_t)(((uint64_t)(uint32_t)latIndex << 32) |
+                     (uint32_t)lonIndex);
+}
+
+LocEngGeofence::LocEngGeofence(LocEngAdapter* adapter,
+                               const GpsGeofenceCallbacks& callbacks,
+                               uint32_t maxAreas, uint32_t cellSizeM,
+                               uint32_t hysteresisM, uint32_t dwellMs) :
+    mAdapter(adapter), mCallbacks(callbacks), mMaxAreas(maxAreas),
+    mCellSizeDeg((cellSizeM ? cellSizeM : 1000) / METERS_PER_DEG),
+    mHysteresisM(hysteresisM), mDwellMs(dwellMs),
+    mTimer(new LocEngGeofenceTimer(adapter, this)),
+    mAreas(new LocEngGeofenceArea*[INITIAL_AREA_BUCKETS]()),
+    mAreaMask(INITIAL_AREA_BUCKETS - 1), mCount(0),
+    mCells(new LocEngGeofenceCell*[INITIAL_CELL_BUCKETS]()),
+    mCellMask(INITIAL_CELL_BUCKETS - 1), mCellCount(0),
+    mInside(NULL), mUnknown(NULL),
+    mQueue(NULL), mQueued(0), mQueueSize(0), mFlushTime(NO_TIME),
+    mHasLocation(false), mStamp(0), mCandidates(0)
+{
+    memset(&mLastLocation, 0, sizeof(mLastLocation));
+    LOC_LOGD("%s: max %u cell %u m hysteresis %u m dwell %u ms", __func__,
+             mMaxAreas, cellSizeM, hysteresisM, mDwellMs);
+}
+
+LocEngGeofence::~LocEngGeofence()
+{
+    mTimer->stop();
+    delete mTimer;
+    for (uint32_t i = 0; i <= mAreaMask; i++) {
+        LocEngGeofenceArea* area = mAreas[i];
+        while (area) {
+            LocEngGeofenceArea* next = area->idNext;
+            delete[] area->cells;
+            delete area;
+            area = next;
+        }
+    }
+    delete[] mAreas;
+    delete[] mCells;
+    delete[] mQueue;
+}
+
+LocEngGeofenceArea* LocEngGeofence::find(int32_t id) const
+{
+    LocEngGeofenceArea* area = mAreas[hashKey((uint32_t)id) & mAreaMask];
+    while (area && area->id != id) {
+        area = area->idNext;
+    }
+    return area;
+}
+
+void LocEngGeofence::link(LocEngGeofenceArea* area,
+                          LocEngGeofenceArea** list)
+{
+    if (area->list != list) {
+        unlink(area);
+        area->list = list;
+        area->prev = NULL;
+        area->next = *list;
+        if (*list) {
+            (*list)->prev = area;
+        }
+        *list = area;
+    }
+}
+
+void LocEngGeofence::unlink(LocEngGeofenceArea* area)
+{
+    if (area->list) {
+        if (area->prev) {
+            area->prev->next = area->next;
+        } else {
+            *area->list = area->next;
+        }
+        if (area->next) {
+            area->next->prev = area->prev;
+        }
+        area->list = NULL;
+        area->prev = area->next = NULL;
+    }
+}
+
+void LocEngGeofence::growAreas()
+{
+    uint32_t mask = (mAreaMask << 1) | 1;
+    LocEngGeofenceArea** areas = new LocEngGeofenceArea*[mask + 1]();
+    for (uint32_t i = 0; i <= mAreaMask; i++) {
+        LocEngGeofenceArea* area = mAreas[i];
+        while (area) {
+            LocEngGeofenceArea* next = area->idNext;
+            uint32_t bucket = hashKey((uint32_t)area->id) & mask;
+            area->idNext = areas[bucket];
+            areas[bucket] = area;
+            area = next;
+        }
+    }
+    delete[] mAreas;
+    mAreas = areas;
+    mAreaMask = mask;
+}
+
+void LocEngGeofence::growCells()
+{
+    uint32_t mask = (mCellMask << 1) | 1;
+    LocEngGeofenceCell** cells = new LocEngGeofenceCell*[mask + 1]();
+    for (uint32_t i = 0; i <= mCellMask; i++) {
+        LocEngGeofenceCell* cell = mCells[i];
+        while (cell) {
+            LocEngGeofenceCell* next = cell->next;
+            uint32_t bucket = hashKey(cell->key) & mask;
+            cell->next = cells[bucket];
+            cells[bucket] = cell;
+            cell = next;
+        }
+    }
+    delete[] mCells;
+    mCells = cells;
+    mCellMask = mask;
+}
+
+void LocEngGeofence::index(LocEngGeofenceArea* area)
+{
+    double dLat = area->radius / METERS_PER_DEG;
+    double dLon = area->radius / area->metersPerDegLon;
+    // cell indices in double, they only fit an int32_t for small fences
+    double lat0 = floor((area->latitude - dLat) / mCellSizeDeg);
+    double lat1 = floor((area->latitude + dLat) / mCellSizeDeg);
+    double lon0 = floor((area->longitude - dLon) / mCellSizeDeg);
+    double lon1 = floor((area->longitude + dLon) / mCellSizeDeg);
+    double count = (lat1 - lat0 + 1) * (lon1 - lon0 + 1);
+
+    // too big, or across the antimeridian
+    bool wide = (!(count <= MAX_CELLS_PER_AREA) ||
+                 area->longitude - dLon < -180.0 ||
+                 area->longitude + dLon > 180.0);
+    area->cellCount = wide ? 1 : (uint32_t)count;
+    area->cells = new LocEngGeofenceCell[area->cellCount];
+
+    LocEngGeofenceCell* cell = area->cells;
+    if (wide) {
+        cell->key = WIDE_CELL_KEY;
+    } else {
+        for (int32_t lat = (int32_t)lat0; lat <= (int32_t)lat1; lat++) {
+            for (int32_t lon = (int32_t)lon0; lon <= (int32_t)lon1; lon++) {
+                (cell++)->key = cellKey(lat, lon);
+            }
+        }
+    }
+
+    mCellCount += area->cellCount;
+    while (mCellCount > mCellMask + 1) {
+        growCells();
+    }
+    for (uint32_t i = 0; i < area->cellCount; i++) {
+        cell = &area->cells[i];
+        uint32_t bucket = hashKey(cell->key) & mCellMask;
+        cell->area = area;
+        cell->next = mCells[bucket];
+        mCells[bucket] = cell;
+    }
+}
+
+void LocEngGeofence::unindex(LocEngGeofenceArea* area)
+{
+    for (uint32_t i = 0; i < area->cellCount; i++) {
+        LocEngGeofenceCell* cell = &area->cells[i];
+        LocEngGeofenceCell** prev = &mCells[hashKey(cell->key) & mCellMask];
+        while (*prev && *prev != cell) {
+            prev = &(*prev)->next;
+        }
+        if (*prev) {
+            *prev = cell->next;
+        }
+    }
+    mCellCount -= area->cellCount;
+    delete[] area->cells;
+    area->cells = NULL;
+    area->cellCount = 0;
+}
+
+int LocEngGeofence::add(int32_t id, double latitude, double longitude,
+                        double radiusM, int lastTransition,
+                        int monitorTransitions, int responsivenessMs)
+{
+    if (find(id)) {
+        return GPS_GEOFENCE_ERROR_ID_EXISTS;
+    }
+    if (mCount >= mMaxAreas) {
+        return GPS_GEOFENCE_ERROR_TOO_MANY_GEOFENCES;
+    }
+    if (monitorTransitions & ~ALL_TRANSITIONS) {
+        return GPS_GEOFENCE_ERROR_INVALID_TRANSITION;
+    }
+    if (!(radiusM > 0 && radiusM <= MAX_RADIUS_M) ||
+        !(fabs(latitude) <= 90.0) || !(fabs(longitude) <= 180.0)) {
+        return GPS_GEOFENCE_ERROR_GENERIC;
+    }
+
+    LocEngGeofenceArea* area = new LocEngGeofenceArea;
+    memset(area, 0, sizeof(*area));
+    area->id = id;
+    area->state = AREA_UNKNOWN;
+    area->monitor = monitorTransitions;
+    area->lastTransition = lastTransition;
+    area->responsivenessMs = responsivenessMs > 0 ? responsivenessMs : 0;
+    area->latitude = latitude;
+    area->longitude = longitude;
+    area->radius = radiusM;
+    area->metersPerDegLon = METERS_PER_DEG * cos(latitude * M_PI / 180.0);
+    if (area->metersPerDegLon < 1.0) {
+        area->metersPerDegLon = 1.0;
+    }
+    // no more than half the radius, or small fences can't be entered
+    double hysteresis = fmin(mHysteresisM, radiusM / 2);
+    area->enter2 = (radiusM - hysteresis) * (radiusM - hysteresis);
+    area->exit2 = (radiusM + hysteresis) * (radiusM + hysteresis);
+    area->stamp = mStamp;
+
+    index(area);
+    link(area, &mUnknown);
+    if (++mCount > mAreaMask + 1) {
+        growAreas();
+    }
+    uint32_t bucket = hashKey((uint32_t)id) & mAreaMask;
+    area->idNext = mAreas[bucket];
+    mAreas[bucket] = area;
+
+    return GPS_GEOFENCE_OPERATION_SUCCESS;
+}
+
+int LocEngGeofence::remove(int32_t id)
+{
+    LocEngGeofenceArea** prev = &mAreas[hashKey((uint32_t)id) & mAreaMask];
+    while (*prev && (*prev)->id != id) {
+        prev = &(*prev)->idNext;
+    }
+    LocEngGeofenceArea* area = *prev;
+    if (NULL == area) {
+        return GPS_GEOFENCE_ERROR_ID_UNKNOWN;
+    }
+    *prev = area->idNext;
+    unlink(area);
+    unindex(area);
+    delete area;
+    mCount--;
+
+    // nothing is to be reported on a fence that is gone
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < mQueued; i++) {
+        if (mQueue[i].id != id) {
+            mQueue[kept++] = mQueue[i];
+        }
+    }
+    mQueued = kept;
+    return GPS_GEOFENCE_OPERATION_SUCCESS;
+}
+
+int LocEngGeofence::pause(int32_t id)
+{
+    LocEngGeofenceArea* area = find(id);
+    if (NULL == area) {
+        return GPS_GEOFENCE_ERROR_ID_UNKNOWN;
+    }
+    area->paused = true;
+    area->state = AREA_UNKNOWN;
+    unlink(area);
+    return GPS_GEOFENCE_OPERATION_SUCCESS;
+}
+
+int LocEngGeofence::resume(int32_t id, int monitorTransitions)
+{
+    LocEngGeofenceArea* area = find(id);
+    if (NULL == area) {
+        return GPS_GEOFENCE_ERROR_ID_UNKNOWN;
+    }
+    if (monitorTransitions & ~ALL_TRANSITIONS) {
+        return GPS_GEOFENCE_ERROR_INVALID_TRANSITION;
+    }
+    area->paused = false;
+    area->monitor = monitorTransitions;
+    link(area, &mUnknown);
+    return GPS_GEOFENCE_OPERATION_SUCCESS;
+}
+
+void LocEngGeofence::queue(LocEngGeofenceArea* area, int32_t transition,
+                           const GpsLocation& location, int64_t now)
+{
+    if (transition == area->lastTransition) {
+        return;
+    }
+    area->lastTransition = transition;
+    if (!(area->monitor & transition)) {
+        return;
+    }
+
+    if (mQueued == mQueueSize) {
+        uint32_t size = mQueueSize ? mQueueSize * 2 : 16;
+        Transition* queue = new Transition[size];
+        memcpy(queue, mQueue, sizeof(Transition) * mQueued);
+        delete[] mQueue;
+        mQueue = queue;
+        mQueueSize = size;
+    }
+    Transition& entry = mQueue[mQueued++];
+    entry.id = area->id;
+    entry.transition = transition;
+    entry.location = location;
+
+    if (now + area->responsivenessMs < mFlushTime) {
+        mFlushTime = now + area->responsivenessMs;
+    }
+}
+
+void LocEngGeofence::evaluate(LocEngGeofenceArea* area,
+                              const GpsLocation& location, int64_t now)
+{
+    if (area->stamp == mStamp || area->paused) {
+        return;
+    }
+    area->stamp = mStamp;
+    mCandidates++;
+
+    double dy = (location.latitude - area->latitude) * METERS_PER_DEG;
+    double dx = (location.longitude - area->longitude) *
+        area->metersPerDegLon;
+    double d2 = dx * dx + dy * dy;
+    bool enter = false;
+
+    switch (area->state) {
+    case AREA_UNKNOWN:
+        // no hysteresis for the first state of a fence
+        if (d2 <= area->radius * area->radius) {
+            enter = true;
+        } else {
+            area->state = AREA_OUTSIDE;
+            unlink(area);
+            queue(area, GPS_GEOFENCE_EXITED, location, now);
+        }
+        break;
+    case AREA_OUTSIDE:
+        enter = (d2 <= area->enter2);
+        break;
+    case AREA_ENTERING:
+        if (d2 >= area->exit2) {
+            // left before the dwell time was up, never entered
+            area->state = AREA_OUTSIDE;
+            unlink(area);
+        } else if (now >= area->dwellTime) {
+            area->state = AREA_INSIDE;
+            queue(area, GPS_GEOFENCE_ENTERED, location, now);
+        }
+        break;
+    case AREA_INSIDE:
+        if (d2 >= area->exit2) {
+            area->state = AREA_OUTSIDE;
+            unlink(area);
+            queue(area, GPS_GEOFENCE_EXITED, location, now);
+        }
+        break;
+    }
+
+    if (enter) {
+        link(area, &mInside);
+        if (mDwellMs) {
+            area->state = AREA_ENTERING;
+            area->dwellTime = now + mDwellMs;
+        } else {
+            area->state = AREA_INSIDE;
+            queue(area, GPS_GEOFENCE_ENTERED, location, now);
+        }
+    }
+}
+
+void LocEngGeofence::onPosition(const GpsLocation& location)
+{
+    if (!(location.flags & GPS_LOCATION_HAS_LAT_LONG) ||
+        !(fabs(location.latitude) <= 90.0) ||
+        !(fabs(location.longitude) <= 180.0)) {
+        return;
+    }
+    int64_t now = ELAPSED_MILLIS_SINCE_BOOT_PLATFORM_LIB_ABSTRACTION;
+    mLastLocation = location;
+    mHasLocation = true;
+    mStamp++;
+    mCandidates = 0;
+
+    // evaluate() may move the fence off the list it is on
+    LocEngGeofenceArea* area = mUnknown;
+    while (area) {
+        LocEngGeofenceArea* next = area->next;
+        evaluate(area, location, now);
+        area = next;
+    }
+    area = mInside;
+    while (area) {
+        LocEngGeofenceArea* next = area->next;
+        evaluate(area, location, now);
+        area = next;
+    }
+
+    int64_t key = cellKey((int32_t)floor(location.latitude / mCellSizeDeg),
+                          (int32_t)floor(location.longitude / mCellSizeDeg));
+    LocEngGeofenceCell* cell = mCells[hashKey(key) & mCellMask];
+    for (; cell; cell = cell->next) {
+        if (cell->key == key) {
+            evaluate(cell->area, location, now);
+        }
+    }
+    cell = mCells[hashKey(WIDE_CELL_KEY) & mCellMask];
+    for (; cell; cell = cell->next) {
+        if (cell->key == WIDE_CELL_KEY) {
+            evaluate(cell->area, location, now);
+        }
+    }
+
+    if (mQueued && mFlushTime <= now) {
+        flush();
+    }
+    rearm(now);
+}
+
+void LocEngGeofence::onTimer()
+{
+    int64_t now = ELAPSED_MILLIS_SINCE_BOOT_PLATFORM_LIB_ABSTRACTION;
+
+    // dwell times that ran out without a fix to confirm them
+    if (mHasLocation) {
+        for (LocEngGeofenceArea* area = mInside; area; area = area->next) {
+            if (AREA_ENTERING == area->state && now >= area->dwellTime) {
+                area->state = AREA_INSIDE;
+                queue(area, GPS_GEOFENCE_ENTERED, mLastLocation, now);
+            }
+        }
+    }
+    if (mQueued && mFlushTime <= now) {
+        flush();
+    }
+    rearm(now);
+}
+
+void LocEngGeofence::rearm(int64_t now)
+{
+    int64_t next = mQueued ? mFlushTime : NO_TIME;
+    if (mDwellMs) {
+        for (LocEngGeofenceArea* area = mInside; area; area = area->next) {
+            if (AREA_ENTERING == area->state && area->dwellTime < next) {
+                next = area->dwellTime;
+            }
+        }
+    }
+
+    mTimer->stop();
+    if (NO_TIME != next) {
+        mTimer->start(next > now ? (uint32_t)(next - now) : 1, true);
+    }
+}
+
+void LocEngGeofence::flush()
+{
+    LOC_LOGD("%s: %u transitions", __func__, mQueued);
+    if (mCallbacks.geofence_transition_callback) {
+        for (uint32_t i = 0; i < mQueued; i++) {
+            Transition& entry = mQueue[i];
+            mCallbacks.geofence_transition_callback(entry.id,
+                                                    &entry.location,
+                                                    entry.transition,
+                                                    entry.location.timestamp);
+        }
+    }
+    mQueued = 0;
+    mFlushTime = NO_TIME;
+}
+
+/*===========================================================================
+  GpsGeofencingInterface glue. The calls come in on the framework's thread
+  and are handed to the MsgTask thread, where the engine lives.
+===========================================================================*/
+
+struct LocEngGeofenceInit : public LocMsg {
+    loc_eng_data_s_type* mLocEng;
+    const GpsGeofenceCallbacks mCallbacks;
+    inline LocEngGeofenceInit(loc_eng_data_s_type* locEng,
+                              const GpsGeofenceCallbacks& callbacks) :
+        LocMsg(), mLocEng(locEng), mCallbacks(callbacks) {}
+    inline virtual void proc() const {
+        if (NULL == mLocEng->geofence) {
+            mLocEng->geofence =
+                new LocEngGeofence(mLocEng->adapter, mCallbacks,
+                                   gps_conf.AP_GEOFENCE_MAX,
+                                   gps_conf.AP_GEOFENCE_CELL_SIZE,
+                                   gps_conf.AP_GEOFENCE_HYSTERESIS,
+                                   gps_conf.AP_GEOFENCE_DWELL_MS);
+        }
+        if (mCallbacks.geofence_status_callback) {
+            mCallbacks.geofence_status_callback(GPS_GEOFENCE_AVAILABLE, NULL);
+        }
+    }
+};
+
+struct LocEngGeofenceAdd : public LocMsg {
+    loc_eng_data_s_type* mLocEng;
+    const int32_t mId;
+    const double mLatitude;
+    const double mLongitude;
+    const double mRadius;
+    const int mLastTransition;
+    const int mMonitorTransitions;
+    const int mResponsivenessMs;
+    inline LocEngGeofenceAdd(loc_eng_data_s_type* locEng, int32_t id,
+                             double latitude, double longitude,
+                             double radius, int lastTransition,
+                             int monitorTransitions, int responsivenessMs) :
+        LocMsg(), mLocEng(locEng), mId(id), mLatitude(latitude),
+        mLongitude(longitude), mRadius(radius),
+        mLastTransition(lastTransition),
+        mMonitorTransitions(monitorTransitions),
+        mResponsivenessMs(responsivenessMs) {}
+    inline virtual void proc() const {
+        LocEngGeofence* geofence = mLocEng->geofence;
+        if (NULL == geofence) {
+            LOC_LOGE("LocEngGeofenceAdd: geofence not initialized");
+            return;
+        }
+        int status = geofence->add(mId, mLatitude, mLongitude, mRadius,
+                                   mLastTransition, mMonitorTransitions,
+                                   mResponsivenessMs);
+        if (geofence->getCallbacks().geofence_add_callback) {
+            geofence->getCallbacks().geofence_add_callback(mId, status);
+        }
+    }
+};
+
+// remove, pause and resume
+struct LocEngGeofenceUpdate : public LocMsg {
+    enum Op { REMOVE, PAUSE, RESUME };
+    loc_eng_data_s_type* mLocEng;
+    const Op mOp;
+    const int32_t mId;
+    const int mMonitorTransitions;
+    inline LocEngGeofenceUpdate(loc_eng_data_s_type* locEng, Op op,
+                                int32_t id, int monitorTransitions) :
+        LocMsg(), mLocEng(locEng), mOp(op), mId(id),
+        mMonitorTransitions(monitorTransitions) {}
+    inline virtual void proc() const {
+        LocEngGeofence* geofence = mLocEng->geofence;
+        if (NULL == geofence) {
+            LOC_LOGE("LocEngGeofenceUpdate: geofence not initialized");
+            return;
+        }
+        const GpsGeofenceCallbacks& callbacks = geofence->getCallbacks();
+        int status;
+        switch (mOp) {
+        case REMOVE:
+            status = geofence->remove(mId);
+            if (callbacks.geofence_remove_callback) {
+                callbacks.geofence_remove_callback(mId, status);
+            }
+            break;
+        case PAUSE:
+            status = geofence->pause(mId);
+            if (callbacks.geofence_pause_callback) {
+                callbacks.geofence_pause_callback(mId, status);
+            }
+            break;
+        case RESUME:
+            status = geofence->resume(mId, mMonitorTransitions);
+            if (callbacks.geofence_resume_callback) {
+                callbacks.geofence_resume_callback(mId, status);
+            }
+            break;
+        }
+    }
+};
+
+// geofence is only created on the MsgTask thread, adapter is enough here
+#define GEOFENCE_INIT_CHECK(loc_eng_data)                          \
+    if (NULL == (loc_eng_data).adapter) {                          \
+        LOC_LOGE("%s: instance not initialized", __func__);        \
+        EXIT_LOG(%s, VOID_RET);                                    \
+        return;                                                    \
+    }
+
+void loc_eng_geofence_init(loc_eng_data_s_type &loc_eng_data,
+                           GpsGeofenceCallbacks* callbacks)
+{
+    ENTRY_LOG_CALLFLOW();
+    if (NULL == loc_eng_data.adapter || NULL == callbacks) {
+        LOC_LOGE("%s: adapter %p callbacks %p", __func__,
+                 loc_eng_data.adapter, callbacks);
+    } else {
+        loc_eng_data.adapter->sendMsg(new LocEngGeofenceInit(&loc_eng_data,
+                                                             *callbacks));
+    }
+    EXIT_LOG(%s, VOID_RET);
+}
+
+void loc_eng_geofence_add(loc_eng_data_s_type &loc_eng_data, int32_t id,
+                          double latitude, double longitude, double radius,
+                          int last_transition, int monitor_transitions,
+                          int notification_responsiveness_ms)
+{
+    ENTRY_LOG_CALLFLOW();
+    GEOFENCE_INIT_CHECK(loc_eng_data);
+
+    loc_eng_data.adapter->sendMsg(
+        new LocEngGeofenceAdd(&loc_eng_data, id, latitude, longitude, radius,
+                              last_transition, monitor_transitions,
+                              notification_responsiveness_ms));
+    EXIT_LOG(%s, VOID_RET);
+}
+
+void loc_eng_geofence_remove(loc_eng_data_s_type &loc_eng_data, int32_t id)
+{
+    ENTRY_LOG_CALLFLOW();
+    GEOFENCE_INIT_CHECK(loc_eng_data);
+
+    loc_eng_data.adapter->sendMsg(
+        new LocEngGeofenceUpdate(&loc_eng_data, LocEngGeofenceUpdate::REMOVE,
+                                 id, 0));
+    EXIT_LOG(%s, VOID_RET);
+}
+
+void loc_eng_geofence_pause(loc_eng_data_s_type &loc_eng_data, int32_t id)
+{
+    ENTRY_LOG_CALLFLOW();
+    GEOFENCE_INIT_CHECK(loc_eng_data);
+
+    loc_eng_data.adapter->sendMsg(
+        new LocEngGeofenceUpdate(&loc_eng_data, LocEngGeofenceUpdate::PAUSE,
+                                 id, 0));
+    EXIT_LOG(%s, VOID_RET);
+}
+
+void loc_eng_geofence_resume(loc_eng_data_s_type &loc_eng_data, int32_t id,
+                             int monitor_transitions)
+{
+    ENTRY_LOG_CALLFLOW();
+    GEOFENCE_INIT_CHECK(loc_eng_data);
+
+    loc_eng_data.adapter->sendMsg(
+        new LocEngGeofenceUpdate(&loc_eng_data, LocEngGeofenceUpdate::RESUME,
+                                 id, monitor_transitions));
+    EXIT_LOG(%s, VOID_RET);
+}
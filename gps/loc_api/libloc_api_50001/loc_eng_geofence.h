@@ -0,0 +1,138 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef LOC_ENG_GEOFENCE_H
+#define LOC_ENG_GEOFENCE_H
+
+#include <stdint.h>
+#include <hardware/gps.h>
+
+class LocEngAdapter;
+class LocEngGeofenceTimer;
+struct LocEngGeofenceArea;
+struct LocEngGeofenceCell;
+
+// Circular geofences evaluated on the AP against the fixes that go
+// through LocEngReportPosition, for the GpsGeofencingInterface.
+//
+// Fences are indexed in a hashed grid of square cells, mCellSizeM on a
+// side; every fence is linked into each cell its bounding box touches.
+// A fix is only tested against the fences of its own cell, the fences it
+// is inside of and the fences that have yet to see their first fix, so
+// the cost of a fix does not grow with the number of fences registered.
+// Fences that would cover too many cells are kept in one shared list
+// and tested on every fix.
+//
+// A fence is entered once the fix is mHysteresisM inside its radius, and
+// exited once the fix is mHysteresisM outside of it. With a dwell time,
+// an entry is only reported after the fixes stayed inside for that long.
+// Transitions are queued and delivered together, as late as the
+// notification_responsiveness_ms of the queued fences allows.
+//
+// Not thread safe. Everything, including the timer expirations, runs on
+// the MsgTask thread of the adapter.
+class LocEngGeofence {
+public:
+    LocEngGeofence(LocEngAdapter* adapter,
+                   const GpsGeofenceCallbacks& callbacks,
+                   uint32_t maxAreas, uint32_t cellSizeM,
+                   uint32_t hysteresisM, uint32_t dwellMs);
+    ~LocEngGeofence();
+
+    // these return GPS_GEOFENCE_OPERATION_SUCCESS or GPS_GEOFENCE_ERROR_*
+    int add(int32_t id, double latitude, double longitude,
+            double radiusM, int lastTransition, int monitorTransitions,
+            int responsivenessMs);
+    int remove(int32_t id);
+    int pause(int32_t id);
+    int resume(int32_t id, int monitorTransitions);
+
+    void onPosition(const GpsLocation& location);
+    void onTimer();
+    // delivers all queued transitions now
+    void flush();
+
+    inline uint32_t getCount() const { return mCount; }
+    // number of fences tested against the latest fix
+    inline uint32_t getCandidates() const { return mCandidates; }
+    inline const GpsGeofenceCallbacks& getCallbacks() const {
+        return mCallbacks;
+    }
+
+private:
+    struct Transition {
+        int32_t id;
+        int32_t transition;
+        GpsLocation location;
+    };
+
+    LocEngAdapter* mAdapter;
+    const GpsGeofenceCallbacks mCallbacks;
+    const uint32_t mMaxAreas;
+    const double mCellSizeDeg;
+    const double mHysteresisM;
+    const uint32_t mDwellMs;
+    LocEngGeofenceTimer* mTimer;
+
+    // id -> fence
+    LocEngGeofenceArea** mAreas;
+    uint32_t mAreaMask;
+    uint32_t mCount;
+    // cell -> fences
+    LocEngGeofenceCell** mCells;
+    uint32_t mCellMask;
+    uint32_t mCellCount;
+    // fences that are inside or being entered, and fences without a state
+    LocEngGeofenceArea* mInside;
+    LocEngGeofenceArea* mUnknown;
+
+    Transition* mQueue;
+    uint32_t mQueued;
+    uint32_t mQueueSize;
+    int64_t mFlushTime;
+
+    GpsLocation mLastLocation;
+    bool mHasLocation;
+    uint32_t mStamp;
+    uint32_t mCandidates;
+
+    LocEngGeofenceArea* find(int32_t id) const;
+    void link(LocEngGeofenceArea* area, LocEngGeofenceArea** list);
+    void unlink(LocEngGeofenceArea* area);
+    void index(LocEngGeofenceArea* area);
+    void unindex(LocEngGeofenceArea* area);
+    void growAreas();
+    void growCells();
+    void evaluate(LocEngGeofenceArea* area, const GpsLocation& location,
+                  int64_t now);
+    void queue(LocEngGeofenceArea* area, int32_t transition,
+               const GpsLocation& location, int64_t now);
+    void rearm(int64_t now);
+};
+
+#endif // LOC_ENG_GEOFENCE_H
@@ -86,17 +86,15 @@ struct LocEngStopFix : public LocMsg {
 
 struct LocEngReportPosition : public LocMsg {
     LocAdapterBase* mAdapter;
-    const UlpLocation mLocation;
-    const GpsLocationExtended mLocationExtended;
+    LocFix* const mFix;
+    const UlpLocation& mLocation;
+    const GpsLocationExtended& mLocationExtended;
     const void* mLocationExt;
     const enum loc_sess_status mStatus;
     const LocPosTechMask mTechMask;
     LocEngReportPosition(LocAdapterBase* adapter,
-                         UlpLocation &loc,
-                         GpsLocationExtended &locExtended,
-                         void* locExt,
-                         enum loc_sess_status st,
-                         LocPosTechMask technology);
+                         LocFix& fix);
+    virtual ~LocEngReportPosition();
     virtual void proc() const;
     void locallog() const;
     virtual void log() const;
@@ -175,6 +173,14 @@ struct LocEngSuplEsClosed : public LocMsg {
     virtual void log() const;
 };
 
+struct LocEngSuplEsRetry : public LocMsg {
+    void* mLocEng;
+    LocEngSuplEsRetry(void* locEng);
+    virtual void proc() const;
+    void locallog() const;
+    virtual void log() const;
+};
+
 struct LocEngRequestSuplEs : public LocMsg {
     void* mLocEng;
     const int mID;
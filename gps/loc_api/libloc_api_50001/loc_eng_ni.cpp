@@ -40,6 +40,7 @@
 #include <unistd.h>
 #include <time.h>
 #include <MsgTask.h>
+#include <LocTimer.h>
 
 #include <loc_eng.h>
 
@@ -59,7 +60,11 @@ using namespace loc_core;
  *                             FUNCTION DECLARATIONS
  *
  *============================================================================*/
-static void* ni_thread_proc(void *args);
+static void loc_eng_ni_session_end(loc_eng_ni_session_s_type* pSession,
+                                   GpsUserResponseType resp);
+static void loc_eng_ni_respond_handler(loc_eng_ni_data_s_type* loc_eng_ni_data_p,
+                                       int notif_id,
+                                       GpsUserResponseType user_response);
 
 struct LocEngInformNiResponse : public LocMsg {
     LocEngAdapter* mAdapter;
@@ -97,6 +102,50 @@ struct LocEngInformNiResponse : public LocMsg {
     }
 };
 
+struct LocEngNiRespond : public LocMsg {
+    loc_eng_ni_data_s_type* mNiData;
+    const int mNotifId;
+    const GpsUserResponseType mResponse;
+    inline LocEngNiRespond(loc_eng_ni_data_s_type* niData, int notifId,
+                           GpsUserResponseType response) :
+        LocMsg(), mNiData(niData), mNotifId(notifId), mResponse(response)
+    {
+        locallog();
+    }
+    inline virtual void proc() const
+    {
+        loc_eng_ni_respond_handler(mNiData, mNotifId, mResponse);
+    }
+    inline void locallog() const
+    {
+        LOC_LOGV("LocEngNiRespond - notif_id: %d response: %s",
+                 mNotifId, loc_get_ni_response_name(mResponse));
+    }
+    inline virtual void log() const
+    {
+        locallog();
+    }
+};
+
+// One per NI request, expiring on the MsgTask thread, where the sessions
+// live.
+class LocEngNiTimer : public LocTimer {
+    loc_eng_ni_session_s_type* const mSession;
+    const int mReqID;
+public:
+    inline LocEngNiTimer(loc_eng_ni_session_s_type* session, int reqID) :
+        LocTimer(session->adapter->getMsgTask()), mSession(session), mReqID(reqID) {}
+    inline virtual void timeOutCallback()
+    {
+        // the session may have been answered, or replaced, since
+        if (mReqID == mSession->reqID && NULL != mSession->rawRequest) {
+            LOC_LOGD("NI request %d timed out, sending no response", mReqID);
+            // deletes this timer
+            loc_eng_ni_session_end(mSession, GPS_NI_RESPONSE_NORESP);
+        }
+    }
+};
+
 /*===========================================================================
 
 FUNCTION loc_eng_ni_request_handler
@@ -170,22 +219,16 @@ void loc_eng_ni_request_handler(loc_eng_data_s_type &loc_eng_data,
             LOC_LOGI("              extras: %s", notif->extras);
         }
 
-        /* For robustness, spawn a thread at this point to timeout to clear up the notification status, even though
+        /* For robustness, time out to clear up the notification status, even though
          * the OEM layer in java does not do so.
          **/
-        pSession->respTimeLeft = 5 + (notif->timeout != 0 ? notif->timeout : LOC_NI_NO_RESPONSE_TIME);
-        LOC_LOGI("Automatically sends 'no response' in %d seconds (to clear status)\n", pSession->respTimeLeft);
+        int respTimeLeft = 5 + (notif->timeout != 0 ? notif->timeout : LOC_NI_NO_RESPONSE_TIME);
+        LOC_LOGI("Automatically sends 'no response' in %d seconds (to clear status)\n", respTimeLeft);
 
-        int rc = 0;
-        rc = pthread_create(&pSession->thread, NULL, ni_thread_proc, pSession);
-        if (rc)
-        {
-            LOC_LOGE("Loc NI thread is not created.\n");
-        }
-        rc = pthread_detach(pSession->thread);
-        if (rc)
+        pSession->timer = new LocEngNiTimer(pSession, pSession->reqID);
+        if (!pSession->timer->start(respTimeLeft * 1000, true))
         {
-            LOC_LOGE("Loc NI thread is not detached.\n");
+            LOC_LOGE("Loc NI timer is not started.\n");
         }
 
         CALLBACK_LOG_CALLFLOW("ni_notify_cb - id", %d, notif->notification_id);
@@ -196,76 +239,40 @@ void loc_eng_ni_request_handler(loc_eng_data_s_type &loc_eng_data,
 
 /*===========================================================================
 
-FUNCTION ni_thread_proc
+FUNCTION loc_eng_ni_session_end
+
+DESCRIPTION
+   Stops the timeout of the session and sends resp to the modem, unless it
+   is GPS_NI_RESPONSE_IGNORE. Called on the MsgTask thread.
+
+RETURN VALUE
+   none
 
 ===========================================================================*/
-static void* ni_thread_proc(void *args)
+static void loc_eng_ni_session_end(loc_eng_ni_session_s_type* pSession,
+                                   GpsUserResponseType resp)
 {
     ENTRY_LOG();
 
-    loc_eng_ni_session_s_type* pSession = (loc_eng_ni_session_s_type*)args;
-    int rc = 0;          /* return code from pthread calls */
-
-    struct timeval present_time;
-    struct timespec expire_time;
-
-    LOC_LOGD("Starting Loc NI thread...\n");
-    pthread_mutex_lock(&pSession->tLock);
-    /* Calculate absolute expire time */
-    gettimeofday(&present_time, NULL);
-    expire_time.tv_sec  = present_time.tv_sec + pSession->respTimeLeft;
-    expire_time.tv_nsec = present_time.tv_usec * 1000;
-    LOC_LOGD("ni_thread_proc-Time out set for abs time %ld with delay %d sec\n",
-             (long) expire_time.tv_sec, pSession->respTimeLeft );
-
-    while (!pSession->respRecvd)
-    {
-        rc = pthread_cond_timedwait(&pSession->tCond,
-                                    &pSession->tLock,
-                                    &expire_time);
-        if (rc == ETIMEDOUT)
-        {
-            pSession->resp = GPS_NI_RESPONSE_NORESP;
-            LOC_LOGD("ni_thread_proc-Thread time out after valting for specified time. Ret Val %d\n",rc );
-            break;
-        }
-    }
-    LOC_LOGD("ni_thread_proc-Java layer has sent us a user response and return value from "
-             "pthread_cond_timedwait = %d\n",rc );
-    pSession->respRecvd = FALSE; /* Reset the user response flag for the next session*/
-
-    LOC_LOGD("pSession->resp is %d\n",pSession->resp);
-
-    // adding this check to support modem restart, in which case, we need the thread
-    // to exit without calling sending data. We made sure that rawRequest is NULL in
-    // loc_eng_ni_reset_on_engine_restart()
-    LocEngAdapter* adapter = pSession->adapter;
-    LocEngInformNiResponse *msg = NULL;
+    // deleting a timer also stops it
+    delete pSession->timer;
+    pSession->timer = NULL;
 
     if (NULL != pSession->rawRequest) {
-        if (pSession->resp != GPS_NI_RESPONSE_IGNORE) {
-            LOC_LOGD("pSession->resp != GPS_NI_RESPONSE_IGNORE \n");
-            msg = new LocEngInformNiResponse(adapter,
-                                             pSession->resp,
-                                             pSession->rawRequest);
+        if (resp != GPS_NI_RESPONSE_IGNORE) {
+            LOC_LOGD("pSession->resp is %d\n", resp);
+            pSession->adapter->sendMsg(new LocEngInformNiResponse(pSession->adapter,
+                                                                  resp,
+                                                                  pSession->rawRequest));
         } else {
             LOC_LOGD("this is the ignore reply for SUPL ES\n");
             free(pSession->rawRequest);
         }
         pSession->rawRequest = NULL;
     }
-    pthread_mutex_unlock(&pSession->tLock);
-
-    pSession->respTimeLeft = 0;
     pSession->reqID = 0;
 
-    if (NULL != msg) {
-        LOC_LOGD("ni_thread_proc: adapter->sendMsg(msg)\n");
-        adapter->sendMsg(msg);
-    }
-
     EXIT_LOG(%s, VOID_RET);
-    return NULL;
 }
 
 void loc_eng_ni_reset_on_engine_restart(loc_eng_data_s_type &loc_eng_data)
@@ -278,30 +285,10 @@ void loc_eng_ni_reset_on_engine_restart(loc_eng_data_s_type &loc_eng_data)
         return;
     }
 
-    // only if modem has requested but then died.
-    if (NULL != loc_eng_ni_data_p->sessionEs.rawRequest) {
-        free(loc_eng_ni_data_p->sessionEs.rawRequest);
-        loc_eng_ni_data_p->sessionEs.rawRequest = NULL;
-
-        pthread_mutex_lock(&loc_eng_ni_data_p->sessionEs.tLock);
-        // the goal is to wake up ni_thread_proc
-        // and let it exit.
-        loc_eng_ni_data_p->sessionEs.respRecvd = TRUE;
-        pthread_cond_signal(&loc_eng_ni_data_p->sessionEs.tCond);
-        pthread_mutex_unlock(&loc_eng_ni_data_p->sessionEs.tLock);
-    }
-
-    if (NULL != loc_eng_ni_data_p->session.rawRequest) {
-        free(loc_eng_ni_data_p->session.rawRequest);
-        loc_eng_ni_data_p->session.rawRequest = NULL;
-
-        pthread_mutex_lock(&loc_eng_ni_data_p->session.tLock);
-        // the goal is to wake up ni_thread_proc
-        // and let it exit.
-        loc_eng_ni_data_p->session.respRecvd = TRUE;
-        pthread_cond_signal(&loc_eng_ni_data_p->session.tCond);
-        pthread_mutex_unlock(&loc_eng_ni_data_p->session.tLock);
-    }
+    // only if modem has requested but then died, in which case no
+    // response is to be sent.
+    loc_eng_ni_session_end(&loc_eng_ni_data_p->sessionEs, GPS_NI_RESPONSE_IGNORE);
+    loc_eng_ni_session_end(&loc_eng_ni_data_p->session, GPS_NI_RESPONSE_IGNORE);
 
     EXIT_LOG(%s, VOID_RET);
 }
@@ -334,19 +321,13 @@ void loc_eng_ni_init(loc_eng_data_s_type &loc_eng_data, GpsNiExtCallbacks *callb
         EXIT_LOG(%s, "loc_eng_ni_init: already inited.");
     } else {
         loc_eng_ni_data_s_type* loc_eng_ni_data_p = &loc_eng_data.loc_eng_ni_data;
-        loc_eng_ni_data_p->sessionEs.respTimeLeft = 0;
-        loc_eng_ni_data_p->sessionEs.respRecvd = FALSE;
+        loc_eng_ni_data_p->sessionEs.timer = NULL;
         loc_eng_ni_data_p->sessionEs.rawRequest = NULL;
         loc_eng_ni_data_p->sessionEs.reqID = 0;
-        pthread_cond_init(&loc_eng_ni_data_p->sessionEs.tCond, NULL);
-        pthread_mutex_init(&loc_eng_ni_data_p->sessionEs.tLock, NULL);
 
-        loc_eng_ni_data_p->session.respTimeLeft = 0;
-        loc_eng_ni_data_p->session.respRecvd = FALSE;
+        loc_eng_ni_data_p->session.timer = NULL;
         loc_eng_ni_data_p->session.rawRequest = NULL;
         loc_eng_ni_data_p->session.reqID = 0;
-        pthread_cond_init(&loc_eng_ni_data_p->session.tCond, NULL);
-        pthread_mutex_init(&loc_eng_ni_data_p->session.tLock, NULL);
 
         loc_eng_data.ni_notify_cb = callbacks->notify_cb;
         EXIT_LOG(%s, VOID_RET);
@@ -357,7 +338,8 @@ void loc_eng_ni_init(loc_eng_data_s_type &loc_eng_data, GpsNiExtCallbacks *callb
 FUNCTION    loc_eng_ni_respond
 
 DESCRIPTION
-   This function receives user response from upper layer framework
+   This function receives user response from upper layer framework, and
+   hands it to the MsgTask thread, where the NI sessions are handled.
 
 DEPENDENCIES
    NONE
@@ -373,25 +355,49 @@ void loc_eng_ni_respond(loc_eng_data_s_type &loc_eng_data,
                         int notif_id, GpsUserResponseType user_response)
 {
     ENTRY_LOG_CALLFLOW();
-    loc_eng_ni_data_s_type* loc_eng_ni_data_p = &loc_eng_data.loc_eng_ni_data;
-    loc_eng_ni_session_s_type* pSession = NULL;
 
-    if (NULL == loc_eng_data.ni_notify_cb) {
+    if (NULL == loc_eng_data.ni_notify_cb || NULL == loc_eng_data.adapter) {
         EXIT_LOG(%s, "loc_eng_ni_init hasn't happened yet.");
         return;
     }
 
+    loc_eng_data.adapter->sendMsg(new LocEngNiRespond(&loc_eng_data.loc_eng_ni_data,
+                                                      notif_id, user_response));
+
+    EXIT_LOG(%s, VOID_RET);
+}
+
+/*===========================================================================
+FUNCTION    loc_eng_ni_respond_handler
+
+DESCRIPTION
+   Ends the session the user response is for, on the MsgTask thread.
+
+DEPENDENCIES
+   NONE
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_eng_ni_respond_handler(loc_eng_ni_data_s_type* loc_eng_ni_data_p,
+                                       int notif_id,
+                                       GpsUserResponseType user_response)
+{
+    ENTRY_LOG();
+    loc_eng_ni_session_s_type* pSession = NULL;
+
     if (notif_id == loc_eng_ni_data_p->sessionEs.reqID &&
         NULL != loc_eng_ni_data_p->sessionEs.rawRequest) {
         pSession = &loc_eng_ni_data_p->sessionEs;
         // ignore any SUPL NI non-Es session if a SUPL NI ES is accepted
         if (user_response == GPS_NI_RESPONSE_ACCEPT &&
             NULL != loc_eng_ni_data_p->session.rawRequest) {
-                pthread_mutex_lock(&loc_eng_ni_data_p->session.tLock);
-                loc_eng_ni_data_p->session.resp = GPS_NI_RESPONSE_IGNORE;
-                loc_eng_ni_data_p->session.respRecvd = TRUE;
-                pthread_cond_signal(&loc_eng_ni_data_p->session.tCond);
-                pthread_mutex_unlock(&loc_eng_ni_data_p->session.tLock);
+            loc_eng_ni_session_end(&loc_eng_ni_data_p->session,
+                                   GPS_NI_RESPONSE_IGNORE);
         }
     } else if (notif_id == loc_eng_ni_data_p->session.reqID &&
         NULL != loc_eng_ni_data_p->session.rawRequest) {
@@ -400,11 +406,7 @@ void loc_eng_ni_respond(loc_eng_data_s_type &loc_eng_data,
 
     if (pSession) {
         LOC_LOGI("loc_eng_ni_respond: send user response %d for notif %d", user_response, notif_id);
-        pthread_mutex_lock(&pSession->tLock);
-        pSession->resp = user_response;
-        pSession->respRecvd = TRUE;
-        pthread_cond_signal(&pSession->tCond);
-        pthread_mutex_unlock(&pSession->tLock);
+        loc_eng_ni_session_end(pSession, user_response);
     }
     else {
         LOC_LOGE("loc_eng_ni_respond: notif_id %d not an active session", notif_id);
@@ -0,0 +1,305 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDDEBUG 0
+#define LOG_TAG "LocSvc_eng"
+
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <loc_eng_resolver.h>
+#include <loc_eng.h>
+#include <LocEngAdapter.h>
+#include <MsgTask.h>
+#include "log_util.h"
+#include "platform_lib_includes.h"
+
+using namespace loc_core;
+
+#define DEFAULT_TTL_SEC 300
+
+static int64_t nowMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+//        case LOC_ENG_MSG_SET_SERVER_IPV4 / IPV6:
+struct LocEngSetServerAddr : public LocMsg {
+    LocEngResolver* mResolver;
+    LocEngAdapter* mAdapter;
+    const LocEngResolver::Address mAddress;
+    const int mPort;
+    const LocServerType mServerType;
+    const uint32_t mGeneration;
+    inline LocEngSetServerAddr(LocEngResolver* resolver,
+                               LocEngAdapter* adapter,
+                               const LocEngResolver::Address& address,
+                               int port,
+                               LocServerType type,
+                               uint32_t generation) :
+        LocMsg(), mResolver(resolver), mAdapter(adapter),
+        mAddress(address), mPort(port), mServerType(type),
+        mGeneration(generation)
+    {
+        locallog();
+    }
+    inline virtual void proc() const {
+        if (!mResolver->apply(mServerType, mGeneration)) {
+            LOC_LOGD("LocEngSetServerAddr - type: %s, superseded",
+                     loc_get_server_type_name(mServerType));
+        } else if (mAddress.ipv6) {
+            mAdapter->setServerIpv6(mAddress.ipv6Addr, mPort, mServerType);
+        } else {
+            mAdapter->setServer(mAddress.ipv4, mPort, mServerType);
+        }
+    }
+    inline void locallog() const {
+        if (mAddress.ipv6) {
+            char buf[INET6_ADDRSTRLEN];
+            inet_ntop(AF_INET6, mAddress.ipv6Addr, buf, sizeof(buf));
+            LOC_LOGV("LocEngSetServerAddr - addr: %s, port: %d, type: %s",
+                     buf, mPort, loc_get_server_type_name(mServerType));
+        } else {
+            LOC_LOGV("LocEngSetServerAddr - addr: %x, port: %d, type: %s",
+                     mAddress.ipv4, mPort, loc_get_server_type_name(mServerType));
+        }
+    }
+    inline virtual void log() const {
+        locallog();
+    }
+};
+
+// runs on the resolver thread
+struct LocEngResolveServer : public LocMsg {
+    LocEngResolver* mResolver;
+    LocEngAdapter* mAdapter;
+    const LocServerType mServerType;
+    const int mPort;
+    const uint32_t mGeneration;
+    char mHost[LocEngResolver::MAX_HOST_LEN + 1];
+    inline LocEngResolveServer(LocEngResolver* resolver, LocEngAdapter* adapter,
+                               LocServerType type, const char* hostname, int port,
+                               uint32_t generation) :
+        LocMsg(), mResolver(resolver), mAdapter(adapter),
+        mServerType(type), mPort(port), mGeneration(generation)
+    {
+        strlcpy(mHost, hostname, sizeof(mHost));
+    }
+    inline virtual void proc() const {
+        LocEngResolver::Address address;
+        if (mResolver->resolve(mHost, address)) {
+            mAdapter->sendMsg(new LocEngSetServerAddr(mResolver, mAdapter, address,
+                                                      mPort, mServerType,
+                                                      mGeneration));
+        } else {
+            LOC_LOGE("%s: hostname %s cannot be resolved.\n", __func__, mHost);
+        }
+    }
+};
+
+LocEngResolver* LocEngResolver::getInstance()
+{
+    static LocEngResolver* sInstance = new LocEngResolver();
+    return sInstance;
+}
+
+LocEngResolver::LocEngResolver() :
+    mWorker(new MsgTask("LocEngResolver", false)),
+    mTtlSec(DEFAULT_TTL_SEC), mNext(0)
+{
+    pthread_mutex_init(&mLock, NULL);
+    memset(mCache, 0, sizeof(mCache));
+    memset(mGeneration, 0, sizeof(mGeneration));
+    memset(mApplied, 0, sizeof(mApplied));
+}
+
+LocEngResolver::~LocEngResolver()
+{
+    mWorker->destroy();
+    pthread_mutex_destroy(&mLock);
+}
+
+int LocEngResolver::setServer(LocEngAdapter* adapter, LocServerType type,
+                              const char* hostname, int port)
+{
+    Address address;
+
+    if (strlen(hostname) > MAX_HOST_LEN) {
+        LOC_LOGE("%s: hostname of %d chars too long.\n",
+                 __func__, (int)strlen(hostname));
+        return -1;
+    }
+
+    pthread_mutex_lock(&mLock);
+    uint32_t generation = ++mGeneration[type];
+    pthread_mutex_unlock(&mLock);
+
+    if (peek(hostname, address)) {
+        adapter->sendMsg(new LocEngSetServerAddr(this, adapter, address, port,
+                                                 type, generation));
+        return 0;
+    }
+
+    mWorker->sendMsg(new LocEngResolveServer(this, adapter, type, hostname, port,
+                                             generation));
+    return 1;
+}
+
+bool LocEngResolver::apply(LocServerType type, uint32_t generation)
+{
+    pthread_mutex_lock(&mLock);
+    // compared as a difference so that it survives the wrap
+    bool newer = (int32_t)(generation - mApplied[type]) > 0;
+    if (newer) {
+        mApplied[type] = generation;
+    }
+    pthread_mutex_unlock(&mLock);
+    return newer;
+}
+
+bool LocEngResolver::peek(const char* hostname, Address& address)
+{
+    struct in_addr addr4;
+    if (inet_pton(AF_INET, hostname, &addr4) == 1) {
+        address.ipv6 = false;
+        address.ipv4 = ntohl(addr4.s_addr);
+        return true;
+    }
+    if (inet_pton(AF_INET6, hostname, address.ipv6Addr) == 1) {
+        address.ipv6 = true;
+        address.ipv4 = 0;
+        return true;
+    }
+    return lookup(hostname, address);
+}
+
+bool LocEngResolver::resolve(const char* hostname, Address& address)
+{
+    if (strlen(hostname) > MAX_HOST_LEN) {
+        return false;
+    }
+
+    // a request queued behind one for the same host is served from cache
+    if (peek(hostname, address)) {
+        return true;
+    }
+
+    struct addrinfo hints;
+    struct addrinfo* result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    int err = getaddrinfo(hostname, NULL, &hints, &result);
+    if (err != 0) {
+        LOC_LOGE("DNS query on '%s' failed: %s\n", hostname, gai_strerror(err));
+        return false;
+    }
+
+    bool found = false;
+    for (struct addrinfo* ai = result; ai != NULL; ai = ai->ai_next) {
+        if (AF_INET == ai->ai_family) {
+            address.ipv6 = false;
+            address.ipv4 = ntohl(((struct sockaddr_in*)ai->ai_addr)->sin_addr.s_addr);
+            found = true;
+            break;
+        }
+        if (AF_INET6 == ai->ai_family && !found) {
+            address.ipv6 = true;
+            address.ipv4 = 0;
+            memcpy(address.ipv6Addr,
+                   &((struct sockaddr_in6*)ai->ai_addr)->sin6_addr,
+                   sizeof(address.ipv6Addr));
+            found = true;
+        }
+    }
+    freeaddrinfo(result);
+
+    if (found) {
+        insert(hostname, address);
+    }
+    return found;
+}
+
+void LocEngResolver::flush()
+{
+    pthread_mutex_lock(&mLock);
+    memset(mCache, 0, sizeof(mCache));
+    pthread_mutex_unlock(&mLock);
+}
+
+bool LocEngResolver::lookup(const char* hostname, Address& address)
+{
+    bool found = false;
+    int64_t now = nowMs();
+
+    pthread_mutex_lock(&mLock);
+    for (int i = 0; i < CACHE_SIZE; i++) {
+        if (mCache[i].expiry > now && strcmp(mCache[i].host, hostname) == 0) {
+            address = mCache[i].address;
+            found = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mLock);
+    return found;
+}
+
+void LocEngResolver::insert(const char* hostname, const Address& address)
+{
+    if (0 == mTtlSec) {
+        return;
+    }
+    int64_t now = nowMs();
+
+    pthread_mutex_lock(&mLock);
+    // the entry of the host, else an expired one, else round robin
+    int slot = -1;
+    for (int i = 0; i < CACHE_SIZE; i++) {
+        if (strcmp(mCache[i].host, hostname) == 0) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && mCache[i].expiry <= now) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        slot = mNext++ % CACHE_SIZE;
+    }
+    strlcpy(mCache[slot].host, hostname, sizeof(mCache[slot].host));
+    mCache[slot].address = address;
+    mCache[slot].expiry = now + (int64_t)mTtlSec * 1000;
+    pthread_mutex_unlock(&mLock);
+}
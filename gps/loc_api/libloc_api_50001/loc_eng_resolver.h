@@ -0,0 +1,107 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef LOC_ENG_RESOLVER_H
+#define LOC_ENG_RESOLVER_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <gps_extended.h>
+
+class LocEngAdapter;
+class MsgTask;
+
+// Resolves the host names of the C2K PDE / MPC servers on a thread of its
+// own, so that a slow or unreachable DNS does not hold up the MsgTask of
+// the adapter. The address is set on the modem from a LocMsg posted back
+// to the adapter once resolved. IP literals are parsed right away, and
+// resolved addresses are cached for mTtlSec seconds; failures are not.
+//
+// IPv4 addresses are preferred, an IPv6 one is only used for a host with
+// no IPv4 address.
+//
+// Every setServer() call on a server type gets a generation; an address
+// is only set if its call is newer than the one last set for the type,
+// so a slow lookup never overwrites a server set after it.
+//
+// There is one resolver for the process, it is never deleted as its
+// worker may still hold requests of the adapter.
+class LocEngResolver {
+public:
+    struct Address {
+        bool     ipv6;
+        uint32_t ipv4;          // host byte order
+        uint8_t  ipv6Addr[16];  // network byte order
+    };
+
+    static LocEngResolver* getInstance();
+
+    // longest host name taken, as in DNS
+    static const int MAX_HOST_LEN = 253;
+
+    // resolves 'hostname' and sets it as server 'type' of 'adapter'.
+    // 0 if cached or an IP literal, 1 if queued for the worker, -1 if
+    // 'hostname' is longer than MAX_HOST_LEN.
+    int setServer(LocEngAdapter* adapter, LocServerType type,
+                  const char* hostname, int port);
+    // cached or literal address of 'hostname', without blocking
+    bool peek(const char* hostname, Address& address);
+    // resolves 'hostname', blocking unless cached; called on the worker
+    bool resolve(const char* hostname, Address& address);
+    // drops all cached addresses
+    void flush();
+    // true if the setServer() call 'generation' on 'type' is newer than
+    // the last one set, which it then becomes; called on the adapter
+    bool apply(LocServerType type, uint32_t generation);
+
+    inline void setTtl(uint32_t ttlSec) { mTtlSec = ttlSec; }
+
+private:
+    struct Entry {
+        char     host[MAX_HOST_LEN + 1];
+        Address  address;
+        int64_t  expiry;        // ms since boot
+    };
+    static const int CACHE_SIZE = 8;
+    static const int SERVER_TYPES = LOC_AGPS_SUPL_SERVER + 1;
+
+    pthread_mutex_t mLock;
+    MsgTask* mWorker;
+    uint32_t mTtlSec;
+    uint32_t mNext;
+    Entry mCache[CACHE_SIZE];
+    uint32_t mGeneration[SERVER_TYPES];  // of the last setServer() call
+    uint32_t mApplied[SERVER_TYPES];     // of the last address set
+
+    LocEngResolver();
+    ~LocEngResolver();
+    bool lookup(const char* hostname, Address& address);
+    void insert(const char* hostname, const Address& address);
+};
+
+#endif // LOC_ENG_RESOLVER_H
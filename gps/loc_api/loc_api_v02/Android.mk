@@ -28,6 +28,8 @@ LOCAL_SRC_FILES = \
     LocApiV02.cpp \
     loc_api_v02_log.c \
     loc_api_v02_client.c \
+    loc_api_v02_ind_tables.c \
+    loc_api_v02_trace.c \
     loc_api_sync_req.c \
     location_service_v02.c
 
@@ -35,12 +37,18 @@ LOCAL_CFLAGS += \
     -fno-short-enums \
     -D_ANDROID_
 
+ifeq ($(TARGET_BUILD_VARIANT),user)
+   LOCAL_CFLAGS += -DTARGET_BUILD_VARIANT_USER
+endif
+
 LOCAL_COPY_HEADERS_TO:= libloc_api_v02/
 
 LOCAL_COPY_HEADERS:= \
     location_service_v02.h \
     loc_api_v02_log.h \
     loc_api_v02_client.h \
+    loc_api_v02_trace.h \
+    loc_api_v02_replay.h \
     loc_api_sync_req.h \
     LocApiV02.h \
     loc_util_log.h
@@ -58,4 +66,76 @@ LOCAL_PRELINK_MODULE := false
 
 include $(BUILD_SHARED_LIBRARY)
 
+# libloc_api_v02 with the QMI client replaced by the trace replay stand-in.
+# Installed as libloc_api_v02.so in its own directory, so that the HAL picks
+# it up when loc_replay runs with LD_LIBRARY_PATH pointing there.
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := libloc_api_v02_replay
+LOCAL_MODULE_STEM := libloc_api_v02
+LOCAL_MODULE_RELATIVE_PATH := loc_replay
+
+LOCAL_MODULE_TAGS := debug
+
+LOCAL_SHARED_LIBRARIES := \
+    libutils \
+    libcutils \
+    libloc_core \
+    libgps.utils \
+    libloc_ds_api
+
+LOCAL_SRC_FILES = \
+    LocApiV02.cpp \
+    loc_api_v02_log.c \
+    loc_api_v02_replay.c \
+    loc_api_v02_ind_tables.c \
+    loc_api_v02_trace.c \
+    loc_api_sync_req.c
+
+LOCAL_CFLAGS += \
+    -fno-short-enums \
+    -D_ANDROID_
+
+ifeq ($(TARGET_BUILD_VARIANT),user)
+   LOCAL_CFLAGS += -DTARGET_BUILD_VARIANT_USER
+endif
+
+LOCAL_C_INCLUDES := \
+    $(TARGET_OUT_HEADERS)/libloc_core \
+    $(TARGET_OUT_HEADERS)/qmi-framework/inc \
+    $(TARGET_OUT_HEADERS)/qmi/inc \
+    $(TARGET_OUT_HEADERS)/gps.utils \
+    $(TARGET_OUT_HEADERS)/libloc_ds_api
+
+LOCAL_PRELINK_MODULE := false
+
+include $(BUILD_SHARED_LIBRARY)
+
+# replay driver
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := loc_replay
+LOCAL_MODULE_TAGS := debug
+
+LOCAL_SRC_FILES := loc_replay.cpp
+
+LOCAL_SHARED_LIBRARIES := \
+    libdl
+
+LOCAL_CFLAGS += \
+    -fno-short-enums \
+    -D_ANDROID_
+
+ifeq ($(TARGET_BUILD_VARIANT),user)
+   LOCAL_CFLAGS += -DTARGET_BUILD_VARIANT_USER
+endif
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH) \
+    $(TARGET_OUT_HEADERS)/qmi-framework/inc \
+    $(TARGET_OUT_HEADERS)/qmi/inc \
+    $(TARGET_OUT_HEADERS)/gps.utils
+
+include $(BUILD_EXECUTABLE)
+
 endif # not BUILD_TINY_ANDROID
@@ -973,37 +973,66 @@ enum loc_api_adapter_err LocApiV02 :: setServer(
   return convertErr(status);
 }
 
-enum loc_api_adapter_err LocApiV02 ::
-    setServer(unsigned int ip, int port, LocServerType type)
+qmiLocServerTypeEnumT_v02 LocApiV02 ::
+    convertServerType(LocServerType type)
 {
-  locClientReqUnionType req_union;
-  locClientStatusEnumType status;
-  qmiLocSetServerReqMsgT_v02 set_server_req;
-  qmiLocSetServerIndMsgT_v02 set_server_ind;
-  qmiLocServerTypeEnumT_v02 set_server_cmd;
-
   switch (type) {
   case LOC_AGPS_MPC_SERVER:
-      set_server_cmd = eQMI_LOC_SERVER_TYPE_CDMA_MPC_V02;
-      break;
+      return eQMI_LOC_SERVER_TYPE_CDMA_MPC_V02;
   case LOC_AGPS_CUSTOM_PDE_SERVER:
-      set_server_cmd = eQMI_LOC_SERVER_TYPE_CUSTOM_PDE_V02;
-      break;
+      return eQMI_LOC_SERVER_TYPE_CUSTOM_PDE_V02;
   default:
-      set_server_cmd = eQMI_LOC_SERVER_TYPE_CDMA_PDE_V02;
-      break;
+      return eQMI_LOC_SERVER_TYPE_CDMA_PDE_V02;
   }
+}
+
+enum loc_api_adapter_err LocApiV02 ::
+    setServer(unsigned int ip, int port, LocServerType type)
+{
+  qmiLocSetServerReqMsgT_v02 set_server_req;
 
   memset(&set_server_req, 0, sizeof(set_server_req));
 
   LOC_LOGD("%s:%d]:, ip = %u, port = %d\n", __func__, __LINE__, ip, port);
 
-  set_server_req.serverType = set_server_cmd;
+  set_server_req.serverType = convertServerType(type);
   set_server_req.ipv4Addr_valid = 1;
   set_server_req.ipv4Addr.addr = ip;
   set_server_req.ipv4Addr.port = port;
 
-  req_union.pSetServerReq = &set_server_req;
+  return sendSetServerReq(&set_server_req);
+}
+
+/* Set the PDE / MPC server to an IPv6 address, ip is in network order */
+enum loc_api_adapter_err LocApiV02 ::
+    setServerIpv6(const uint8_t* ip, int port, LocServerType type)
+{
+  qmiLocSetServerReqMsgT_v02 set_server_req;
+
+  memset(&set_server_req, 0, sizeof(set_server_req));
+
+  set_server_req.serverType = convertServerType(type);
+  set_server_req.ipv6Addr_valid = 1;
+  for (int i = 0; i < QMI_LOC_IPV6_ADDR_LENGTH_V02; i++) {
+    set_server_req.ipv6Addr.addr[i] = (uint16_t)((ip[2 * i] << 8) | ip[2 * i + 1]);
+  }
+  set_server_req.ipv6Addr.port = port;
+
+  LOC_LOGD("%s:%d]:, ip = %x:%x:...:%x, port = %d\n", __func__, __LINE__,
+           set_server_req.ipv6Addr.addr[0], set_server_req.ipv6Addr.addr[1],
+           set_server_req.ipv6Addr.addr[QMI_LOC_IPV6_ADDR_LENGTH_V02 - 1], port);
+
+  return sendSetServerReq(&set_server_req);
+}
+
+enum loc_api_adapter_err LocApiV02 ::
+    sendSetServerReq(qmiLocSetServerReqMsgT_v02* set_server_req)
+{
+  locClientReqUnionType req_union;
+  locClientStatusEnumType status;
+  qmiLocSetServerIndMsgT_v02 set_server_ind;
+
+  req_union.pSetServerReq = set_server_req;
 
   status = loc_sync_send_req(clientHandle,
                              QMI_LOC_SET_SERVER_REQ_V02,
@@ -1783,14 +1812,12 @@ enum loc_api_adapter_err LocApiV02 :: convertErr(
 void LocApiV02 :: reportPosition (
   const qmiLocEventPositionReportIndMsgT_v02 *location_report_ptr)
 {
-    UlpLocation location;
+    // the fix is built in place here and shared, not copied, downstream
+    LocFix* fix = LocFix::obtain();
+    UlpLocation& location = fix->editLocation();
     LocPosTechMask tech_Mask = LOC_POS_TECH_MASK_DEFAULT;
     LOC_LOGD("Reporting postion from V2 Adapter\n");
-    memset(&location, 0, sizeof (UlpLocation));
-    location.size = sizeof(location);
-    GpsLocationExtended locationExtended;
-    memset(&locationExtended, 0, sizeof (GpsLocationExtended));
-    locationExtended.size = sizeof(locationExtended);
+    GpsLocationExtended& locationExtended = fix->editLocationExtended();
     // Process the position from final and intermediate reports
 
     if( (location_report_ptr->sessionStatus == eQMI_LOC_SESS_STATUS_SUCCESS_V02) ||
@@ -1940,27 +1967,26 @@ void LocApiV02 :: reportPosition (
                     break;
                }
             }
-            LocApiBase::reportPosition( location,
-                            locationExtended,
-                            (void*)location_report_ptr,
-                            (location_report_ptr->sessionStatus
-                             == eQMI_LOC_SESS_STATUS_IN_PROGRESS_V02 ?
-                             LOC_SESS_INTERMEDIATE : LOC_SESS_SUCCESS),
-                            tech_Mask);
+            fix->setLocationExt((void*)location_report_ptr);
+            fix->setStatus(location_report_ptr->sessionStatus
+                           == eQMI_LOC_SESS_STATUS_IN_PROGRESS_V02 ?
+                           LOC_SESS_INTERMEDIATE : LOC_SESS_SUCCESS);
+            fix->setTechMask(tech_Mask);
+            LocApiBase::reportPosition(*fix);
         }
     }
     else
     {
-        LocApiBase::reportPosition(location,
-                                   locationExtended,
-                                   NULL,
-                                   LOC_SESS_FAILURE);
+        fix->setStatus(LOC_SESS_FAILURE);
+        LocApiBase::reportPosition(*fix);
 
         LOC_LOGD("%s:%d]: Ignoring position report with sess status = %d, "
                       "fix id = %u\n", __func__, __LINE__,
                       location_report_ptr->sessionStatus,
                       location_report_ptr->fixId );
     }
+
+    fix->drop();
 }
 
 /* convert satellite report to loc eng format and  send the converted
@@ -1968,7 +1994,7 @@ void LocApiV02 :: reportPosition (
 void  LocApiV02 :: reportSv (
   const qmiLocEventGnssSvInfoIndMsgT_v02 *gnss_report_ptr)
 {
-  GnssSvStatus      SvStatus;
+  HaxxSvStatus      SvStatus;
   GpsLocationExtended locationExtended;
   int              num_svs_max, i;
   const qmiLocSvInfoStructT_v02 *sv_info_ptr;
@@ -1979,7 +2005,7 @@ void  LocApiV02 :: reportSv (
             gnss_report_ptr->altitudeAssumed);
 
   num_svs_max = 0;
-  memset (&SvStatus, 0, sizeof (GnssSvStatus));
+  memset (&SvStatus, 0, sizeof (HaxxSvStatus));
   memset(&locationExtended, 0, sizeof (GpsLocationExtended));
   locationExtended.size = sizeof(locationExtended);
   if(gnss_report_ptr->svList_valid == 1)
@@ -2820,6 +2846,11 @@ void LocApiV02::ds_client_event_cb(ds_client_status_enum_type result)
         LOC_LOGE("%s:%d]: Emergency call is stopped", __func__, __LINE__);
         reportDataCallClosed();
     }
+    else if(result == E_DS_CLIENT_RETRY_LATER) {
+        LOC_LOGE("%s:%d]: Could not start emergency call. Retry after delay\n",
+                 __func__, __LINE__);
+        reportDataCallRetry();
+    }
     return;
 }
 
@@ -2846,6 +2877,8 @@ int LocApiV02 :: openAndStartDataCall()
                                                             &profile_index,
                                                             &pdp_type);
     if(result == E_DS_CLIENT_SUCCESS) {
+        // does not wait for the call, which comes up or fails later
+        // through ds_client_event_cb()
         result = ds_client_start_call(dsClientHandle, profile_index, pdp_type);
 
         if(result == E_DS_CLIENT_SUCCESS) {
@@ -2865,8 +2898,8 @@ int LocApiV02 :: openAndStartDataCall()
         ret = LOC_API_ADAPTER_ERR_ENGINE_BUSY;
     }
     else {
-        LOC_LOGE("%s:%d]: Unable to bring up emergency call using DS. ret = %d",
-                 __func__, __LINE__, (int)ret);
+        LOC_LOGE("%s:%d]: Unable to bring up emergency call using DS. result = %d",
+                 __func__, __LINE__, (int)result);
         ret = LOC_API_ADAPTER_ERR_UNSUPPORTED;
     }
 
@@ -69,6 +69,13 @@ private:
   /* Convert error from loc_api_v02 to loc eng format*/
   static enum loc_api_adapter_err convertErr(locClientStatusEnumType status);
 
+  /* Convert PDE / MPC server type from loc eng to loc_api_v02 format */
+  static qmiLocServerTypeEnumT_v02 convertServerType(LocServerType type);
+
+  /* Send a set server request and wait for its indication */
+  enum loc_api_adapter_err sendSetServerReq(
+    qmiLocSetServerReqMsgT_v02* set_server_req);
+
   /* convert Ni Encoding type from QMI_LOC to loc eng format */
   static GpsNiEncodingType convertNiEncoding(
     qmiLocNiDataCodingSchemeEnumT_v02 loc_encoding);
@@ -177,6 +184,8 @@ public:
     setServer(const char* url, int len);
   virtual enum loc_api_adapter_err
     setServer(unsigned int ip, int port, LocServerType type);
+  virtual enum loc_api_adapter_err
+    setServerIpv6(const uint8_t* ip, int port, LocServerType type);
   virtual enum loc_api_adapter_err
     setXtraData(char* data, int length);
   virtual enum loc_api_adapter_err
@@ -26,6 +26,7 @@
  * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <errno.h>
 #include <sys/time.h>
@@ -33,6 +34,7 @@
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <cutils/atomic.h>
 #include <loc_cfg.h>
 #include "loc_api_v02_client.h"
 #include "loc_api_sync_req.h"
@@ -47,40 +49,114 @@
 #include "loc_util_log.h"
 
 #define LOC_SYNC_REQ_BUFFER_SIZE 8
+#define LOC_SYNC_REQ_BUFFER_SIZE_MAX 256
 #define GPS_CONF_FILE "/etc/gps.conf"
+
+/* Slot states. The low bits of a slot state word hold one of these values,
+   the remaining bits hold a generation count that is bumped every time the
+   slot is freed, so that a stale reference to a recycled slot can never win
+   a compare-and-swap. */
+#define LOC_SYNC_SLOT_FREE        0   /* available for a new request */
+#define LOC_SYNC_SLOT_RESERVED    1   /* owned by a requester, not visible */
+#define LOC_SYNC_SLOT_ARMED       2   /* published, waiting for its ind */
+#define LOC_SYNC_SLOT_COMPLETING  3   /* ind thread is copying the payload */
+#define LOC_SYNC_SLOT_DONE        4   /* ind delivered */
+#define LOC_SYNC_SLOT_STATE_BITS  3
+#define LOC_SYNC_SLOT_STATE_MASK  ((1 << LOC_SYNC_SLOT_STATE_BITS) - 1)
+
+#define LOC_SYNC_STATE(word)      ((word) & LOC_SYNC_SLOT_STATE_MASK)
+#define LOC_SYNC_GEN(word)        ((word) & ~LOC_SYNC_SLOT_STATE_MASK)
+#define LOC_SYNC_WORD(gen, state) (LOC_SYNC_GEN(gen) | (state))
+
+/* Hash bucket values, other values are slot index + 1 */
+#define LOC_SYNC_BUCKET_EMPTY     0
+#define LOC_SYNC_BUCKET_TOMBSTONE (-1)
+
 pthread_mutex_t  loc_sync_call_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static bool loc_sync_call_initialized = false;
 
+/* Number of sync request slots, configurable with SYNC_REQ_SLOTS in gps.conf */
+static uint32_t SYNC_REQ_SLOTS = LOC_SYNC_REQ_BUFFER_SIZE;
+
+static const loc_param_s_type loc_sync_req_param_table[] =
+{
+   {"SYNC_REQ_SLOTS", &SYNC_REQ_SLOTS, NULL, 'n'},
+};
+
 typedef struct {
-   pthread_mutex_t         sync_req_lock;
+   /* state word, see LOC_SYNC_SLOT_* */
+   volatile int32_t        state;
+
+   /* hash bucket this slot is published in while armed */
+   int32_t                 bucket;
 
    /* Client ID */
    locClientHandleType     client_handle;
 
-   /*  waiting conditional variable */
-   pthread_cond_t          ind_arrived_cond;
-
-   /* Callback waiting data block, protected by loc_cb_data_mutex */
-   bool                    ind_is_selected;              /* is cb selected? */
-   bool                    ind_is_waiting;               /* is waiting?     */
-   bool                    ind_has_arrived;              /* callback has arrived */
    uint32_t                req_id;                    /*  sync request */
    void                    *recv_ind_payload_ptr; /* received  payload */
-   uint32_t                recv_ind_id;      /* received  ind   */
+   uint32_t                recv_ind_id;      /* ind to wait for */
+
+   /* only used to park and wake the requesting thread */
+   pthread_mutex_t         sync_req_lock;
+   pthread_cond_t          ind_arrived_cond;
 
 } loc_sync_req_data_s_type;
 
 typedef struct {
-   bool                        in_use;  /* at least one sync call is active */
-   bool                        slot_in_use[LOC_SYNC_REQ_BUFFER_SIZE];
-   loc_sync_req_data_s_type    slots[LOC_SYNC_REQ_BUFFER_SIZE];
+   /* number of armed slots, lets the ind path bail out without probing */
+   volatile int32_t            armed_count;
+   /* rotating start point for slot allocation */
+   volatile int32_t            alloc_hint;
+   /* free slots not yet reserved by a requester */
+   volatile int32_t            free_count;
+   uint32_t                    num_slots;
+   uint32_t                    bucket_mask;
+   /* open addressing table of (client handle, ind id) -> slot index + 1 */
+   volatile int32_t            *buckets;
+   /* serializes bucket inserts and removals among requesters; the ind
+      path only reads buckets and never takes it */
+   pthread_mutex_t             bucket_lock;
+   uint32_t                    num_tombstones;
+   /* scratch for loc_sync_sweep_tombstones(), one byte per bucket */
+   uint8_t                     *covered;
+   loc_sync_req_data_s_type    *slots;
 } loc_sync_req_array_s_type;
 
 /***************************************************************************
  *                 DATA FOR ASYNCHRONOUS RPC PROCESSING
  **************************************************************************/
-loc_sync_req_array_s_type loc_sync_array;
+loc_sync_req_array_s_type loc_sync_array = {
+   .bucket_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/*===========================================================================
+
+FUNCTION   loc_sync_hash
+
+DESCRIPTION
+   Hashes a (client handle, indication id) pair into a bucket index
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   bucket index
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static inline uint32_t loc_sync_hash(locClientHandleType client_handle,
+                                     uint32_t ind_id)
+{
+   uint32_t h = (uint32_t)(uintptr_t)client_handle ^ (ind_id * 0x9E3779B1u);
+   h ^= h >> 16;
+   h *= 0x85EBCA6Bu;
+   h ^= h >> 13;
+   return h & loc_sync_array.bucket_mask;
+}
 
 /*===========================================================================
 
@@ -102,7 +178,7 @@ SIDE EFFECTS
 void loc_sync_req_init()
 {
    LOC_LOGV(" %s:%d]:\n", __func__, __LINE__);
-   UTIL_READ_CONF_DEFAULT(GPS_CONF_FILE);
+   UTIL_READ_CONF(GPS_CONF_FILE, loc_sync_req_param_table);
    pthread_mutex_lock(&loc_sync_call_mutex);
    if(true == loc_sync_call_initialized)
    {
@@ -111,27 +187,68 @@ void loc_sync_req_init()
       return;
    }
 
-   loc_sync_array.in_use = false;
+   uint32_t num_slots = SYNC_REQ_SLOTS;
+   if (num_slots == 0 || num_slots > LOC_SYNC_REQ_BUFFER_SIZE_MAX)
+   {
+      LOC_LOGW("%s:%d]: invalid SYNC_REQ_SLOTS %u, using %d\n",
+               __func__, __LINE__, num_slots, LOC_SYNC_REQ_BUFFER_SIZE);
+      num_slots = LOC_SYNC_REQ_BUFFER_SIZE;
+   }
+
+   /* at least twice as many buckets as slots keeps probe chains short */
+   uint32_t num_buckets = 1;
+   while (num_buckets < 2 * num_slots)
+   {
+      num_buckets <<= 1;
+   }
 
-   memset(loc_sync_array.slot_in_use, 0, sizeof(loc_sync_array.slot_in_use));
+   loc_sync_array.slots = (loc_sync_req_data_s_type *)
+      calloc(num_slots, sizeof(loc_sync_req_data_s_type));
+   loc_sync_array.buckets = (volatile int32_t *)
+      calloc(num_buckets, sizeof(int32_t));
+   loc_sync_array.covered = (uint8_t *)calloc(num_buckets, sizeof(uint8_t));
 
-   int i;
-   for (i = 0; i < LOC_SYNC_REQ_BUFFER_SIZE; i++)
+   if (NULL == loc_sync_array.slots || NULL == loc_sync_array.buckets ||
+       NULL == loc_sync_array.covered)
+   {
+      LOC_LOGE("%s:%d]: failed to allocate %u slots\n",
+               __func__, __LINE__, num_slots);
+      free(loc_sync_array.slots);
+      free((void *)loc_sync_array.buckets);
+      free(loc_sync_array.covered);
+      loc_sync_array.slots = NULL;
+      loc_sync_array.buckets = NULL;
+      loc_sync_array.covered = NULL;
+      pthread_mutex_unlock(&loc_sync_call_mutex);
+      return;
+   }
+
+   loc_sync_array.num_slots = num_slots;
+   loc_sync_array.bucket_mask = num_buckets - 1;
+   loc_sync_array.armed_count = 0;
+   loc_sync_array.alloc_hint = 0;
+   loc_sync_array.free_count = num_slots;
+   loc_sync_array.num_tombstones = 0;
+
+   uint32_t i;
+   for (i = 0; i < num_slots; i++)
    {
       loc_sync_req_data_s_type *slot = &loc_sync_array.slots[i];
 
       pthread_mutex_init(&slot->sync_req_lock, NULL);
       pthread_cond_init(&slot->ind_arrived_cond, NULL);
 
+      slot->state = LOC_SYNC_WORD(0, LOC_SYNC_SLOT_FREE);
+      slot->bucket = -1;
       slot->client_handle = LOC_CLIENT_INVALID_HANDLE_VALUE;
-      slot->ind_is_selected = false;       /* is ind selected? */
-      slot->ind_is_waiting  = false;       /* is waiting?     */
-      slot->ind_has_arrived = false;       /* callback has arrived */
       slot->recv_ind_id = 0;       /* ind to wait for   */
       slot->recv_ind_payload_ptr = NULL;
       slot->req_id =  0;   /* req id   */
    }
 
+   LOC_LOGD("%s:%d]: %u slots, %u buckets\n",
+            __func__, __LINE__, num_slots, num_buckets);
+
    loc_sync_call_initialized = true;
    pthread_mutex_unlock(&loc_sync_call_mutex);
 }
@@ -142,7 +259,10 @@ void loc_sync_req_init()
 FUNCTION    loc_sync_process_ind
 
 DESCRIPTION
-   Wakes up blocked API calls to check if the needed callback has arrived
+   Wakes up the blocked API call waiting for this indication, if any. Runs
+   on the QMI indication thread and takes no shared lock: the waiter is
+   found with a hash lookup on (client_handle, ind_id) and claimed with a
+   single compare-and-swap of its state word.
 
 DEPENDENCIES
    N/A
@@ -164,71 +284,71 @@ void loc_sync_process_ind(
    LOC_LOGV("%s:%d]: received indication, handle = %p ind_id = %u \n",
                  __func__,__LINE__, client_handle, ind_id);
 
-   pthread_mutex_lock(&loc_sync_call_mutex);
-
-   if (!loc_sync_array.in_use)
+   if (0 == android_atomic_acquire_load(&loc_sync_array.armed_count))
    {
       LOC_LOGD("%s:%d]: loc_sync_array not in use \n",
                     __func__, __LINE__);
-      pthread_mutex_unlock(&loc_sync_call_mutex);
       return;
    }
 
-   bool in_use = false, consumed = false;
-   int i;
+   uint32_t b = loc_sync_hash(client_handle, ind_id);
+   uint32_t probes;
 
-   for (i = 0; i < LOC_SYNC_REQ_BUFFER_SIZE && !consumed; i++)
+   for (probes = 0; probes <= loc_sync_array.bucket_mask;
+        probes++, b = (b + 1) & loc_sync_array.bucket_mask)
    {
-      loc_sync_req_data_s_type *slot = &loc_sync_array.slots[i];
+      int32_t entry = android_atomic_acquire_load(&loc_sync_array.buckets[b]);
 
-      in_use |= loc_sync_array.slot_in_use[i];
-
-      pthread_mutex_lock(&slot->sync_req_lock);
-
-      if ( (loc_sync_array.slot_in_use[i]) && (slot->client_handle == client_handle)
-            && (ind_id == slot->recv_ind_id) && (!slot->ind_has_arrived))
+      if (LOC_SYNC_BUCKET_EMPTY == entry)
+      {
+         break;
+      }
+      if (LOC_SYNC_BUCKET_TOMBSTONE == entry)
       {
-         // copy the payload to the slot waiting for this ind
-         size_t payload_size = 0;
+         continue;
+      }
 
-         LOC_LOGV("%s:%d]: found slot %d selected for ind %u \n",
-                       __func__, __LINE__, i, ind_id);
+      loc_sync_req_data_s_type *slot = &loc_sync_array.slots[entry - 1];
+      int32_t word = android_atomic_acquire_load(&slot->state);
 
-         if(true == locClientGetSizeByRespIndId(ind_id, &payload_size) &&
-            NULL != slot->recv_ind_payload_ptr && NULL != ind_payload_ptr)
-         {
-            LOC_LOGV("%s:%d]: copying ind payload size = %u \n",
-                          __func__, __LINE__, payload_size);
+      if (LOC_SYNC_SLOT_ARMED != LOC_SYNC_STATE(word) ||
+          slot->client_handle != client_handle ||
+          slot->recv_ind_id != ind_id)
+      {
+         continue;
+      }
 
-            memcpy(slot->recv_ind_payload_ptr, ind_payload_ptr, payload_size);
+      /* claim the waiter; fails if it timed out or was recycled meanwhile */
+      if (0 != android_atomic_acquire_cas(word,
+                  LOC_SYNC_WORD(word, LOC_SYNC_SLOT_COMPLETING), &slot->state))
+      {
+         continue;
+      }
 
-            consumed = true;
+      // copy the payload to the slot waiting for this ind
+      size_t payload_size = 0;
 
-         }
-         /* Received a callback while waiting, wake up thread to check it */
-         if (slot->ind_is_waiting)
-         {
-            slot->recv_ind_id = ind_id;
+      LOC_LOGV("%s:%d]: found slot %d selected for ind %u \n",
+                    __func__, __LINE__, entry - 1, ind_id);
 
-            pthread_cond_signal(&slot->ind_arrived_cond);
-         }
-         else
-         {
-            /* If callback arrives before wait, remember it */
-            LOC_LOGV("%s:%d]: ind %u arrived before wait was called \n",
-                          __func__, __LINE__, ind_id);
+      if(true == locClientGetSizeByRespIndId(ind_id, &payload_size) &&
+         NULL != slot->recv_ind_payload_ptr && NULL != ind_payload_ptr)
+      {
+         LOC_LOGV("%s:%d]: copying ind payload size = %u \n",
+                       __func__, __LINE__, payload_size);
 
-            slot->ind_has_arrived = true;
-         }
+         memcpy(slot->recv_ind_payload_ptr, ind_payload_ptr, payload_size);
       }
-      pthread_mutex_unlock(&slot->sync_req_lock);
-   }
 
-   if (!in_use) {
-      loc_sync_array.in_use = false;
+      /* the requester checks its state under this lock before sleeping,
+         so the wakeup cannot be lost */
+      pthread_mutex_lock(&slot->sync_req_lock);
+      android_atomic_release_store(LOC_SYNC_WORD(word, LOC_SYNC_SLOT_DONE),
+                                   &slot->state);
+      pthread_cond_signal(&slot->ind_arrived_cond);
+      pthread_mutex_unlock(&slot->sync_req_lock);
+      return;
    }
-
-   pthread_mutex_unlock(&loc_sync_call_mutex);
 }
 
 /*===========================================================================
@@ -251,22 +371,47 @@ SIDE EFFECTS
 ===========================================================================*/
 static int loc_alloc_slot()
 {
-   int i, select_id = -1; /* no free buffer */
+   int select_id = -1; /* no free buffer */
+   uint32_t num_slots = loc_sync_array.num_slots;
+   uint32_t start, i;
 
-   pthread_mutex_lock(&loc_sync_call_mutex);
+   if (0 == num_slots)
+   {
+      LOC_LOGE("%s:%d]: not initialized\n", __func__, __LINE__);
+      return select_id;
+   }
 
-   for (i = 0; i < LOC_SYNC_REQ_BUFFER_SIZE; i++)
+   /* reserve one of the free slots first. A single scan could miss it,
+      as slots are freed behind the scan while others are taken ahead */
+   int32_t free_count;
+   do
    {
-      if (!loc_sync_array.slot_in_use[i])
+      free_count = android_atomic_acquire_load(&loc_sync_array.free_count);
+      if (free_count <= 0)
       {
-         select_id = i;
-         loc_sync_array.slot_in_use[i] = 1;
-         loc_sync_array.in_use = true;
-         break;
+         LOC_LOGV("%s:%d]: no free slot\n", __func__, __LINE__);
+         return select_id;
+      }
+   } while (0 != android_atomic_acquire_cas(free_count, free_count - 1,
+                                            &loc_sync_array.free_count));
+
+   start = (uint32_t)android_atomic_inc(&loc_sync_array.alloc_hint);
+
+   /* the reserved slot is found within a few rounds at most */
+   for (i = 0; select_id < 0; i++)
+   {
+      uint32_t n = (start + i) % num_slots;
+      loc_sync_req_data_s_type *slot = &loc_sync_array.slots[n];
+      int32_t word = android_atomic_acquire_load(&slot->state);
+
+      if (LOC_SYNC_SLOT_FREE == LOC_SYNC_STATE(word) &&
+          0 == android_atomic_acquire_cas(word,
+                  LOC_SYNC_WORD(word, LOC_SYNC_SLOT_RESERVED), &slot->state))
+      {
+         select_id = n;
       }
    }
 
-   pthread_mutex_unlock(&loc_sync_call_mutex);
    LOC_LOGV("%s:%d]: returning slot %d\n",
                  __func__, __LINE__, select_id);
    return select_id;
@@ -274,10 +419,69 @@ static int loc_alloc_slot()
 
 /*===========================================================================
 
+FUNCTION    loc_sync_sweep_tombstones
+
+DESCRIPTION
+   Empties the tombstones that no probe chain runs through any more, so
+   that lookups for indications nobody waits for stop early instead of
+   scanning the whole table. A tombstone that lies between the home bucket
+   of an armed slot and the bucket it was published in has to stay, the
+   ind path would stop short of that slot otherwise. Called with
+   bucket_lock held, so the armed slots and their buckets can't change.
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_sync_sweep_tombstones()
+{
+   uint32_t mask = loc_sync_array.bucket_mask;
+   uint32_t i, b;
+
+   memset(loc_sync_array.covered, 0, mask + 1);
+   for (i = 0; i < loc_sync_array.num_slots; i++)
+   {
+      loc_sync_req_data_s_type *slot = &loc_sync_array.slots[i];
+
+      if (slot->bucket < 0)
+      {
+         continue;
+      }
+      for (b = loc_sync_hash(slot->client_handle, slot->recv_ind_id);
+           b != (uint32_t)slot->bucket; b = (b + 1) & mask)
+      {
+         loc_sync_array.covered[b] = 1;
+      }
+   }
+
+   for (b = 0; b <= mask; b++)
+   {
+      if (LOC_SYNC_BUCKET_TOMBSTONE == loc_sync_array.buckets[b] &&
+          !loc_sync_array.covered[b])
+      {
+         android_atomic_release_store(LOC_SYNC_BUCKET_EMPTY,
+                                      &loc_sync_array.buckets[b]);
+         loc_sync_array.num_tombstones--;
+      }
+   }
+
+   LOC_LOGV("%s:%d]: %u tombstones left\n",
+            __func__, __LINE__, loc_sync_array.num_tombstones);
+}
+
+/*===========================================================================
+
 FUNCTION    loc_free_slot
 
 DESCRIPTION
-   Frees a buffer slot after the synchronous API call
+   Frees a buffer slot after the synchronous API call. The slot must not be
+   armed, i.e. the indication path can no longer claim it.
 
 DEPENDENCIES
    N/A
@@ -291,37 +495,35 @@ SIDE EFFECTS
 ===========================================================================*/
 static void loc_free_slot(int select_id)
 {
-   int i;
-   loc_sync_req_data_s_type *slot;
-
-   pthread_mutex_lock(&loc_sync_call_mutex);
+   loc_sync_req_data_s_type *slot = &loc_sync_array.slots[select_id];
 
    LOC_LOGD("%s:%d]: freeing slot %d\n", __func__, __LINE__, select_id);
 
-   loc_sync_array.slot_in_use[select_id] = 0;
-
-   slot = &loc_sync_array.slots[select_id];
+   if (slot->bucket >= 0)
+   {
+      pthread_mutex_lock(&loc_sync_array.bucket_lock);
+      android_atomic_release_store(LOC_SYNC_BUCKET_TOMBSTONE,
+                                   &loc_sync_array.buckets[slot->bucket]);
+      slot->bucket = -1;
+      if (++loc_sync_array.num_tombstones > loc_sync_array.num_slots)
+      {
+         loc_sync_sweep_tombstones();
+      }
+      pthread_mutex_unlock(&loc_sync_array.bucket_lock);
+      android_atomic_dec(&loc_sync_array.armed_count);
+   }
 
    slot->client_handle = LOC_CLIENT_INVALID_HANDLE_VALUE;
-   slot->ind_is_selected = false;       /* is ind selected? */
-   slot->ind_is_waiting  = false;       /* is waiting?     */
-   slot->ind_has_arrived = false;       /* callback has arrived */
    slot->recv_ind_id = 0;       /* ind to wait for   */
    slot->recv_ind_payload_ptr = NULL;
    slot->req_id =  0;
 
-   // check if all slots are now free
-   for (i = 0; i < LOC_SYNC_REQ_BUFFER_SIZE; i++)
-   {
-      if (loc_sync_array.slot_in_use[i]) break;
-   }
-
-   if (i >= LOC_SYNC_REQ_BUFFER_SIZE)
-   {
-      loc_sync_array.in_use = false;
-   }
-
-   pthread_mutex_unlock(&loc_sync_call_mutex);
+   /* bump the generation so stale references can not claim the slot */
+   int32_t word = slot->state;
+   android_atomic_release_store(
+      LOC_SYNC_WORD(word + (1 << LOC_SYNC_SLOT_STATE_BITS), LOC_SYNC_SLOT_FREE),
+      &slot->state);
+   android_atomic_inc(&loc_sync_array.free_count);
 }
 
 /*===========================================================================
@@ -329,7 +531,8 @@ static void loc_free_slot(int select_id)
 FUNCTION    loc_sync_select_ind
 
 DESCRIPTION
-   Selects which indication to wait for.
+   Selects which indication to wait for, and publishes the slot in the hash
+   table so the indication path can find it.
 
 
 DEPENDENCIES
@@ -364,31 +567,90 @@ static int loc_sync_select_ind(
 
    loc_sync_req_data_s_type *slot = &loc_sync_array.slots[select_id];
 
-   pthread_mutex_lock(&slot->sync_req_lock);
-
    slot->client_handle = client_handle;
-   slot->ind_is_selected = true;
-   slot->ind_is_waiting = false;
-   slot->ind_has_arrived = false;
-
    slot->recv_ind_id = ind_id;
    slot->req_id      = req_id;
    slot->recv_ind_payload_ptr = ind_payload_ptr; //store the payload ptr
 
-   pthread_mutex_unlock(&slot->sync_req_lock);
+   /* there are at least twice as many buckets as slots, so this always
+      finds an empty or tombstoned bucket */
+   uint32_t b = loc_sync_hash(client_handle, ind_id);
+   pthread_mutex_lock(&loc_sync_array.bucket_lock);
+   for (;; b = (b + 1) & loc_sync_array.bucket_mask)
+   {
+      int32_t entry = loc_sync_array.buckets[b];
+
+      if (LOC_SYNC_BUCKET_EMPTY == entry ||
+          LOC_SYNC_BUCKET_TOMBSTONE == entry)
+      {
+         if (LOC_SYNC_BUCKET_TOMBSTONE == entry)
+         {
+            loc_sync_array.num_tombstones--;
+         }
+         android_atomic_release_store(select_id + 1,
+                                      &loc_sync_array.buckets[b]);
+         slot->bucket = b;
+         break;
+      }
+   }
+   pthread_mutex_unlock(&loc_sync_array.bucket_lock);
+
+   android_atomic_inc(&loc_sync_array.armed_count);
+
+   int32_t word = slot->state;
+   android_atomic_release_store(LOC_SYNC_WORD(word, LOC_SYNC_SLOT_ARMED),
+                                &slot->state);
 
    return select_id;
 }
 
 
+/*===========================================================================
+
+FUNCTION    loc_sync_cancel_ind
+
+DESCRIPTION
+   Withdraws a selected indication that will not be waited for, e.g. because
+   sending the request failed, and frees its slot.
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_sync_cancel_ind(int select_id)
+{
+   loc_sync_req_data_s_type *slot = &loc_sync_array.slots[select_id];
+   int32_t word = android_atomic_acquire_load(&slot->state);
+
+   if (LOC_SYNC_SLOT_ARMED != LOC_SYNC_STATE(word) ||
+       0 != android_atomic_acquire_cas(word,
+               LOC_SYNC_WORD(word, LOC_SYNC_SLOT_RESERVED), &slot->state))
+   {
+      /* the indication path owns it; let it finish writing the payload */
+      pthread_mutex_lock(&slot->sync_req_lock);
+      while (LOC_SYNC_SLOT_DONE !=
+             LOC_SYNC_STATE(android_atomic_acquire_load(&slot->state)))
+      {
+         pthread_cond_wait(&slot->ind_arrived_cond, &slot->sync_req_lock);
+      }
+      pthread_mutex_unlock(&slot->sync_req_lock);
+   }
+
+   loc_free_slot(select_id);
+}
+
 /*===========================================================================
 
 FUNCTION    loc_sync_wait_for_ind
 
 DESCRIPTION
    Waits for a selected indication. The wait expires in timeout_seconds seconds.
-   If the function is called before an existing wait has finished, it will
-   immediately return error.
 
 DEPENDENCIES
    N/A
@@ -406,7 +668,7 @@ static int loc_sync_wait_for_ind(
       uint32_t ind_id
 )
 {
-   if (select_id < 0 || select_id >= LOC_SYNC_REQ_BUFFER_SIZE || !loc_sync_array.slot_in_use[select_id])
+   if (select_id < 0 || (uint32_t)select_id >= loc_sync_array.num_slots)
    {
       LOC_LOGE("%s:%d]: invalid select_id: %d \n",
                     __func__, __LINE__, select_id);
@@ -417,52 +679,47 @@ static int loc_sync_wait_for_ind(
    loc_sync_req_data_s_type *slot = &loc_sync_array.slots[select_id];
 
    int ret_val = 0;  /* the return value of this function: 0 = no error */
-   int rc;          /* return code from pthread calls */
+   int rc = 0;      /* return code from pthread calls */
 
    struct timeval present_time;
    struct timespec expire_time;
 
-   pthread_mutex_lock(&slot->sync_req_lock);
+   /* Calculate absolute expire time */
+   gettimeofday(&present_time, NULL);
+   expire_time.tv_sec  = present_time.tv_sec;
+   expire_time.tv_nsec = present_time.tv_usec * 1000;
+   expire_time.tv_sec += timeout_seconds;
 
-  do
-  {
-      if (slot->ind_has_arrived)
-      {
-         ret_val = 0;    /* success */
-         break;
-      }
+   pthread_mutex_lock(&slot->sync_req_lock);
 
-      if (slot->ind_is_waiting)
+   /* If callback arrived before wait, this does not block */
+   while (LOC_SYNC_SLOT_DONE !=
+          LOC_SYNC_STATE(android_atomic_acquire_load(&slot->state)))
+   {
+      if (ETIMEDOUT == rc)
       {
-         LOC_LOGW("%s:%d]: already waiting in this slot %d\n", __func__,
-                       __LINE__, select_id);
-         ret_val = -EBUSY; // busy
-         break;
-      }
-
-      /* Calculate absolute expire time */
-      gettimeofday(&present_time, NULL);
-      expire_time.tv_sec  = present_time.tv_sec;
-      expire_time.tv_nsec = present_time.tv_usec * 1000;
-      expire_time.tv_sec += timeout_seconds;
-
-      /* Take new wait request */
-      slot->ind_is_waiting = true;
-
-      /* Waiting */
-      rc = pthread_cond_timedwait(&slot->ind_arrived_cond,
-            &slot->sync_req_lock, &expire_time);
+         int32_t word = android_atomic_acquire_load(&slot->state);
 
-      slot->ind_is_waiting = false;
+         if (LOC_SYNC_SLOT_ARMED == LOC_SYNC_STATE(word) &&
+             0 == android_atomic_acquire_cas(word,
+                     LOC_SYNC_WORD(word, LOC_SYNC_SLOT_RESERVED), &slot->state))
+         {
+            LOC_LOGE("%s:%d]: slot %d, timed out for ind_id %s\n",
+                       __func__, __LINE__, select_id, loc_get_v02_event_name(ind_id));
+            ret_val = -ETIMEDOUT; //time out
+            break;
+         }
 
-      if(rc == ETIMEDOUT)
+         /* lost the race against the indication thread, which is
+            now copying the payload and about to signal */
+         rc = pthread_cond_wait(&slot->ind_arrived_cond, &slot->sync_req_lock);
+      }
+      else
       {
-         LOC_LOGE("%s:%d]: slot %d, timed out for ind_id %s\n",
-                    __func__, __LINE__, select_id, loc_get_v02_event_name(ind_id));
-         ret_val = -ETIMEDOUT; //time out
+         rc = pthread_cond_timedwait(&slot->ind_arrived_cond,
+               &slot->sync_req_lock, &expire_time);
       }
-
-  } while (0);
+   }
 
    pthread_mutex_unlock(&slot->sync_req_lock);
    loc_free_slot(select_id);
@@ -513,7 +770,7 @@ locClientStatusEnumType loc_sync_send_req
 
       if (status != eLOC_CLIENT_SUCCESS )
       {
-         loc_free_slot(select_id);
+         loc_sync_cancel_ind(select_id);
       }
       else
       {
@@ -540,8 +797,168 @@ locClientStatusEnumType loc_sync_send_req
          }
       }
    } /* select id */
+   else
+   {
+      /* no slot to wait in, the indication payload would never be filled */
+      status = eLOC_CLIENT_FAILURE_NOT_ENOUGH_MEMORY;
+   }
 
    return status;
 }
 
+#ifdef __LOC_DEBUG__
+
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Stand-in for the QMI client layer: every request is answered from a
+   responder thread, after a short random delay, through
+   loc_sync_process_ind(), exactly as locClientIndCb would. */
+
+#define DEBUG_RESP_QUEUE_SIZE 4096
+
+typedef struct {
+   locClientHandleType  handle;
+   uint32_t             ind_id;
+} debug_resp_s_type;
+
+static debug_resp_s_type debug_resp_queue[DEBUG_RESP_QUEUE_SIZE];
+static uint32_t debug_resp_head, debug_resp_tail;
+static pthread_mutex_t debug_resp_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t debug_resp_cond = PTHREAD_COND_INITIALIZER;
+
+void loc_read_conf(const char* conf_file_name,
+                   const loc_param_s_type* config_table,
+                   uint32_t table_length)
+{
+   const char *slots = getenv("SYNC_REQ_SLOTS");
+   if (NULL != slots && table_length > 0)
+   {
+      *(uint32_t *)config_table[0].param_ptr = atoi(slots);
+   }
+}
+
+bool locClientGetSizeByRespIndId(uint32_t respIndId, size_t *pRespIndSize)
+{
+   *pRespIndSize = sizeof(uint32_t);
+   return true;
+}
+
+locClientStatusEnumType locClientSendReq(locClientHandleType handle,
+                                         uint32_t reqId,
+                                         locClientReqUnionType reqPayload)
+{
+   pthread_mutex_lock(&debug_resp_lock);
+   debug_resp_queue[debug_resp_tail % DEBUG_RESP_QUEUE_SIZE].handle = handle;
+   debug_resp_queue[debug_resp_tail % DEBUG_RESP_QUEUE_SIZE].ind_id = reqId;
+   debug_resp_tail++;
+   pthread_cond_signal(&debug_resp_cond);
+   pthread_mutex_unlock(&debug_resp_lock);
+   return eLOC_CLIENT_SUCCESS;
+}
+
+static void* debug_responder(void* arg)
+{
+   for (;;)
+   {
+      debug_resp_s_type resp;
+      pthread_mutex_lock(&debug_resp_lock);
+      while (debug_resp_head == debug_resp_tail)
+      {
+         pthread_cond_wait(&debug_resp_cond, &debug_resp_lock);
+      }
+      resp = debug_resp_queue[debug_resp_head % DEBUG_RESP_QUEUE_SIZE];
+      debug_resp_head++;
+      pthread_mutex_unlock(&debug_resp_lock);
+
+      /* the payload echoes the ind id so requesters can check delivery */
+      uint32_t payload = resp.ind_id;
+      loc_sync_process_ind(resp.handle, resp.ind_id, &payload);
+   }
+   return NULL;
+}
+
+typedef struct {
+   int         id;
+   int         iterations;
+   int         failures;
+} debug_requester_s_type;
+
+static void* debug_requester(void* arg)
+{
+   debug_requester_s_type *req = (debug_requester_s_type *)arg;
+   locClientHandleType handle = (locClientHandleType)(uintptr_t)(0x1000 + (req->id & 3));
+   locClientReqUnionType payload;
+   int i;
+
+   memset(&payload, 0, sizeof(payload));
+   for (i = 0; i < req->iterations; i++)
+   {
+      uint32_t ind_id = (req->id << 16) | (i & 0xffff);
+      uint32_t ind = 0;
+      if (eLOC_CLIENT_SUCCESS != loc_sync_send_req(handle, ind_id, payload,
+                                                   LOC_ENGINE_SYNC_REQUEST_TIMEOUT,
+                                                   ind_id, &ind) ||
+          ind != ind_id)
+      {
+         req->failures++;
+      }
+   }
+   return NULL;
+}
+
+// For Linux command line testing, built by gps/host as loc_sync_req_stress:
+// test: SYNC_REQ_SLOTS=64 ./loc_sync_req_stress <requesters> <requests per requester> <responders>
+int main(int argc, char** argv)
+{
+   int requesters = argc > 1 ? atoi(argv[1]) : 32;
+   int iterations = argc > 2 ? atoi(argv[2]) : 10000;
+   int responders = argc > 3 ? atoi(argv[3]) : 2;
+   pthread_t threads[requesters + responders];
+   debug_requester_s_type reqs[requesters];
+   struct timespec start, end;
+   int i, failures = 0;
+
+   loc_sync_req_init();
+
+   for (i = 0; i < responders; i++)
+   {
+      pthread_create(&threads[requesters + i], NULL, debug_responder, NULL);
+   }
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for (i = 0; i < requesters; i++)
+   {
+      reqs[i].id = i;
+      reqs[i].iterations = iterations;
+      reqs[i].failures = 0;
+      pthread_create(&threads[i], NULL, debug_requester, &reqs[i]);
+   }
+   for (i = 0; i < requesters; i++)
+   {
+      pthread_join(threads[i], NULL);
+      failures += reqs[i].failures;
+   }
+   clock_gettime(CLOCK_MONOTONIC, &end);
+
+   /* tombstones must have been swept as they piled up */
+   uint32_t b, tombstones = 0;
+   for (b = 0; b <= loc_sync_array.bucket_mask; b++)
+   {
+      if (LOC_SYNC_BUCKET_EMPTY != loc_sync_array.buckets[b])
+      {
+         tombstones++;
+      }
+   }
+
+   double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+   printf("slots %u requesters %d requests %d failures %d tombstones %u: "
+          "%.0f req/s, %.2f us/req\n",
+          loc_sync_array.num_slots, requesters, requesters * iterations, failures,
+          tombstones, requesters * iterations / secs,
+          secs * 1e6 / (requesters * iterations));
+
+   return (failures || tombstones > loc_sync_array.num_slots) ? 1 : 0;
+}
 
+#endif
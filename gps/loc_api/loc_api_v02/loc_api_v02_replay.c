@@ -0,0 +1,450 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <cutils/atomic.h>
+
+#if defined( _ANDROID_)
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_api_v02"
+#endif //_ANDROID_
+
+#include "loc_api_v02_client.h"
+#include "loc_api_v02_replay.h"
+#include "loc_util_log.h"
+
+#define LOC_CLIENT_REPLAY_MAX_CLIENTS (4)
+
+/* Client slots are never freed, so a replay that raced with
+   locClientClose() still dereferences valid memory; a closed client
+   simply has no callbacks. */
+typedef struct locClientReplayClientStructT
+{
+  struct locClientReplayClientStructT *pMe;
+  bool                                 inUse;
+  locClientEventMaskType               eventRegMask;
+  locClientEventIndCbType              eventCallback;
+  locClientRespIndCbType               respCallback;
+  locClientErrorCbType                 errorCallback;
+  void                                *pClientCookie;
+}locClientReplayClientType;
+
+static locClientReplayClientType
+    locClientReplayClients[LOC_CLIENT_REPLAY_MAX_CLIENTS];
+static pthread_mutex_t locClientReplayMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t locClientReplayCond = PTHREAD_COND_INITIALIZER;
+static volatile uint32_t locClientReplayRequests = 0;
+
+static locClientReplayClientType* locClientReplayGetClient(
+    locClientHandleType handle)
+{
+  locClientReplayClientType *pClient = (locClientReplayClientType *)handle;
+
+  if(NULL == pClient || pClient != pClient->pMe || !pClient->inUse)
+  {
+    LOC_LOGE("%s:%d]: invalid handle %p\n", __func__, __LINE__, handle);
+    return NULL;
+  }
+  return pClient;
+}
+
+locClientStatusEnumType locClientOpen (
+  locClientEventMaskType         eventRegMask,
+  const locClientCallbacksType*  pLocClientCallbacks,
+  locClientHandleType*           pLocClientHandle,
+  const void*                    pClientCookie)
+{
+  locClientStatusEnumType status = eLOC_CLIENT_FAILURE_INTERNAL;
+  int idx;
+
+  if( (NULL == pLocClientCallbacks) || (NULL == pLocClientHandle)
+      || (NULL == pLocClientCallbacks->respIndCb) ||
+      (pLocClientCallbacks->size != sizeof(locClientCallbacksType)))
+  {
+    LOC_LOGE("%s:%d]: Invalid parameters in locClientOpen\n",
+             __func__, __LINE__);
+    return eLOC_CLIENT_FAILURE_INVALID_PARAMETER;
+  }
+
+  pthread_mutex_lock(&locClientReplayMutex);
+  for(idx = 0; idx < LOC_CLIENT_REPLAY_MAX_CLIENTS; idx++)
+  {
+    locClientReplayClientType *pClient = &locClientReplayClients[idx];
+    if(!pClient->inUse)
+    {
+      pClient->pMe = pClient;
+      pClient->eventRegMask = eventRegMask;
+      pClient->eventCallback = pLocClientCallbacks->eventIndCb;
+      pClient->respCallback = pLocClientCallbacks->respIndCb;
+      pClient->errorCallback = pLocClientCallbacks->errorCb;
+      pClient->pClientCookie = (void *)pClientCookie;
+      pClient->inUse = true;
+      *pLocClientHandle = (locClientHandleType)pClient;
+      status = eLOC_CLIENT_SUCCESS;
+      pthread_cond_broadcast(&locClientReplayCond);
+      break;
+    }
+  }
+  pthread_mutex_unlock(&locClientReplayMutex);
+
+  if(eLOC_CLIENT_SUCCESS != status)
+  {
+    LOC_LOGE("%s:%d]: out of replay client slots\n", __func__, __LINE__);
+    *pLocClientHandle = LOC_CLIENT_INVALID_HANDLE_VALUE;
+  }
+  return status;
+}
+
+locClientStatusEnumType locClientClose(
+  locClientHandleType* pLocClientHandle)
+{
+  locClientReplayClientType *pClient;
+
+  if(NULL == pLocClientHandle)
+  {
+    return eLOC_CLIENT_FAILURE_INVALID_PARAMETER;
+  }
+
+  pthread_mutex_lock(&locClientReplayMutex);
+  pClient = locClientReplayGetClient(*pLocClientHandle);
+  if(NULL != pClient)
+  {
+    pClient->eventCallback = NULL;
+    pClient->respCallback = NULL;
+    pClient->errorCallback = NULL;
+    pClient->inUse = false;
+  }
+  pthread_mutex_unlock(&locClientReplayMutex);
+
+  *pLocClientHandle = LOC_CLIENT_INVALID_HANDLE_VALUE;
+  return (NULL == pClient) ? eLOC_CLIENT_FAILURE_INVALID_HANDLE :
+                             eLOC_CLIENT_SUCCESS;
+}
+
+/* Every QMI_LOC request is answered by a response indication with the
+   same id. The stand-in answers right away with a zeroed indication,
+   whose status field reads eQMI_LOC_SUCCESS_V02. This is called from
+   within loc_sync_send_req(), after the request slot was armed, so the
+   synchronous caller is released as soon as it starts waiting. */
+locClientStatusEnumType locClientSendReq(
+  locClientHandleType      handle,
+  uint32_t                 reqId,
+  locClientReqUnionType    reqPayload)
+{
+  locClientReplayClientType *pClient;
+  locClientRespIndCbType localRespCallback;
+  locClientRespIndUnionType respIndUnion;
+  void *pCookie;
+  size_t indSize = 0;
+  void *indBuffer;
+
+  (void)reqPayload;
+
+  pthread_mutex_lock(&locClientReplayMutex);
+  pClient = locClientReplayGetClient(handle);
+  localRespCallback = (NULL != pClient) ? pClient->respCallback : NULL;
+  pCookie = (NULL != pClient) ? pClient->pClientCookie : NULL;
+  pthread_mutex_unlock(&locClientReplayMutex);
+
+  if(NULL == pClient)
+  {
+    return eLOC_CLIENT_FAILURE_INVALID_HANDLE;
+  }
+
+  android_atomic_inc((volatile int32_t *)&locClientReplayRequests);
+
+  if(!locClientGetSizeByRespIndId(reqId, &indSize))
+  {
+    LOC_LOGW("%s:%d]: no response indication for req id %u\n",
+             __func__, __LINE__, reqId);
+    return eLOC_CLIENT_SUCCESS;
+  }
+
+  indBuffer = calloc(1, indSize);
+  if(NULL == indBuffer)
+  {
+    return eLOC_CLIENT_FAILURE_NOT_ENOUGH_MEMORY;
+  }
+
+  respIndUnion.pDeleteAssistDataInd =
+      (qmiLocDeleteAssistDataIndMsgT_v02 *)indBuffer;
+  if(NULL != localRespCallback)
+  {
+    localRespCallback(handle, reqId, respIndUnion, pCookie);
+  }
+  free(indBuffer);
+
+  return eLOC_CLIENT_SUCCESS;
+}
+
+/* The replayed engine is reported as supporting none of the optional
+   messages, so that the HAL takes its most basic path */
+locClientStatusEnumType locClientSupportMsgCheck(
+  locClientHandleType      handle,
+  const uint32_t*          msgArray,
+  uint32_t                 msgArrayLength,
+  uint64_t*                supportedMsg)
+{
+  (void)handle;
+  (void)msgArray;
+  (void)msgArrayLength;
+
+  if(NULL == supportedMsg)
+  {
+    return eLOC_CLIENT_FAILURE_INVALID_PARAMETER;
+  }
+  *supportedMsg = 0;
+  return eLOC_CLIENT_SUCCESS;
+}
+
+bool locClientRegisterEventMask(
+  locClientHandleType    clientHandle,
+  locClientEventMaskType eventRegMask)
+{
+  bool ret = false;
+
+  pthread_mutex_lock(&locClientReplayMutex);
+  locClientReplayClientType *pClient = locClientReplayGetClient(clientHandle);
+  if(NULL != pClient)
+  {
+    pClient->eventRegMask = eventRegMask;
+    ret = true;
+  }
+  pthread_mutex_unlock(&locClientReplayMutex);
+
+  return ret;
+}
+
+/* dispatch one indication to all open clients */
+static void locClientReplayDispatch(const locIndTraceRecordHeaderT *pHeader,
+                                    void *indBuffer)
+{
+  locClientReplayClientType clients[LOC_CLIENT_REPLAY_MAX_CLIENTS];
+  int numClients = 0;
+  int idx;
+
+  // snapshot the clients, callbacks may issue requests of their own
+  pthread_mutex_lock(&locClientReplayMutex);
+  for(idx = 0; idx < LOC_CLIENT_REPLAY_MAX_CLIENTS; idx++)
+  {
+    if(locClientReplayClients[idx].inUse)
+    {
+      clients[numClients++] = locClientReplayClients[idx];
+    }
+  }
+  pthread_mutex_unlock(&locClientReplayMutex);
+
+  for(idx = 0; idx < numClients; idx++)
+  {
+    locClientHandleType handle = (locClientHandleType)clients[idx].pMe;
+
+    if(eLOC_IND_TRACE_EVENT == pHeader->type)
+    {
+      locClientEventIndUnionType eventIndUnion;
+      eventIndUnion.pPositionReportEvent =
+          (qmiLocEventPositionReportIndMsgT_v02 *)indBuffer;
+      if(NULL != clients[idx].eventCallback)
+      {
+        clients[idx].eventCallback(handle, pHeader->msgId, eventIndUnion,
+                                   clients[idx].pClientCookie);
+      }
+    }
+    else
+    {
+      locClientRespIndUnionType respIndUnion;
+      respIndUnion.pDeleteAssistDataInd =
+          (qmiLocDeleteAssistDataIndMsgT_v02 *)indBuffer;
+      if(NULL != clients[idx].respCallback)
+      {
+        clients[idx].respCallback(handle, pHeader->msgId, respIndUnion,
+                                  clients[idx].pClientCookie);
+      }
+    }
+  }
+}
+
+static bool locClientReplayWaitForClient(uint32_t waitForClientMs)
+{
+  struct timespec deadline;
+  bool found = false;
+  int rc = 0;
+  int idx;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += waitForClientMs / 1000;
+  deadline.tv_nsec += (waitForClientMs % 1000) * 1000000L;
+  if(deadline.tv_nsec >= 1000000000L)
+  {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock(&locClientReplayMutex);
+  while(!found && ETIMEDOUT != rc)
+  {
+    for(idx = 0; idx < LOC_CLIENT_REPLAY_MAX_CLIENTS; idx++)
+    {
+      found = found || locClientReplayClients[idx].inUse;
+    }
+    if(!found)
+    {
+      rc = pthread_cond_timedwait(&locClientReplayCond,
+                                  &locClientReplayMutex, &deadline);
+    }
+  }
+  pthread_mutex_unlock(&locClientReplayMutex);
+
+  return found;
+}
+
+int locClientReplayRun(const char* path,
+                       bool realTime,
+                       uint32_t waitForClientMs,
+                       locClientReplayHookType hook,
+                       void* pCookie,
+                       locClientReplayStatsT* pStats)
+{
+  locClientReplayStatsT stats;
+  locIndTraceRecordHeaderT header;
+  void *payload = NULL;
+  uint64_t firstTs = 0, lastTs = 0, startNs;
+  uint32_t requestsBefore = locClientReplayRequests;
+  bool first = true;
+  FILE *trace;
+
+  memset(&stats, 0, sizeof(stats));
+
+  trace = loc_ind_trace_open(path);
+  if(NULL == trace)
+  {
+    return -1;
+  }
+
+  if(!locClientReplayWaitForClient(waitForClientMs))
+  {
+    LOC_LOGE("%s:%d]: no client opened within %u ms\n",
+             __func__, __LINE__, waitForClientMs);
+    fclose(trace);
+    return -1;
+  }
+
+  startNs = loc_ind_trace_now_ns();
+  while(loc_ind_trace_read(trace, &header, &payload))
+  {
+    size_t indSize = 0;
+    bool known = (eLOC_IND_TRACE_EVENT == header.type) ?
+        locClientGetSizeByEventIndId(header.msgId, &indSize) :
+        locClientGetSizeByRespIndId(header.msgId, &indSize);
+
+    // a size mismatch means the trace came from a different ABI
+    if(!known || (0 != header.size && indSize != header.size))
+    {
+      LOC_LOGW("%s:%d]: skipping msg id %u, size %u expected %u\n",
+               __func__, __LINE__, header.msgId, header.size,
+               (uint32_t)indSize);
+      stats.skipped++;
+      free(payload);
+      continue;
+    }
+
+    if(0 == header.size)
+    {
+      // indication without payload, hand out a zeroed struct
+      free(payload);
+      payload = calloc(1, indSize);
+      if(NULL == payload)
+      {
+        break;
+      }
+    }
+
+    if(first)
+    {
+      firstTs = header.timestampNs;
+      first = false;
+    }
+    lastTs = header.timestampNs;
+
+    if(realTime && header.timestampNs > firstTs)
+    {
+      uint64_t dueNs = startNs + (header.timestampNs - firstTs);
+      uint64_t nowNs = loc_ind_trace_now_ns();
+      if(dueNs > nowNs)
+      {
+        struct timespec due;
+        due.tv_sec = dueNs / 1000000000ULL;
+        due.tv_nsec = dueNs % 1000000000ULL;
+        while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                                       &due, NULL));
+      }
+      else if(nowNs - dueNs > stats.maxLagNs)
+      {
+        stats.maxLagNs = nowNs - dueNs;
+      }
+    }
+
+    if(NULL != hook)
+    {
+      hook(header.msgId, (locIndTraceTypeEnumT)header.type, payload,
+           indSize, loc_ind_trace_now_ns(), pCookie);
+    }
+    locClientReplayDispatch(&header, payload);
+
+    if(eLOC_IND_TRACE_EVENT == header.type)
+    {
+      stats.events++;
+    }
+    else
+    {
+      stats.resps++;
+    }
+    free(payload);
+    payload = NULL;
+  }
+  fclose(trace);
+
+  stats.replayNs = loc_ind_trace_now_ns() - startNs;
+  stats.traceSpanNs = lastTs - firstTs;
+  stats.requests = locClientReplayRequests - requestsBefore;
+
+  LOC_LOGI("%s:%d]: replayed %u events, %u resps, %u skipped in %llu ms\n",
+           __func__, __LINE__, stats.events, stats.resps, stats.skipped,
+           (unsigned long long)(stats.replayNs / 1000000));
+
+  if(NULL != pStats)
+  {
+    *pStats = stats;
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOC_API_V02_REPLAY_H
+#define LOC_API_V02_REPLAY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include "loc_api_v02_trace.h"
+
+/* Stand-in locClient layer that has no QMI transport. It is built into a
+   variant of libloc_api_v02 (see Android.mk) so that the whole HAL above
+   LocApiV02 can be driven from a trace captured with QMI_IND_TRACE_FILE.
+   Requests are answered immediately with a zeroed (successful) response
+   indication, indications come only from locClientReplayRun(). */
+
+/* Called right before each replayed indication is dispatched */
+typedef void (*locClientReplayHookType)(
+      uint32_t                 msgId,
+      locIndTraceTypeEnumT     type,
+      const void*              payload,
+      uint32_t                 size,
+      uint64_t                 dispatchNs,
+      void*                    pCookie);
+
+typedef struct
+{
+  uint32_t events;           /* event indications dispatched */
+  uint32_t resps;            /* response indications dispatched */
+  uint32_t skipped;          /* records with an unknown id or bad size */
+  uint32_t requests;         /* requests answered by the stand-in */
+  uint64_t traceSpanNs;      /* last - first record timestamp */
+  uint64_t replayNs;         /* wall time spent replaying */
+  uint64_t maxLagNs;         /* worst dispatch lateness in real time mode */
+}locClientReplayStatsT;
+
+/* Replays the trace at path into the open client(s). With realTime the
+   recorded inter-indication spacing is kept, otherwise records are
+   dispatched back to back. Waits up to waitForClientMs for LocApiV02 to
+   open its client. Returns 0 on success, -1 on error. */
+extern int locClientReplayRun(const char* path,
+                              bool realTime,
+                              uint32_t waitForClientMs,
+                              locClientReplayHookType hook,
+                              void* pCookie,
+                              locClientReplayStatsT* pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOC_API_V02_REPLAY_H */
@@ -0,0 +1,241 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <loc_cfg.h>
+#include "loc_api_v02_trace.h"
+
+/* Logging */
+// Uncomment to log verbose logs
+#define LOG_NDEBUG 1
+
+// log debug logs
+#define LOG_NDDEBUG 1
+#define LOG_TAG "LocSvc_api_v02"
+#include "loc_util_log.h"
+
+#define GPS_CONF_FILE "/etc/gps.conf"
+
+/* Path of the capture file, configurable with QMI_IND_TRACE_FILE in
+   gps.conf; capturing is off when it is empty */
+static char QMI_IND_TRACE_FILE[LOC_MAX_PARAM_STRING] = "";
+
+static const loc_param_s_type loc_ind_trace_param_table[] =
+{
+   {"QMI_IND_TRACE_FILE", &QMI_IND_TRACE_FILE, NULL, 's'},
+};
+
+static pthread_once_t loc_ind_trace_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t loc_ind_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile int loc_ind_trace_fd = -1;
+
+uint64_t loc_ind_trace_now_ns()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void loc_ind_trace_read_conf()
+{
+   UTIL_READ_CONF(GPS_CONF_FILE, loc_ind_trace_param_table);
+   if ('\0' != QMI_IND_TRACE_FILE[0])
+   {
+      loc_ind_trace_start(QMI_IND_TRACE_FILE);
+   }
+}
+
+void loc_ind_trace_init()
+{
+   pthread_once(&loc_ind_trace_once, loc_ind_trace_read_conf);
+}
+
+bool loc_ind_trace_start(const char* path)
+{
+   locIndTraceFileHeaderT header;
+   int fd;
+
+   if (NULL == path)
+   {
+      return false;
+   }
+
+   fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0640);
+   if (fd < 0)
+   {
+      LOC_LOGE("%s:%d]: could not open %s, %s\n",
+               __func__, __LINE__, path, strerror(errno));
+      return false;
+   }
+
+   header.magic = LOC_IND_TRACE_MAGIC;
+   header.version = LOC_IND_TRACE_VERSION;
+   header.recordHeaderSize = sizeof(locIndTraceRecordHeaderT);
+   if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header))
+   {
+      LOC_LOGE("%s:%d]: could not write header to %s\n",
+               __func__, __LINE__, path);
+      close(fd);
+      return false;
+   }
+
+   pthread_mutex_lock(&loc_ind_trace_mutex);
+   if (loc_ind_trace_fd >= 0)
+   {
+      close(loc_ind_trace_fd);
+   }
+   loc_ind_trace_fd = fd;
+   pthread_mutex_unlock(&loc_ind_trace_mutex);
+
+   LOC_LOGI("%s:%d]: capturing QMI indications to %s\n",
+            __func__, __LINE__, path);
+   return true;
+}
+
+void loc_ind_trace_stop()
+{
+   pthread_mutex_lock(&loc_ind_trace_mutex);
+   if (loc_ind_trace_fd >= 0)
+   {
+      close(loc_ind_trace_fd);
+      loc_ind_trace_fd = -1;
+   }
+   pthread_mutex_unlock(&loc_ind_trace_mutex);
+}
+
+bool loc_ind_trace_enabled()
+{
+   return loc_ind_trace_fd >= 0;
+}
+
+void loc_ind_trace_record(uint32_t msgId,
+                          locIndTraceTypeEnumT type,
+                          const void* payload,
+                          uint32_t size)
+{
+   locIndTraceRecordHeaderT header;
+   struct iovec iov[2];
+   ssize_t len;
+
+   // unlocked check, so that the indication path pays nothing when off
+   if (loc_ind_trace_fd < 0)
+   {
+      return;
+   }
+
+   header.msgId = msgId;
+   header.type = type;
+   header.size = (NULL == payload) ? 0 : size;
+   header.reserved = 0;
+   header.timestampNs = loc_ind_trace_now_ns();
+
+   iov[0].iov_base = &header;
+   iov[0].iov_len = sizeof(header);
+   iov[1].iov_base = (void*)payload;
+   iov[1].iov_len = header.size;
+   len = sizeof(header) + header.size;
+
+   // one writev per record keeps records whole in an O_APPEND file
+   pthread_mutex_lock(&loc_ind_trace_mutex);
+   if (loc_ind_trace_fd >= 0 &&
+       writev(loc_ind_trace_fd, iov, 2) != len)
+   {
+      LOC_LOGE("%s:%d]: trace write failed, %s; capture stopped\n",
+               __func__, __LINE__, strerror(errno));
+      close(loc_ind_trace_fd);
+      loc_ind_trace_fd = -1;
+   }
+   pthread_mutex_unlock(&loc_ind_trace_mutex);
+}
+
+FILE* loc_ind_trace_open(const char* path)
+{
+   locIndTraceFileHeaderT header;
+   FILE* trace = fopen(path, "rb");
+
+   if (NULL == trace)
+   {
+      LOC_LOGE("%s:%d]: could not open %s, %s\n",
+               __func__, __LINE__, path, strerror(errno));
+      return NULL;
+   }
+
+   if (fread(&header, sizeof(header), 1, trace) != 1 ||
+       LOC_IND_TRACE_MAGIC != header.magic ||
+       LOC_IND_TRACE_VERSION != header.version ||
+       sizeof(locIndTraceRecordHeaderT) != header.recordHeaderSize)
+   {
+      LOC_LOGE("%s:%d]: %s is not a QMI indication trace\n",
+               __func__, __LINE__, path);
+      fclose(trace);
+      return NULL;
+   }
+
+   return trace;
+}
+
+bool loc_ind_trace_read(FILE* trace,
+                        locIndTraceRecordHeaderT* pHeader,
+                        void** pPayload)
+{
+   void* payload = NULL;
+
+   if (NULL == trace || NULL == pHeader || NULL == pPayload ||
+       fread(pHeader, sizeof(*pHeader), 1, trace) != 1)
+   {
+      return false;
+   }
+
+   // always hand out a buffer, even for empty indications
+   payload = calloc(1, pHeader->size > 0 ? pHeader->size : 1);
+   if (NULL == payload)
+   {
+      LOC_LOGE("%s:%d]: out of memory for %u bytes\n",
+               __func__, __LINE__, pHeader->size);
+      return false;
+   }
+
+   if (pHeader->size > 0 &&
+       fread(payload, pHeader->size, 1, trace) != 1)
+   {
+      LOC_LOGE("%s:%d]: truncated record for msg id %u\n",
+               __func__, __LINE__, pHeader->msgId);
+      free(payload);
+      return false;
+   }
+
+   *pPayload = payload;
+   return true;
+}
@@ -0,0 +1,109 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOC_API_V02_TRACE_H
+#define LOC_API_V02_TRACE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Binary trace of decoded QMI_LOC indications.
+
+   A trace file starts with a locIndTraceFileHeaderT, followed by one
+   record per indication: a locIndTraceRecordHeaderT and then exactly
+   'size' bytes of decoded payload (the qmiLoc*IndMsgT_v02 struct as it
+   was handed to the client callbacks). All fields are in host order,
+   traces are meant to be replayed on the same target ABI. */
+
+#define LOC_IND_TRACE_MAGIC    (0x51494C43)  /* "CLIQ" little endian */
+#define LOC_IND_TRACE_VERSION  (1)
+
+typedef enum
+{
+  eLOC_IND_TRACE_EVENT = 0,     /* event indication */
+  eLOC_IND_TRACE_RESP  = 1      /* response indication */
+}locIndTraceTypeEnumT;
+
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recordHeaderSize;    /* sizeof(locIndTraceRecordHeaderT) */
+}locIndTraceFileHeaderT;
+
+typedef struct
+{
+  uint32_t msgId;               /* QMI_LOC_*_IND_V02 */
+  uint32_t type;                /* locIndTraceTypeEnumT */
+  uint32_t size;                /* payload size in bytes */
+  uint32_t reserved;
+  uint64_t timestampNs;         /* CLOCK_MONOTONIC at decode time */
+}locIndTraceRecordHeaderT;
+
+/* Reads QMI_IND_TRACE_FILE from gps.conf once and starts capturing if it
+   is set. Safe to call multiple times. */
+extern void loc_ind_trace_init();
+
+/* Starts capturing to path, truncating it; returns false on error */
+extern bool loc_ind_trace_start(const char* path);
+
+/* Stops capturing and closes the trace file */
+extern void loc_ind_trace_stop();
+
+/* true if indications are being captured */
+extern bool loc_ind_trace_enabled();
+
+/* Appends one decoded indication to the trace, no-op when not capturing */
+extern void loc_ind_trace_record(uint32_t msgId,
+                                 locIndTraceTypeEnumT type,
+                                 const void* payload,
+                                 uint32_t size);
+
+/* Opens a trace for reading and validates its header; NULL on error */
+extern FILE* loc_ind_trace_open(const char* path);
+
+/* Reads the next record. On success *pPayload points to a malloc'ed
+   buffer of pHeader->size bytes that the caller frees. Returns false at
+   end of trace or on a truncated record. */
+extern bool loc_ind_trace_read(FILE* trace,
+                               locIndTraceRecordHeaderT* pHeader,
+                               void** pPayload);
+
+/* Current CLOCK_MONOTONIC time in ns */
+extern uint64_t loc_ind_trace_now_ns();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOC_API_V02_TRACE_H */
@@ -0,0 +1,287 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Replays a QMI_LOC indication trace (captured with QMI_IND_TRACE_FILE in
+   gps.conf) through the full HAL stack and reports throughput and the
+   latency from indication dispatch to the framework location callback.
+
+   The HAL has to be loaded against the replay variant of libloc_api_v02,
+   which is installed in its own directory:
+
+     LD_LIBRARY_PATH=/system/vendor/lib/loc_replay loc_replay \
+         [-r] [-w wait_ms] [-h hal_lib] trace_file
+
+   -r keeps the recorded indication spacing, the default replays as fast
+   as the stack consumes indications.
+
+   gps/host builds the same stack for the host, so a trace pulled off a
+   device can be replayed with "make replay TRACE=trace_file" there. */
+
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_replay"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include <hardware/gps.h>
+#include <loc_api_v02_replay.h>
+#include <location_service_v02.h>
+
+#define LOC_REPLAY_HAL_LIB        "/system/lib/hw/gps.msm8974.so"
+#define LOC_REPLAY_API_LIB        "libloc_api_v02.so"
+#define LOC_REPLAY_WAIT_MS        (5000)
+#define LOC_REPLAY_DRAIN_US       (200000)
+// position indications in flight between dispatch and location_cb
+#define LOC_REPLAY_INFLIGHT_MAX   (64)
+
+typedef int (*locClientReplayRunType)(const char*, bool, uint32_t,
+                                      locClientReplayHookType, void*,
+                                      locClientReplayStatsT*);
+
+struct LocReplayInFlight {
+    uint64_t utcMs;
+    uint64_t dispatchNs;
+};
+
+static pthread_mutex_t sMutex = PTHREAD_MUTEX_INITIALIZER;
+static LocReplayInFlight sInFlight[LOC_REPLAY_INFLIGHT_MAX];
+static uint32_t sInFlightNext = 0;
+static std::vector<uint64_t> sLatencyNs;
+static uint32_t sLocations = 0;
+static uint32_t sUnmatched = 0;
+static uint32_t sSvReports = 0;
+static uint32_t sNmea = 0;
+
+// same clock as the dispatch timestamps handed to replay_hook
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// remember when each position report was handed to LocApiV02, keyed by
+// its UTC timestamp which LocApiV02 passes on unchanged to the framework
+static void replay_hook(uint32_t msgId, locIndTraceTypeEnumT type,
+                        const void* payload, uint32_t size,
+                        uint64_t dispatchNs, void* cookie)
+{
+    const qmiLocEventPositionReportIndMsgT_v02* report =
+        (const qmiLocEventPositionReportIndMsgT_v02*)payload;
+
+    if (eLOC_IND_TRACE_EVENT == type &&
+        QMI_LOC_EVENT_POSITION_REPORT_IND_V02 == msgId &&
+        sizeof(*report) == size && report->timestampUtc_valid) {
+        pthread_mutex_lock(&sMutex);
+        LocReplayInFlight& slot =
+            sInFlight[sInFlightNext++ % LOC_REPLAY_INFLIGHT_MAX];
+        slot.utcMs = report->timestampUtc;
+        slot.dispatchNs = dispatchNs;
+        pthread_mutex_unlock(&sMutex);
+    }
+}
+
+static void location_cb(GpsLocation* location)
+{
+    uint64_t now = now_ns();
+    bool matched = false;
+
+    pthread_mutex_lock(&sMutex);
+    sLocations++;
+    for (uint32_t i = 0; i < LOC_REPLAY_INFLIGHT_MAX && !matched; i++) {
+        LocReplayInFlight& slot = sInFlight[i];
+        if (slot.dispatchNs != 0 &&
+            slot.utcMs == (uint64_t)location->timestamp) {
+            sLatencyNs.push_back(now - slot.dispatchNs);
+            slot.dispatchNs = 0;
+            matched = true;
+        }
+    }
+    if (!matched) {
+        sUnmatched++;
+    }
+    pthread_mutex_unlock(&sMutex);
+}
+
+static void status_cb(GpsStatus* status) {}
+static void sv_status_cb(GpsSvStatus* sv_info) { sSvReports++; }
+static void nmea_cb(GpsUtcTime timestamp, const char* nmea, int length)
+{
+    sNmea++;
+}
+static void set_capabilities_cb(uint32_t capabilities) {}
+static void acquire_wakelock_cb() {}
+static void release_wakelock_cb() {}
+static void request_utc_time_cb() {}
+
+struct LocReplayThreadArgs {
+    void (*start)(void*);
+    void* arg;
+};
+
+static void* replay_thread_entry(void* data)
+{
+    LocReplayThreadArgs args = *(LocReplayThreadArgs*)data;
+    delete (LocReplayThreadArgs*)data;
+    args.start(args.arg);
+    return NULL;
+}
+
+static pthread_t create_thread_cb(const char* name, void (*start)(void*),
+                                  void* arg)
+{
+    pthread_t tid = 0;
+    LocReplayThreadArgs* args = new LocReplayThreadArgs;
+    args->start = start;
+    args->arg = arg;
+    if (pthread_create(&tid, NULL, replay_thread_entry, args)) {
+        delete args;
+        return 0;
+    }
+    return tid;
+}
+
+static uint64_t percentile(const std::vector<uint64_t>& sorted, int pct)
+{
+    return sorted.empty() ? 0 : sorted[(sorted.size() - 1) * pct / 100];
+}
+
+int main(int argc, char** argv)
+{
+    const char* halLib = LOC_REPLAY_HAL_LIB;
+    uint32_t waitMs = LOC_REPLAY_WAIT_MS;
+    bool realTime = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "rw:h:")) != -1) {
+        switch (opt) {
+        case 'r': realTime = true; break;
+        case 'w': waitMs = atoi(optarg); break;
+        case 'h': halLib = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-r] [-w wait_ms] [-h hal_lib] "
+                    "trace_file\n", argv[0]);
+            return 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-r] [-w wait_ms] [-h hal_lib] "
+                "trace_file\n", argv[0]);
+        return 1;
+    }
+
+    void* hal = dlopen(halLib, RTLD_NOW);
+    const GpsInterface* (*getGpsInterface)() = (NULL == hal) ? NULL :
+        (const GpsInterface* (*)())dlsym(hal, "get_gps_interface");
+    const GpsInterface* gps = (NULL == getGpsInterface) ? NULL :
+        getGpsInterface();
+    if (NULL == gps) {
+        fprintf(stderr, "could not load gps interface from %s: %s\n",
+                halLib, dlerror());
+        return 1;
+    }
+
+    // the HAL loads libloc_api_v02 itself; this finds the same instance
+    void* api = dlopen(LOC_REPLAY_API_LIB, RTLD_NOW);
+    locClientReplayRunType replayRun = (NULL == api) ? NULL :
+        (locClientReplayRunType)dlsym(api, "locClientReplayRun");
+    if (NULL == replayRun) {
+        fprintf(stderr, "%s is not the replay variant, "
+                "check LD_LIBRARY_PATH\n", LOC_REPLAY_API_LIB);
+        return 1;
+    }
+
+    GpsCallbacks callbacks;
+    memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.size = sizeof(callbacks);
+    callbacks.location_cb = location_cb;
+    callbacks.status_cb = status_cb;
+    callbacks.sv_status_cb = sv_status_cb;
+    callbacks.nmea_cb = nmea_cb;
+    callbacks.set_capabilities_cb = set_capabilities_cb;
+    callbacks.acquire_wakelock_cb = acquire_wakelock_cb;
+    callbacks.release_wakelock_cb = release_wakelock_cb;
+    callbacks.create_thread_cb = create_thread_cb;
+    callbacks.request_utc_time_cb = request_utc_time_cb;
+
+    if (gps->init(&callbacks) != 0) {
+        fprintf(stderr, "gps init failed\n");
+        return 1;
+    }
+    gps->start();
+
+    locClientReplayStatsT stats;
+    int ret = replayRun(argv[optind], realTime, waitMs, replay_hook, NULL,
+                        &stats);
+    // let the HAL threads deliver what is still queued
+    usleep(LOC_REPLAY_DRAIN_US);
+    gps->stop();
+    gps->cleanup();
+
+    if (ret != 0) {
+        fprintf(stderr, "replay of %s failed\n", argv[optind]);
+        return 1;
+    }
+
+    pthread_mutex_lock(&sMutex);
+    std::vector<uint64_t> sorted(sLatencyNs);
+    pthread_mutex_unlock(&sMutex);
+    std::sort(sorted.begin(), sorted.end());
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        sum += sorted[i];
+    }
+    uint32_t total = stats.events + stats.resps;
+    double replaySec = stats.replayNs / 1e9;
+
+    printf("mode            %s\n", realTime ? "real time" : "max speed");
+    printf("indications     %u (%u events, %u resps, %u skipped)\n",
+           total, stats.events, stats.resps, stats.skipped);
+    printf("requests        %u\n", stats.requests);
+    printf("trace span      %.3f s\n", stats.traceSpanNs / 1e9);
+    printf("replay time     %.3f s\n", replaySec);
+    printf("throughput      %.1f ind/s\n",
+           replaySec > 0 ? total / replaySec : 0.0);
+    printf("max lag         %.3f ms\n", stats.maxLagNs / 1e6);
+    printf("callbacks       %u locations (%u unmatched), %u sv, %u nmea\n",
+           sLocations, sUnmatched, sSvReports, sNmea);
+    printf("ind->location   n=%zu avg=%.1f us p50=%.1f us p99=%.1f us "
+           "max=%.1f us\n", sorted.size(),
+           sorted.empty() ? 0.0 : sum / 1e3 / sorted.size(),
+           percentile(sorted, 50) / 1e3, percentile(sorted, 99) / 1e3,
+           sorted.empty() ? 0.0 : sorted.back() / 1e3);
+    return 0;
+}
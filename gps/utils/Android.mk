@@ -23,7 +23,9 @@ LOCAL_SRC_FILES += \
     LocTimer.cpp \
     LocThread.cpp \
     MsgTask.cpp \
-    loc_misc_utils.cpp
+    loc_misc_utils.cpp \
+    loc_trace.cpp \
+    loc_thread_policy.cpp
 
 LOCAL_CFLAGS += \
      -fno-short-enums \
@@ -57,7 +59,8 @@ LOCAL_COPY_HEADERS:= \
    platform_lib_abstractions/platform_lib_includes.h \
    platform_lib_abstractions/platform_lib_time.h \
    platform_lib_abstractions/platform_lib_macros.h \
-   loc_misc_utils.h
+   loc_misc_utils.h \
+   loc_thread_policy.h
 
 LOCAL_MODULE := libgps.utils
 LOCAL_CLANG := false
@@ -67,5 +70,22 @@ LOCAL_MODULE_TAGS := optional
 LOCAL_PRELINK_MODULE := false
 
 include $(BUILD_SHARED_LIBRARY)
+
+# reads the binary trace of tracing processes, see log_util.h
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := loc_trace_dump
+LOCAL_MODULE_TAGS := debug
+
+LOCAL_SRC_FILES := loc_trace_dump.c
+
+LOCAL_CFLAGS += \
+     -fno-short-enums \
+     -D_ANDROID_
+
+LOCAL_C_INCLUDES:= \
+    $(LOCAL_PATH)/platform_lib_abstractions
+
+include $(BUILD_EXECUTABLE)
 endif # not BUILD_TINY_ANDROID
 #endif # BOARD_VENDOR_QCOM_GPS_LOC_API_HARDWARE
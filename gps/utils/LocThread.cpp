@@ -27,6 +27,7 @@
  *
  */
 #include <LocThread.h>
+#include <loc_thread_policy.h>
 #include <string.h>
 #include <pthread.h>
 
@@ -36,6 +37,7 @@ class LocThreadDelegate {
     pthread_t mThandle;
     pthread_mutex_t mMutex;
     int mRefCount;
+    char mName[16];
     ~LocThreadDelegate();
     LocThreadDelegate(LocThread::tCreate creator, const char* threadName,
                       LocRunnable* runnable, bool joinable);
@@ -71,6 +73,9 @@ LocThreadDelegate::LocThreadDelegate(LocThread::tCreate creator,
     if (!threadName) {
         threadName = "LocThread";
     }
+    // truncated to what pthread_setname_np() takes, the thread
+    // policy is looked up by this name too
+    strlcpy(mName, threadName, sizeof(mName));
 
     // create the thread here, then if successful
     // and a name is given, we set the thread name
@@ -82,13 +87,8 @@ LocThreadDelegate::LocThreadDelegate(LocThread::tCreate creator,
     }
 
     if (mThandle) {
-        // set thread name
-        char lname[16];
-        int len = sizeof(lname) - 1;
-        memcpy(lname, threadName, len);
-        lname[len] = 0;
         // set the thread name here
-        pthread_setname_np(mThandle, lname);
+        pthread_setname_np(mThandle, mName);
 
         // detach, if not joinable
         if (!joinable) {
@@ -181,6 +181,8 @@ void* LocThreadDelegate::threadMain(void* arg) {
         if (runnable) {
             if (locThread->isRunning()) {
                 runnable->prerun();
+                // after prerun(), which may set a policy of its own
+                loc_thread_policy_apply(locThread->mName);
             }
 
             while (locThread->isRunning() && runnable->run());
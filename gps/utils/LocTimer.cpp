@@ -67,13 +67,16 @@ LocTimerContainer - core of the timer service. It is a container (derived from
                     There are 2 of such containers, one for sw timers (or Linux
                     timers) one for hw timers (or Linux alarms). It adds one of
                     each (those that expire the soonest) to kernel via services
-                    provided by LocTimerPollTask. All the heap management on the
-                    LocTimerDelegate objs are done in the MsgTask context, such
-                    that synchronization is ensured.
+                    provided by LocTimerPollTask. The heap of each container is
+                    guarded by its mutex. Timers are added / removed on the
+                    client's thread and popped on expiration on the poll
+                    thread, with no thread in between.
 LocTimerPollTask - is a class that wraps timerfd and epoll POXIS APIs. It also
                    both implements LocRunnalbe with epoll_wait() in the run()
                    method. It is also a LocThread client, so as to loop the run
-                   method.
+                   method. Client callbacks are called on this thread, unless
+                   the client gave its LocTimer a MsgTask, in which case the
+                   expiration is posted straight to that MsgTask.
 LocTimerWrapper - a LocTimer client itself, to implement the existing C API with
                   APIs, loc_timer_start() and loc_timer_stop().
 
@@ -87,8 +90,8 @@ class LocTimerPollTask;
 // * contains the timers, and add / remove them into the heap
 // * provides and maps 2 of such containers, one for timers (or  mSwTimers), one
 //   for alarms (or mHwTimers);
-// * provides a polling thread;
-// * provides a MsgTask thread for synchronized add / remove / timer client callback.
+// * provides a polling thread, on which expired timers are popped;
+// * guards its heap with a mutex, for add / remove on the client threads.
 class LocTimerContainer : public LocHeap {
     // mutex to synchronize getters of static members
     static pthread_mutex_t mMutex;
@@ -96,17 +99,16 @@ class LocTimerContainer : public LocHeap {
     static LocTimerContainer* mSwTimers;
     // Container of alarms
     static LocTimerContainer* mHwTimers;
-    // Msg task to provider msg Q, sender and reader.
-    static MsgTask* mMsgTask;
     // Poll task to provide epoll call and threading to poll.
     static LocTimerPollTask* mPollTask;
     // timer / alarm fd
     int mDevFd;
+    // guards the heap and the timer fd setting
+    pthread_mutex_t mHeapMutex;
     // ctor
     LocTimerContainer(bool wakeOnExpire);
     // dtor
     ~LocTimerContainer();
-    static MsgTask* getMsgTaskLocked();
     static LocTimerPollTask* getPollTaskLocked();
     // extend LocHeap and pop if the top outRanks input
     LocTimerDelegate* popIfOutRanks(LocTimerDelegate& timer);
@@ -121,7 +123,8 @@ public:
     int getTimerFd();
     // add a timer / alarm obj into the container
     void add(LocTimerDelegate& timer);
-    // remove a timer / alarm obj from the container
+    // remove a timer / alarm obj from the container and delete it, unless
+    // it was popped on expiration already, then expire() deletes it
     void remove(LocTimerDelegate& timer);
     // handling of timer / alarm expiration
     void expire();
@@ -178,10 +181,15 @@ class LocTimerDelegate : public LocRankable {
     LocSharedLock* mLock;
     struct timespec mFutureTime;
     LocTimerContainer* mContainer;
+    const MsgTask* mMsgTask;
+    // chains the timers popped in one expiration
+    LocTimerDelegate* mNext;
     // not a complete obj, just ctor for LocRankable comparisons
     inline LocTimerDelegate(struct timespec& delay)
-        : mClient(NULL), mLock(NULL), mFutureTime(delay), mContainer(NULL) {}
+        : mClient(NULL), mLock(NULL), mFutureTime(delay), mContainer(NULL),
+          mMsgTask(NULL), mNext(NULL) {}
     inline ~LocTimerDelegate() { if (mLock) { mLock->drop(); mLock = NULL; } }
+    void deliver();
 public:
     LocTimerDelegate(LocTimer& client, struct timespec& futureTime, bool wakeOnExpire);
     void destroyLocked();
@@ -201,7 +209,6 @@ public:
 pthread_mutex_t LocTimerContainer::mMutex = PTHREAD_MUTEX_INITIALIZER;
 LocTimerContainer* LocTimerContainer::mSwTimers = NULL;
 LocTimerContainer* LocTimerContainer::mHwTimers = NULL;
-MsgTask* LocTimerContainer::mMsgTask = NULL;
 LocTimerPollTask* LocTimerContainer::mPollTask = NULL;
 
 // ctor - initialize timer heaps
@@ -210,6 +217,8 @@ LocTimerPollTask* LocTimerContainer::mPollTask = NULL;
 LocTimerContainer::LocTimerContainer(bool wakeOnExpire) :
     mDevFd(timerfd_create(wakeOnExpire ? CLOCK_BOOTTIME_ALARM : CLOCK_BOOTTIME, 0)) {
 
+    pthread_mutex_init(&mHeapMutex, NULL);
+
     if ((-1 == mDevFd) && (errno == EINVAL)) {
         LOC_LOGW("%s: timerfd_create failure, fallback to CLOCK_MONOTONIC - %s",
             __FUNCTION__, strerror(errno));
@@ -219,7 +228,6 @@ LocTimerContainer::LocTimerContainer(bool wakeOnExpire) :
     if (-1 != mDevFd) {
         // ensure we have the necessary resources created
         LocTimerContainer::getPollTaskLocked();
-        LocTimerContainer::getMsgTaskLocked();
     } else {
         LOC_LOGE("%s: timerfd_create failure - %s", __FUNCTION__, strerror(errno));
     }
@@ -230,6 +238,7 @@ LocTimerContainer::LocTimerContainer(bool wakeOnExpire) :
 inline
 LocTimerContainer::~LocTimerContainer() {
     close(mDevFd);
+    pthread_mutex_destroy(&mHeapMutex);
 }
 
 LocTimerContainer* LocTimerContainer::get(bool wakeOnExpire) {
@@ -252,14 +261,6 @@ LocTimerContainer* LocTimerContainer::get(bool wakeOnExpire) {
     return container;
 }
 
-MsgTask* LocTimerContainer::getMsgTaskLocked() {
-    // it is cheap to check pointer first than locking mutext unconditionally
-    if (!mMsgTask) {
-        mMsgTask = new MsgTask("LocTimerMsgTask", false);
-    }
-    return mMsgTask;
-}
-
 LocTimerPollTask* LocTimerContainer::getPollTaskLocked() {
     // it is cheap to check pointer first than locking mutext unconditionally
     if (!mPollTask) {
@@ -305,79 +306,72 @@ void LocTimerContainer::updateSoonestTime(LocTimerDelegate* priorTop) {
     }
 }
 
-// all the heap management is done in the MsgTask context.
-inline
+// on the client's thread
 void LocTimerContainer::add(LocTimerDelegate& timer) {
-    struct MsgTimerPush : public LocMsg {
-        LocTimerContainer* mTimerContainer;
-        LocHeapNode* mTree;
-        LocTimerDelegate* mTimer;
-        inline MsgTimerPush(LocTimerContainer& container, LocTimerDelegate& timer) :
-            LocMsg(), mTimerContainer(&container), mTimer(&timer) {}
-        inline virtual void proc() const {
-            LocTimerDelegate* priorTop = mTimerContainer->getSoonestTimer();
-            mTimerContainer->push((LocRankable&)(*mTimer));
-            mTimerContainer->updateSoonestTime(priorTop);
-        }
-    };
-
-    mMsgTask->sendMsg(new MsgTimerPush(*this, timer));
+    pthread_mutex_lock(&mHeapMutex);
+    LocTimerDelegate* priorTop = getSoonestTimer();
+    push((LocRankable&)timer);
+    updateSoonestTime(priorTop);
+    pthread_mutex_unlock(&mHeapMutex);
 }
 
-// all the heap management is done in the MsgTask context.
+// on the client's thread, with the client's lock held
 void LocTimerContainer::remove(LocTimerDelegate& timer) {
-    struct MsgTimerRemove : public LocMsg {
-        LocTimerContainer* mTimerContainer;
-        LocTimerDelegate* mTimer;
-        inline MsgTimerRemove(LocTimerContainer& container, LocTimerDelegate& timer) :
-            LocMsg(), mTimerContainer(&container), mTimer(&timer) {}
-        inline virtual void proc() const {
-            LocTimerDelegate* priorTop = mTimerContainer->getSoonestTimer();
-
-            // update soonest timer only if mTimer is actually removed from
-            // mTimerContainer AND mTimer is not priorTop.
-            if (priorTop == ((LocHeap*)mTimerContainer)->remove((LocRankable&)*mTimer)) {
-                // if passing in NULL, we tell updateSoonestTime to update
-                // kernel with the current top timer interval.
-                mTimerContainer->updateSoonestTime(NULL);
-            }
-            // all timers are deleted here, and only here.
-            delete mTimer;
-        }
-    };
+    pthread_mutex_lock(&mHeapMutex);
+    LocTimerDelegate* priorTop = getSoonestTimer();
+    LocTimerDelegate* removed =
+        (LocTimerDelegate*)((LocHeap*)this)->remove((LocRankable&)timer);
+
+    // update soonest timer only if timer is actually removed from
+    // the heap AND timer was the priorTop.
+    if (NULL != removed && priorTop == removed) {
+        // if passing in NULL, we tell updateSoonestTime to update
+        // kernel with the current top timer interval.
+        updateSoonestTime(NULL);
+    }
+    pthread_mutex_unlock(&mHeapMutex);
 
-    mMsgTask->sendMsg(new MsgTimerRemove(*this, timer));
+    // if not in the heap, it has been popped by expire(), which has it
+    if (removed) {
+        delete removed;
+    }
 }
 
-// all the heap management is done in the MsgTask context.
+// on the poll thread.
 // Upon expire, we check and continuously pop the heap until
-// the top node's timeout is in the future.
+// the top node's timeout is in the future. The popped timers are
+// expired after the heap is unlocked, as their clients may start
+// and stop timers from their callbacks.
 void LocTimerContainer::expire() {
-    struct MsgTimerExpire : public LocMsg {
-        LocTimerContainer* mTimerContainer;
-        inline MsgTimerExpire(LocTimerContainer& container) :
-            LocMsg(), mTimerContainer(&container) {}
-        inline virtual void proc() const {
-            struct timespec now;
-            // get time spec of now
-            clock_gettime(CLOCK_BOOTTIME, &now);
-            LocTimerDelegate timerOfNow(now);
-            // pop everything in the heap that outRanks now, i.e. has time older than now
-            // and then call expire() on that timer.
-            for (LocTimerDelegate* timer = (LocTimerDelegate*)mTimerContainer->pop();
-                 NULL != timer;
-                 timer = mTimerContainer->popIfOutRanks(timerOfNow)) {
-                // the timer delegate obj will be deleted before the return of this call
-                timer->expire();
-            }
-            mTimerContainer->updateSoonestTime(NULL);
-        }
-    };
+    LocTimerDelegate* expired = NULL;
+    LocTimerDelegate** tail = &expired;
 
+    pthread_mutex_lock(&mHeapMutex);
     struct itimerspec delay = {0};
     timerfd_settime(getTimerFd(), TFD_TIMER_ABSTIME, &delay, NULL);
     mPollTask->removePoll(*this);
-    mMsgTask->sendMsg(new MsgTimerExpire(*this));
+
+    struct timespec now;
+    // get time spec of now
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    LocTimerDelegate timerOfNow(now);
+    // pop everything in the heap that outRanks now, i.e. has time older than now
+    for (LocTimerDelegate* timer = (LocTimerDelegate*)pop();
+         NULL != timer;
+         timer = popIfOutRanks(timerOfNow)) {
+        timer->mNext = NULL;
+        *tail = timer;
+        tail = &timer->mNext;
+    }
+    updateSoonestTime(NULL);
+    pthread_mutex_unlock(&mHeapMutex);
+
+    while (NULL != expired) {
+        LocTimerDelegate* timer = expired;
+        expired = timer->mNext;
+        // the timer delegate obj may be deleted before the return of this call
+        timer->expire();
+    }
 }
 
 LocTimerDelegate* LocTimerContainer::popIfOutRanks(LocTimerDelegate& timer) {
@@ -476,7 +470,9 @@ LocTimerDelegate::LocTimerDelegate(LocTimer& client, struct timespec& futureTime
     : mClient(&client),
       mLock(mClient->mLock->share()),
       mFutureTime(futureTime),
-      mContainer(LocTimerContainer::get(wakeOnExpire)) {
+      mContainer(LocTimerContainer::get(wakeOnExpire)),
+      mMsgTask(client.mMsgTask),
+      mNext(NULL) {
     // adding the timer into the container
     mContainer->add(*this);
 }
@@ -507,28 +503,74 @@ int LocTimerDelegate::ranks(LocRankable& rankable) {
         // larger time ranks lower!!!
         // IOW, if input obj has bigger tv_sec, this obj outRanks higher
         rank = timer->mFutureTime.tv_sec - mFutureTime.tv_sec;
+        // within the same second, or timers due in a second could be
+        // popped along with the one expiring now
+        if (0 == rank) {
+            rank = (timer->mFutureTime.tv_nsec > mFutureTime.tv_nsec) -
+                   (timer->mFutureTime.tv_nsec < mFutureTime.tv_nsec);
+        }
     }
     return rank;
 }
 
-inline
+// on the poll thread, once popped off the heap. From here on *this* obj
+// is deleted here or by the delivery on the client's MsgTask, not by
+// LocTimerContainer::remove().
 void LocTimerDelegate::expire() {
-    // keeping a copy of client pointer to be safe
-    // when timeOutCallback() is called at the end of this
-    // method, *this* obj may be already deleted.
+    struct MsgTimerDeliver : public LocMsg {
+        LocTimerDelegate* mTimer;
+        inline MsgTimerDeliver(LocTimerDelegate& timer) :
+            LocMsg(), mTimer(&timer) {}
+        inline ~MsgTimerDeliver() { delete mTimer; }
+        inline virtual void proc() const {
+            mTimer->deliver();
+        }
+    };
+
+    mLock->lock();
     LocTimer* client = mClient;
-    // force a stop, which will lead to delete of this obj
-    if (client && client->stop()) {
+    // so that a stop() from now on does not look in the heap for *this*
+    mContainer = NULL;
+    if (client && mMsgTask) {
+        // the client still sees the timer running until delivered
+        mMsgTask->sendMsg(new MsgTimerDeliver(*this));
+        mLock->unlock();
+        return;
+    }
+    if (client) {
+        // what stop() would do, the timer is no longer running
+        client->mTimer = NULL;
+    }
+    mLock->unlock();
+
+    if (client) {
         // calling client callback with a pointer save on the stack
-        // only if stop() returns true, i.e. it hasn't been stopped
-        // already.
+        client->timeOutCallback();
+    }
+    delete this;
+}
+
+// on the client's MsgTask, unless stopped meanwhile
+void LocTimerDelegate::deliver() {
+    mLock->lock();
+    LocTimer* client = mClient;
+    if (client) {
+        client->mTimer = NULL;
+    }
+    mLock->unlock();
+
+    if (client) {
         client->timeOutCallback();
     }
 }
 
 
 /***************************LocTimer methods***************************/
-LocTimer::LocTimer() : mTimer(NULL), mLock(new LocSharedLock()) {
+LocTimer::LocTimer() : mTimer(NULL), mLock(new LocSharedLock()), mMsgTask(NULL) {
+}
+
+LocTimer::LocTimer(const MsgTask* msgTask) :
+    mTimer(NULL), mLock(new LocSharedLock()), mMsgTask(msgTask) {
 }
 
 LocTimer::~LocTimer() {
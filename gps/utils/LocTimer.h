@@ -36,6 +36,7 @@
 // opaque class to provide service implementation.
 class LocTimerDelegate;
 class LocSharedLock;
+class MsgTask;
 
 // LocTimer client must extend this class and implementthe callback.
 // start() / stop() methods are to arm / disarm timer.
@@ -43,6 +44,7 @@ class LocTimer
 {
     LocTimerDelegate* mTimer;
     LocSharedLock* mLock;
+    const MsgTask* mMsgTask;
     // don't really want mLock to be manipulated by clients, yet LocTimer
     // has to have a reference to the lock so that the delete of LocTimer
     // and LocTimerDelegate can work together on their share resources.
@@ -50,6 +52,10 @@ class LocTimer
 
 public:
     LocTimer();
+    // timeOutCallback() is called on msgTask instead of the timer thread,
+    // with no hop in between. The timer counts as running until then, so
+    // a stop() on msgTask before the callback still cancels it.
+    LocTimer(const MsgTask* msgTask);
     virtual ~LocTimer();
 
     // timeOutInMs:  timeout delay in ms
@@ -67,7 +73,8 @@ public:
 
     //  LocTimer client Should implement this method.
     //  This method is used for timeout calling back to client. This method
-    //  should be short enough (eg: send a message to your own thread).
+    //  should be short enough (eg: send a message to your own thread), or
+    //  the timer be given the MsgTask to call it on.
     virtual void timeOutCallback() = 0;
 };
 
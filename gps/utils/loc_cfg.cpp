@@ -40,6 +40,11 @@
 #include <loc_cfg.h>
 #include <log_util.h>
 #include <loc_misc_utils.h>
+#include <LocThread.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
 #ifdef USE_GLIB
 #include <glib.h>
 #endif
@@ -54,12 +59,14 @@
 /* Parameter data */
 static uint32_t DEBUG_LEVEL = 0xff;
 static uint32_t TIMESTAMP = 0;
+static uint32_t TRACE_LEVEL = 0;
 
 /* Parameter spec table */
 static const loc_param_s_type loc_param_table[] =
 {
     {"DEBUG_LEVEL",    &DEBUG_LEVEL, NULL,    'n'},
     {"TIMESTAMP",      &TIMESTAMP,   NULL,    'n'},
+    {"TRACE_LEVEL",    &TRACE_LEVEL, NULL,    'n'},
 };
 static const int loc_param_num = sizeof(loc_param_table) / sizeof(loc_param_s_type);
 
@@ -158,6 +165,63 @@ int loc_set_config_entry(const loc_param_s_type* config_entry, loc_param_v_type*
     return ret;
 }
 
+/*===========================================================================
+FUNCTION loc_parse_conf_item
+
+DESCRIPTION
+   Splits a line of configuration item into its name and value, and parses
+   the value as a number and as a float.
+
+PARAMETERS:
+   input_buf : buffer contanis config item, tokenized in place
+   config_value: parsed item, pointing into input_buf
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   true if input_buf holds a config item
+
+SIDE EFFECTS
+   N/A
+===========================================================================*/
+static bool loc_parse_conf_item(char* input_buf, loc_param_v_type* config_value)
+{
+    char *lasts;
+    memset(config_value, 0, sizeof(*config_value));
+
+    /* Separate variable and value */
+    config_value->param_name = strtok_r(input_buf, "=", &lasts);
+    /* skip lines that do not contain "=" */
+    if (NULL == config_value->param_name) {
+        return false;
+    }
+    config_value->param_str_value = strtok_r(NULL, "=", &lasts);
+    /* skip lines that do not contain two operands */
+    if (NULL == config_value->param_str_value) {
+        return false;
+    }
+
+    /* Trim leading and trailing spaces */
+    loc_util_trim_space(config_value->param_name);
+    loc_util_trim_space(config_value->param_str_value);
+
+    /* Parse numerical value */
+    if ((strlen(config_value->param_str_value) >=3) &&
+        (config_value->param_str_value[0] == '0') &&
+        (tolower(config_value->param_str_value[1]) == 'x'))
+    {
+        /* hex */
+        config_value->param_int_value = (int) strtol(&config_value->param_str_value[2],
+                                                     (char**) NULL, 16);
+    }
+    else {
+        config_value->param_double_value = (double) atof(config_value->param_str_value); /* float */
+        config_value->param_int_value = atoi(config_value->param_str_value); /* dec */
+    }
+    return true;
+}
+
 /*===========================================================================
 FUNCTION loc_fill_conf_item
 
@@ -186,49 +250,464 @@ int loc_fill_conf_item(char* input_buf,
     int ret = 0;
 
     if (input_buf && config_table) {
-        char *lasts;
         loc_param_v_type config_value;
-        memset(&config_value, 0, sizeof(config_value));
-
-        /* Separate variable and value */
-        config_value.param_name = strtok_r(input_buf, "=", &lasts);
-        /* skip lines that do not contain "=" */
-        if (config_value.param_name) {
-            config_value.param_str_value = strtok_r(NULL, "=", &lasts);
-
-            /* skip lines that do not contain two operands */
-            if (config_value.param_str_value) {
-                /* Trim leading and trailing spaces */
-                loc_util_trim_space(config_value.param_name);
-                loc_util_trim_space(config_value.param_str_value);
-
-                /* Parse numerical value */
-                if ((strlen(config_value.param_str_value) >=3) &&
-                    (config_value.param_str_value[0] == '0') &&
-                    (tolower(config_value.param_str_value[1]) == 'x'))
-                {
-                    /* hex */
-                    config_value.param_int_value = (int) strtol(&config_value.param_str_value[2],
-                                                                (char**) NULL, 16);
-                }
-                else {
-                    config_value.param_double_value = (double) atof(config_value.param_str_value); /* float */
-                    config_value.param_int_value = atoi(config_value.param_str_value); /* dec */
+
+        if (loc_parse_conf_item(input_buf, &config_value)) {
+            for(uint32_t i = 0; NULL != config_table && i < table_length; i++)
+            {
+                if(!loc_set_config_entry(&config_table[i], &config_value)) {
+                    ret += 1;
                 }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/*=============================================================================
+ *
+ *                          CONFIGURATION STORE
+ *
+ * Every configuration file is parsed once into a hash table of its items,
+ * and loc_read_conf() fills the tables of its callers from there. A file is
+ * parsed again when stat() tells it has changed, or, for files with change
+ * callbacks registered, as soon as inotify reports a write to it. In the
+ * latter case the callbacks are called if any item has changed, so that
+ * clients can read their tables again.
+ *
+ * When a file has the same item more than once, the last one counts.
+ *
+ *============================================================================*/
+
+typedef struct loc_cfg_item_s
+{
+    loc_param_v_type value;
+    uint32_t hash;
+} loc_cfg_item_s_type;
+
+typedef struct loc_cfg_file_s
+{
+    char* path;
+    bool exists;
+    struct stat st;
+    /* items in the order of the file; the name and value strings of an item
+       point into its line in lines */
+    loc_cfg_item_s_type* items;
+    uint32_t item_count;
+    char (*lines)[LOC_MAX_PARAM_LINE];
+    /* open addressing, index of the item + 1, 0 for an empty slot */
+    uint32_t* slots;
+    uint32_t slot_mask;
+    /* re-parsed with changes the change callbacks have not been told of */
+    bool changed;
+    struct loc_cfg_file_s* next;
+} loc_cfg_file_s_type;
+
+typedef struct loc_cfg_cb_s
+{
+    char* path;
+    int wd;
+    loc_cfg_change_cb cb;
+    void* user_data;
+    struct loc_cfg_cb_s* next;
+} loc_cfg_cb_s_type;
+
+static pthread_mutex_t loc_cfg_mutex = PTHREAD_MUTEX_INITIALIZER;
+static loc_cfg_file_s_type* loc_cfg_files = NULL;
+static loc_cfg_cb_s_type* loc_cfg_cbs = NULL;
+
+static uint32_t loc_cfg_hash(const char* name)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
+
+static const loc_param_v_type* loc_cfg_find(const loc_cfg_file_s_type* file,
+                                            const char* name)
+{
+    if (0 == file->item_count) {
+        return NULL;
+    }
+    uint32_t hash = loc_cfg_hash(name);
+    for (uint32_t slot = hash & file->slot_mask; file->slots[slot];
+         slot = (slot + 1) & file->slot_mask) {
+        const loc_cfg_item_s_type* item = &file->items[file->slots[slot] - 1];
+        if (item->hash == hash && 0 == strcmp(item->value.param_name, name)) {
+            return &item->value;
+        }
+    }
+    return NULL;
+}
+
+static void loc_cfg_clear(loc_cfg_file_s_type* file)
+{
+    free(file->items);
+    free(file->lines);
+    free(file->slots);
+    file->items = NULL;
+    file->lines = NULL;
+    file->slots = NULL;
+    file->item_count = 0;
+    file->slot_mask = 0;
+}
+
+/* parses the file into file->items, replacing whatever was there */
+static void loc_cfg_parse(loc_cfg_file_s_type* file)
+{
+    loc_cfg_clear(file);
+    file->exists = (0 == stat(file->path, &file->st));
+    FILE* conf_fp = file->exists ? fopen(file->path, "r") : NULL;
+    if (NULL == conf_fp) {
+        file->exists = false;
+        return;
+    }
 
-                for(uint32_t i = 0; NULL != config_table && i < table_length; i++)
-                {
-                    if(!loc_set_config_entry(&config_table[i], &config_value)) {
-                        ret += 1;
-                    }
+    /* all lines first, the items point into them */
+    uint32_t line_count = 0, capacity = 0;
+    char input_buf[LOC_MAX_PARAM_LINE];
+    while (fgets(input_buf, LOC_MAX_PARAM_LINE, conf_fp)) {
+        if (line_count == capacity) {
+            uint32_t new_capacity = capacity ? capacity * 2 : 64;
+            char (*lines)[LOC_MAX_PARAM_LINE] = (char (*)[LOC_MAX_PARAM_LINE])
+                realloc(file->lines, new_capacity * sizeof(file->lines[0]));
+            if (NULL == lines) {
+                LOC_LOGE("%s: out of memory, %s truncated", __FUNCTION__,
+                         file->path);
+                break;
+            }
+            file->lines = lines;
+            capacity = new_capacity;
+        }
+        memcpy(file->lines[line_count++], input_buf, LOC_MAX_PARAM_LINE);
+    }
+    fclose(conf_fp);
+
+    file->items = (loc_cfg_item_s_type*)
+        malloc((line_count ? line_count : 1) * sizeof(file->items[0]));
+    for (uint32_t i = 0; NULL != file->items && i < line_count; i++) {
+        loc_cfg_item_s_type* item = &file->items[file->item_count];
+        /* comments can't name a parameter anyone asks for */
+        if (loc_parse_conf_item(file->lines[i], &item->value) &&
+            '#' != item->value.param_name[0]) {
+            item->hash = loc_cfg_hash(item->value.param_name);
+            file->item_count++;
+        }
+    }
+
+    uint32_t slots = 16;
+    while (slots < file->item_count * 2) {
+        slots <<= 1;
+    }
+    file->slots = (uint32_t*)calloc(slots, sizeof(uint32_t));
+    if (NULL == file->slots) {
+        LOC_LOGE("%s: out of memory, %s ignored", __FUNCTION__, file->path);
+        loc_cfg_clear(file);
+        return;
+    }
+    file->slot_mask = slots - 1;
+    for (uint32_t i = 0; i < file->item_count; i++) {
+        loc_cfg_item_s_type* item = &file->items[i];
+        uint32_t slot = item->hash & file->slot_mask;
+        while (file->slots[slot]) {
+            loc_cfg_item_s_type* other = &file->items[file->slots[slot] - 1];
+            if (other->hash == item->hash &&
+                0 == strcmp(other->value.param_name, item->value.param_name)) {
+                break;
+            }
+            slot = (slot + 1) & file->slot_mask;
+        }
+        /* a later item of the same name replaces the earlier one */
+        file->slots[slot] = i + 1;
+    }
+    LOC_LOGD("%s: %s, %u items", __FUNCTION__, file->path, file->item_count);
+}
+
+/* true if the file is not the one last parsed */
+static bool loc_cfg_stale(const loc_cfg_file_s_type* file)
+{
+    struct stat st;
+    if (0 != stat(file->path, &st)) {
+        return file->exists;
+    }
+    return !file->exists ||
+        st.st_ino != file->st.st_ino || st.st_dev != file->st.st_dev ||
+        st.st_size != file->st.st_size ||
+        st.st_mtim.tv_sec != file->st.st_mtim.tv_sec ||
+        st.st_mtim.tv_nsec != file->st.st_mtim.tv_nsec;
+}
+
+/* parses the file again; true if any item has changed */
+static bool loc_cfg_reload(loc_cfg_file_s_type* file)
+{
+    loc_cfg_file_s_type old = *file;
+    old.path = NULL;
+    file->items = NULL;
+    file->lines = NULL;
+    file->slots = NULL;
+    file->item_count = 0;
+    loc_cfg_parse(file);
+
+    bool changed = (old.exists != file->exists ||
+                    old.item_count != file->item_count);
+    for (uint32_t i = 0; !changed && i < file->item_count; i++) {
+        const loc_param_v_type* a = &old.items[i].value;
+        const loc_param_v_type* b = &file->items[i].value;
+        changed = (strcmp(a->param_name, b->param_name) ||
+                   strcmp(a->param_str_value, b->param_str_value));
+    }
+    loc_cfg_clear(&old);
+    return changed;
+}
+
+/* the file as last parsed, if ever; loc_cfg_mutex must be held */
+static loc_cfg_file_s_type* loc_cfg_lookup(const char* conf_file_name)
+{
+    loc_cfg_file_s_type* file = loc_cfg_files;
+    while (file && strcmp(file->path, conf_file_name)) {
+        file = file->next;
+    }
+    return file;
+}
+
+/* the parsed file, up to date; loc_cfg_mutex must be held */
+static loc_cfg_file_s_type* loc_cfg_get(const char* conf_file_name)
+{
+    loc_cfg_file_s_type* file = loc_cfg_lookup(conf_file_name);
+    if (NULL == file) {
+        file = (loc_cfg_file_s_type*)calloc(1, sizeof(*file));
+        if (NULL == file || NULL == (file->path = strdup(conf_file_name))) {
+            free(file);
+            return NULL;
+        }
+        file->next = loc_cfg_files;
+        loc_cfg_files = file;
+        loc_cfg_parse(file);
+    } else if (loc_cfg_stale(file) && loc_cfg_reload(file)) {
+        file->changed = true;
+    }
+    return file;
+}
+
+static void loc_cfg_fill(const loc_cfg_file_s_type* file,
+                         const loc_param_s_type* config_table,
+                         uint32_t table_length)
+{
+    for (uint32_t i = 0; i < table_length; i++) {
+        const loc_param_s_type* config_entry = &config_table[i];
+        /* Clear all validity bits */
+        if (NULL != config_entry->param_set) {
+            *(config_entry->param_set) = 0;
+        }
+        const loc_param_v_type* config_value =
+            loc_cfg_find(file, config_entry->param_name);
+        if (NULL != config_value) {
+            loc_set_config_entry(config_entry,
+                                 (loc_param_v_type*)config_value);
+        }
+    }
+}
+
+/* Blocks on inotify for writes to the files that have change callbacks */
+class LocCfgWatcher : public LocRunnable {
+    const int mFd;
+public:
+    inline LocCfgWatcher(int fd) : LocRunnable(), mFd(fd) {}
+    virtual bool run();
+};
+
+static int loc_cfg_inotify_fd = -1;
+
+bool LocCfgWatcher::run()
+{
+    char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t len = read(mFd, buf, sizeof(buf));
+    if (len <= 0) {
+        if (len < 0 && EINTR == errno) {
+            return true;
+        }
+        LOC_LOGE("%s: read failed, %s", __FUNCTION__, strerror(errno));
+        return false;
+    }
+
+    // the callbacks are called without the lock, they may read their tables
+    loc_cfg_cb_s_type* pending = NULL;
+    pthread_mutex_lock(&loc_cfg_mutex);
+    for (char* ptr = buf; ptr < buf + len; ) {
+        const struct inotify_event* event = (const struct inotify_event*)ptr;
+        ptr += sizeof(struct inotify_event) + event->len;
+        if (0 == event->len) {
+            continue;
+        }
+
+        bool changed = false, reloaded = false;
+        for (loc_cfg_cb_s_type* cb = loc_cfg_cbs; cb; cb = cb->next) {
+            const char* base = strrchr(cb->path, '/');
+            base = base ? base + 1 : cb->path;
+            if (cb->wd != event->wd || strcmp(base, event->name)) {
+                continue;
+            }
+            if (!reloaded) {
+                loc_cfg_file_s_type* file = loc_cfg_lookup(cb->path);
+                if (NULL != file) {
+                    changed = loc_cfg_reload(file) || file->changed;
+                    file->changed = false;
                 }
+                reloaded = true;
+                LOC_LOGI("%s: %s %s", __FUNCTION__, cb->path,
+                         changed ? "changed" : "unchanged");
             }
+            if (changed) {
+                loc_cfg_cb_s_type* copy =
+                    (loc_cfg_cb_s_type*)malloc(sizeof(*copy));
+                if (NULL != copy) {
+                    *copy = *cb;
+                    copy->path = strdup(cb->path);
+                    copy->next = pending;
+                    pending = copy;
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&loc_cfg_mutex);
+
+    while (pending) {
+        loc_cfg_cb_s_type* next = pending->next;
+        if (pending->path) {
+            pending->cb(pending->path, pending->user_data);
         }
+        free(pending->path);
+        free(pending);
+        pending = next;
     }
+    return true;
+}
+
+/*===========================================================================
+FUNCTION loc_cfg_register_change_cb
+
+DESCRIPTION
+   Registers a callback to be called, on a thread of the configuration
+   store, after the given configuration file has been changed on disk.
+   The callback typically calls loc_read_conf() again.
+
+PARAMETERS:
+   conf_file_name: configuration file to watch
+   cb: the callback
+   user_data: passed back to the callback
+
+DEPENDENCIES
+   N/A
 
+RETURN VALUE
+   0: success
+  -1: failure
+
+SIDE EFFECTS
+   N/A
+===========================================================================*/
+int loc_cfg_register_change_cb(const char* conf_file_name,
+                               loc_cfg_change_cb cb, void* user_data)
+{
+    int ret = -1;
+    if (NULL == conf_file_name || NULL == cb) {
+        return ret;
+    }
+
+    pthread_mutex_lock(&loc_cfg_mutex);
+    if (loc_cfg_inotify_fd < 0) {
+        int fd = inotify_init();
+        if (fd >= 0) {
+            // lives as long as the process
+            LocThread* watcher_thread = new LocThread();
+            LocCfgWatcher* watcher = new LocCfgWatcher(fd);
+            if (watcher_thread->start("loc_cfg_watcher", watcher, false)) {
+                loc_cfg_inotify_fd = fd;
+            } else {
+                delete watcher;
+                delete watcher_thread;
+                close(fd);
+            }
+        }
+    }
+
+    if (loc_cfg_inotify_fd >= 0) {
+        // watch the directory, files are often replaced rather than written
+        char dir[PATH_MAX];
+        const char* base = strrchr(conf_file_name, '/');
+        if (NULL == base) {
+            strlcpy(dir, ".", sizeof(dir));
+        } else if (base == conf_file_name) {
+            strlcpy(dir, "/", sizeof(dir));
+        } else {
+            strlcpy(dir, conf_file_name,
+                    (size_t)(base - conf_file_name) + 1 < sizeof(dir) ?
+                    (size_t)(base - conf_file_name) + 1 : sizeof(dir));
+        }
+        int wd = inotify_add_watch(loc_cfg_inotify_fd, dir,
+                                   IN_CLOSE_WRITE | IN_MOVED_TO |
+                                   IN_CREATE | IN_DELETE | IN_MOVED_FROM);
+        loc_cfg_cb_s_type* entry = (loc_cfg_cb_s_type*)malloc(sizeof(*entry));
+        if (wd >= 0 && NULL != entry &&
+            NULL != (entry->path = strdup(conf_file_name))) {
+            entry->wd = wd;
+            entry->cb = cb;
+            entry->user_data = user_data;
+            entry->next = loc_cfg_cbs;
+            loc_cfg_cbs = entry;
+            // have it parsed, so that changes can be told
+            loc_cfg_get(conf_file_name);
+            ret = 0;
+        } else {
+            LOC_LOGE("%s: can't watch %s, %s", __FUNCTION__, dir,
+                     strerror(errno));
+            free(entry);
+        }
+    }
+    pthread_mutex_unlock(&loc_cfg_mutex);
     return ret;
 }
 
+/*===========================================================================
+FUNCTION loc_cfg_unregister_change_cb
+
+DESCRIPTION
+   Removes a callback registered with loc_cfg_register_change_cb().
+
+PARAMETERS:
+   conf_file_name, cb, user_data: as registered
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+===========================================================================*/
+void loc_cfg_unregister_change_cb(const char* conf_file_name,
+                                  loc_cfg_change_cb cb, void* user_data)
+{
+    pthread_mutex_lock(&loc_cfg_mutex);
+    for (loc_cfg_cb_s_type** prev = &loc_cfg_cbs; *prev; ) {
+        loc_cfg_cb_s_type* entry = *prev;
+        if (entry->cb == cb && entry->user_data == user_data &&
+            0 == strcmp(entry->path, conf_file_name)) {
+            *prev = entry->next;
+            free(entry->path);
+            free(entry);
+        } else {
+            prev = &entry->next;
+        }
+    }
+    pthread_mutex_unlock(&loc_cfg_mutex);
+}
+
 /*===========================================================================
 FUNCTION loc_read_conf_r (repetitive)
 
@@ -380,21 +859,18 @@ SIDE EFFECTS
 void loc_read_conf(const char* conf_file_name, const loc_param_s_type* config_table,
                    uint32_t table_length)
 {
-    FILE *conf_fp = NULL;
-    char *lasts;
-    loc_param_v_type config_value;
-    uint32_t i;
-
-    if((conf_fp = fopen(conf_file_name, "r")) != NULL)
+    pthread_mutex_lock(&loc_cfg_mutex);
+    const loc_cfg_file_s_type* file = loc_cfg_get(conf_file_name);
+    if (NULL != file && file->exists)
     {
         LOC_LOGD("%s: using %s", __FUNCTION__, conf_file_name);
         if(table_length && config_table) {
-            loc_read_conf_r(conf_fp, config_table, table_length);
-            rewind(conf_fp);
+            loc_cfg_fill(file, config_table, table_length);
         }
-        loc_read_conf_r(conf_fp, loc_param_table, loc_param_num);
-        fclose(conf_fp);
+        loc_cfg_fill(file, loc_param_table, loc_param_num);
     }
+    pthread_mutex_unlock(&loc_cfg_mutex);
     /* Initialize logging mechanism with parsed data */
     loc_logger_init(DEBUG_LEVEL, TIMESTAMP);
+    loc_trace_init(TRACE_LEVEL);
 }
@@ -72,6 +72,9 @@ typedef struct
 extern "C" {
 #endif
 
+/* Called after a watched configuration file has changed on disk */
+typedef void (*loc_cfg_change_cb)(const char* conf_file_name, void* user_data);
+
 /*=============================================================================
  *
  *                       MODULE EXPORTED FUNCTIONS
@@ -84,6 +87,10 @@ int loc_read_conf_r(FILE *conf_fp, const loc_param_s_type* config_table,
                     uint32_t table_length);
 int loc_update_conf(const char* conf_data, int32_t length,
                     const loc_param_s_type* config_table, uint32_t table_length);
+int loc_cfg_register_change_cb(const char* conf_file_name,
+                               loc_cfg_change_cb cb, void* user_data);
+void loc_cfg_unregister_change_cb(const char* conf_file_name,
+                                  loc_cfg_change_cb cb, void* user_data);
 #ifdef __cplusplus
 }
 #endif
@@ -84,21 +84,18 @@ const char* loc_get_name_from_val(const loc_name_val_s_type table[], size_t tabl
    return UNKNOWN_STR;
 }
 
-static const loc_name_val_s_type loc_msg_q_status[] =
-{
-    NAME_VAL( eMSG_Q_SUCCESS ),
-    NAME_VAL( eMSG_Q_FAILURE_GENERAL ),
-    NAME_VAL( eMSG_Q_INVALID_PARAMETER ),
-    NAME_VAL( eMSG_Q_INVALID_HANDLE ),
-    NAME_VAL( eMSG_Q_UNAVAILABLE_RESOURCE ),
-    NAME_VAL( eMSG_Q_INSUFFICIENT_BUFFER )
-};
-static const size_t loc_msg_q_status_num = LOC_TABLE_SIZE(loc_msg_q_status);
-
 /* Find msg_q status name */
 const char* loc_get_msg_q_status(int status)
 {
-   return loc_get_name_from_val(loc_msg_q_status, loc_msg_q_status_num, (long) status);
+   switch (status) {
+   NAME_CASE( eMSG_Q_SUCCESS )
+   NAME_CASE( eMSG_Q_FAILURE_GENERAL )
+   NAME_CASE( eMSG_Q_INVALID_PARAMETER )
+   NAME_CASE( eMSG_Q_INVALID_HANDLE )
+   NAME_CASE( eMSG_Q_UNAVAILABLE_RESOURCE )
+   NAME_CASE( eMSG_Q_INSUFFICIENT_BUFFER )
+   default: return UNKNOWN_STR;
+   }
 }
 
 const char* log_succ_fail_string(int is_succ)
@@ -47,6 +47,16 @@ typedef struct
 
 #define NAME_VAL(x) {"" #x "", x }
 
+/* O(1) lookups, for names of values that are looked up per event.
+   NAME_CASE makes a case of a switch that returns the name of the value,
+   the compiler turns dense cases into a jump table. NAME_IDX makes an
+   entry of a (C only) array indexed by value, for LOC_NAME_FROM_IDX. */
+#define NAME_CASE(x) case x: return "" #x "";
+#define NAME_IDX(x) [x] = "" #x ""
+#define LOC_NAME_FROM_IDX(table, value)                                 \
+   (((unsigned long)(value) < LOC_TABLE_SIZE(table) && (table)[value]) ? \
+    (table)[value] : UNKNOWN_STR)
+
 #define UNKNOWN_STR "UNKNOWN"
 
 #define CHECK_MASK(type, value, mask_var, mask) \
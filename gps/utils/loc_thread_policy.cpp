@@ -0,0 +1,345 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define LOG_NDDEBUG 0
+#define LOG_TAG "LocSvc_thread"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fnmatch.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <loc_cfg.h>
+#include <loc_misc_utils.h>
+#include <loc_thread_policy.h>
+#include "log_util.h"
+
+#define GPS_CONF_FILE "/etc/gps.conf"
+
+/* Threads remembered for loc_thread_policy_report() */
+#define LOC_THREAD_POLICY_MAX_THREADS 32
+
+/* A rule of gps.conf reads, fields separated by single spaces,
+     THREAD_POLICY_<n> = <name pattern> <class> <priority> <nice> <cpus>
+   e.g. "LocTimer* fifo 2 0 4-7" or "LocEngResolver other 0 10 0-3".
+     name pattern - fnmatch() pattern on the thread name
+     class        - other, batch, idle, fifo or rr
+     priority     - real time priority, 1 - 99, for fifo and rr
+     nice         - -20 - 19, for other and batch
+     cpus         - CPU list, "0-3,6", or "-" to leave the affinity alone */
+typedef struct
+{
+    char pattern[LOC_MAX_PARAM_STRING];
+    int policy;
+    int priority;
+    int nice;
+    int has_cpus;
+    cpu_set_t cpus;
+} loc_thread_rule_s_type;
+
+typedef struct
+{
+    pid_t tid;
+    char name[16];
+    int rule;
+} loc_thread_entry_s_type;
+
+static char THREAD_POLICY[LOC_THREAD_POLICY_MAX_RULES][LOC_MAX_PARAM_STRING];
+
+static const loc_param_s_type loc_thread_policy_param_table[] =
+{
+    {"THREAD_POLICY_1", &THREAD_POLICY[0], NULL, 's'},
+    {"THREAD_POLICY_2", &THREAD_POLICY[1], NULL, 's'},
+    {"THREAD_POLICY_3", &THREAD_POLICY[2], NULL, 's'},
+    {"THREAD_POLICY_4", &THREAD_POLICY[3], NULL, 's'},
+    {"THREAD_POLICY_5", &THREAD_POLICY[4], NULL, 's'},
+    {"THREAD_POLICY_6", &THREAD_POLICY[5], NULL, 's'},
+    {"THREAD_POLICY_7", &THREAD_POLICY[6], NULL, 's'},
+    {"THREAD_POLICY_8", &THREAD_POLICY[7], NULL, 's'},
+};
+
+static pthread_once_t loc_thread_policy_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t loc_thread_policy_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t loc_thread_policy_key;
+static loc_thread_rule_s_type loc_thread_rules[LOC_THREAD_POLICY_MAX_RULES];
+static int loc_thread_rule_num = 0;
+static loc_thread_entry_s_type loc_thread_entries[LOC_THREAD_POLICY_MAX_THREADS];
+static int loc_thread_entry_next = 0;
+
+static const char* loc_thread_policy_name(int policy)
+{
+    switch (policy) {
+    case SCHED_OTHER: return "other";
+    case SCHED_FIFO:  return "fifo";
+    case SCHED_RR:    return "rr";
+    case SCHED_BATCH: return "batch";
+    case SCHED_IDLE:  return "idle";
+    default:          return "unknown";
+    }
+}
+
+static int loc_thread_policy_parse_class(const char* name)
+{
+    static const int policies[] =
+        { SCHED_OTHER, SCHED_FIFO, SCHED_RR, SCHED_BATCH, SCHED_IDLE };
+    for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++) {
+        if (0 == strcmp(name, loc_thread_policy_name(policies[i]))) {
+            return policies[i];
+        }
+    }
+    return -1;
+}
+
+/* "0-3,6" into 'cpus', false if malformed */
+static bool loc_thread_policy_parse_cpus(char* list, cpu_set_t* cpus)
+{
+    char* ranges[32];
+    int num = loc_util_split_string(list, ranges, 32, ',');
+
+    CPU_ZERO(cpus);
+    for (int i = 0; i < num; i++) {
+        char* end;
+        long first = strtol(ranges[i], &end, 10);
+        long last = first;
+        if (end == ranges[i]) {
+            return false;
+        }
+        if ('-' == *end) {
+            char* start = end + 1;
+            last = strtol(start, &end, 10);
+            if (end == start) {
+                return false;
+            }
+        }
+        if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            CPU_SET(cpu, cpus);
+        }
+    }
+    return num > 0;
+}
+
+/* parses the THREAD_POLICY_<n> strings, loc_thread_policy_lock held */
+static void loc_thread_policy_parse(void)
+{
+    loc_thread_rule_num = 0;
+    for (int i = 0; i < LOC_THREAD_POLICY_MAX_RULES; i++) {
+        char rule[LOC_MAX_PARAM_STRING];
+        char* fields[6];
+        strlcpy(rule, THREAD_POLICY[i], sizeof(rule));
+        if ('\0' == rule[0]) {
+            continue;
+        }
+
+        int num = loc_util_split_string(rule, fields, 6, ' ');
+        loc_thread_rule_s_type* r = &loc_thread_rules[loc_thread_rule_num];
+        if (num != 5 ||
+            (r->policy = loc_thread_policy_parse_class(fields[1])) < 0) {
+            LOC_LOGE("%s: THREAD_POLICY_%d \"%s\" is malformed",
+                     __func__, i + 1, THREAD_POLICY[i]);
+            continue;
+        }
+        strlcpy(r->pattern, fields[0], sizeof(r->pattern));
+        r->priority = atoi(fields[2]);
+        r->nice = atoi(fields[3]);
+        r->has_cpus = (0 != strcmp(fields[4], "-"));
+        if (r->has_cpus && !loc_thread_policy_parse_cpus(fields[4], &r->cpus)) {
+            LOC_LOGE("%s: THREAD_POLICY_%d has a bad CPU list", __func__, i + 1);
+            continue;
+        }
+        loc_thread_rule_num++;
+    }
+    LOC_LOGD("%s: %d thread policy rules", __func__, loc_thread_rule_num);
+}
+
+/* new rules only apply to threads started afterwards */
+static void loc_thread_policy_changed(const char* conf_file_name, void* user_data)
+{
+    pthread_mutex_lock(&loc_thread_policy_lock);
+    memset(THREAD_POLICY, 0, sizeof(THREAD_POLICY));
+    UTIL_READ_CONF(conf_file_name, loc_thread_policy_param_table);
+    loc_thread_policy_parse();
+    pthread_mutex_unlock(&loc_thread_policy_lock);
+}
+
+static void loc_thread_policy_init(void)
+{
+    pthread_key_create(&loc_thread_policy_key, NULL);
+    loc_thread_policy_changed(GPS_CONF_FILE, NULL);
+    loc_cfg_register_change_cb(GPS_CONF_FILE, loc_thread_policy_changed, NULL);
+}
+
+/* remembers the thread for the report, over the oldest one if full */
+static void loc_thread_policy_remember(pid_t tid, const char* name, int rule)
+{
+    loc_thread_entry_s_type* entry = NULL;
+    for (int i = 0; i < LOC_THREAD_POLICY_MAX_THREADS; i++) {
+        if (loc_thread_entries[i].tid == tid || 0 == loc_thread_entries[i].tid) {
+            entry = &loc_thread_entries[i];
+            break;
+        }
+    }
+    if (NULL == entry) {
+        entry = &loc_thread_entries[loc_thread_entry_next];
+        loc_thread_entry_next = (loc_thread_entry_next + 1) % LOC_THREAD_POLICY_MAX_THREADS;
+    }
+    entry->tid = tid;
+    strlcpy(entry->name, name, sizeof(entry->name));
+    entry->rule = rule;
+}
+
+void loc_thread_policy_apply(const char* name)
+{
+    pthread_once(&loc_thread_policy_once, loc_thread_policy_init);
+
+    // once per thread, threads not ours call this on every callback
+    if (NULL != pthread_getspecific(loc_thread_policy_key)) {
+        return;
+    }
+    pthread_setspecific(loc_thread_policy_key, (void*)1);
+
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+    loc_thread_rule_s_type rule;
+    int index = -1;
+
+    pthread_mutex_lock(&loc_thread_policy_lock);
+    for (int i = 0; i < loc_thread_rule_num; i++) {
+        if (0 == fnmatch(loc_thread_rules[i].pattern, name, 0)) {
+            rule = loc_thread_rules[i];
+            index = i;
+            break;
+        }
+    }
+    loc_thread_policy_remember(tid, name, index);
+    pthread_mutex_unlock(&loc_thread_policy_lock);
+
+    if (index < 0) {
+        return;
+    }
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    if (SCHED_FIFO == rule.policy || SCHED_RR == rule.policy) {
+        param.sched_priority = rule.priority;
+    }
+    int err = pthread_setschedparam(pthread_self(), rule.policy, &param);
+    if (0 != err) {
+        LOC_LOGE("%s: %s: %s %d failed: %s", __func__, name,
+                 loc_thread_policy_name(rule.policy), param.sched_priority,
+                 strerror(err));
+    }
+    if (SCHED_OTHER == rule.policy || SCHED_BATCH == rule.policy) {
+        if (0 != setpriority(PRIO_PROCESS, tid, rule.nice)) {
+            LOC_LOGE("%s: %s: nice %d failed: %s", __func__, name, rule.nice,
+                     strerror(errno));
+        }
+    }
+    if (rule.has_cpus && 0 != sched_setaffinity(tid, sizeof(rule.cpus), &rule.cpus)) {
+        LOC_LOGE("%s: %s: affinity failed: %s", __func__, name, strerror(errno));
+    }
+    LOC_LOGD("%s: %s (%d) set by THREAD_POLICY rule %d", __func__, name, tid, index + 1);
+}
+
+/* CPU the thread last ran on, field 39 of /proc/self/task/<tid>/stat */
+static int loc_thread_policy_current_cpu(pid_t tid)
+{
+    char path[64];
+    char buf[512];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+    FILE* fp = fopen(path, "r");
+    if (NULL == fp) {
+        return -1;
+    }
+    size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+    fclose(fp);
+    buf[len] = '\0';
+
+    // the name in field 2 may hold spaces, count from its closing ')'
+    char* p = strrchr(buf, ')');
+    int field = 2;
+    while (NULL != p && field < 39) {
+        p = strchr(p + 1, ' ');
+        field++;
+    }
+    return (NULL != p) ? atoi(p + 1) : -1;
+}
+
+void loc_thread_policy_report(void)
+{
+    loc_thread_entry_s_type entries[LOC_THREAD_POLICY_MAX_THREADS];
+
+    pthread_mutex_lock(&loc_thread_policy_lock);
+    memcpy(entries, loc_thread_entries, sizeof(entries));
+    pthread_mutex_unlock(&loc_thread_policy_lock);
+
+    for (int i = 0; i < LOC_THREAD_POLICY_MAX_THREADS; i++) {
+        pid_t tid = entries[i].tid;
+        if (0 == tid) {
+            continue;
+        }
+        int cpu = loc_thread_policy_current_cpu(tid);
+        if (cpu < 0) {
+            // gone
+            continue;
+        }
+
+        struct sched_param param;
+        int policy = sched_getscheduler(tid);
+        if (0 != sched_getparam(tid, &param)) {
+            param.sched_priority = 0;
+        }
+        errno = 0;
+        int nice = getpriority(PRIO_PROCESS, tid);
+
+        char allowed[64] = "";
+        cpu_set_t cpus;
+        if (0 == sched_getaffinity(tid, sizeof(cpus), &cpus)) {
+            size_t len = 0;
+            for (int c = 0; c < CPU_SETSIZE && len < sizeof(allowed) - 4; c++) {
+                if (CPU_ISSET(c, &cpus)) {
+                    len += snprintf(allowed + len, sizeof(allowed) - len,
+                                    len ? ",%d" : "%d", c);
+                }
+            }
+        }
+
+        LOC_LOGI("%s: %-15s tid %5d rule %d: %s prio %d nice %d cpus %s on cpu %d",
+                 __func__, entries[i].name, tid, entries[i].rule + 1,
+                 loc_thread_policy_name(policy), param.sched_priority, nice,
+                 allowed, cpu);
+    }
+}
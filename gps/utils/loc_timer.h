@@ -34,6 +34,8 @@
 extern "C" {
 #endif /* __cplusplus */
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 /*
     user_data: client context pointer, passthrough. Originally received
@@ -0,0 +1,566 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define LOG_NDDEBUG 0
+#define LOG_TAG "LocSvc_trace"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <cutils/atomic.h>
+#include "log_util.h"
+
+/* records per thread, a power of 2 */
+#define LOC_TRACE_RING_SIZE 256
+#define LOC_TRACE_RECORD_SIZE 192
+
+typedef enum {
+    LOC_TRACE_ARG_INT,
+    LOC_TRACE_ARG_LONG,
+    LOC_TRACE_ARG_LLONG,
+    LOC_TRACE_ARG_DOUBLE,
+    LOC_TRACE_ARG_PTR,
+    LOC_TRACE_ARG_STR
+} loc_trace_arg_e_type;
+
+#define LOC_TRACE_HEADER_SIZE (2 * sizeof(uint64_t) + 2 * sizeof(int32_t) + \
+                               LOC_TRACE_MAX_ARGS * sizeof(uint64_t))
+#define LOC_TRACE_STR_SIZE (LOC_TRACE_RECORD_SIZE - LOC_TRACE_HEADER_SIZE)
+/* args[] value of a string that did not fit */
+#define LOC_TRACE_STR_NONE UINT64_MAX
+
+typedef struct loc_trace_record_s
+{
+    uint64_t time_ns;
+    /* union keeps the record layout the same on 32 and 64 bit */
+    union {
+        const loc_trace_fmt_s_type* fmt;
+        uint64_t pad;
+    };
+    int32_t tid;
+    int32_t reserved;
+    /* integers, pointers and doubles as their bits, strings as offsets
+       into str */
+    uint64_t args[LOC_TRACE_MAX_ARGS];
+    char str[LOC_TRACE_STR_SIZE];
+} loc_trace_record_s_type;
+
+typedef struct loc_trace_ring_s
+{
+    /* count of records written, only written by the owner thread */
+    volatile int32_t head;
+    /* 0 once the owner thread has exited, the ring is then reused */
+    int32_t in_use;
+    int32_t tid;
+    struct loc_trace_ring_s* next;
+    loc_trace_record_s_type records[LOC_TRACE_RING_SIZE];
+} loc_trace_ring_s_type;
+
+unsigned long loc_trace_level = 0;
+
+static pthread_once_t loc_trace_once = PTHREAD_ONCE_INIT;
+static pthread_once_t loc_trace_serve_once = PTHREAD_ONCE_INIT;
+static pthread_key_t loc_trace_key;
+static pthread_mutex_t loc_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static loc_trace_ring_s_type* loc_trace_rings = NULL;
+
+static void loc_trace_thread_exit(void* ring)
+{
+    pthread_mutex_lock(&loc_trace_mutex);
+    ((loc_trace_ring_s_type*)ring)->in_use = 0;
+    pthread_mutex_unlock(&loc_trace_mutex);
+}
+
+static void loc_trace_key_create()
+{
+    pthread_key_create(&loc_trace_key, loc_trace_thread_exit);
+}
+
+/* the ring of the calling thread, taken from the rings of exited threads
+   or allocated the first time the thread records */
+static loc_trace_ring_s_type* loc_trace_get_ring()
+{
+    pthread_once(&loc_trace_once, loc_trace_key_create);
+    loc_trace_ring_s_type* ring =
+        (loc_trace_ring_s_type*)pthread_getspecific(loc_trace_key);
+    if (NULL == ring) {
+        pthread_mutex_lock(&loc_trace_mutex);
+        for (ring = loc_trace_rings; ring && ring->in_use; ring = ring->next);
+        if (NULL == ring) {
+            ring = (loc_trace_ring_s_type*)calloc(1, sizeof(*ring));
+            if (NULL != ring) {
+                ring->next = loc_trace_rings;
+                loc_trace_rings = ring;
+            }
+        }
+        if (NULL != ring) {
+            ring->in_use = 1;
+            ring->tid = (int32_t)syscall(SYS_gettid);
+            pthread_setspecific(loc_trace_key, ring);
+        }
+        pthread_mutex_unlock(&loc_trace_mutex);
+    }
+    return ring;
+}
+
+/* Finds the printf conversion after '%' at *format. Returns the conversion
+   character and moves *format past it; the argument types it takes are
+   appended to types. 0 if it can't be traced, '%' for a literal. */
+static char loc_trace_next_conversion(const char** format, uint8_t* types,
+                                      int32_t* argc)
+{
+    const char* p = *format;
+    p += strspn(p, "-+ #0'");
+    if ('*' == *p) {
+        if (*argc >= LOC_TRACE_MAX_ARGS) return 0;
+        types[(*argc)++] = LOC_TRACE_ARG_INT;
+        p++;
+    } else {
+        p += strspn(p, "0123456789");
+    }
+    if ('.' == *p) {
+        p++;
+        if ('*' == *p) {
+            if (*argc >= LOC_TRACE_MAX_ARGS) return 0;
+            types[(*argc)++] = LOC_TRACE_ARG_INT;
+            p++;
+        } else {
+            p += strspn(p, "0123456789");
+        }
+    }
+
+    uint8_t integer = LOC_TRACE_ARG_INT;
+    if ('h' == *p) {
+        p += ('h' == p[1]) ? 2 : 1;
+    } else if ('l' == *p && 'l' == p[1]) {
+        integer = LOC_TRACE_ARG_LLONG;
+        p += 2;
+    } else if ('l' == *p || 'z' == *p || 't' == *p) {
+        integer = LOC_TRACE_ARG_LONG;
+        p++;
+    } else if ('j' == *p || 'q' == *p) {
+        integer = LOC_TRACE_ARG_LLONG;
+        p++;
+    } else if ('L' == *p) {
+        return 0;
+    }
+
+    char conversion = *p;
+    uint8_t type;
+    switch (conversion) {
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+        type = integer;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+    case 'a': case 'A':
+        type = LOC_TRACE_ARG_DOUBLE;
+        break;
+    case 'p':
+        type = LOC_TRACE_ARG_PTR;
+        break;
+    case 's':
+        type = LOC_TRACE_ARG_STR;
+        break;
+    case '%':
+        *format = p + 1;
+        return '%';
+    default:
+        return 0;
+    }
+    if (*argc >= LOC_TRACE_MAX_ARGS) {
+        return 0;
+    }
+    types[(*argc)++] = type;
+    *format = p + 1;
+    return conversion;
+}
+
+/* fills in the argument types of fmt, once per call site */
+static int32_t loc_trace_parse(loc_trace_fmt_s_type* fmt)
+{
+    uint8_t types[LOC_TRACE_MAX_ARGS];
+    int32_t argc = 0;
+    for (const char* p = strchr(fmt->format, '%'); NULL != p;
+         p = strchr(p, '%')) {
+        p++;
+        if (0 == loc_trace_next_conversion(&p, types, &argc)) {
+            argc = LOC_TRACE_FMT_BAD;
+            break;
+        }
+    }
+    if (argc > 0) {
+        memcpy(fmt->types, types, argc);
+    }
+    android_atomic_release_store(argc, &fmt->argc);
+    return argc;
+}
+
+/* dumps the trace to every client that connects, until the socket fails */
+static void* loc_trace_serve_thread(void* arg)
+{
+    int sock = (int)(intptr_t)arg;
+    for (;;) {
+        int client = accept(sock, NULL, NULL);
+        if (client < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            LOC_LOGE("%s:%d]: accept failed: %s", __func__, __LINE__,
+                     strerror(errno));
+            break;
+        }
+        loc_trace_dump(client);
+        close(client);
+    }
+    close(sock);
+    return NULL;
+}
+
+static void loc_trace_serve()
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s%s%d",
+             LOC_TRACE_SOCK_DIR, LOC_TRACE_SOCK_NAME, (int)getpid());
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        LOC_LOGE("%s:%d]: socket failed: %s", __func__, __LINE__,
+                 strerror(errno));
+        return;
+    }
+    // left behind by an earlier process with the same pid
+    unlink(addr.sun_path);
+    pthread_t thread;
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        chmod(addr.sun_path, 0660) < 0 || listen(sock, 1) < 0 ||
+        pthread_create(&thread, NULL, loc_trace_serve_thread,
+                       (void*)(intptr_t)sock) != 0) {
+        LOC_LOGE("%s:%d]: can't serve trace dumps on %s: %s", __func__,
+                 __LINE__, addr.sun_path, strerror(errno));
+        close(sock);
+        return;
+    }
+    pthread_detach(thread);
+}
+
+/*===========================================================================
+FUNCTION loc_trace_init
+
+DESCRIPTION
+   Sets the highest level of messages that are traced instead of logged,
+   TRACE_LEVEL of gps.conf. 0 turns tracing off. Levels that DEBUG_LEVEL
+   filters out are not traced either, so loc_logger_init() has to be
+   called first.
+
+   The first time tracing is turned on, the process starts serving
+   loc_trace_dump() on LOC_TRACE_SOCK_DIR/LOC_TRACE_SOCK_NAME<pid>, which
+   is what the loc_trace_dump tool reads.
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   None
+
+SIDE EFFECTS
+   N/A
+===========================================================================*/
+void loc_trace_init(unsigned long level)
+{
+    // 0xff leaves the filtering to the Android log levels
+    if (loc_logger.DEBUG_LEVEL <= 5 && level > loc_logger.DEBUG_LEVEL) {
+        level = loc_logger.DEBUG_LEVEL;
+    }
+    loc_trace_level = level;
+    if (level > 0) {
+        pthread_once(&loc_trace_serve_once, loc_trace_serve);
+    }
+}
+
+/*===========================================================================
+FUNCTION loc_trace_record
+
+DESCRIPTION
+   Records a message into the trace ring of the calling thread. Called
+   through LOC_TRACE(), with the static format descriptor of the call site
+   and the arguments of the format.
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   1 if recorded, 0 if the format can't be traced or the thread has no
+   ring, LOC_TRACE() then logs the message as it is
+
+SIDE EFFECTS
+   Overwrites the oldest record of the thread once its ring is full
+===========================================================================*/
+int loc_trace_record(loc_trace_fmt_s_type* fmt, ...)
+{
+    int32_t argc = android_atomic_acquire_load(&fmt->argc);
+    if (LOC_TRACE_FMT_UNPARSED == argc) {
+        argc = loc_trace_parse(fmt);
+    }
+    if (argc < 0) {
+        return 0;
+    }
+    loc_trace_ring_s_type* ring = loc_trace_get_ring();
+    if (NULL == ring) {
+        return 0;
+    }
+
+    int32_t head = ring->head;
+    loc_trace_record_s_type* record =
+        &ring->records[(uint32_t)head & (LOC_TRACE_RING_SIZE - 1)];
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    record->time_ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    record->fmt = fmt;
+    record->tid = ring->tid;
+
+    va_list ap;
+    va_start(ap, fmt);
+    size_t used = 0;
+    for (int32_t i = 0; i < argc; i++) {
+        switch (fmt->types[i]) {
+        case LOC_TRACE_ARG_INT:
+            record->args[i] = (uint64_t)(int64_t)va_arg(ap, int);
+            break;
+        case LOC_TRACE_ARG_LONG:
+            record->args[i] = (uint64_t)(int64_t)va_arg(ap, long);
+            break;
+        case LOC_TRACE_ARG_LLONG:
+            record->args[i] = (uint64_t)va_arg(ap, long long);
+            break;
+        case LOC_TRACE_ARG_DOUBLE: {
+            double d = va_arg(ap, double);
+            memcpy(&record->args[i], &d, sizeof(d));
+            break;
+        }
+        case LOC_TRACE_ARG_PTR:
+            record->args[i] = (uint64_t)(uintptr_t)va_arg(ap, void*);
+            break;
+        case LOC_TRACE_ARG_STR: {
+            const char* str = va_arg(ap, const char*);
+            if (NULL == str) {
+                str = "(null)";
+            }
+            if (used < LOC_TRACE_STR_SIZE) {
+                // truncated to what is left
+                size_t len = strnlen(str, LOC_TRACE_STR_SIZE - used - 1);
+                memcpy(&record->str[used], str, len);
+                record->str[used + len] = '\0';
+                record->args[i] = used;
+                used += len + 1;
+            } else {
+                record->args[i] = LOC_TRACE_STR_NONE;
+            }
+            break;
+        }
+        }
+    }
+    va_end(ap);
+
+    android_atomic_release_store(head + 1, &ring->head);
+    return 1;
+}
+
+/* formats record into buf, truncated to size - 1 characters and the
+   terminating '\0'. Returns the length written. Only formats that could
+   be parsed are ever recorded. */
+static int loc_trace_format(const loc_trace_record_s_type* record,
+                            char* buf, size_t size)
+{
+    const loc_trace_fmt_s_type* fmt = record->fmt;
+    size_t len = 0;
+    int32_t arg = 0;
+    const char* p = fmt->format;
+    while (*p && len < size) {
+        const char* percent = strchr(p, '%');
+        size_t literal = percent ? (size_t)(percent - p) : strlen(p);
+        size_t n = literal < size - len ? literal : size - len - 1;
+        memcpy(buf + len, p, n);
+        len += n;
+        buf[len] = '\0';
+        if (NULL == percent || len + 1 >= size) {
+            break;
+        }
+
+        // one conversion, with '*' replaced by the recorded values
+        const char* end = percent + 1;
+        uint8_t types[LOC_TRACE_MAX_ARGS];
+        int32_t argc = 0;
+        char conversion = loc_trace_next_conversion(&end, types, &argc);
+        p = end;
+        if ('%' == conversion) {
+            buf[len++] = '%';
+            buf[len] = '\0';
+            continue;
+        }
+        char spec[32];
+        size_t s = 0;
+        for (const char* c = percent; c < end && s < sizeof(spec) - 24; c++) {
+            if ('*' == *c) {
+                s += snprintf(spec + s, sizeof(spec) - s, "%d",
+                              (int)record->args[arg++]);
+            } else {
+                spec[s++] = *c;
+            }
+        }
+        spec[s] = '\0';
+
+        uint64_t value = record->args[arg++];
+        int w = 0;
+        switch (types[argc - 1]) {
+        case LOC_TRACE_ARG_INT:
+            w = snprintf(buf + len, size - len, spec, (int)value);
+            break;
+        case LOC_TRACE_ARG_LONG:
+            w = snprintf(buf + len, size - len, spec, (long)value);
+            break;
+        case LOC_TRACE_ARG_LLONG:
+            w = snprintf(buf + len, size - len, spec, (long long)value);
+            break;
+        case LOC_TRACE_ARG_DOUBLE: {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            w = snprintf(buf + len, size - len, spec, d);
+            break;
+        }
+        case LOC_TRACE_ARG_PTR:
+            w = snprintf(buf + len, size - len, spec, (void*)(uintptr_t)value);
+            break;
+        case LOC_TRACE_ARG_STR:
+            w = snprintf(buf + len, size - len, spec,
+                         LOC_TRACE_STR_NONE == value ? "" : &record->str[value]);
+            break;
+        }
+        len += (w > 0) ? (size_t)w : 0;
+    }
+    return (int)(len < size ? len : size - 1);
+}
+
+static int loc_trace_compare(const void* a, const void* b)
+{
+    uint64_t ta = ((const loc_trace_record_s_type*)a)->time_ns;
+    uint64_t tb = ((const loc_trace_record_s_type*)b)->time_ns;
+    return (ta < tb) ? -1 : (ta > tb);
+}
+
+/*===========================================================================
+FUNCTION loc_trace_dump
+
+DESCRIPTION
+   Formats the records of all threads, oldest first, one per line, into fd:
+
+   <monotonic seconds> <tid> <message>
+
+   Threads keep recording while the dump is taken; records they overwrite
+   during the dump are left out.
+
+DEPENDENCIES
+   N/A
+
+RETURN VALUE
+   number of records written, -1 on failure
+
+SIDE EFFECTS
+   N/A
+===========================================================================*/
+int loc_trace_dump(int fd)
+{
+    pthread_mutex_lock(&loc_trace_mutex);
+    uint32_t ring_count = 0;
+    for (loc_trace_ring_s_type* ring = loc_trace_rings; ring; ring = ring->next) {
+        ring_count++;
+    }
+    const size_t ring_size = sizeof(((loc_trace_ring_s_type*)0)->records);
+    loc_trace_record_s_type* records = (loc_trace_record_s_type*)
+        malloc((ring_count ? ring_count : 1) * ring_size);
+    loc_trace_record_s_type* copy = (loc_trace_record_s_type*)malloc(ring_size);
+    if (NULL == records || NULL == copy) {
+        pthread_mutex_unlock(&loc_trace_mutex);
+        free(records);
+        free(copy);
+        return -1;
+    }
+
+    uint32_t count = 0;
+    for (loc_trace_ring_s_type* ring = loc_trace_rings; ring; ring = ring->next) {
+        uint32_t before = (uint32_t)android_atomic_acquire_load(&ring->head);
+        memcpy(copy, ring->records, ring_size);
+        android_memory_barrier();
+        uint32_t after = (uint32_t)android_atomic_acquire_load(&ring->head);
+
+        // record 'before - i' is intact if the writer has not come back
+        // to its slot, nor is writing it, i.e. after - (before - i) < size
+        for (uint32_t i = 1; i <= LOC_TRACE_RING_SIZE && i <= before; i++) {
+            uint32_t seq = before - i;
+            if (after - seq >= LOC_TRACE_RING_SIZE) {
+                break;
+            }
+            records[count++] = copy[seq & (LOC_TRACE_RING_SIZE - 1)];
+        }
+    }
+    pthread_mutex_unlock(&loc_trace_mutex);
+    free(copy);
+
+    qsort(records, count, sizeof(records[0]), loc_trace_compare);
+    char line[512];
+    for (uint32_t i = 0; i < count; i++) {
+        int len = snprintf(line, sizeof(line), "%llu.%06llu %5d ",
+                           (unsigned long long)(records[i].time_ns / 1000000000ULL),
+                           (unsigned long long)(records[i].time_ns / 1000ULL % 1000000ULL),
+                           records[i].tid);
+        if (len < 0 || len > (int)sizeof(line) - 2) {
+            len = (len < 0) ? 0 : (int)sizeof(line) - 2;
+        }
+        // one byte is kept for the newline
+        len += loc_trace_format(&records[i], line + len, sizeof(line) - len - 1);
+        if (len > 0 && line[len - 1] != '\n') {
+            line[len++] = '\n';
+        }
+        if (write(fd, line, len) < 0) {
+            break;
+        }
+    }
+    free(records);
+    return (int)count;
+}
@@ -0,0 +1,112 @@
+/* Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Prints the binary trace of processes that trace with TRACE_LEVEL in
+   gps.conf, as formatted by their loc_trace_dump():
+
+     loc_trace_dump [pid...]
+
+   Without pids, every tracing process found in LOC_TRACE_SOCK_DIR is
+   dumped in turn. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "log_util.h"
+
+static int loc_trace_dump_pid(const char* pid)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s%s%s",
+             LOC_TRACE_SOCK_DIR, LOC_TRACE_SOCK_NAME, pid);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0 || connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "%s: %s\n", addr.sun_path, strerror(errno));
+        if (sock >= 0) {
+            close(sock);
+        }
+        return -1;
+    }
+
+    char buf[4096];
+    ssize_t len;
+    while ((len = read(sock, buf, sizeof(buf))) > 0 ||
+           (len < 0 && EINTR == errno)) {
+        if (len > 0 && fwrite(buf, 1, len, stdout) != (size_t)len) {
+            break;
+        }
+    }
+    close(sock);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int failures = 0;
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            failures += (loc_trace_dump_pid(argv[i]) < 0);
+        }
+        return failures ? 1 : 0;
+    }
+
+    DIR* dir = opendir(LOC_TRACE_SOCK_DIR);
+    if (NULL == dir) {
+        fprintf(stderr, "%s: %s\n", LOC_TRACE_SOCK_DIR, strerror(errno));
+        return 1;
+    }
+    const size_t prefix = strlen(LOC_TRACE_SOCK_NAME);
+    int found = 0;
+    struct dirent* entry;
+    while (NULL != (entry = readdir(dir))) {
+        if (0 == strncmp(entry->d_name, LOC_TRACE_SOCK_NAME, prefix)) {
+            const char* pid = entry->d_name + prefix;
+            printf("==== pid %s\n", pid);
+            fflush(stdout);
+            // sockets of exited processes are reported and skipped
+            failures += (loc_trace_dump_pid(pid) < 0);
+            found++;
+        }
+    }
+    closedir(dir);
+    if (0 == found) {
+        fprintf(stderr, "no tracing process in %s\n", LOC_TRACE_SOCK_DIR);
+        return 1;
+    }
+    return (failures == found) ? 1 : 0;
+}
@@ -30,6 +30,8 @@
 #ifndef __LOG_UTIL_H__
 #define __LOG_UTIL_H__
 
+#include <stdint.h>
+
 #ifndef USE_GLIB
 #include <utils/Log.h>
 #endif /* USE_GLIB */
@@ -69,6 +71,8 @@ typedef struct loc_logger_s
  *
  *============================================================================*/
 extern loc_logger_s_type loc_logger;
+/* Highest level recorded into the trace buffers rather than logged, 0: off */
+extern unsigned long loc_trace_level;
 
 // Logging Improvements
 extern const char *loc_logger_boolStr[];
@@ -91,6 +95,72 @@ extern const char EXIT_ERROR_TAG[];
 extern void loc_logger_init(unsigned long debug, unsigned long timestamp);
 extern char* get_timestamp(char* str, unsigned long buf_size);
 
+/*=============================================================================
+ *
+ *                               BINARY TRACE
+ *
+ * Info, debug and verbose messages at or below both TRACE_LEVEL and
+ * DEBUG_LEVEL of gps.conf are not formatted when logged. Each thread writes
+ * them into a ring buffer of its own as a record of a timestamp, the static
+ * format descriptor of the call site, which serves as the format ID, and
+ * the raw arguments, strings copied. Nothing is locked on the way. The records are only formatted when
+ * loc_trace_dump() is called, e.g. by the loc_trace_dump tool.
+ *
+ *============================================================================*/
+#define LOC_TRACE_MAX_ARGS 8
+
+/* Format descriptor, one static instance per call site */
+typedef struct loc_trace_fmt_s
+{
+  const char*      format;
+  int32_t          level;
+  /* LOC_TRACE_FMT_UNPARSED until the first record, then the number of
+     arguments, LOC_TRACE_FMT_BAD if the format can't be traced */
+  volatile int32_t argc;
+  uint8_t          types[LOC_TRACE_MAX_ARGS];
+} loc_trace_fmt_s_type;
+
+/* Where a tracing process serves its dump, suffixed with its pid */
+#ifndef LOC_TRACE_SOCK_DIR
+#define LOC_TRACE_SOCK_DIR "/data/misc/location/"
+#endif
+#define LOC_TRACE_SOCK_NAME "loc_trace_"
+
+#define LOC_TRACE_FMT_UNPARSED (-1)
+#define LOC_TRACE_FMT_BAD      (-2)
+
+extern void loc_trace_init(unsigned long level);
+extern int loc_trace_record(loc_trace_fmt_s_type* fmt, ...);
+extern int loc_trace_dump(int fd);
+
+/* Levels above LOC_LOG_MAX_LEVEL are not compiled in. User builds cap
+   DEBUG_LEVEL at 2 in loc_logger_init(), so they drop info and up. */
+#ifndef LOC_LOG_MAX_LEVEL
+#ifdef TARGET_BUILD_VARIANT_USER
+#define LOC_LOG_MAX_LEVEL 2
+#else
+#define LOC_LOG_MAX_LEVEL 5
+#endif
+#endif
+
+/* errors and warnings are always logged */
+#define LOC_TRACING(LEVEL) \
+    ((LEVEL) >= 3 && (LEVEL) <= LOC_LOG_MAX_LEVEL && (LEVEL) <= loc_trace_level)
+
+/* Formats that can't be recorded, e.g. with more than LOC_TRACE_MAX_ARGS
+   arguments, are logged the way the LOC_LOGx macros log them untraced */
+#define LOC_TRACE(LEVEL, FMT, ...)                                              \
+    do {                                                                      \
+        static loc_trace_fmt_s_type loc_trace_fmt_ =                          \
+            { FMT, LEVEL, LOC_TRACE_FMT_UNPARSED, { 0 } };                    \
+        if (!loc_trace_record(&loc_trace_fmt_, ##__VA_ARGS__)) {              \
+            if (loc_logger.DEBUG_LEVEL <= 5) { ALOGE(FMT, ##__VA_ARGS__); }   \
+            else if ((LEVEL) == 3) { ALOGI(FMT, ##__VA_ARGS__); }             \
+            else if ((LEVEL) == 4) { ALOGD(FMT, ##__VA_ARGS__); }             \
+            else { ALOGV(FMT, ##__VA_ARGS__); }                               \
+        }                                                                     \
+    } while(0)
+
 #ifndef DEBUG_DMN_LOC_API
 
 /* LOGGING MACROS */
@@ -98,35 +168,38 @@ extern char* get_timestamp(char* str, unsigned long buf_size);
   if that value remains unchanged, it means gps.conf did not
   provide a value and we default to the initial value to use
   Android's logging levels*/
-#define IF_LOC_LOGE if((loc_logger.DEBUG_LEVEL >= 1) && (loc_logger.DEBUG_LEVEL <= 5))
+#define IF_LOC_LOGE if((LOC_LOG_MAX_LEVEL >= 1) && (loc_logger.DEBUG_LEVEL >= 1) && (loc_logger.DEBUG_LEVEL <= 5))
 
-#define IF_LOC_LOGW if((loc_logger.DEBUG_LEVEL >= 2) && (loc_logger.DEBUG_LEVEL <= 5))
+#define IF_LOC_LOGW if((LOC_LOG_MAX_LEVEL >= 2) && (loc_logger.DEBUG_LEVEL >= 2) && (loc_logger.DEBUG_LEVEL <= 5))
 
-#define IF_LOC_LOGI if((loc_logger.DEBUG_LEVEL >= 3) && (loc_logger.DEBUG_LEVEL <= 5))
+#define IF_LOC_LOGI if((LOC_LOG_MAX_LEVEL >= 3) && (loc_logger.DEBUG_LEVEL >= 3) && (loc_logger.DEBUG_LEVEL <= 5))
 
-#define IF_LOC_LOGD if((loc_logger.DEBUG_LEVEL >= 4) && (loc_logger.DEBUG_LEVEL <= 5))
+#define IF_LOC_LOGD if((LOC_LOG_MAX_LEVEL >= 4) && (loc_logger.DEBUG_LEVEL >= 4) && (loc_logger.DEBUG_LEVEL <= 5))
 
-#define IF_LOC_LOGV if((loc_logger.DEBUG_LEVEL >= 5) && (loc_logger.DEBUG_LEVEL <= 5))
+#define IF_LOC_LOGV if((LOC_LOG_MAX_LEVEL >= 5) && (loc_logger.DEBUG_LEVEL >= 5) && (loc_logger.DEBUG_LEVEL <= 5))
 
 #define LOC_LOGE(...) \
 IF_LOC_LOGE { ALOGE("E/" __VA_ARGS__); } \
-else if (loc_logger.DEBUG_LEVEL == 0xff) { ALOGE("E/" __VA_ARGS__); }
+else if (LOC_LOG_MAX_LEVEL >= 1 && loc_logger.DEBUG_LEVEL == 0xff) { ALOGE("E/" __VA_ARGS__); }
 
 #define LOC_LOGW(...) \
 IF_LOC_LOGW { ALOGE("W/" __VA_ARGS__); }  \
-else if (loc_logger.DEBUG_LEVEL == 0xff) { ALOGW("W/" __VA_ARGS__); }
+else if (LOC_LOG_MAX_LEVEL >= 2 && loc_logger.DEBUG_LEVEL == 0xff) { ALOGW("W/" __VA_ARGS__); }
 
 #define LOC_LOGI(...) \
-IF_LOC_LOGI { ALOGE("I/" __VA_ARGS__); }   \
-else if (loc_logger.DEBUG_LEVEL == 0xff) { ALOGI("I/" __VA_ARGS__); }
+if (LOC_TRACING(3)) { LOC_TRACE(3, "I/" __VA_ARGS__); } \
+else IF_LOC_LOGI { ALOGE("I/" __VA_ARGS__); }   \
+else if (LOC_LOG_MAX_LEVEL >= 3 && loc_logger.DEBUG_LEVEL == 0xff) { ALOGI("I/" __VA_ARGS__); }
 
 #define LOC_LOGD(...) \
-IF_LOC_LOGD { ALOGE("D/" __VA_ARGS__); }   \
-else if (loc_logger.DEBUG_LEVEL == 0xff) { ALOGD("D/" __VA_ARGS__); }
+if (LOC_TRACING(4)) { LOC_TRACE(4, "D/" __VA_ARGS__); } \
+else IF_LOC_LOGD { ALOGE("D/" __VA_ARGS__); }   \
+else if (LOC_LOG_MAX_LEVEL >= 4 && loc_logger.DEBUG_LEVEL == 0xff) { ALOGD("D/" __VA_ARGS__); }
 
 #define LOC_LOGV(...) \
-IF_LOC_LOGV { ALOGE("V/" __VA_ARGS__); }   \
-else if (loc_logger.DEBUG_LEVEL == 0xff) { ALOGV("V/" __VA_ARGS__); }
+if (LOC_TRACING(5)) { LOC_TRACE(5, "V/" __VA_ARGS__); } \
+else IF_LOC_LOGV { ALOGE("V/" __VA_ARGS__); }   \
+else if (LOC_LOG_MAX_LEVEL >= 5 && loc_logger.DEBUG_LEVEL == 0xff) { ALOGV("V/" __VA_ARGS__); }
 
 #else /* DEBUG_DMN_LOC_API */
 
@@ -147,9 +220,11 @@ else if (loc_logger.DEBUG_LEVEL == 0xff) { ALOGV("V/" __VA_ARGS__); }
  *                          LOGGING IMPROVEMENT MACROS
  *
  *============================================================================*/
-#define LOG_(LOC_LOG, ID, WHAT, SPEC, VAL)                                    \
+#define LOG_(LOC_LOG, LEVEL, ID, WHAT, SPEC, VAL)                             \
     do {                                                                      \
-        if (loc_logger.TIMESTAMP) {                                           \
+        if (LOC_TRACING(LEVEL)) {                                             \
+            LOC_TRACE(LEVEL, "%s %s line %d " #SPEC, ID, WHAT, __LINE__, VAL);\
+        } else if (loc_logger.TIMESTAMP) {                                    \
             char ts[32];                                                      \
             LOC_LOG("[%s] %s %s line %d " #SPEC,                              \
                      get_timestamp(ts, sizeof(ts)), ID, WHAT, __LINE__, VAL); \
@@ -159,9 +234,9 @@ else if (loc_logger.DEBUG_LEVEL == 0xff) { ALOGV("V/" __VA_ARGS__); }
         }                                                                     \
     } while(0)
 
-#define LOG_I(ID, WHAT, SPEC, VAL) LOG_(LOC_LOGI, ID, WHAT, SPEC, VAL)
-#define LOG_V(ID, WHAT, SPEC, VAL) LOG_(LOC_LOGV, ID, WHAT, SPEC, VAL)
-#define LOG_E(ID, WHAT, SPEC, VAL) LOG_(LOC_LOGE, ID, WHAT, SPEC, VAL)
+#define LOG_I(ID, WHAT, SPEC, VAL) LOG_(LOC_LOGI, 3, ID, WHAT, SPEC, VAL)
+#define LOG_V(ID, WHAT, SPEC, VAL) LOG_(LOC_LOGV, 5, ID, WHAT, SPEC, VAL)
+#define LOG_E(ID, WHAT, SPEC, VAL) LOG_(LOC_LOGE, 1, ID, WHAT, SPEC, VAL)
 
 #define ENTRY_LOG() LOG_V(ENTRY_TAG, __func__, %s, "")
 #define EXIT_LOG(SPEC, VAL) LOG_V(EXIT_TAG, __func__, SPEC, VAL)
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016 The CyanogenMod Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKES_FOR_HOST_HARDWARE_LIGHTS_H
+#define FAKES_FOR_HOST_HARDWARE_LIGHTS_H
+
+/*
+ * Host stand-in for the parts of hardware/hardware.h and hardware/lights.h
+ * the lights HAL uses, laid out as in libhardware.
+ */
+
+#include <stdint.h>
+
+#define MAKE_TAG_CONSTANT(A,B,C,D) (((A) << 24) | ((B) << 16) | ((C) << 8) | (D))
+#define HARDWARE_MODULE_TAG MAKE_TAG_CONSTANT('H', 'W', 'M', 'T')
+#define HARDWARE_DEVICE_TAG MAKE_TAG_CONSTANT('H', 'W', 'D', 'T')
+
+#define HAL_MODULE_INFO_SYM         HMI
+#define HAL_MODULE_INFO_SYM_AS_STR  "HMI"
+
+struct hw_module_t;
+struct hw_module_methods_t;
+struct hw_device_t;
+
+struct hw_module_t {
+    uint32_t tag;
+    uint16_t version_major;
+    uint16_t version_minor;
+    const char *id;
+    const char *name;
+    const char *author;
+    struct hw_module_methods_t *methods;
+    void *dso;
+    uint32_t reserved[32-7];
+};
+
+struct hw_module_methods_t {
+    int (*open)(const struct hw_module_t *module, const char *id,
+            struct hw_device_t **device);
+};
+
+struct hw_device_t {
+    uint32_t tag;
+    uint32_t version;
+    struct hw_module_t *module;
+    uint32_t reserved[12];
+    int (*close)(struct hw_device_t *device);
+};
+
+#define LIGHTS_HARDWARE_MODULE_ID "lights"
+
+#define LIGHT_ID_BACKLIGHT          "backlight"
+#define LIGHT_ID_KEYBOARD           "keyboard"
+#define LIGHT_ID_BUTTONS            "buttons"
+#define LIGHT_ID_BATTERY            "battery"
+#define LIGHT_ID_NOTIFICATIONS      "notifications"
+#define LIGHT_ID_ATTENTION          "attention"
+
+#define LIGHT_FLASH_NONE            0
+#define LIGHT_FLASH_TIMED           1
+#define LIGHT_FLASH_HARDWARE        2
+
+#define BRIGHTNESS_MODE_USER        0
+#define BRIGHTNESS_MODE_SENSOR      1
+
+struct light_state_t {
+    unsigned int color;
+    int flashMode;
+    int flashOnMS;
+    int flashOffMS;
+    int brightnessMode;
+};
+
+struct light_device_t {
+    struct hw_device_t common;
+    int (*set_light)(struct light_device_t *dev,
+            struct light_state_t const *state);
+};
+
+#endif // FAKES_FOR_HOST_HARDWARE_LIGHTS_H
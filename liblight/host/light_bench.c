@@ -0,0 +1,678 @@
+/*
+ * Copyright (C) 2016 The CyanogenMod Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host benchmark suite for the lights HAL.
+ *
+ * Build and run with "make bench" in this directory. Every result is one
+ * {"benchmark", "params", "metric", "value", "unit"} record in a JSON
+ * document written with -o (stdout gets a readable summary), so that runs
+ * can be diffed across changes.
+ *
+ *   usage: light_bench [-f filter] [-s scale] [-l module] [-o results.json]
+ *     -f  only run benchmarks whose name contains filter
+ *     -s  multiply iteration counts by scale (default 1)
+ *     -l  the HAL to load (default lights.msm8974.so next to light_bench)
+ *
+ * The HAL is loaded afresh for every run, with dlopen() as the framework
+ * does. The /sys/class/leds nodes it writes are stood in for by open(),
+ * pwrite() and friends below, which the HAL finds before the C library
+ * ones: they keep the value last written to every node and count the
+ * syscalls, so that a run can be checked against another one.
+ *
+ * The HAL applies set_light calls on its update worker, folding together
+ * what comes within a window. A run that keeps the devices open makes its
+ * calls in bursts and lets the worker settle after each one before it
+ * looks at the nodes.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dlfcn.h>
+#include <libgen.h>
+#include <pthread.h>
+
+#include <hardware/lights.h>
+
+#define BENCH_MAX_RESULTS       256
+#define BENCH_STR_LEN           64
+#define SYSFS_PREFIX            "/sys/class/leds/"
+#define FAKE_MAX_NODES          32
+#define FAKE_MAX_FDS            1024
+#define FAKE_VALUE_MAX          256
+// long enough for the worker to apply a burst, twice UPDATE_WINDOW_MS
+#define SETTLE_US               40000
+
+/******************************************************************************/
+
+/*
+ * results
+ */
+
+struct bench_result {
+    char benchmark[BENCH_STR_LEN];
+    char params[BENCH_STR_LEN];
+    char metric[BENCH_STR_LEN];
+    double value;
+    char unit[BENCH_STR_LEN];
+};
+
+static struct bench_result results[BENCH_MAX_RESULTS];
+static int num_results;
+static double scale = 1.0;
+static char module_path[1024];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t scaled(uint32_t count)
+{
+    uint32_t n = (uint32_t)(count * scale);
+    return n > 0 ? n : 1;
+}
+
+static void report(const char *benchmark, const char *params,
+        const char *metric, double value, const char *unit)
+{
+    struct bench_result *r;
+    printf("%-22s %-24s %-20s %14.3f %s\n",
+            benchmark, params, metric, value, unit);
+    if (num_results == BENCH_MAX_RESULTS)
+        return;
+    r = &results[num_results++];
+    snprintf(r->benchmark, sizeof(r->benchmark), "%s", benchmark);
+    snprintf(r->params, sizeof(r->params), "%s", params);
+    snprintf(r->metric, sizeof(r->metric), "%s", metric);
+    r->value = value;
+    snprintf(r->unit, sizeof(r->unit), "%s", unit);
+}
+
+/******************************************************************************/
+
+/*
+ * stand-in sysfs
+ */
+
+struct fake_node {
+    char path[128];
+    char value[FAKE_VALUE_MAX];
+};
+
+static pthread_mutex_t fake_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct fake_node fake_nodes[FAKE_MAX_NODES];
+static int fake_num_nodes;
+// node + 1 of every fd open on a node, 0 for other fds
+static int fake_fds[FAKE_MAX_FDS];
+// 1 for the LEDs of DT based drivers, which have duty_pcts
+static int fake_dt;
+
+// syscalls made on nodes
+static struct {
+    uint32_t opens;
+    uint32_t closes;
+    uint32_t writes;
+} fake_stats;
+
+static void fake_reset(int dt)
+{
+    pthread_mutex_lock(&fake_lock);
+    memset(fake_nodes, 0, sizeof(fake_nodes));
+    fake_num_nodes = 0;
+    memset(&fake_stats, 0, sizeof(fake_stats));
+    fake_dt = dt;
+    pthread_mutex_unlock(&fake_lock);
+}
+
+static int fake_owns(const char *path)
+{
+    return strncmp(path, SYSFS_PREFIX, strlen(SYSFS_PREFIX)) == 0;
+}
+
+// 1 if node sets how an LED blinks and that LED does not blink
+static int fake_hidden(const struct fake_node *node)
+{
+    static const char *const params[] = {
+        "/grpfreq", "/grppwm", "/duty_pcts", "/ramp_step_ms"
+    };
+    char blink[sizeof(node->path)];
+    size_t i, len = strlen(node->path), n;
+    int j;
+
+    for (i = 0; i < sizeof(params) / sizeof(params[0]); i++) {
+        n = strlen(params[i]);
+        if (len > n && strcmp(node->path + len - n, params[i]) == 0)
+            break;
+    }
+    if (i == sizeof(params) / sizeof(params[0]))
+        return 0;
+    snprintf(blink, sizeof(blink), "%.*s/blink", (int)(len - n), node->path);
+    for (j = 0; j < fake_num_nodes; j++)
+        if (strcmp(fake_nodes[j].path, blink) == 0)
+            return strcmp(fake_nodes[j].value, "0\n") == 0;
+    return 1;
+}
+
+/*
+ * Order independent hash of what the nodes hold, but for the blink
+ * settings of an LED that does not blink, which no longer show.
+ */
+static uint64_t fake_hash(void)
+{
+    uint64_t hash = 0, h;
+    const char *p;
+    int i;
+
+    pthread_mutex_lock(&fake_lock);
+    for (i = 0; i < fake_num_nodes; i++) {
+        if (fake_hidden(&fake_nodes[i]))
+            continue;
+        h = 1469598103934665603ULL;
+        for (p = fake_nodes[i].path; *p; p++)
+            h = (h ^ (uint8_t)*p) * 1099511628211ULL;
+        for (p = fake_nodes[i].value; *p; p++)
+            h = (h ^ (uint8_t)*p) * 1099511628211ULL;
+        hash += h;
+    }
+    pthread_mutex_unlock(&fake_lock);
+    return hash;
+}
+
+static int real_open(const char *path, int flags, mode_t mode)
+{
+    static int (*real)(const char *, int, ...);
+    if (!real)
+        real = (int (*)(const char *, int, ...))dlsym(RTLD_NEXT, "open");
+    return real(path, flags, mode);
+}
+
+int open(const char *path, int flags, ...)
+{
+    mode_t mode = 0;
+    va_list ap;
+    int fd, i;
+
+    if (flags & O_CREAT) {
+        va_start(ap, flags);
+        mode = va_arg(ap, int);
+        va_end(ap);
+    }
+    if (!fake_owns(path))
+        return real_open(path, flags, mode);
+
+    fd = real_open("/dev/null", O_RDWR | (flags & O_CLOEXEC), 0);
+    if (fd < 0 || fd >= FAKE_MAX_FDS)
+        return -1;
+    pthread_mutex_lock(&fake_lock);
+    for (i = 0; i < fake_num_nodes; i++)
+        if (strcmp(fake_nodes[i].path, path) == 0)
+            break;
+    if (i == fake_num_nodes && i < FAKE_MAX_NODES) {
+        snprintf(fake_nodes[i].path, sizeof(fake_nodes[i].path), "%s", path);
+        fake_num_nodes++;
+    }
+    fake_fds[fd] = i + 1;
+    fake_stats.opens++;
+    pthread_mutex_unlock(&fake_lock);
+    return fd;
+}
+
+int access(const char *path, int mode)
+{
+    static int (*real)(const char *, int);
+    if (fake_owns(path)) {
+        if (!fake_dt && strstr(path, "duty_pcts")) {
+            errno = ENOENT;
+            return -1;
+        }
+        return 0;
+    }
+    if (!real)
+        real = (int (*)(const char *, int))dlsym(RTLD_NEXT, "access");
+    return real(path, mode);
+}
+
+// takes a write to a node, -1 if fd is not on one
+static ssize_t fake_write(int fd, const void *buf, size_t count)
+{
+    int node;
+
+    if (fd < 0 || fd >= FAKE_MAX_FDS)
+        return -1;
+    pthread_mutex_lock(&fake_lock);
+    node = fake_fds[fd] - 1;
+    if (node >= 0 && node < FAKE_MAX_NODES) {
+        // sysfs takes the whole value of every write
+        snprintf(fake_nodes[node].value, FAKE_VALUE_MAX, "%.*s",
+                (int)count, (const char *)buf);
+        fake_stats.writes++;
+    }
+    pthread_mutex_unlock(&fake_lock);
+    return node >= 0 ? (ssize_t)count : -1;
+}
+
+ssize_t write(int fd, const void *buf, size_t count)
+{
+    static ssize_t (*real)(int, const void *, size_t);
+    if (fake_write(fd, buf, count) >= 0)
+        return count;
+    if (!real)
+        real = (ssize_t (*)(int, const void *, size_t))
+                dlsym(RTLD_NEXT, "write");
+    return real(fd, buf, count);
+}
+
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset)
+{
+    static ssize_t (*real)(int, const void *, size_t, off_t);
+    if (fake_write(fd, buf, count) >= 0)
+        return count;
+    if (!real)
+        real = (ssize_t (*)(int, const void *, size_t, off_t))
+                dlsym(RTLD_NEXT, "pwrite");
+    return real(fd, buf, count, offset);
+}
+
+int close(int fd)
+{
+    static int (*real)(int);
+    if (fd >= 0 && fd < FAKE_MAX_FDS) {
+        pthread_mutex_lock(&fake_lock);
+        if (fake_fds[fd]) {
+            fake_fds[fd] = 0;
+            fake_stats.closes++;
+        }
+        pthread_mutex_unlock(&fake_lock);
+    }
+    if (!real)
+        real = (int (*)(int))dlsym(RTLD_NEXT, "close");
+    return real(fd);
+}
+
+/******************************************************************************/
+
+/*
+ * the HAL
+ */
+
+enum {
+    LIGHT_BACKLIGHT,
+    LIGHT_BATTERY,
+    LIGHT_NOTIFICATIONS,
+    LIGHT_ATTENTION,
+    LIGHT_COUNT
+};
+
+static const char *const light_ids[LIGHT_COUNT] = {
+    LIGHT_ID_BACKLIGHT,
+    LIGHT_ID_BATTERY,
+    LIGHT_ID_NOTIFICATIONS,
+    LIGHT_ID_ATTENTION,
+};
+
+struct lights {
+    void *dso;
+    struct hw_module_t *module;
+    struct light_device_t *devs[LIGHT_COUNT];
+};
+
+// loads a fresh copy of the HAL, dt for the LEDs of DT based drivers
+static int lights_load(struct lights *lights, int dt)
+{
+    memset(lights, 0, sizeof(*lights));
+    fake_reset(dt);
+    lights->dso = dlopen(module_path, RTLD_NOW | RTLD_LOCAL);
+    if (!lights->dso) {
+        fprintf(stderr, "%s\n", dlerror());
+        return -1;
+    }
+    lights->module = (struct hw_module_t *)
+            dlsym(lights->dso, HAL_MODULE_INFO_SYM_AS_STR);
+    if (!lights->module) {
+        dlclose(lights->dso);
+        return -1;
+    }
+    return 0;
+}
+
+static struct light_device_t *lights_open(struct lights *lights, int light)
+{
+    struct hw_device_t *dev = NULL;
+    if (lights->module->methods->open(lights->module, light_ids[light],
+            &dev) != 0)
+        return NULL;
+    return (struct light_device_t *)dev;
+}
+
+static void lights_close(struct light_device_t *dev)
+{
+    if (dev)
+        dev->common.close(&dev->common);
+}
+
+static void lights_unload(struct lights *lights)
+{
+    int i;
+    for (i = 0; i < LIGHT_COUNT; i++)
+        lights_close(lights->devs[i]);
+    dlclose(lights->dso);
+}
+
+/******************************************************************************/
+
+/*
+ * workloads
+ */
+
+// call i of a workload: which light is set to what
+typedef void (*workload_fn)(uint32_t i, int *light,
+        struct light_state_t *state);
+
+/*
+ * Auto-brightness: the backlight follows a light sensor, which reports a
+ * new level for every 8 samples.
+ */
+static void workload_backlight(uint32_t i, int *light,
+        struct light_state_t *state)
+{
+    uint32_t level = 40 + (i / 8) % 64;
+
+    memset(state, 0, sizeof(*state));
+    *light = LIGHT_BACKLIGHT;
+    state->color = 0xff000000 | (level << 16) | (level << 8) | level;
+    state->brightnessMode = BRIGHTNESS_MODE_SENSOR;
+}
+
+/*
+ * Battery updates of a charging phone, every one the same but for the
+ * one that finds it full, interleaved with notifications blinking and
+ * going away and a rare attention blink.
+ */
+static void workload_speaker(uint32_t i, int *light,
+        struct light_state_t *state)
+{
+    memset(state, 0, sizeof(*state));
+    switch (i % 4) {
+    case 0:
+    case 2:
+        *light = LIGHT_BATTERY;
+        state->color = (i % 400 < 200) ? 0xffff8000 : 0xff00ff00;
+        break;
+    case 1:
+        *light = LIGHT_NOTIFICATIONS;
+        if (i % 64 < 32) {
+            state->color = 0xff0000ff;
+            state->flashMode = LIGHT_FLASH_TIMED;
+            state->flashOnMS = 1000;
+            state->flashOffMS = 3000;
+        }
+        break;
+    case 3:
+        *light = LIGHT_ATTENTION;
+        if (i % 1024 < 4) {
+            state->color = 0xffffffff;
+            state->flashMode = LIGHT_FLASH_HARDWARE;
+            state->flashOnMS = 500;
+            state->flashOffMS = 500;
+        }
+        break;
+    }
+}
+
+struct run_stats {
+    double ns_per_call;
+    double syscalls_per_call;
+    double writes_per_call;
+};
+
+/*
+ * Notifications posted and cleared in a storm, with the battery and the
+ * attention light changing in between.
+ */
+static void workload_storm(uint32_t i, int *light,
+        struct light_state_t *state)
+{
+    memset(state, 0, sizeof(*state));
+    switch (i % 8) {
+    case 3:
+        *light = LIGHT_BATTERY;
+        state->color = (i % 16 < 8) ? 0xffff0000 : 0xffff8000;
+        break;
+    case 6:
+        *light = LIGHT_ATTENTION;
+        if (i % 32 < 16) {
+            state->color = 0xffffffff;
+            state->flashMode = LIGHT_FLASH_HARDWARE;
+            state->flashOnMS = 500;
+            state->flashOffMS = 500;
+        }
+        break;
+    default:
+        *light = LIGHT_NOTIFICATIONS;
+        state->color = 0xff000000 | (i * 0x10307);
+        state->flashMode = LIGHT_FLASH_TIMED;
+        state->flashOnMS = 100 + i % 900;
+        state->flashOffMS = 1000;
+        break;
+    }
+}
+
+/*
+ * Makes count calls of workload on a fresh HAL. With reopen, the device
+ * is opened for every call and closed after it, which applies the call
+ * before the next one, and hashes gets what the nodes hold after every
+ * call. Otherwise the devices are kept open, the calls are made in bursts
+ * of burst calls, and hashes gets what the nodes hold once the worker
+ * settled after the last call of each burst.
+ */
+static int run_workload(workload_fn workload, int dt, int reopen,
+        uint32_t count, uint32_t burst, uint64_t *hashes,
+        struct run_stats *stats)
+{
+    struct light_state_t state;
+    struct lights lights;
+    struct light_device_t *dev;
+    uint64_t start, elapsed = 0;
+    uint32_t i;
+    int light;
+
+    if (lights_load(&lights, dt) < 0)
+        return -1;
+    for (i = 0; !reopen && i < LIGHT_COUNT; i++)
+        lights.devs[i] = lights_open(&lights, i);
+
+    for (i = 0; i < count; i++) {
+        workload(i, &light, &state);
+        start = now_ns();
+        dev = reopen ? lights_open(&lights, light) : lights.devs[light];
+        dev->set_light(dev, &state);
+        if (reopen)
+            lights_close(dev);
+        elapsed += now_ns() - start;
+        if (!reopen && (i % burst == burst - 1 || i == count - 1))
+            usleep(SETTLE_US);
+        else if (!reopen)
+            continue;
+        hashes[i] = fake_hash();
+    }
+
+    stats->ns_per_call = (double)elapsed / count;
+    stats->syscalls_per_call = (double)(fake_stats.opens +
+            fake_stats.closes + fake_stats.writes) / count;
+    stats->writes_per_call = (double)fake_stats.writes / count;
+    lights_unload(&lights);
+    return 0;
+}
+
+static void report_run(const char *benchmark, const char *params,
+        const struct run_stats *stats)
+{
+    report(benchmark, params, "ns_per_call", stats->ns_per_call, "ns");
+    report(benchmark, params, "syscalls_per_call", stats->syscalls_per_call,
+            "count");
+    report(benchmark, params, "writes_per_call", stats->writes_per_call,
+            "count");
+}
+
+/*
+ * Runs workload with the device reopened for every call, as if the HAL
+ * kept nothing, and kept open, and checks that after every burst the
+ * nodes hold what they held after its last call when reopened.
+ */
+static void bench_workload(const char *benchmark, workload_fn workload,
+        int dt, uint32_t count, uint32_t burst)
+{
+    struct run_stats stats;
+    uint64_t *expected, *hashes;
+    uint32_t i, errors = 0, checks = 0;
+    char params[BENCH_STR_LEN];
+    const char *driver = dt ? "dt" : "drv";
+
+    expected = calloc(count, sizeof(uint64_t));
+    hashes = calloc(count, sizeof(uint64_t));
+    if (!expected || !hashes)
+        goto out;
+
+    if (run_workload(workload, dt, 1, count, burst, expected, &stats) < 0)
+        goto out;
+    snprintf(params, sizeof(params), "%s reopened", driver);
+    report_run(benchmark, params, &stats);
+
+    if (run_workload(workload, dt, 0, count, burst, hashes, &stats) < 0)
+        goto out;
+    snprintf(params, sizeof(params), "%s kept open burst=%u", driver, burst);
+    report_run(benchmark, params, &stats);
+
+    for (i = 0; i < count; i++) {
+        if (i % burst == burst - 1 || i == count - 1) {
+            errors += (hashes[i] != expected[i]);
+            checks++;
+        }
+    }
+    snprintf(params, sizeof(params), "check=state %s", driver);
+    report(benchmark, params, "errors", errors, "count");
+    report(benchmark, params, "checked", checks, "count");
+out:
+    free(hashes);
+    free(expected);
+}
+
+// a burst is a second of samples of the light sensor
+static void bench_backlight(void)
+{
+    bench_workload("backlight", workload_backlight, 0, scaled(800), 8);
+}
+
+static void bench_speaker(void)
+{
+    bench_workload("speaker", workload_speaker, 0, scaled(800), 8);
+    bench_workload("speaker", workload_speaker, 1, scaled(800), 8);
+}
+
+static void bench_storm(void)
+{
+    bench_workload("storm", workload_storm, 0, scaled(4000), 200);
+    bench_workload("storm", workload_storm, 1, scaled(4000), 200);
+}
+
+/******************************************************************************/
+
+/*
+ * main
+ */
+
+struct bench {
+    const char *name;
+    void (*run)(void);
+};
+
+static const struct bench benches[] = {
+    { "backlight", bench_backlight },
+    { "speaker", bench_speaker },
+    { "storm", bench_storm },
+};
+
+static void write_json(FILE *out)
+{
+    char host[64] = "";
+    int i;
+    gethostname(host, sizeof(host) - 1);
+    fprintf(out, "{\n  \"suite\": \"light_bench\",\n  \"host\": \"%s\",\n"
+            "  \"scale\": %g,\n  \"results\": [\n", host, scale);
+    for (i = 0; i < num_results; i++) {
+        const struct bench_result *r = &results[i];
+        fprintf(out, "    {\"benchmark\": \"%s\", \"params\": \"%s\", "
+                "\"metric\": \"%s\", \"value\": %.3f, \"unit\": \"%s\"}"
+                "%s\n", r->benchmark, r->params, r->metric, r->value,
+                r->unit, (i + 1 < num_results) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = NULL;
+    const char *out_path = NULL;
+    char self[1024];
+    size_t i;
+    int opt;
+
+    snprintf(self, sizeof(self), "%s", argv[0]);
+    snprintf(module_path, sizeof(module_path), "%s/lights.msm8974.so",
+            dirname(self));
+    while ((opt = getopt(argc, argv, "f:s:l:o:")) != -1) {
+        switch (opt) {
+        case 'f': filter = optarg; break;
+        case 's': scale = atof(optarg); break;
+        case 'l':
+            snprintf(module_path, sizeof(module_path), "%s", optarg);
+            break;
+        case 'o': out_path = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-f filter] [-s scale] [-l module] "
+                    "[-o results.json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (!filter || strstr(benches[i].name, filter))
+            benches[i].run();
+    }
+
+    if (out_path) {
+        FILE *out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "could not open %s\n", out_path);
+            return 1;
+        }
+        write_json(out);
+        fclose(out);
+    }
+    return 0;
+}
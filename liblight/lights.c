@@ -27,6 +27,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <time.h>
 
 #include <sys/ioctl.h>
 #include <sys/types.h>
@@ -47,9 +48,36 @@ static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
 static struct light_state_t g_notification;
 static struct light_state_t g_battery;
 static struct light_state_t g_attention;
+static int g_backlight;
+static int g_buttons;
 
 static int g_led_is_dt = 0;
 
+// Serializes opening and closing devices, which starts and stops the worker
+static pthread_mutex_t g_devices_lock = PTHREAD_MUTEX_INITIALIZER;
+// Devices open, the worker runs and the sysfs nodes are kept open while
+// there is one
+static int g_devices = 0;
+
+/*
+ * The set_light methods only record the state asked for, under g_lock,
+ * and return. The update worker applies it off the caller's thread, at
+ * most once per UPDATE_WINDOW_MS: what is asked for while it waits is
+ * folded into one update with the latest state of every light. The
+ * worker is the only thread that writes the sysfs nodes.
+ */
+#define UPDATE_WINDOW_MS        20
+
+// Lights with a state not applied yet, in g_pending
+#define PENDING_BACKLIGHT       0x1
+#define PENDING_BUTTONS         0x2
+#define PENDING_SPEAKER         0x4
+
+static pthread_t g_worker;
+static pthread_cond_t g_worker_cond;
+static unsigned int g_pending;
+static int g_worker_stop;
+
 const char *const LCD_FILE
         = "/sys/class/leds/lcd-backlight/brightness";
 
@@ -98,14 +126,70 @@ char const *const LED_DT_BLINK_FILE
 // Brightness ramp up/down time for blinking
 #define LED_DT_RAMP_MS          500
 
+// Longest value written to a node, the duty_pcts list
+#define NODE_VALUE_MAX          ((3+1)*LED_DT_DUTY_STEPS+1)
+
+enum {
+    NODE_LCD,
+    NODE_BUTTONS,
+    NODE_RED,
+    NODE_GREEN,
+    NODE_BLUE,
+    NODE_FREQ,
+    NODE_PWM,
+    NODE_BLINK,
+    NODE_DT_RED,
+    NODE_DT_RAMP_STEP,
+    NODE_DT_DUTY,
+    NODE_DT_BLINK,
+    NODE_COUNT
+};
+
+/*
+ * A sysfs node written by the HAL. It is opened on the first write and
+ * kept open until the last device is closed, and the value last written
+ * to it is kept so that writing the same value again is skipped: the
+ * HAL is the only writer of these nodes.
+ */
+struct led_node {
+    const char *path;
+    int fd;
+    int warned;
+    int len;                        // -1: value unknown
+    char value[NODE_VALUE_MAX];
+};
+
+static struct led_node g_nodes[NODE_COUNT];
+
+// Writes done and skipped as unchanged since the devices were opened
+static struct {
+    unsigned int writes;
+    unsigned int skipped;
+    unsigned int opens;
+    unsigned int speaker_skipped;
+    unsigned int updates;
+    unsigned int coalesced;         // set_light calls folded into another
+} g_node_stats;
+
+// State the speaker LED shows, if g_speaker_valid
+static struct light_state_t g_speaker;
+static int g_speaker_valid = 0;
+
 /**
  * device methods
  */
 
 void init_globals(void)
 {
+    pthread_condattr_t attr;
+    int i;
+
     // init the mutex
     pthread_mutex_init(&g_lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_worker_cond, &attr);
+    pthread_condattr_destroy(&attr);
 
     /*
      * Determine whether LED is DT based.
@@ -116,35 +200,91 @@ void init_globals(void)
      * Thus, if duty_pcts exists, the driver is DT based.
      */
     g_led_is_dt = (access(LED_DT_DUTY_FILE, R_OK) == 0);
+
+    g_nodes[NODE_LCD].path = LCD_FILE;
+    g_nodes[NODE_BUTTONS].path = BUTTONS_FILE;
+    g_nodes[NODE_RED].path = RED_LED_FILE;
+    g_nodes[NODE_GREEN].path = GREEN_LED_FILE;
+    g_nodes[NODE_BLUE].path = BLUE_LED_FILE;
+    g_nodes[NODE_FREQ].path = LED_FREQ_FILE;
+    g_nodes[NODE_PWM].path = LED_PWM_FILE;
+    g_nodes[NODE_BLINK].path = LED_BLINK_FILE;
+    g_nodes[NODE_DT_RED].path = LED_DT_RED_BRIGHTNESS;
+    g_nodes[NODE_DT_RAMP_STEP].path = LED_DT_RAMP_STEP_FILE;
+    g_nodes[NODE_DT_DUTY].path = LED_DT_DUTY_FILE;
+    g_nodes[NODE_DT_BLINK].path = LED_DT_BLINK_FILE;
+    for (i = 0; i < NODE_COUNT; i++) {
+        g_nodes[i].fd = -1;
+        g_nodes[i].len = -1;
+    }
 }
 
+// Closes the nodes and forgets their values, once the worker is stopped
+static void
+close_nodes(void)
+{
+    int i;
+
+    for (i = 0; i < NODE_COUNT; i++) {
+        if (g_nodes[i].fd >= 0)
+            close(g_nodes[i].fd);
+        g_nodes[i].fd = -1;
+        g_nodes[i].len = -1;
+    }
+    g_speaker_valid = 0;
+    ALOGV("%u updates for %u more set_light calls, %u sysfs writes, "
+            "%u skipped as unchanged, %u opens, %u speaker updates skipped\n",
+            g_node_stats.updates, g_node_stats.coalesced,
+            g_node_stats.writes, g_node_stats.skipped, g_node_stats.opens,
+            g_node_stats.speaker_skipped);
+    memset(&g_node_stats, 0, sizeof(g_node_stats));
+}
+
+// Called on the worker
 static int
-write_string(const char *path, const char *buffer)
+write_string(int id, const char *buffer)
 {
-    int fd;
-    static int already_warned = 0;
+    struct led_node *node = &g_nodes[id];
+    int bytes = strlen(buffer);
+    int amt;
 
-    fd = open(path, O_RDWR);
-    if (fd >= 0) {
-        int bytes = strlen(buffer);
-        int amt = write(fd, buffer, bytes);
-        close(fd);
-        return amt == -1 ? -errno : 0;
-    } else {
-        if (already_warned == 0) {
-            ALOGE("write_string failed to open %s (%s)\n", path, strerror(errno));
-            already_warned = 1;
+    if (node->len == bytes && memcmp(node->value, buffer, bytes) == 0) {
+        g_node_stats.skipped++;
+        return 0;
+    }
+
+    if (node->fd < 0) {
+        node->fd = open(node->path, O_RDWR | O_CLOEXEC);
+        if (node->fd < 0) {
+            if (node->warned == 0) {
+                ALOGE("write_string failed to open %s (%s)\n", node->path,
+                        strerror(errno));
+                node->warned = 1;
+            }
+            return -errno;
         }
-        return -errno;
+        g_node_stats.opens++;
+    }
+
+    // sysfs takes every write as the whole value, from the start
+    amt = pwrite(node->fd, buffer, bytes, 0);
+    g_node_stats.writes++;
+    if (amt == -1 || bytes >= NODE_VALUE_MAX) {
+        // the driver may have taken part of it, or it is too long to keep
+        node->len = -1;
+        return amt == -1 ? -errno : 0;
     }
+    memcpy(node->value, buffer, bytes);
+    node->len = bytes;
+    return 0;
 }
 
 static int
-write_int(const char *path, int value)
+write_int(int id, int value)
 {
     char buffer[20];
     sprintf(buffer, "%d\n", value);
-    return write_string(path, buffer);
+    return write_string(id, buffer);
 }
 
 static int
@@ -171,10 +311,10 @@ set_speaker_light_locked_drv(struct light_device_t *dev,
     unsigned int colorRGB;
 
     if (state == NULL) {
-        write_int(RED_LED_FILE, 0);
-        write_int(GREEN_LED_FILE, 0);
-        write_int(BLUE_LED_FILE, 0);
-        write_int(LED_BLINK_FILE, 0);
+        write_int(NODE_RED, 0);
+        write_int(NODE_GREEN, 0);
+        write_int(NODE_BLUE, 0);
+        write_int(NODE_BLINK, 0);
         return 0;
     }
 
@@ -214,15 +354,15 @@ set_speaker_light_locked_drv(struct light_device_t *dev,
         pwm = 0;
     }
 
-    write_int(RED_LED_FILE, (colorRGB >> 16) & 0xFF);
-    write_int(GREEN_LED_FILE, (colorRGB >> 8) & 0xFF);
-    write_int(BLUE_LED_FILE, colorRGB & 0xFF);
+    write_int(NODE_RED, (colorRGB >> 16) & 0xFF);
+    write_int(NODE_GREEN, (colorRGB >> 8) & 0xFF);
+    write_int(NODE_BLUE, colorRGB & 0xFF);
 
     if (blink) {
-        write_int(LED_FREQ_FILE, freq);
-        write_int(LED_PWM_FILE, pwm);
+        write_int(NODE_FREQ, freq);
+        write_int(NODE_PWM, pwm);
     }
-    write_int(LED_BLINK_FILE, blink);
+    write_int(NODE_BLINK, blink);
 
     return 0;
 }
@@ -236,8 +376,8 @@ set_speaker_light_locked_dt(struct light_device_t *dev,
     unsigned int colorRGB;
 
     if (state == NULL) {
-        write_int(LED_DT_BLINK_FILE, 0);
-        write_int(LED_DT_RED_BRIGHTNESS, 0);
+        write_int(NODE_DT_BLINK, 0);
+        write_int(NODE_DT_RED, 0);
         return 0;
     }
 
@@ -274,12 +414,12 @@ set_speaker_light_locked_dt(struct light_device_t *dev,
         }
         p += sprintf(p, "\n");
 
-        write_int(LED_DT_RAMP_STEP_FILE, stepMS);
-        write_string(LED_DT_DUTY_FILE, dutystr);
-        write_int(LED_DT_BLINK_FILE, 1);
+        write_int(NODE_DT_RAMP_STEP, stepMS);
+        write_string(NODE_DT_DUTY, dutystr);
+        write_int(NODE_DT_BLINK, 1);
     }
     else {
-        write_int(LED_DT_RED_BRIGHTNESS, colorRGB ? 255 : 0);
+        write_int(NODE_DT_RED, colorRGB ? 255 : 0);
     }
 
     return 0;
@@ -295,50 +435,134 @@ set_speaker_light_locked(struct light_device_t *dev,
     return set_speaker_light_locked_drv(dev, state);
 }
 
+// The state the speaker LED is to show, called with g_lock held
 static void
-handle_speaker_battery_locked(struct light_device_t *dev,
-        const struct light_state_t *state)
+speaker_state_locked(struct light_state_t *state)
 {
-    set_speaker_light_locked(dev, NULL);
     if (is_lit(&g_attention)) {
-        set_speaker_light_locked(dev, &g_attention);
+        *state = g_attention;
     } else if (is_lit(&g_notification)) {
-        set_speaker_light_locked(dev, &g_notification);
+        *state = g_notification;
     } else {
-        set_speaker_light_locked(dev, &g_battery);
+        *state = g_battery;
     }
 }
 
+// Called on the worker
+static void
+handle_speaker_battery(const struct light_state_t *next)
+{
+    // the LED is reset on a change, a blink restarts; no change, no reset
+    if (g_speaker_valid && memcmp(next, &g_speaker, sizeof(g_speaker)) == 0) {
+        g_node_stats.speaker_skipped++;
+        return;
+    }
+    set_speaker_light_locked(NULL, NULL);
+    set_speaker_light_locked(NULL, next);
+    g_speaker = *next;
+    g_speaker_valid = 1;
+}
+
+// Records that light has a new state for the worker, with g_lock held
+static void
+request_update_locked(unsigned int light)
+{
+    if (g_pending & light)
+        g_node_stats.coalesced++;
+    g_pending |= light;
+    pthread_cond_signal(&g_worker_cond);
+}
+
+static uint64_t
+now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+ * The update worker. It applies what is pending with the state of the
+ * lights at that time, so every light ends up as it was last set and the
+ * speaker LED shows what the last of its calls asked for, as if the
+ * calls had been applied one by one. Once asked to stop, it applies what
+ * is pending without waiting and exits.
+ */
+static void *
+update_worker(void *arg)
+{
+    struct light_state_t speaker;
+    struct timespec deadline;
+    uint64_t next_update = 0;
+    unsigned int pending;
+    int backlight, buttons;
+
+    pthread_mutex_lock(&g_lock);
+    for (;;) {
+        while (!g_pending && !g_worker_stop)
+            pthread_cond_wait(&g_worker_cond, &g_lock);
+        if (!g_pending)
+            break;
+
+        // one update per window, what comes in meanwhile is folded in
+        while (!g_worker_stop && now_ms() < next_update) {
+            deadline.tv_sec = next_update / 1000;
+            deadline.tv_nsec = (next_update % 1000) * 1000000;
+            pthread_cond_timedwait(&g_worker_cond, &g_lock, &deadline);
+        }
+
+        pending = g_pending;
+        g_pending = 0;
+        backlight = g_backlight;
+        buttons = g_buttons;
+        speaker_state_locked(&speaker);
+        pthread_mutex_unlock(&g_lock);
+
+        if (pending & PENDING_BACKLIGHT)
+            write_int(NODE_LCD, backlight);
+        if (pending & PENDING_BUTTONS)
+            write_int(NODE_BUTTONS, buttons);
+        if (pending & PENDING_SPEAKER)
+            handle_speaker_battery(&speaker);
+        g_node_stats.updates++;
+
+        pthread_mutex_lock(&g_lock);
+        next_update = now_ms() + UPDATE_WINDOW_MS;
+    }
+    pthread_mutex_unlock(&g_lock);
+    return NULL;
+}
+
 static int
 set_light_backlight(struct light_device_t *dev,
         const struct light_state_t *state)
 {
-    int err = 0;
     int brightness = rgb_to_brightness(state);
 
     pthread_mutex_lock(&g_lock);
 
-    err = write_int(LCD_FILE, brightness);
+    g_backlight = brightness;
+    request_update_locked(PENDING_BACKLIGHT);
 
     pthread_mutex_unlock(&g_lock);
 
-    return err;
+    return 0;
 }
 
 static int
 set_light_buttons(struct light_device_t *dev,
         const struct light_state_t *state)
 {
-    int err = 0;
     int brightness = rgb_to_brightness(state);
 
     pthread_mutex_lock(&g_lock);
 
-    err = write_int(BUTTONS_FILE, brightness);
+    g_buttons = brightness;
+    request_update_locked(PENDING_BUTTONS);
 
     pthread_mutex_unlock(&g_lock);
 
-    return err;
+    return 0;
 }
 
 static int
@@ -374,7 +598,7 @@ set_light_notifications(struct light_device_t *dev,
         // Update with the new color
         g_notification.color = (rgb[0] << 16) + (rgb[1] << 8) + rgb[2];
     }
-    handle_speaker_battery_locked(dev, state);
+    request_update_locked(PENDING_SPEAKER);
 
     pthread_mutex_unlock(&g_lock);
 
@@ -395,7 +619,7 @@ set_light_attention(struct light_device_t *dev,
     } else if (state->flashMode == LIGHT_FLASH_NONE) {
         g_attention.color = 0;
     }
-    handle_speaker_battery_locked(dev, state);
+    request_update_locked(PENDING_SPEAKER);
 
     pthread_mutex_unlock(&g_lock);
 
@@ -409,7 +633,7 @@ set_light_battery(struct light_device_t *dev,
     pthread_mutex_lock(&g_lock);
 
     g_battery = *state;
-    handle_speaker_battery_locked(dev, state);
+    request_update_locked(PENDING_SPEAKER);
 
     pthread_mutex_unlock(&g_lock);
 
@@ -421,6 +645,17 @@ static int
 close_lights(struct light_device_t *dev)
 {
     if (dev) {
+        pthread_mutex_lock(&g_devices_lock);
+        if (--g_devices == 0) {
+            // the last updates are applied before the worker exits
+            pthread_mutex_lock(&g_lock);
+            g_worker_stop = 1;
+            pthread_cond_signal(&g_worker_cond);
+            pthread_mutex_unlock(&g_lock);
+            pthread_join(g_worker, NULL);
+            close_nodes();
+        }
+        pthread_mutex_unlock(&g_devices_lock);
         free(dev);
     }
     return 0;
@@ -456,8 +691,22 @@ static int open_lights(const struct hw_module_t *module, const char *name,
     pthread_once(&g_init, init_globals);
 
     struct light_device_t *dev = malloc(sizeof(struct light_device_t));
+    if (!dev)
+        return -ENOMEM;
     memset(dev, 0, sizeof(*dev));
 
+    pthread_mutex_lock(&g_devices_lock);
+    if (g_devices == 0) {
+        g_worker_stop = 0;
+        if (pthread_create(&g_worker, NULL, update_worker, NULL) != 0) {
+            pthread_mutex_unlock(&g_devices_lock);
+            free(dev);
+            return -EAGAIN;
+        }
+    }
+    g_devices++;
+    pthread_mutex_unlock(&g_devices_lock);
+
     dev->common.tag = HARDWARE_DEVICE_TAG;
     dev->common.version = 0;
     dev->common.module = (struct hw_module_t*)module;